@@ -0,0 +1,859 @@
+/**
+ * @file benchmark.c
+ *
+ * @author :Yujin Yu
+ * @date   :2025.05.21
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "ts_global.h"
+#include "slot_filter.h"
+#include "ts_analyzer.h"
+#include "get_pat_info.h"
+#include "get_pmt_info.h"
+#include "section_store.h"
+#include "string_pool.h"
+#include "get_sdt_info.h"
+#include "get_eit_info.h"
+#include "integrate_data.h"
+#include "table_context.h"
+#include "ts_generator.h"
+#include "benchmark.h"
+
+#define BENCHMARK_SECTION_HEADER_LENGTH 8   // table_id .. last_section_number
+#define BENCHMARK_PAT_PROGRAM_COUNT     250 // programs per PAT section
+#define BENCHMARK_SDT_SERVICE_COUNT     10  // services per SDT section
+#define BENCHMARK_EVENTS_PER_PROGRAM    2   // present and following of each program in the integration cases
+#define BENCHMARK_GARBAGE_LENGTH        4000
+#define BENCHMARK_DETECT_PACKETS        1000
+#define BENCHMARK_TRANSPORT_STREAM_ID   0x0001
+#define BENCHMARK_ORIGINAL_NETWORK_ID   0x233A
+#define BENCHMARK_EVENT_START_MJD       60000
+
+#ifndef ENABLE_ALLOCATION_COUNT
+#define ENABLE_ALLOCATION_COUNT 0 // 1 wraps malloc, calloc and realloc of the whole binary, only for a binary built to run the benchmarks
+#endif
+
+// gcc defines __SANITIZE_ADDRESS__, clang only answers __has_feature
+#if defined(__SANITIZE_ADDRESS__)
+#define BENCHMARK_UNDER_ASAN 1
+#elif defined(__has_feature)
+#if __has_feature(address_sanitizer)
+#define BENCHMARK_UNDER_ASAN 1
+#endif
+#endif
+
+//--------------------------------------------------------------------------------------------
+// allocation counting, glibc only: malloc of the whole binary forwards to the libc allocator
+//--------------------------------------------------------------------------------------------
+#if ENABLE_ALLOCATION_COUNT && defined(__GLIBC__) && !defined(BENCHMARK_UNDER_ASAN)
+#define BENCHMARK_COUNT_ALLOCATIONS 1
+
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *pointer, size_t size);
+
+static __thread long long allocation_count = 0;
+
+void *malloc(size_t size)
+{
+	allocation_count++;
+	return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size)
+{
+	allocation_count++;
+	return __libc_calloc(count, size);
+}
+
+void *realloc(void *pointer, size_t size)
+{
+	allocation_count++;
+	return __libc_realloc(pointer, size);
+}
+
+static long long get_allocation_count(void)
+{
+	return allocation_count;
+}
+#else
+#define BENCHMARK_COUNT_ALLOCATIONS 0
+
+static long long get_allocation_count(void)
+{
+	return 0;
+}
+#endif
+
+//--------------------------------------------------------------------------------------------
+typedef struct
+{
+	long long elapsed_ns;
+	long long allocation_count;
+	long long start_ns;
+	long long start_allocation_count;
+} BenchmarkTimer;
+
+// Runs the case for the given iterations, only the time between start_timer and stop_timer counts
+typedef void (*benchmark_function)(BenchmarkTimer *timer, long long iterations, int parameter, int mix);
+
+typedef struct
+{
+	char               name[BENCHMARK_NAME_LENGTH];
+	const char        *item_name;
+	double             items_per_op;
+	benchmark_function function;
+	int                parameter;
+	int                mix;
+} BenchmarkCase;
+
+typedef enum
+{
+	DISPATCH_MIX_ALL = 0, // every packet is on a filtered PID
+	DISPATCH_MIX_SPARSE,  // one packet in ten
+	DISPATCH_MIX_NONE     // no packet passes the PID compare
+} DispatchMix;
+
+typedef enum
+{
+	DETECT_INPUT_CLEAN_188 = 0,
+	DETECT_INPUT_CLEAN_204,
+	DETECT_INPUT_GARBAGE_188
+} DetectInput;
+
+// Prebuilt sections and the PID each one is replayed on
+typedef struct
+{
+	unsigned char  *data;
+	int             length;
+	int             capacity;
+	int            *offset_array;
+	unsigned short *pid_array;
+	int             count;
+	int             count_capacity;
+} SectionList;
+
+static const char *dispatch_mix_name[] = {"all", "sparse", "none"};
+static const char *detect_input_name[] = {"clean188", "clean204", "garbage188"};
+
+static long long callback_count = 0;
+static unsigned  random_state   = 1;
+
+//--------------------------------------------------------------------------------------------
+static long long get_time_ns(void)
+{
+	struct timespec now = {0};
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (long long)now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+static void start_timer(BenchmarkTimer *timer)
+{
+	timer->start_allocation_count = get_allocation_count();
+	timer->start_ns               = get_time_ns();
+}
+
+static void stop_timer(BenchmarkTimer *timer)
+{
+	timer->elapsed_ns += get_time_ns() - timer->start_ns;
+	timer->allocation_count += get_allocation_count() - timer->start_allocation_count;
+}
+
+// Fixed LCG so every run feeds the same bytes
+static unsigned char next_random_byte(void)
+{
+	random_state = random_state * 1103515245 + 12345;
+	return (unsigned char)(random_state >> 16);
+}
+
+/**
+ * @brief Reserve room for one more section of at most MAX_SECTION_LENGTH bytes
+ *
+ * @return where the section is built, NULL when out of memory
+ */
+static unsigned char *begin_section(SectionList *section_list)
+{
+	unsigned char  *new_data         = NULL;
+	int            *new_offset_array = NULL;
+	unsigned short *new_pid_array    = NULL;
+	int             new_capacity     = 0;
+
+	if (section_list->length + MAX_SECTION_LENGTH > section_list->capacity)
+	{
+		new_capacity = MAX(section_list->capacity * 2, section_list->length + MAX_SECTION_LENGTH);
+		new_data     = (unsigned char *)realloc(section_list->data, new_capacity);
+		if (new_data == NULL)
+			return NULL;
+		section_list->data     = new_data;
+		section_list->capacity = new_capacity;
+	}
+
+	if (section_list->count == section_list->count_capacity)
+	{
+		new_capacity     = MAX(section_list->count_capacity * 2, 64);
+		new_offset_array = (int *)realloc(section_list->offset_array, new_capacity * sizeof(int));
+		if (new_offset_array == NULL)
+			return NULL;
+		section_list->offset_array = new_offset_array;
+
+		new_pid_array = (unsigned short *)realloc(section_list->pid_array, new_capacity * sizeof(unsigned short));
+		if (new_pid_array == NULL)
+			return NULL;
+		section_list->pid_array      = new_pid_array;
+		section_list->count_capacity = new_capacity;
+	}
+
+	return section_list->data + section_list->length;
+}
+
+static void end_section(SectionList *section_list, unsigned short pid, int section_length)
+{
+	section_list->offset_array[section_list->count] = section_list->length;
+	section_list->pid_array[section_list->count]    = pid;
+	section_list->count++;
+	section_list->length += section_length;
+}
+
+static void free_section_list(SectionList *section_list)
+{
+	free(section_list->data);
+	free(section_list->offset_array);
+	free(section_list->pid_array);
+	memset(section_list, 0, sizeof(SectionList));
+}
+
+static int put_text(unsigned char *buffer, const char *text)
+{
+	int length = (int)strlen(text);
+
+	buffer[0] = (unsigned char)length;
+	memcpy(buffer + 1, text, length);
+	return length + 1;
+}
+
+// One event with a short event descriptor, service_id is the program number
+static int build_eit_section(unsigned char *section, unsigned short service_id, int event_index)
+{
+	unsigned char *body          = section + BENCHMARK_SECTION_HEADER_LENGTH;
+	unsigned char *event         = body + 6;
+	unsigned char *descriptor    = event + 12;
+	char           title[64]     = {0};
+	int            mjd           = BENCHMARK_EVENT_START_MJD + event_index / 24;
+	int            hour          = event_index % 24;
+	int            length        = 0;
+
+	body[0] = BENCHMARK_TRANSPORT_STREAM_ID >> 8;
+	body[1] = BENCHMARK_TRANSPORT_STREAM_ID & 0xFF;
+	body[2] = BENCHMARK_ORIGINAL_NETWORK_ID >> 8;
+	body[3] = BENCHMARK_ORIGINAL_NETWORK_ID & 0xFF;
+	body[4] = 0;    // segment_last_section_number
+	body[5] = 0x50; // last_table_id
+
+	snprintf(title, sizeof(title), "Event %d of service %d", event_index, service_id);
+	descriptor[0] = 0x4D;
+	memcpy(descriptor + 2, "eng", 3);
+	length        = 5;
+	length += put_text(descriptor + length, title);
+	length += put_text(descriptor + length, "Benchmark event");
+	descriptor[1] = (unsigned char)(length - 2);
+
+	event[0]  = (event_index + 1) >> 8;
+	event[1]  = (event_index + 1) & 0xFF;
+	event[2]  = mjd >> 8;
+	event[3]  = mjd & 0xFF;
+	event[4]  = (unsigned char)(((hour / 10) << 4) | (hour % 10));
+	event[5]  = 0x00;
+	event[6]  = 0x00;
+	event[7]  = 0x01; // one hour
+	event[8]  = 0x00;
+	event[9]  = 0x00;
+	event[10] = 0x80 | ((length >> 8) & 0x0F); // running
+	event[11] = length & 0xFF;
+
+	return complete_section(section, 0x50, service_id, 1, 0, 0, 6 + 12 + length);
+}
+
+/**
+ * @brief PAT, one PMT per program, SDT and EIT of program_count programs
+ *
+ * @return 0: successful
+ *         <0: out of memory
+ */
+static int build_stream_sections(SectionList *section_list, int program_count, int events_per_program)
+{
+	unsigned char *section             = NULL;
+	unsigned char *body                = NULL;
+	char           name[32]            = {0};
+	int            section_count       = 0;
+	int            first_program       = 0;
+	int            program_in_section  = 0;
+	int            descriptor_length   = 0;
+	int            body_length         = 0;
+	int            section_number      = 0;
+	int            program_number      = 0;
+	int            i                   = 0;
+	int            j                   = 0;
+
+	section_count = (program_count + BENCHMARK_PAT_PROGRAM_COUNT - 1) / BENCHMARK_PAT_PROGRAM_COUNT;
+	// clang-format off
+	for (section_number=0; section_number<section_count; section_number++)
+	{ // clang-format on
+		if ((section = begin_section(section_list)) == NULL)
+			return -1;
+		body               = section + BENCHMARK_SECTION_HEADER_LENGTH;
+		first_program      = section_number * BENCHMARK_PAT_PROGRAM_COUNT;
+		program_in_section = MIN(BENCHMARK_PAT_PROGRAM_COUNT, program_count - first_program);
+		// clang-format off
+		for (i=0; i<program_in_section; i++)
+		{ // clang-format on
+			program_number  = first_program + i + 1;
+			body[i * 4 + 0] = program_number >> 8;
+			body[i * 4 + 1] = program_number & 0xFF;
+			body[i * 4 + 2] = 0xE0 | ((0x100 + program_number - 1) >> 8);
+			body[i * 4 + 3] = (0x100 + program_number - 1) & 0xFF;
+		}
+		end_section(section_list, PAT_PID, complete_section(section, 0x00, BENCHMARK_TRANSPORT_STREAM_ID, 1, section_number, section_count - 1, program_in_section * 4));
+	}
+
+	// video and audio ES per program
+	// clang-format off
+	for (i=0; i<program_count; i++)
+	{ // clang-format on
+		if ((section = begin_section(section_list)) == NULL)
+			return -1;
+		body = section + BENCHMARK_SECTION_HEADER_LENGTH;
+		// clang-format off
+		for (j=0; j<2; j++)
+		{ // clang-format on
+			body[4 + j * 5 + 0] = (j == 0) ? 0x02 : 0x04;
+			body[4 + j * 5 + 1] = 0xE0 | (((0x1000 + i * 2 + j) >> 8) & 0x1F);
+			body[4 + j * 5 + 2] = (0x1000 + i * 2 + j) & 0xFF;
+			body[4 + j * 5 + 3] = 0xF0;
+			body[4 + j * 5 + 4] = 0x00;
+		}
+		body[0] = body[5];
+		body[1] = body[6];
+		body[2] = 0xF0;
+		body[3] = 0x00;
+		end_section(section_list, 0x100 + i, complete_section(section, PMT_TABLE_ID, i + 1, 1, 0, 0, 4 + 10));
+	}
+
+	section_count = (program_count + BENCHMARK_SDT_SERVICE_COUNT - 1) / BENCHMARK_SDT_SERVICE_COUNT;
+	// clang-format off
+	for (section_number=0; section_number<section_count; section_number++)
+	{ // clang-format on
+		if ((section = begin_section(section_list)) == NULL)
+			return -1;
+		body        = section + BENCHMARK_SECTION_HEADER_LENGTH;
+		body[0]     = BENCHMARK_ORIGINAL_NETWORK_ID >> 8;
+		body[1]     = BENCHMARK_ORIGINAL_NETWORK_ID & 0xFF;
+		body[2]     = 0xFF;
+		body_length = 3;
+
+		first_program      = section_number * BENCHMARK_SDT_SERVICE_COUNT;
+		program_in_section = MIN(BENCHMARK_SDT_SERVICE_COUNT, program_count - first_program);
+		// clang-format off
+		for (i=0; i<program_in_section; i++)
+		{ // clang-format on
+			program_number = first_program + i + 1;
+			snprintf(name, sizeof(name), "Service %d", program_number);
+
+			// service descriptor, digital television
+			body[body_length + 5] = 0x48;
+			body[body_length + 7] = 0x01;
+			descriptor_length     = 3;
+			descriptor_length += put_text(body + body_length + 5 + descriptor_length, "Benchmark");
+			descriptor_length += put_text(body + body_length + 5 + descriptor_length, name);
+			body[body_length + 6] = (unsigned char)(descriptor_length - 2);
+
+			body[body_length + 0] = program_number >> 8;
+			body[body_length + 1] = program_number & 0xFF;
+			body[body_length + 2] = 0xFF; // EIT schedule and present/following
+			body[body_length + 3] = 0x80 | ((descriptor_length >> 8) & 0x0F);
+			body[body_length + 4] = descriptor_length & 0xFF;
+			body_length += 5 + descriptor_length;
+		}
+		end_section(section_list, SDT_PID, complete_section(section, 0x42, BENCHMARK_TRANSPORT_STREAM_ID, 1, section_number, section_count - 1, body_length));
+	}
+
+	// clang-format off
+	for (i=0; i<program_count; i++)
+	{ // clang-format on
+		// clang-format off
+		for (j=0; j<events_per_program; j++)
+		{ // clang-format on
+			if ((section = begin_section(section_list)) == NULL)
+				return -1;
+			end_section(section_list, EIT_PID, build_eit_section(section, i + 1, j));
+		}
+	}
+
+	return 0;
+}
+
+//--------------------------------------------------------------------------------------------
+// cases
+//--------------------------------------------------------------------------------------------
+static void run_crc_case(BenchmarkTimer *timer, long long iterations, int length, int mix)
+{
+	unsigned char buffer[4096] = {0};
+	volatile int  result       = 0;
+	long long     i            = 0;
+
+	(void)mix;
+
+	// clang-format off
+	for (i=0; i<length; i++)
+	{ // clang-format on
+		buffer[i] = next_random_byte();
+	}
+
+	start_timer(timer);
+	// clang-format off
+	for (i=0; i<iterations; i++)
+	{ // clang-format on
+		result += crc_check(buffer, length);
+	}
+	stop_timer(timer);
+}
+
+static int count_callback(Slot *slot, int filter_index, unsigned char *section_buffer, unsigned short pid)
+{
+	(void)slot;
+	(void)filter_index;
+	(void)section_buffer;
+	(void)pid;
+
+	callback_count++;
+	return 0;
+}
+
+/**
+ * @brief Packets of filter_count PIDs, each carrying one complete 32 byte section, mixed with 0x1FFE
+ */
+static unsigned char *build_dispatch_packets(int filter_count, int mix)
+{
+	unsigned char  continuity_counter[MAX_FILTER_COUNT + 1] = {0};
+	unsigned char *buffer                                   = NULL;
+	unsigned char *packet                                   = NULL;
+	unsigned short pid                                      = 0;
+	int            stream_index                             = 0;
+	int            matched_count                            = 0;
+	int            i                                        = 0;
+
+	buffer = (unsigned char *)malloc(BENCHMARK_DISPATCH_PACKETS * TS_PACKET_SIZE);
+	if (buffer == NULL)
+		return NULL;
+	memset(buffer, 0xFF, BENCHMARK_DISPATCH_PACKETS * TS_PACKET_SIZE);
+
+	// clang-format off
+	for (i=0; i<BENCHMARK_DISPATCH_PACKETS; i++)
+	{ // clang-format on
+		packet = buffer + i * TS_PACKET_SIZE;
+		if ((mix == DISPATCH_MIX_ALL) || ((mix == DISPATCH_MIX_SPARSE) && (i % 10 == 0)))
+		{
+			stream_index = matched_count++ % filter_count;
+			pid          = 0x20 + stream_index;
+		}
+		else
+		{
+			stream_index = MAX_FILTER_COUNT;
+			pid          = 0x1FFE;
+		}
+
+		packet[0] = SYNC_BYTE;
+		packet[1] = 0x40 | (pid >> 8);
+		packet[2] = pid & 0xFF;
+		packet[3] = 0x10 | continuity_counter[stream_index];
+		packet[4] = 0x00; // pointer_field
+		continuity_counter[stream_index] = (continuity_counter[stream_index] + 1) & 0x0F;
+
+		memset(packet + 5 + BENCHMARK_SECTION_HEADER_LENGTH, stream_index, 20);
+		complete_section(packet + 5, 0x80, pid, 1, 0, 0, 20);
+	}
+
+	return buffer;
+}
+
+static void run_dispatch_case(BenchmarkTimer *timer, long long iterations, int filter_count, int mix)
+{
+	unsigned char  filter_match[FILTER_MASK_LENGTH] = {SYNC_BYTE, 0x00, 0x00};
+	unsigned char  filter_mask[FILTER_MASK_LENGTH]  = {0xFF, 0x1F, 0xFF};
+	unsigned char *buffer                           = NULL;
+	Slot           slot                             = {0};
+	long long      i                                = 0;
+
+	if ((buffer = build_dispatch_packets(filter_count, mix)) == NULL)
+		return;
+
+	slot = init_slot(NULL, TS_PACKET_SIZE, 0);
+	// clang-format off
+	for (i=0; i<filter_count; i++)
+	{ // clang-format on
+		filter_match[1] = ((0x20 + i) >> 8) & 0x1F;
+		filter_match[2] = (0x20 + i) & 0xFF;
+		alloc_filter(&slot, filter_match, filter_mask, 1, count_callback);
+	}
+
+	start_timer(timer);
+	// clang-format off
+	for (i=0; i<iterations; i++)
+	{ // clang-format on
+		feed_slot(&slot, buffer, BENCHMARK_DISPATCH_PACKETS * TS_PACKET_SIZE);
+	}
+	stop_timer(timer);
+
+	clear_slot(&slot);
+	free(buffer);
+}
+
+static void run_detect_case(BenchmarkTimer *timer, long long iterations, int input, int mix)
+{
+	unsigned char *buffer              = NULL;
+	FILE          *input_fp            = NULL;
+	int            packet_size         = (input == DETECT_INPUT_CLEAN_204) ? TS_FEC_PACKET_SIZE : TS_PACKET_SIZE;
+	int            prefix_length       = (input == DETECT_INPUT_GARBAGE_188) ? BENCHMARK_GARBAGE_LENGTH : 0;
+	int            length              = prefix_length + BENCHMARK_DETECT_PACKETS * packet_size;
+	long           first_sync_position = 0;
+	long long      i                   = 0;
+
+	(void)mix;
+
+	if ((buffer = (unsigned char *)malloc(length)) == NULL)
+		return;
+
+	// clang-format off
+	for (i=0; i<length; i++)
+	{ // clang-format on
+		buffer[i] = next_random_byte();
+	}
+
+	// clang-format off
+	for (i=0; i<BENCHMARK_DETECT_PACKETS; i++)
+	{ // clang-format on
+		buffer[prefix_length + i * packet_size] = SYNC_BYTE;
+	}
+
+	if ((input_fp = fmemopen(buffer, length, "rb")) == NULL)
+	{
+		free(buffer);
+		return;
+	}
+
+	start_timer(timer);
+	// clang-format off
+	for (i=0; i<iterations; i++)
+	{ // clang-format on
+		detect_ts_packet_size(input_fp, &first_sync_position);
+	}
+	stop_timer(timer);
+
+	fclose(input_fp);
+	free(buffer);
+}
+
+static void run_eit_insert_case(BenchmarkTimer *timer, long long iterations, int event_count, int mix)
+{
+	SectionList   section_list  = {0};
+	Slot          slot          = {0};
+	TableContext *table_context = NULL;
+	unsigned char *section      = NULL;
+	int            service_count = MIN(BENCHMARK_SERVICE_COUNT, event_count);
+	long long      i            = 0;
+	int            j            = 0;
+
+	(void)mix;
+
+	// schedule order: the events of one service, then the next service
+	// clang-format off
+	for (j=0; j<event_count; j++)
+	{ // clang-format on
+		if ((section = begin_section(&section_list)) == NULL)
+		{
+			free_section_list(&section_list);
+			return;
+		}
+		end_section(&section_list, EIT_PID, build_eit_section(section, j / (event_count / service_count) + 1, j % (event_count / service_count)));
+	}
+
+	// clang-format off
+	for (i=0; i<iterations; i++)
+	{ // clang-format on
+		if ((table_context = alloc_table_context()) == NULL)
+			break;
+		switch_table_context(table_context);
+
+		start_timer(timer);
+		// clang-format off
+		for (j=0; j<section_list.count; j++)
+		{ // clang-format on
+			eit_callback(&slot, 0, section_list.data + section_list.offset_array[j], EIT_PID);
+		}
+		stop_timer(timer);
+
+		free_table_context(table_context);
+		switch_table_context(NULL);
+	}
+
+	free_section_list(&section_list);
+}
+
+static void run_integration_case(BenchmarkTimer *timer, long long iterations, int program_count, int mix)
+{
+	SectionList      section_list      = {0};
+	Slot             slot              = {0};
+	TableContext    *table_context     = NULL;
+	ProgramInfoList *program_info_list = NULL;
+	unsigned char   *section           = NULL;
+	long long        i                 = 0;
+	int              j                 = 0;
+
+	(void)mix;
+
+	if (build_stream_sections(&section_list, program_count, BENCHMARK_EVENTS_PER_PROGRAM) < 0)
+	{
+		free_section_list(&section_list);
+		return;
+	}
+
+	// clang-format off
+	for (i=0; i<iterations; i++)
+	{ // clang-format on
+		if ((table_context = alloc_table_context()) == NULL)
+			break;
+
+		// acquisition is not timed, only the integration of the acquired tables
+		slot               = init_slot(NULL, TS_PACKET_SIZE, 0);
+		slot.table_context = table_context;
+		switch_table_context(table_context);
+		init_pat_resource(&slot);
+		init_sdt_resource(&slot);
+		init_eit_resource(&slot);
+		// clang-format off
+		for (j=0; j<section_list.count; j++)
+		{ // clang-format on
+			section = section_list.data + section_list.offset_array[j];
+			replay_section(&slot, section_list.pid_array[j], section, (((section[1] & 0x0F) << 8) | section[2]) + 3);
+		}
+		free_pat_resource();
+		free_pmt_resource();
+		free_sdt_resource();
+		free_eit_resource();
+
+		start_timer(timer);
+		program_info_list = get_program_info_list();
+		free_program_info_list(program_info_list);
+		stop_timer(timer);
+
+		clear_slot(&slot);
+		free_table_context(table_context);
+		switch_table_context(NULL);
+	}
+
+	free_section_list(&section_list);
+}
+
+//--------------------------------------------------------------------------------------------
+static int add_case(BenchmarkCase *case_array, int case_count, const BenchmarkConfig *config, const char *name, const char *item_name, double items_per_op, benchmark_function function, int parameter, int mix)
+{
+	BenchmarkCase *benchmark_case = NULL;
+
+	if ((case_count >= BENCHMARK_MAX_RESULT_COUNT) || ((config->name_filter != NULL) && (strstr(name, config->name_filter) == NULL)))
+		return case_count;
+
+	benchmark_case = &case_array[case_count];
+	snprintf(benchmark_case->name, sizeof(benchmark_case->name), "%s", name);
+	benchmark_case->item_name    = item_name;
+	benchmark_case->items_per_op = items_per_op;
+	benchmark_case->function     = function;
+	benchmark_case->parameter    = parameter;
+	benchmark_case->mix          = mix;
+	return case_count + 1;
+}
+
+static int collect_cases(BenchmarkCase *case_array, const BenchmarkConfig *config)
+{
+	static const int crc_length_array[]     = {16, 188, 1024, 4096};
+	static const int filter_count_array[]   = {1, 8, 32};
+	static const int event_count_array[]    = {1000, 10000, 100000, 1000000};
+	static const int program_count_array[]  = {100, 1000};
+
+	char name[BENCHMARK_NAME_LENGTH] = {0};
+	int  max_event_count             = (config->max_event_count > 0) ? config->max_event_count : BENCHMARK_DEFAULT_MAX_EVENT;
+	int  case_count                  = 0;
+	int  i                           = 0;
+	int  j                           = 0;
+
+	// clang-format off
+	for (i=0; i<(int)ARRAY_SIZE(crc_length_array); i++)
+	{ // clang-format on
+		snprintf(name, sizeof(name), "crc32/%d", crc_length_array[i]);
+		case_count = add_case(case_array, case_count, config, name, "byte", crc_length_array[i], run_crc_case, crc_length_array[i], 0);
+	}
+
+	// clang-format off
+	for (i=0; i<(int)ARRAY_SIZE(filter_count_array); i++)
+	{ // clang-format on
+		// clang-format off
+		for (j=0; j<(int)ARRAY_SIZE(dispatch_mix_name); j++)
+		{ // clang-format on
+			snprintf(name, sizeof(name), "dispatch/%d/%s", filter_count_array[i], dispatch_mix_name[j]);
+			case_count = add_case(case_array, case_count, config, name, "packet", BENCHMARK_DISPATCH_PACKETS, run_dispatch_case, filter_count_array[i], j);
+		}
+	}
+
+	// clang-format off
+	for (i=0; i<(int)ARRAY_SIZE(detect_input_name); i++)
+	{ // clang-format on
+		snprintf(name, sizeof(name), "detect/%s", detect_input_name[i]);
+		case_count = add_case(case_array, case_count, config, name, "detection", 1, run_detect_case, i, 0);
+	}
+
+	// clang-format off
+	for (i=0; i<(int)ARRAY_SIZE(event_count_array); i++)
+	{ // clang-format on
+		if (event_count_array[i] > max_event_count)
+			break;
+		snprintf(name, sizeof(name), "eit_insert/%d", event_count_array[i]);
+		case_count = add_case(case_array, case_count, config, name, "event", event_count_array[i], run_eit_insert_case, event_count_array[i], 0);
+	}
+
+	// clang-format off
+	for (i=0; i<(int)ARRAY_SIZE(program_count_array); i++)
+	{ // clang-format on
+		snprintf(name, sizeof(name), "integration/%d", program_count_array[i]);
+		case_count = add_case(case_array, case_count, config, name, "program", program_count_array[i], run_integration_case, program_count_array[i], 0);
+	}
+
+	return case_count;
+}
+
+/**
+ * @brief Double the iterations until the timed part ran BENCHMARK_MIN_TIME_NS, stdout is muted meanwhile
+ */
+static void run_case(const BenchmarkCase *benchmark_case, BenchmarkResult *result)
+{
+	BenchmarkTimer timer      = {0};
+	long long      iterations = 1;
+
+	while (1)
+	{
+		memset(&timer, 0, sizeof(timer));
+		benchmark_case->function(&timer, iterations, benchmark_case->parameter, benchmark_case->mix);
+		if (timer.elapsed_ns >= BENCHMARK_MIN_TIME_NS)
+			break;
+
+		// jump close to the target once the time is measurable, the last round overshoots a little
+		if (timer.elapsed_ns > BENCHMARK_MIN_TIME_NS / 100)
+			iterations = MAX(iterations + 1, (long long)(iterations * 1.2 * BENCHMARK_MIN_TIME_NS / timer.elapsed_ns));
+		else
+			iterations *= 10;
+	}
+
+	memcpy(result->name, benchmark_case->name, sizeof(result->name));
+	result->iterations         = iterations;
+	result->ns_per_op          = (double)timer.elapsed_ns / iterations;
+	result->item_name          = benchmark_case->item_name;
+	result->items_per_second   = benchmark_case->items_per_op * 1e9 / result->ns_per_op;
+	result->allocations_per_op = BENCHMARK_COUNT_ALLOCATIONS ? (double)timer.allocation_count / iterations : -1;
+}
+
+static int write_benchmark_json(const char *file_name, const BenchmarkResult *result_array, int result_count)
+{
+	FILE *output_fp = NULL;
+	int   i         = 0;
+
+	if ((output_fp = fopen(file_name, "w")) == NULL)
+		return BENCHMARK_OPEN_ERROR;
+
+	fprintf(output_fp, "{\n  \"min_time_ns\": %lld,\n  \"allocations_counted\": %s,\n  \"benchmarks\": [\n", BENCHMARK_MIN_TIME_NS, BENCHMARK_COUNT_ALLOCATIONS ? "true" : "false");
+	// clang-format off
+	for (i=0; i<result_count; i++)
+	{ // clang-format on
+		fprintf(output_fp, "    {\"name\": \"%s\", \"iterations\": %lld, \"ns_per_op\": %.3f, \"items_per_second\": %.1f, \"item\": \"%s\"",
+		        result_array[i].name, result_array[i].iterations, result_array[i].ns_per_op, result_array[i].items_per_second, result_array[i].item_name);
+		if (result_array[i].allocations_per_op >= 0)
+			fprintf(output_fp, ", \"allocations_per_op\": %.3f", result_array[i].allocations_per_op);
+		fprintf(output_fp, "}%s\n", (i + 1 < result_count) ? "," : "");
+	}
+	fprintf(output_fp, "  ]\n}\n");
+
+	if (fclose(output_fp) != 0)
+		return BENCHMARK_WRITE_ERROR;
+	return 0;
+}
+
+int run_benchmarks(const BenchmarkConfig *config)
+{
+	BenchmarkCase   case_array[BENCHMARK_MAX_RESULT_COUNT];
+	BenchmarkResult result_array[BENCHMARK_MAX_RESULT_COUNT];
+	int             case_count = 0;
+	int             stdout_fd  = -1;
+	int             null_fd    = -1;
+	int             error_code = 0;
+	int             i          = 0;
+
+	if (config == NULL)
+	{
+		LOG("Invalid parameters, error code : %d\n", BENCHMARK_PARAM_ERROR);
+		return BENCHMARK_PARAM_ERROR;
+	}
+
+	memset(case_array, 0, sizeof(case_array));
+	memset(result_array, 0, sizeof(result_array));
+	case_count = collect_cases(case_array, config);
+
+	DOUBLE_LINE
+	LOG("%-24s %14s %14s %20s %12s\n", "benchmark", "iterations", "ns/op", "items/s", "allocs/op");
+	SINGLE_LINE
+	fflush(stdout);
+
+	// clang-format off
+	for (i=0; i<case_count; i++)
+	{ // clang-format on
+		// the table callbacks log what they acquire, keep that out of the report
+		stdout_fd = dup(STDOUT_FILENO);
+		null_fd   = open("/dev/null", O_WRONLY);
+		if ((stdout_fd >= 0) && (null_fd >= 0))
+			dup2(null_fd, STDOUT_FILENO);
+
+		random_state = 1;
+		run_case(&case_array[i], &result_array[i]);
+
+		fflush(stdout);
+		if (stdout_fd >= 0)
+		{
+			dup2(stdout_fd, STDOUT_FILENO);
+			close(stdout_fd);
+		}
+		if (null_fd >= 0)
+			close(null_fd);
+
+		LOG("%-24s %14lld %14.1f %14.0f %-6s", result_array[i].name, result_array[i].iterations, result_array[i].ns_per_op, result_array[i].items_per_second, result_array[i].item_name);
+		if (result_array[i].allocations_per_op >= 0)
+			LOG("%12.2f\n", result_array[i].allocations_per_op);
+		else
+			LOG("%12s\n", "-");
+		fflush(stdout);
+	}
+	DOUBLE_LINE
+
+	if (config->output_file_name != NULL)
+	{
+		if ((error_code = write_benchmark_json(config->output_file_name, result_array, case_count)) < 0)
+		{
+			LOG("write %s fail, error code : %d\n", config->output_file_name, error_code);
+			return error_code;
+		}
+		LOG("results written to %s\n", config->output_file_name);
+	}
+
+	return case_count;
+}
@@ -0,0 +1,52 @@
+/**
+ * @file benchmark.h
+ *
+ * @brief Reproducible microbenchmarks of the demux hot paths: CRC, packet dispatch, packet size detection,
+ *        EIT insertion and program integration. Inputs are built in memory from fixed patterns, every case
+ *        runs until BENCHMARK_MIN_TIME_NS has passed and reports ns/op, items/s and heap allocations per op.
+ *
+ * @author :Yujin Yu
+ * @date   :2025.05.21
+ */
+#ifndef BENCHMARK_H
+#define BENCHMARK_H
+
+//--------------------------------------------------------------------------------------------
+// macro definition
+//--------------------------------------------------------------------------------------------
+#define BENCHMARK_MIN_TIME_NS       200000000LL // each case is repeated until it ran this long
+#define BENCHMARK_MAX_RESULT_COUNT  64
+#define BENCHMARK_NAME_LENGTH       48
+#define BENCHMARK_DISPATCH_PACKETS  4096   // packets fed per iteration of a dispatch case
+#define BENCHMARK_DEFAULT_MAX_EVENT 10000  // EIT insertion sizes above this are skipped unless asked for
+#define BENCHMARK_SERVICE_COUNT     100    // services the EIT insertion events are spread over
+
+typedef struct
+{
+	const char *name_filter;      // NULL: every case, otherwise cases whose name contains it
+	const char *output_file_name; // NULL: table only, otherwise JSON is written there as well
+	int         max_event_count;  // largest EIT insertion case, 0: BENCHMARK_DEFAULT_MAX_EVENT
+} BenchmarkConfig;
+
+typedef struct
+{
+	char        name[BENCHMARK_NAME_LENGTH];
+	long long   iterations;
+	double      ns_per_op;
+	double      items_per_second;
+	const char *item_name;          // what items_per_second counts: "byte", "packet", "event" ...
+	double      allocations_per_op; // <0: not counted in this build
+} BenchmarkResult;
+
+//--------------------------------------------------------------------------------------------
+// Function declaration
+//--------------------------------------------------------------------------------------------
+/**
+ * @brief Run the selected cases, print a table and write the JSON report
+ *
+ * @return >=0: number of cases run
+ *         <0 : error code
+ */
+int run_benchmarks(const BenchmarkConfig *config);
+
+#endif
@@ -0,0 +1,687 @@
+/**
+ * @file dvb_charset.c
+ *
+ * @author :Yujin Yu
+ * @date   :2025.05.14
+ */
+#include <stdio.h>
+#include <string.h>
+#include "ts_global.h"
+#include "string_pool.h"
+#include "dvb_charset.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define ASCII_RUN_SIMD 1
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define ASCII_RUN_SIMD 1
+#endif
+
+#define DVB_CR_LF             0x8A   // control code 0x8A, E08A in UCS-2
+#define DVB_CONTROL_FIRST     0x80   // 0x80-0x9F are control codes in the single byte tables
+#define DVB_CONTROL_LAST      0x9F
+#define UCS2_CONTROL_BASE     0xE000 // 0xE080-0xE09F are the control codes in UCS-2
+#define REPLACEMENT_CHARACTER 0xFFFD
+
+typedef enum
+{
+	DVB_TABLE_ISO6937 = 0, // default, no selector
+	DVB_TABLE_ISO8859,
+	DVB_TABLE_UCS2,
+	DVB_TABLE_UTF8,
+	DVB_TABLE_UNSUPPORTED // KS X 1001, GB-2312 and encoding_type_id, bytes are kept as they are
+} DvbCharacterTable;
+
+//--------------------------------------------------------------------------------------------
+// Character tables, 0xA0-0xFF
+//--------------------------------------------------------------------------------------------
+// ISO 6937 as in figure A.1, 0xC1-0xCF are non spacing diacritical marks placed before the letter
+static const unsigned short iso6937_table[96] = {
+	0x00A0, 0x00A1, 0x00A2, 0x00A3, 0x20AC, 0x00A5, 0x0000, 0x00A7, 0x00A4, 0x2018, 0x201C, 0x00AB,
+	0x2190, 0x2191, 0x2192, 0x2193, 0x00B0, 0x00B1, 0x00B2, 0x00B3, 0x00D7, 0x00B5, 0x00B6, 0x00B7,
+	0x00F7, 0x2019, 0x201D, 0x00BB, 0x00BC, 0x00BD, 0x00BE, 0x00BF, 0x0000, 0x0300, 0x0301, 0x0302,
+	0x0303, 0x0304, 0x0306, 0x0307, 0x0308, 0x0308, 0x030A, 0x0327, 0x0332, 0x030B, 0x0328, 0x030C,
+	0x2015, 0x00B9, 0x00AE, 0x00A9, 0x2122, 0x266A, 0x00AC, 0x00A6, 0x0000, 0x0000, 0x0000, 0x0000,
+	0x215B, 0x215C, 0x215D, 0x215E, 0x2126, 0x00C6, 0x0110, 0x00AA, 0x0126, 0x0000, 0x0132, 0x013F,
+	0x0141, 0x00D8, 0x0152, 0x00BA, 0x00DE, 0x0166, 0x014A, 0x0149, 0x0138, 0x00E6, 0x0111, 0x00F0,
+	0x0127, 0x0131, 0x0133, 0x0140, 0x0142, 0x00F8, 0x0153, 0x00DF, 0x00FE, 0x0167, 0x014B, 0x00AD,
+};
+
+#define ISO6937_DIACRITIC_FIRST 0xC1
+#define ISO6937_DIACRITIC_LAST  0xCF
+#define ISO6937_BASE_FIRST      0x41 // 'A'
+#define ISO6937_BASE_LAST       0x7A // 'z'
+
+// Precomposed letter for diacritic 0xC1-0xCF and base letter 'A'-'z', 0: keep the combining mark
+static const unsigned short iso6937_compose[15][58] = {
+	{ // 0xC1 U+0300
+		0x00C0, 0x0000, 0x0000, 0x0000, 0x00C8, 0x0000, 0x0000, 0x0000, 0x00CC, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x01F8, 0x00D2, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x00D9, 0x0000, 0x1E80, 0x0000,
+		0x1EF2, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x00E0, 0x0000, 0x0000, 0x0000,
+		0x00E8, 0x0000, 0x0000, 0x0000, 0x00EC, 0x0000, 0x0000, 0x0000, 0x0000, 0x01F9, 0x00F2, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x00F9, 0x0000, 0x1E81, 0x0000, 0x1EF3, 0x0000,
+	},
+	{ // 0xC2 U+0301
+		0x00C1, 0x0000, 0x0106, 0x0000, 0x00C9, 0x0000, 0x01F4, 0x0000, 0x00CD, 0x0000, 0x1E30, 0x0139,
+		0x1E3E, 0x0143, 0x00D3, 0x1E54, 0x0000, 0x0154, 0x015A, 0x0000, 0x00DA, 0x0000, 0x1E82, 0x0000,
+		0x00DD, 0x0179, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x00E1, 0x0000, 0x0107, 0x0000,
+		0x00E9, 0x0000, 0x01F5, 0x0000, 0x00ED, 0x0000, 0x1E31, 0x013A, 0x1E3F, 0x0144, 0x00F3, 0x1E55,
+		0x0000, 0x0155, 0x015B, 0x0000, 0x00FA, 0x0000, 0x1E83, 0x0000, 0x00FD, 0x017A,
+	},
+	{ // 0xC3 U+0302
+		0x00C2, 0x0000, 0x0108, 0x0000, 0x00CA, 0x0000, 0x011C, 0x0124, 0x00CE, 0x0134, 0x0000, 0x0000,
+		0x0000, 0x0000, 0x00D4, 0x0000, 0x0000, 0x0000, 0x015C, 0x0000, 0x00DB, 0x0000, 0x0174, 0x0000,
+		0x0176, 0x1E90, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x00E2, 0x0000, 0x0109, 0x0000,
+		0x00EA, 0x0000, 0x011D, 0x0125, 0x00EE, 0x0135, 0x0000, 0x0000, 0x0000, 0x0000, 0x00F4, 0x0000,
+		0x0000, 0x0000, 0x015D, 0x0000, 0x00FB, 0x0000, 0x0175, 0x0000, 0x0177, 0x1E91,
+	},
+	{ // 0xC4 U+0303
+		0x00C3, 0x0000, 0x0000, 0x0000, 0x1EBC, 0x0000, 0x0000, 0x0000, 0x0128, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x00D1, 0x00D5, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0168, 0x1E7C, 0x0000, 0x0000,
+		0x1EF8, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x00E3, 0x0000, 0x0000, 0x0000,
+		0x1EBD, 0x0000, 0x0000, 0x0000, 0x0129, 0x0000, 0x0000, 0x0000, 0x0000, 0x00F1, 0x00F5, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0169, 0x1E7D, 0x0000, 0x0000, 0x1EF9, 0x0000,
+	},
+	{ // 0xC5 U+0304
+		0x0100, 0x0000, 0x0000, 0x0000, 0x0112, 0x0000, 0x1E20, 0x0000, 0x012A, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x0000, 0x014C, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x016A, 0x0000, 0x0000, 0x0000,
+		0x0232, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0101, 0x0000, 0x0000, 0x0000,
+		0x0113, 0x0000, 0x1E21, 0x0000, 0x012B, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x014D, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x016B, 0x0000, 0x0000, 0x0000, 0x0233, 0x0000,
+	},
+	{ // 0xC6 U+0306
+		0x0102, 0x0000, 0x0000, 0x0000, 0x0114, 0x0000, 0x011E, 0x0000, 0x012C, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x0000, 0x014E, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x016C, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0103, 0x0000, 0x0000, 0x0000,
+		0x0115, 0x0000, 0x011F, 0x0000, 0x012D, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x014F, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x016D, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+	},
+	{ // 0xC7 U+0307
+		0x0226, 0x1E02, 0x010A, 0x1E0A, 0x0116, 0x1E1E, 0x0120, 0x1E22, 0x0130, 0x0000, 0x0000, 0x0000,
+		0x1E40, 0x1E44, 0x022E, 0x1E56, 0x0000, 0x1E58, 0x1E60, 0x1E6A, 0x0000, 0x0000, 0x1E86, 0x1E8A,
+		0x1E8E, 0x017B, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0227, 0x1E03, 0x010B, 0x1E0B,
+		0x0117, 0x1E1F, 0x0121, 0x1E23, 0x0000, 0x0000, 0x0000, 0x0000, 0x1E41, 0x1E45, 0x022F, 0x1E57,
+		0x0000, 0x1E59, 0x1E61, 0x1E6B, 0x0000, 0x0000, 0x1E87, 0x1E8B, 0x1E8F, 0x017C,
+	},
+	{ // 0xC8 U+0308
+		0x00C4, 0x0000, 0x0000, 0x0000, 0x00CB, 0x0000, 0x0000, 0x1E26, 0x00CF, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x0000, 0x00D6, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x00DC, 0x0000, 0x1E84, 0x1E8C,
+		0x0178, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x00E4, 0x0000, 0x0000, 0x0000,
+		0x00EB, 0x0000, 0x0000, 0x1E27, 0x00EF, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x00F6, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x1E97, 0x00FC, 0x0000, 0x1E85, 0x1E8D, 0x00FF, 0x0000,
+	},
+	{ // 0xC9 U+0308
+		0x00C4, 0x0000, 0x0000, 0x0000, 0x00CB, 0x0000, 0x0000, 0x1E26, 0x00CF, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x0000, 0x00D6, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x00DC, 0x0000, 0x1E84, 0x1E8C,
+		0x0178, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x00E4, 0x0000, 0x0000, 0x0000,
+		0x00EB, 0x0000, 0x0000, 0x1E27, 0x00EF, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x00F6, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x1E97, 0x00FC, 0x0000, 0x1E85, 0x1E8D, 0x00FF, 0x0000,
+	},
+	{ // 0xCA U+030A
+		0x00C5, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x016E, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x00E5, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x016F, 0x0000, 0x1E98, 0x0000, 0x1E99, 0x0000,
+	},
+	{ // 0xCB U+0327
+		0x0000, 0x0000, 0x00C7, 0x1E10, 0x0228, 0x0000, 0x0122, 0x1E28, 0x0000, 0x0000, 0x0136, 0x013B,
+		0x0000, 0x0145, 0x0000, 0x0000, 0x0000, 0x0156, 0x015E, 0x0162, 0x0000, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x00E7, 0x1E11,
+		0x0229, 0x0000, 0x0123, 0x1E29, 0x0000, 0x0000, 0x0137, 0x013C, 0x0000, 0x0146, 0x0000, 0x0000,
+		0x0000, 0x0157, 0x015F, 0x0163, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+	},
+	{ // 0xCC U+0332
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+	},
+	{ // 0xCD U+030B
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x0000, 0x0150, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0170, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0151, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0171, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+	},
+	{ // 0xCE U+0328
+		0x0104, 0x0000, 0x0000, 0x0000, 0x0118, 0x0000, 0x0000, 0x0000, 0x012E, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x0000, 0x01EA, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0172, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0105, 0x0000, 0x0000, 0x0000,
+		0x0119, 0x0000, 0x0000, 0x0000, 0x012F, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x01EB, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0173, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+	},
+	{ // 0xCF U+030C
+		0x01CD, 0x0000, 0x010C, 0x010E, 0x011A, 0x0000, 0x01E6, 0x021E, 0x01CF, 0x0000, 0x01E8, 0x013D,
+		0x0000, 0x0147, 0x01D1, 0x0000, 0x0000, 0x0158, 0x0160, 0x0164, 0x01D3, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x017D, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x01CE, 0x0000, 0x010D, 0x010F,
+		0x011B, 0x0000, 0x01E7, 0x021F, 0x01D0, 0x01F0, 0x01E9, 0x013E, 0x0000, 0x0148, 0x01D2, 0x0000,
+		0x0000, 0x0159, 0x0161, 0x0165, 0x01D4, 0x0000, 0x0000, 0x0000, 0x0000, 0x017E,
+	},
+};
+
+static const unsigned short iso8859_table[16][96] = {
+	{0}, // unused
+	{ // ISO 8859-1
+		0x00A0, 0x00A1, 0x00A2, 0x00A3, 0x00A4, 0x00A5, 0x00A6, 0x00A7, 0x00A8, 0x00A9, 0x00AA, 0x00AB,
+		0x00AC, 0x00AD, 0x00AE, 0x00AF, 0x00B0, 0x00B1, 0x00B2, 0x00B3, 0x00B4, 0x00B5, 0x00B6, 0x00B7,
+		0x00B8, 0x00B9, 0x00BA, 0x00BB, 0x00BC, 0x00BD, 0x00BE, 0x00BF, 0x00C0, 0x00C1, 0x00C2, 0x00C3,
+		0x00C4, 0x00C5, 0x00C6, 0x00C7, 0x00C8, 0x00C9, 0x00CA, 0x00CB, 0x00CC, 0x00CD, 0x00CE, 0x00CF,
+		0x00D0, 0x00D1, 0x00D2, 0x00D3, 0x00D4, 0x00D5, 0x00D6, 0x00D7, 0x00D8, 0x00D9, 0x00DA, 0x00DB,
+		0x00DC, 0x00DD, 0x00DE, 0x00DF, 0x00E0, 0x00E1, 0x00E2, 0x00E3, 0x00E4, 0x00E5, 0x00E6, 0x00E7,
+		0x00E8, 0x00E9, 0x00EA, 0x00EB, 0x00EC, 0x00ED, 0x00EE, 0x00EF, 0x00F0, 0x00F1, 0x00F2, 0x00F3,
+		0x00F4, 0x00F5, 0x00F6, 0x00F7, 0x00F8, 0x00F9, 0x00FA, 0x00FB, 0x00FC, 0x00FD, 0x00FE, 0x00FF,
+	},
+	{ // ISO 8859-2
+		0x00A0, 0x0104, 0x02D8, 0x0141, 0x00A4, 0x013D, 0x015A, 0x00A7, 0x00A8, 0x0160, 0x015E, 0x0164,
+		0x0179, 0x00AD, 0x017D, 0x017B, 0x00B0, 0x0105, 0x02DB, 0x0142, 0x00B4, 0x013E, 0x015B, 0x02C7,
+		0x00B8, 0x0161, 0x015F, 0x0165, 0x017A, 0x02DD, 0x017E, 0x017C, 0x0154, 0x00C1, 0x00C2, 0x0102,
+		0x00C4, 0x0139, 0x0106, 0x00C7, 0x010C, 0x00C9, 0x0118, 0x00CB, 0x011A, 0x00CD, 0x00CE, 0x010E,
+		0x0110, 0x0143, 0x0147, 0x00D3, 0x00D4, 0x0150, 0x00D6, 0x00D7, 0x0158, 0x016E, 0x00DA, 0x0170,
+		0x00DC, 0x00DD, 0x0162, 0x00DF, 0x0155, 0x00E1, 0x00E2, 0x0103, 0x00E4, 0x013A, 0x0107, 0x00E7,
+		0x010D, 0x00E9, 0x0119, 0x00EB, 0x011B, 0x00ED, 0x00EE, 0x010F, 0x0111, 0x0144, 0x0148, 0x00F3,
+		0x00F4, 0x0151, 0x00F6, 0x00F7, 0x0159, 0x016F, 0x00FA, 0x0171, 0x00FC, 0x00FD, 0x0163, 0x02D9,
+	},
+	{ // ISO 8859-3
+		0x00A0, 0x0126, 0x02D8, 0x00A3, 0x00A4, 0x0000, 0x0124, 0x00A7, 0x00A8, 0x0130, 0x015E, 0x011E,
+		0x0134, 0x00AD, 0x0000, 0x017B, 0x00B0, 0x0127, 0x00B2, 0x00B3, 0x00B4, 0x00B5, 0x0125, 0x00B7,
+		0x00B8, 0x0131, 0x015F, 0x011F, 0x0135, 0x00BD, 0x0000, 0x017C, 0x00C0, 0x00C1, 0x00C2, 0x0000,
+		0x00C4, 0x010A, 0x0108, 0x00C7, 0x00C8, 0x00C9, 0x00CA, 0x00CB, 0x00CC, 0x00CD, 0x00CE, 0x00CF,
+		0x0000, 0x00D1, 0x00D2, 0x00D3, 0x00D4, 0x0120, 0x00D6, 0x00D7, 0x011C, 0x00D9, 0x00DA, 0x00DB,
+		0x00DC, 0x016C, 0x015C, 0x00DF, 0x00E0, 0x00E1, 0x00E2, 0x0000, 0x00E4, 0x010B, 0x0109, 0x00E7,
+		0x00E8, 0x00E9, 0x00EA, 0x00EB, 0x00EC, 0x00ED, 0x00EE, 0x00EF, 0x0000, 0x00F1, 0x00F2, 0x00F3,
+		0x00F4, 0x0121, 0x00F6, 0x00F7, 0x011D, 0x00F9, 0x00FA, 0x00FB, 0x00FC, 0x016D, 0x015D, 0x02D9,
+	},
+	{ // ISO 8859-4
+		0x00A0, 0x0104, 0x0138, 0x0156, 0x00A4, 0x0128, 0x013B, 0x00A7, 0x00A8, 0x0160, 0x0112, 0x0122,
+		0x0166, 0x00AD, 0x017D, 0x00AF, 0x00B0, 0x0105, 0x02DB, 0x0157, 0x00B4, 0x0129, 0x013C, 0x02C7,
+		0x00B8, 0x0161, 0x0113, 0x0123, 0x0167, 0x014A, 0x017E, 0x014B, 0x0100, 0x00C1, 0x00C2, 0x00C3,
+		0x00C4, 0x00C5, 0x00C6, 0x012E, 0x010C, 0x00C9, 0x0118, 0x00CB, 0x0116, 0x00CD, 0x00CE, 0x012A,
+		0x0110, 0x0145, 0x014C, 0x0136, 0x00D4, 0x00D5, 0x00D6, 0x00D7, 0x00D8, 0x0172, 0x00DA, 0x00DB,
+		0x00DC, 0x0168, 0x016A, 0x00DF, 0x0101, 0x00E1, 0x00E2, 0x00E3, 0x00E4, 0x00E5, 0x00E6, 0x012F,
+		0x010D, 0x00E9, 0x0119, 0x00EB, 0x0117, 0x00ED, 0x00EE, 0x012B, 0x0111, 0x0146, 0x014D, 0x0137,
+		0x00F4, 0x00F5, 0x00F6, 0x00F7, 0x00F8, 0x0173, 0x00FA, 0x00FB, 0x00FC, 0x0169, 0x016B, 0x02D9,
+	},
+	{ // ISO 8859-5
+		0x00A0, 0x0401, 0x0402, 0x0403, 0x0404, 0x0405, 0x0406, 0x0407, 0x0408, 0x0409, 0x040A, 0x040B,
+		0x040C, 0x00AD, 0x040E, 0x040F, 0x0410, 0x0411, 0x0412, 0x0413, 0x0414, 0x0415, 0x0416, 0x0417,
+		0x0418, 0x0419, 0x041A, 0x041B, 0x041C, 0x041D, 0x041E, 0x041F, 0x0420, 0x0421, 0x0422, 0x0423,
+		0x0424, 0x0425, 0x0426, 0x0427, 0x0428, 0x0429, 0x042A, 0x042B, 0x042C, 0x042D, 0x042E, 0x042F,
+		0x0430, 0x0431, 0x0432, 0x0433, 0x0434, 0x0435, 0x0436, 0x0437, 0x0438, 0x0439, 0x043A, 0x043B,
+		0x043C, 0x043D, 0x043E, 0x043F, 0x0440, 0x0441, 0x0442, 0x0443, 0x0444, 0x0445, 0x0446, 0x0447,
+		0x0448, 0x0449, 0x044A, 0x044B, 0x044C, 0x044D, 0x044E, 0x044F, 0x2116, 0x0451, 0x0452, 0x0453,
+		0x0454, 0x0455, 0x0456, 0x0457, 0x0458, 0x0459, 0x045A, 0x045B, 0x045C, 0x00A7, 0x045E, 0x045F,
+	},
+	{ // ISO 8859-6
+		0x00A0, 0x0000, 0x0000, 0x0000, 0x00A4, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+		0x060C, 0x00AD, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x061B, 0x0000, 0x0000, 0x0000, 0x061F, 0x0000, 0x0621, 0x0622, 0x0623,
+		0x0624, 0x0625, 0x0626, 0x0627, 0x0628, 0x0629, 0x062A, 0x062B, 0x062C, 0x062D, 0x062E, 0x062F,
+		0x0630, 0x0631, 0x0632, 0x0633, 0x0634, 0x0635, 0x0636, 0x0637, 0x0638, 0x0639, 0x063A, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0640, 0x0641, 0x0642, 0x0643, 0x0644, 0x0645, 0x0646, 0x0647,
+		0x0648, 0x0649, 0x064A, 0x064B, 0x064C, 0x064D, 0x064E, 0x064F, 0x0650, 0x0651, 0x0652, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+	},
+	{ // ISO 8859-7
+		0x00A0, 0x2018, 0x2019, 0x00A3, 0x20AC, 0x20AF, 0x00A6, 0x00A7, 0x00A8, 0x00A9, 0x037A, 0x00AB,
+		0x00AC, 0x00AD, 0x0000, 0x2015, 0x00B0, 0x00B1, 0x00B2, 0x00B3, 0x0384, 0x0385, 0x0386, 0x00B7,
+		0x0388, 0x0389, 0x038A, 0x00BB, 0x038C, 0x00BD, 0x038E, 0x038F, 0x0390, 0x0391, 0x0392, 0x0393,
+		0x0394, 0x0395, 0x0396, 0x0397, 0x0398, 0x0399, 0x039A, 0x039B, 0x039C, 0x039D, 0x039E, 0x039F,
+		0x03A0, 0x03A1, 0x0000, 0x03A3, 0x03A4, 0x03A5, 0x03A6, 0x03A7, 0x03A8, 0x03A9, 0x03AA, 0x03AB,
+		0x03AC, 0x03AD, 0x03AE, 0x03AF, 0x03B0, 0x03B1, 0x03B2, 0x03B3, 0x03B4, 0x03B5, 0x03B6, 0x03B7,
+		0x03B8, 0x03B9, 0x03BA, 0x03BB, 0x03BC, 0x03BD, 0x03BE, 0x03BF, 0x03C0, 0x03C1, 0x03C2, 0x03C3,
+		0x03C4, 0x03C5, 0x03C6, 0x03C7, 0x03C8, 0x03C9, 0x03CA, 0x03CB, 0x03CC, 0x03CD, 0x03CE, 0x0000,
+	},
+	{ // ISO 8859-8
+		0x00A0, 0x0000, 0x00A2, 0x00A3, 0x00A4, 0x00A5, 0x00A6, 0x00A7, 0x00A8, 0x00A9, 0x00D7, 0x00AB,
+		0x00AC, 0x00AD, 0x00AE, 0x00AF, 0x00B0, 0x00B1, 0x00B2, 0x00B3, 0x00B4, 0x00B5, 0x00B6, 0x00B7,
+		0x00B8, 0x00B9, 0x00F7, 0x00BB, 0x00BC, 0x00BD, 0x00BE, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x2017, 0x05D0, 0x05D1, 0x05D2, 0x05D3, 0x05D4, 0x05D5, 0x05D6, 0x05D7,
+		0x05D8, 0x05D9, 0x05DA, 0x05DB, 0x05DC, 0x05DD, 0x05DE, 0x05DF, 0x05E0, 0x05E1, 0x05E2, 0x05E3,
+		0x05E4, 0x05E5, 0x05E6, 0x05E7, 0x05E8, 0x05E9, 0x05EA, 0x0000, 0x0000, 0x200E, 0x200F, 0x0000,
+	},
+	{ // ISO 8859-9
+		0x00A0, 0x00A1, 0x00A2, 0x00A3, 0x00A4, 0x00A5, 0x00A6, 0x00A7, 0x00A8, 0x00A9, 0x00AA, 0x00AB,
+		0x00AC, 0x00AD, 0x00AE, 0x00AF, 0x00B0, 0x00B1, 0x00B2, 0x00B3, 0x00B4, 0x00B5, 0x00B6, 0x00B7,
+		0x00B8, 0x00B9, 0x00BA, 0x00BB, 0x00BC, 0x00BD, 0x00BE, 0x00BF, 0x00C0, 0x00C1, 0x00C2, 0x00C3,
+		0x00C4, 0x00C5, 0x00C6, 0x00C7, 0x00C8, 0x00C9, 0x00CA, 0x00CB, 0x00CC, 0x00CD, 0x00CE, 0x00CF,
+		0x011E, 0x00D1, 0x00D2, 0x00D3, 0x00D4, 0x00D5, 0x00D6, 0x00D7, 0x00D8, 0x00D9, 0x00DA, 0x00DB,
+		0x00DC, 0x0130, 0x015E, 0x00DF, 0x00E0, 0x00E1, 0x00E2, 0x00E3, 0x00E4, 0x00E5, 0x00E6, 0x00E7,
+		0x00E8, 0x00E9, 0x00EA, 0x00EB, 0x00EC, 0x00ED, 0x00EE, 0x00EF, 0x011F, 0x00F1, 0x00F2, 0x00F3,
+		0x00F4, 0x00F5, 0x00F6, 0x00F7, 0x00F8, 0x00F9, 0x00FA, 0x00FB, 0x00FC, 0x0131, 0x015F, 0x00FF,
+	},
+	{ // ISO 8859-10
+		0x00A0, 0x0104, 0x0112, 0x0122, 0x012A, 0x0128, 0x0136, 0x00A7, 0x013B, 0x0110, 0x0160, 0x0166,
+		0x017D, 0x00AD, 0x016A, 0x014A, 0x00B0, 0x0105, 0x0113, 0x0123, 0x012B, 0x0129, 0x0137, 0x00B7,
+		0x013C, 0x0111, 0x0161, 0x0167, 0x017E, 0x2015, 0x016B, 0x014B, 0x0100, 0x00C1, 0x00C2, 0x00C3,
+		0x00C4, 0x00C5, 0x00C6, 0x012E, 0x010C, 0x00C9, 0x0118, 0x00CB, 0x0116, 0x00CD, 0x00CE, 0x00CF,
+		0x00D0, 0x0145, 0x014C, 0x00D3, 0x00D4, 0x00D5, 0x00D6, 0x0168, 0x00D8, 0x0172, 0x00DA, 0x00DB,
+		0x00DC, 0x00DD, 0x00DE, 0x00DF, 0x0101, 0x00E1, 0x00E2, 0x00E3, 0x00E4, 0x00E5, 0x00E6, 0x012F,
+		0x010D, 0x00E9, 0x0119, 0x00EB, 0x0117, 0x00ED, 0x00EE, 0x00EF, 0x00F0, 0x0146, 0x014D, 0x00F3,
+		0x00F4, 0x00F5, 0x00F6, 0x0169, 0x00F8, 0x0173, 0x00FA, 0x00FB, 0x00FC, 0x00FD, 0x00FE, 0x0138,
+	},
+	{ // ISO 8859-11
+		0x00A0, 0x0E01, 0x0E02, 0x0E03, 0x0E04, 0x0E05, 0x0E06, 0x0E07, 0x0E08, 0x0E09, 0x0E0A, 0x0E0B,
+		0x0E0C, 0x0E0D, 0x0E0E, 0x0E0F, 0x0E10, 0x0E11, 0x0E12, 0x0E13, 0x0E14, 0x0E15, 0x0E16, 0x0E17,
+		0x0E18, 0x0E19, 0x0E1A, 0x0E1B, 0x0E1C, 0x0E1D, 0x0E1E, 0x0E1F, 0x0E20, 0x0E21, 0x0E22, 0x0E23,
+		0x0E24, 0x0E25, 0x0E26, 0x0E27, 0x0E28, 0x0E29, 0x0E2A, 0x0E2B, 0x0E2C, 0x0E2D, 0x0E2E, 0x0E2F,
+		0x0E30, 0x0E31, 0x0E32, 0x0E33, 0x0E34, 0x0E35, 0x0E36, 0x0E37, 0x0E38, 0x0E39, 0x0E3A, 0x0000,
+		0x0000, 0x0000, 0x0000, 0x0E3F, 0x0E40, 0x0E41, 0x0E42, 0x0E43, 0x0E44, 0x0E45, 0x0E46, 0x0E47,
+		0x0E48, 0x0E49, 0x0E4A, 0x0E4B, 0x0E4C, 0x0E4D, 0x0E4E, 0x0E4F, 0x0E50, 0x0E51, 0x0E52, 0x0E53,
+		0x0E54, 0x0E55, 0x0E56, 0x0E57, 0x0E58, 0x0E59, 0x0E5A, 0x0E5B, 0x0000, 0x0000, 0x0000, 0x0000,
+	},
+	{0}, // ISO 8859-12 does not exist
+	{ // ISO 8859-13
+		0x00A0, 0x201D, 0x00A2, 0x00A3, 0x00A4, 0x201E, 0x00A6, 0x00A7, 0x00D8, 0x00A9, 0x0156, 0x00AB,
+		0x00AC, 0x00AD, 0x00AE, 0x00C6, 0x00B0, 0x00B1, 0x00B2, 0x00B3, 0x201C, 0x00B5, 0x00B6, 0x00B7,
+		0x00F8, 0x00B9, 0x0157, 0x00BB, 0x00BC, 0x00BD, 0x00BE, 0x00E6, 0x0104, 0x012E, 0x0100, 0x0106,
+		0x00C4, 0x00C5, 0x0118, 0x0112, 0x010C, 0x00C9, 0x0179, 0x0116, 0x0122, 0x0136, 0x012A, 0x013B,
+		0x0160, 0x0143, 0x0145, 0x00D3, 0x014C, 0x00D5, 0x00D6, 0x00D7, 0x0172, 0x0141, 0x015A, 0x016A,
+		0x00DC, 0x017B, 0x017D, 0x00DF, 0x0105, 0x012F, 0x0101, 0x0107, 0x00E4, 0x00E5, 0x0119, 0x0113,
+		0x010D, 0x00E9, 0x017A, 0x0117, 0x0123, 0x0137, 0x012B, 0x013C, 0x0161, 0x0144, 0x0146, 0x00F3,
+		0x014D, 0x00F5, 0x00F6, 0x00F7, 0x0173, 0x0142, 0x015B, 0x016B, 0x00FC, 0x017C, 0x017E, 0x2019,
+	},
+	{ // ISO 8859-14
+		0x00A0, 0x1E02, 0x1E03, 0x00A3, 0x010A, 0x010B, 0x1E0A, 0x00A7, 0x1E80, 0x00A9, 0x1E82, 0x1E0B,
+		0x1EF2, 0x00AD, 0x00AE, 0x0178, 0x1E1E, 0x1E1F, 0x0120, 0x0121, 0x1E40, 0x1E41, 0x00B6, 0x1E56,
+		0x1E81, 0x1E57, 0x1E83, 0x1E60, 0x1EF3, 0x1E84, 0x1E85, 0x1E61, 0x00C0, 0x00C1, 0x00C2, 0x00C3,
+		0x00C4, 0x00C5, 0x00C6, 0x00C7, 0x00C8, 0x00C9, 0x00CA, 0x00CB, 0x00CC, 0x00CD, 0x00CE, 0x00CF,
+		0x0174, 0x00D1, 0x00D2, 0x00D3, 0x00D4, 0x00D5, 0x00D6, 0x1E6A, 0x00D8, 0x00D9, 0x00DA, 0x00DB,
+		0x00DC, 0x00DD, 0x0176, 0x00DF, 0x00E0, 0x00E1, 0x00E2, 0x00E3, 0x00E4, 0x00E5, 0x00E6, 0x00E7,
+		0x00E8, 0x00E9, 0x00EA, 0x00EB, 0x00EC, 0x00ED, 0x00EE, 0x00EF, 0x0175, 0x00F1, 0x00F2, 0x00F3,
+		0x00F4, 0x00F5, 0x00F6, 0x1E6B, 0x00F8, 0x00F9, 0x00FA, 0x00FB, 0x00FC, 0x00FD, 0x0177, 0x00FF,
+	},
+	{ // ISO 8859-15
+		0x00A0, 0x00A1, 0x00A2, 0x00A3, 0x20AC, 0x00A5, 0x0160, 0x00A7, 0x0161, 0x00A9, 0x00AA, 0x00AB,
+		0x00AC, 0x00AD, 0x00AE, 0x00AF, 0x00B0, 0x00B1, 0x00B2, 0x00B3, 0x017D, 0x00B5, 0x00B6, 0x00B7,
+		0x017E, 0x00B9, 0x00BA, 0x00BB, 0x0152, 0x0153, 0x0178, 0x00BF, 0x00C0, 0x00C1, 0x00C2, 0x00C3,
+		0x00C4, 0x00C5, 0x00C6, 0x00C7, 0x00C8, 0x00C9, 0x00CA, 0x00CB, 0x00CC, 0x00CD, 0x00CE, 0x00CF,
+		0x00D0, 0x00D1, 0x00D2, 0x00D3, 0x00D4, 0x00D5, 0x00D6, 0x00D7, 0x00D8, 0x00D9, 0x00DA, 0x00DB,
+		0x00DC, 0x00DD, 0x00DE, 0x00DF, 0x00E0, 0x00E1, 0x00E2, 0x00E3, 0x00E4, 0x00E5, 0x00E6, 0x00E7,
+		0x00E8, 0x00E9, 0x00EA, 0x00EB, 0x00EC, 0x00ED, 0x00EE, 0x00EF, 0x00F0, 0x00F1, 0x00F2, 0x00F3,
+		0x00F4, 0x00F5, 0x00F6, 0x00F7, 0x00F8, 0x00F9, 0x00FA, 0x00FB, 0x00FC, 0x00FD, 0x00FE, 0x00FF,
+	},
+};
+
+//--------------------------------------------------------------------------------------------
+// Function
+//--------------------------------------------------------------------------------------------
+// Number of leading bytes in 0x20-0x7F, those are the same in every single byte table and in UTF-8
+static int get_ascii_run_length(const unsigned char *input, int length)
+{
+	int run_length = 0;
+
+#ifdef ASCII_RUN_SIMD
+	while (run_length + 16 <= length)
+	{
+#if defined(__SSE2__)
+		// signed compare, 0x80-0xFF are negative and fall below 0x20 together with the C0 codes
+		__m128i bytes = _mm_loadu_si128((const __m128i *)(input + run_length));
+		int     mask  = _mm_movemask_epi8(_mm_cmplt_epi8(bytes, _mm_set1_epi8(0x20)));
+
+		if (mask != 0)
+			return run_length + __builtin_ctz(mask);
+#elif defined(__ARM_NEON)
+		int8x16_t  bytes = vreinterpretq_s8_u8(vld1q_u8(input + run_length));
+		uint64x2_t mask  = vreinterpretq_u64_u8(vcltq_s8(bytes, vdupq_n_s8(0x20)));
+
+		if ((vgetq_lane_u64(mask, 0) | vgetq_lane_u64(mask, 1)) != 0)
+			break;
+#endif
+		run_length += 16;
+	}
+#endif
+
+	while ((run_length < length) && (input[run_length] >= 0x20) && (input[run_length] < 0x80))
+	{
+		run_length++;
+	}
+	return run_length;
+}
+
+// -1 when the character and the terminator do not fit
+static int put_utf8(char *output, int write_position, int output_size, unsigned int code_point)
+{
+	if (code_point < 0x80)
+	{
+		if (write_position + 1 >= output_size)
+			return -1;
+		output[write_position++] = code_point;
+	}
+	else if (code_point < 0x800)
+	{
+		if (write_position + 2 >= output_size)
+			return -1;
+		output[write_position++] = 0xC0 | (code_point >> 6);
+		output[write_position++] = 0x80 | (code_point & 0x3F);
+	}
+	else
+	{
+		if (write_position + 3 >= output_size)
+			return -1;
+		output[write_position++] = 0xE0 | (code_point >> 12);
+		output[write_position++] = 0x80 | ((code_point >> 6) & 0x3F);
+		output[write_position++] = 0x80 | (code_point & 0x3F);
+	}
+	return write_position;
+}
+
+// Control codes of EN 300 468 table A.1: CR/LF is kept, emphasis and reserved codes are dropped
+static int put_control_code(char *output, int write_position, int output_size, unsigned int control_code)
+{
+	if (control_code == DVB_CR_LF)
+		return put_utf8(output, write_position, output_size, '\n');
+	return write_position;
+}
+
+static DvbCharacterTable select_character_table(const unsigned char *input, int length, int *read_position, int *iso8859_part)
+{
+	*read_position = 0;
+	*iso8859_part  = 0;
+
+	if ((length == 0) || (input[0] >= 0x20))
+		return DVB_TABLE_ISO6937;
+
+	*read_position = 1;
+	if ((input[0] >= 0x01) && (input[0] <= 0x0B) && (input[0] != 0x08))
+	{
+		*iso8859_part = input[0] + 4; // 0x01: ISO 8859-5 ... 0x0B: ISO 8859-15
+		return DVB_TABLE_ISO8859;
+	}
+
+	switch (input[0])
+	{
+	case 0x10:
+		*read_position = MIN(3, length);
+		if ((length >= 3) && (input[1] == 0x00) && (input[2] >= 1) && (input[2] <= 15) && (input[2] != 12))
+		{
+			*iso8859_part = input[2];
+			return DVB_TABLE_ISO8859;
+		}
+		return DVB_TABLE_ISO6937;
+	case 0x11: // ISO/IEC 10646 basic multilingual plane
+	case 0x14: // Big5 subset of ISO/IEC 10646, same two byte coding
+		return DVB_TABLE_UCS2;
+	case 0x15:
+		return DVB_TABLE_UTF8;
+	case 0x12: // KS X 1001
+	case 0x13: // GB-2312
+		return DVB_TABLE_UNSUPPORTED;
+	case 0x1F:
+		*read_position = MIN(2, length); // encoding_type_id
+		return DVB_TABLE_UNSUPPORTED;
+	default:
+		return DVB_TABLE_ISO6937; // reserved selector
+	}
+}
+
+static int decode_single_byte_table(const unsigned char *input, int length, int read_position, const unsigned short *table,
+                                    char *output, int output_size)
+{
+	int          write_position = 0;
+	int          run_length     = 0;
+	int          next_position  = 0;
+	unsigned int byte           = 0;
+	unsigned int code_point     = 0;
+	unsigned int composed       = 0;
+
+	while ((read_position < length) && (write_position >= 0))
+	{
+		run_length = get_ascii_run_length(input + read_position, length - read_position);
+		if (run_length > 0)
+		{
+			run_length = MIN(run_length, output_size - 1 - write_position);
+			memcpy(output + write_position, input + read_position, run_length);
+			write_position += run_length;
+			read_position += run_length;
+			if (write_position >= output_size - 1)
+				break;
+			continue;
+		}
+
+		byte = input[read_position++];
+		if (byte < 0x20)
+		{
+			continue; // C0 codes are not defined inside the text
+		}
+		if (byte <= DVB_CONTROL_LAST)
+		{
+			next_position = put_control_code(output, write_position, output_size, byte);
+		}
+		else
+		{
+			code_point = table[byte - 0xA0];
+			if (code_point == 0)
+				continue;
+
+			if ((table == iso6937_table) && (byte >= ISO6937_DIACRITIC_FIRST) && (byte <= ISO6937_DIACRITIC_LAST) &&
+			    (read_position < length) && (input[read_position] >= 0x20) && (input[read_position] < 0x80))
+			{
+				// the mark comes before the letter, Unicode wants the precomposed letter or the letter first
+				composed = 0;
+				if ((input[read_position] >= ISO6937_BASE_FIRST) && (input[read_position] <= ISO6937_BASE_LAST))
+				{
+					composed = iso6937_compose[byte - ISO6937_DIACRITIC_FIRST][input[read_position] - ISO6937_BASE_FIRST];
+				}
+
+				if (composed != 0)
+				{
+					code_point = composed;
+				}
+				else
+				{
+					next_position = put_utf8(output, write_position, output_size, input[read_position]);
+					if (next_position < 0)
+						break;
+					write_position = next_position;
+				}
+				read_position++;
+			}
+			next_position = put_utf8(output, write_position, output_size, code_point);
+		}
+
+		if (next_position < 0)
+			break;
+		write_position = next_position;
+	}
+
+	output[write_position] = '\0';
+	return write_position;
+}
+
+static int decode_ucs2(const unsigned char *input, int length, int read_position, char *output, int output_size)
+{
+	int          write_position = 0;
+	int          next_position  = 0;
+	unsigned int code_point     = 0;
+
+	for (; read_position + 1 < length; read_position += 2)
+	{
+		code_point = (input[read_position] << 8) | input[read_position + 1];
+		if (code_point < 0x20)
+			continue;
+
+		if ((code_point >= UCS2_CONTROL_BASE + DVB_CONTROL_FIRST) && (code_point <= UCS2_CONTROL_BASE + DVB_CONTROL_LAST))
+		{
+			next_position = put_control_code(output, write_position, output_size, code_point - UCS2_CONTROL_BASE);
+		}
+		else
+		{
+			if ((code_point >= 0xD800) && (code_point <= 0xDFFF))
+				code_point = REPLACEMENT_CHARACTER; // no surrogate pairs in the BMP table
+			next_position = put_utf8(output, write_position, output_size, code_point);
+		}
+
+		if (next_position < 0)
+			break;
+		write_position = next_position;
+	}
+
+	output[write_position] = '\0';
+	return write_position;
+}
+
+// Validated copy, broken sequences become U+FFFD
+static int decode_utf8(const unsigned char *input, int length, int read_position, char *output, int output_size)
+{
+	int          write_position  = 0;
+	int          next_position   = 0;
+	int          run_length      = 0;
+	int          sequence_length = 0;
+	int          i               = 0;
+	unsigned int code_point      = 0;
+
+	while (read_position < length)
+	{
+		run_length = get_ascii_run_length(input + read_position, length - read_position);
+		if (run_length > 0)
+		{
+			run_length = MIN(run_length, output_size - 1 - write_position);
+			memcpy(output + write_position, input + read_position, run_length);
+			write_position += run_length;
+			read_position += run_length;
+			if (write_position >= output_size - 1)
+				break;
+			continue;
+		}
+
+		code_point = input[read_position];
+		if (code_point < 0x20)
+		{
+			read_position++;
+			continue;
+		}
+
+		sequence_length = (code_point >= 0xF0) ? 4 : (code_point >= 0xE0) ? 3 : (code_point >= 0xC2) ? 2 : 0;
+		if ((sequence_length == 0) || (read_position + sequence_length > length))
+		{
+			code_point      = REPLACEMENT_CHARACTER;
+			sequence_length = 1;
+		}
+		else
+		{
+			code_point &= 0x3F >> (sequence_length - 1);
+			// clang-format off
+			for (i=1; i<sequence_length; i++)
+			{ // clang-format on
+				if ((input[read_position + i] & 0xC0) != 0x80)
+					break;
+				code_point = (code_point << 6) | (input[read_position + i] & 0x3F);
+			}
+			if ((i < sequence_length) || (code_point > 0xFFFF) || ((sequence_length == 3) && (code_point < 0x800)) ||
+			    ((code_point >= 0xD800) && (code_point <= 0xDFFF)))
+			{
+				// outside the basic multilingual plane is kept as U+FFFD as well, put_utf8 writes 3 bytes at most
+				code_point      = REPLACEMENT_CHARACTER;
+				sequence_length = (i < sequence_length) ? i : sequence_length;
+			}
+		}
+		read_position += sequence_length;
+
+		if ((code_point >= DVB_CONTROL_FIRST) && (code_point <= DVB_CONTROL_LAST))
+			next_position = put_control_code(output, write_position, output_size, code_point);
+		else if ((code_point >= UCS2_CONTROL_BASE + DVB_CONTROL_FIRST) && (code_point <= UCS2_CONTROL_BASE + DVB_CONTROL_LAST))
+			next_position = put_control_code(output, write_position, output_size, code_point - UCS2_CONTROL_BASE);
+		else
+			next_position = put_utf8(output, write_position, output_size, code_point);
+
+		if (next_position < 0)
+			break;
+		write_position = next_position;
+	}
+
+	output[write_position] = '\0';
+	return write_position;
+}
+
+// Multi byte tables without a mapping keep their ASCII bytes, the others become U+FFFD so the output stays valid UTF-8
+static int copy_unsupported(const unsigned char *input, int length, int read_position, char *output, int output_size)
+{
+	int write_position = 0;
+	int next_position  = 0;
+
+	for (; read_position < length; read_position++)
+	{
+		if (input[read_position] < 0x20)
+			continue;
+
+		next_position = put_utf8(output, write_position, output_size, (input[read_position] < 0x80) ? input[read_position] : REPLACEMENT_CHARACTER);
+		if (next_position < 0)
+			break;
+		write_position = next_position;
+	}
+
+	output[write_position] = '\0';
+	return write_position;
+}
+
+int decode_dvb_string(const unsigned char *input, int length, char *output, int output_size)
+{
+	DvbCharacterTable character_table = DVB_TABLE_ISO6937;
+	int               read_position   = 0;
+	int               iso8859_part    = 0;
+
+	if ((output == NULL) || (output_size <= 0))
+		return 0;
+
+	output[0] = '\0';
+	if ((input == NULL) || (length <= 0))
+		return 0;
+
+	character_table = select_character_table(input, length, &read_position, &iso8859_part);
+	switch (character_table)
+	{
+	case DVB_TABLE_ISO8859:
+		return decode_single_byte_table(input, length, read_position, iso8859_table[iso8859_part], output, output_size);
+	case DVB_TABLE_UCS2:
+		return decode_ucs2(input, length, read_position, output, output_size);
+	case DVB_TABLE_UTF8:
+		return decode_utf8(input, length, read_position, output, output_size);
+	case DVB_TABLE_UNSUPPORTED:
+		return copy_unsupported(input, length, read_position, output, output_size);
+	default:
+		return decode_single_byte_table(input, length, read_position, iso6937_table, output, output_size);
+	}
+}
+
+int intern_dvb_string(StringPool *string_pool, const unsigned char *input, int length, StringHandle *handle)
+{
+	StringHandle raw_handle     = 0;
+	StringHandle decoded_handle = 0;
+	int          decoded_length = 0;
+	int          error_code     = 0;
+	char         decoded[DVB_DECODE_BUFFER_SIZE];
+
+	if ((error_code = intern_string(string_pool, (const char *)input, length, &raw_handle)) < 0)
+		return error_code;
+
+	*handle = 0;
+	if (raw_handle == 0)
+		return 0;
+
+	if (get_decoded_handle(string_pool, raw_handle, &decoded_handle) == 1)
+	{
+		*handle = decoded_handle;
+		return 0;
+	}
+
+	// plain ASCII without selector is already UTF-8, the raw string is its own decoded form
+	if (get_ascii_run_length(input, length) == length)
+	{
+		decoded_handle = raw_handle;
+	}
+	else
+	{
+		decoded_length = decode_dvb_string(input, MIN(length, DVB_MAX_TEXT_LENGTH), decoded, sizeof(decoded));
+		if ((error_code = intern_string(string_pool, decoded, decoded_length, &decoded_handle)) < 0)
+			return error_code;
+	}
+
+	set_decoded_handle(string_pool, raw_handle, decoded_handle);
+	*handle = decoded_handle;
+	return 0;
+}
@@ -0,0 +1,41 @@
+/**
+ * @file dvb_charset.h
+ *
+ * @brief Text of SI descriptors to UTF-8, character tables of EN 300 468 Annex A
+ *        (ISO 6937, ISO 8859-1..15, UCS-2 BE, UTF-8). Include string_pool.h first.
+ *
+ * @author :Yujin Yu
+ * @date   :2025.05.14
+ */
+#ifndef DVB_CHARSET_H
+#define DVB_CHARSET_H
+
+#define DVB_MAX_TEXT_LENGTH    255  // a text field of a descriptor has an 8 bit length
+#define DVB_DECODE_BUFFER_SIZE 1024 // every input byte becomes at most 3 bytes of UTF-8
+
+//--------------------------------------------------------------------------------------------
+// Function declaration
+//--------------------------------------------------------------------------------------------
+/**
+ * @brief Decode a DVB text field, the leading character table selector is consumed,
+ *        emphasis codes are dropped and the CR/LF code becomes '\n'
+ *
+ * @param input       Raw bytes of the text field
+ * @param length      Number of bytes
+ * @param output      UTF-8 output, always terminated
+ * @param output_size Size of output, the text is cut at a character boundary if it does not fit
+ *
+ * @return length of the UTF-8 text without the terminator
+ */
+int decode_dvb_string(const unsigned char *input, int length, char *output, int output_size);
+
+/**
+ * @brief Intern a raw DVB text field and return the handle of its UTF-8 form,
+ *        the decoded handle is cached per raw string so each distinct text is decoded once
+ *
+ * @return 0: successful
+ *         <0: error code
+ */
+int intern_dvb_string(StringPool *string_pool, const unsigned char *input, int length, StringHandle *handle);
+
+#endif
@@ -0,0 +1,495 @@
+/**
+ * @file epg_export.c
+ *
+ * @author :Yujin Yu
+ * @date   :2025.05.18
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ts_global.h"
+#include "slot_filter.h"
+#include "get_pat_info.h"
+#include "get_pmt_info.h"
+#include "section_store.h"
+#include "string_pool.h"
+#include "dvb_charset.h"
+#include "get_sdt_info.h"
+#include "get_eit_info.h"
+#include "integrate_data.h"
+#include "epg_export.h"
+
+#define MAX_EXTENDED_DESCRIPTOR_COUNT 16 // descriptor_number is 4 bits
+
+// configuration shared by every demux context, not table state
+static EpgExportConfig epg_export_config = {0};
+static int             export_count      = 0;
+
+typedef struct
+{
+	unsigned int language_code;
+	int          title_length;
+	int          text_length;
+	char         title[DVB_DECODE_BUFFER_SIZE];
+	char         text[EXPORT_TEXT_BUFFER_SIZE];
+} EventText;
+
+//--------------------------------------------------------------------------------------------
+// Output buffer
+//--------------------------------------------------------------------------------------------
+static void flush_export_buffer(ExportBuffer *buffer)
+{
+	if ((buffer->length > 0) && (buffer->error_code == 0))
+	{
+		if (fwrite(buffer->data, 1, buffer->length, buffer->fp) != (size_t)buffer->length)
+		{
+			buffer->error_code = EPG_EXPORT_WRITE_ERROR;
+		}
+	}
+	buffer->length = 0;
+}
+
+static void put_bytes(ExportBuffer *buffer, const char *bytes, int length)
+{
+	int copy_length = 0;
+
+	while (length > 0)
+	{
+		if (buffer->length == EXPORT_BUFFER_SIZE)
+			flush_export_buffer(buffer);
+
+		copy_length = MIN(length, EXPORT_BUFFER_SIZE - buffer->length);
+		memcpy(buffer->data + buffer->length, bytes, copy_length);
+		buffer->length += copy_length;
+		bytes += copy_length;
+		length -= copy_length;
+	}
+}
+
+#define PUT_LITERAL(buffer, literal) put_bytes((buffer), (literal), sizeof(literal) - 1)
+
+static void put_char(ExportBuffer *buffer, char c)
+{
+	if (buffer->length == EXPORT_BUFFER_SIZE)
+		flush_export_buffer(buffer);
+	buffer->data[buffer->length++] = c;
+}
+
+static void put_unsigned(ExportBuffer *buffer, unsigned long value)
+{
+	char digits[20];
+	int  position = sizeof(digits);
+
+	do
+	{
+		digits[--position] = '0' + (value % 10);
+		value /= 10;
+	} while (value != 0);
+
+	put_bytes(buffer, digits + position, sizeof(digits) - position);
+}
+
+// Fixed width with leading zeros, width is at most 4
+static void put_padded(ExportBuffer *buffer, unsigned int value, int width)
+{
+	char digits[4];
+	int  i = 0;
+
+	for (i = width - 1; i >= 0; i--)
+	{
+		digits[i] = '0' + (value % 10);
+		value /= 10;
+	}
+	put_bytes(buffer, digits, width);
+}
+
+// Runs of characters that need no escaping are copied in one piece
+static void put_xml_escaped(ExportBuffer *buffer, const char *text, int length)
+{
+	int           start = 0;
+	int           i     = 0;
+	unsigned char c     = 0;
+
+	// clang-format off
+	for (i=0; i<length; i++)
+	{ // clang-format on
+		c = (unsigned char)text[i];
+		if ((c >= 0x20) && (c != '&') && (c != '<') && (c != '>') && (c != '"') && (c != '\''))
+			continue;
+
+		put_bytes(buffer, text + start, i - start);
+		start = i + 1;
+		switch (c)
+		{
+		case '&': PUT_LITERAL(buffer, "&amp;"); break;
+		case '<': PUT_LITERAL(buffer, "&lt;"); break;
+		case '>': PUT_LITERAL(buffer, "&gt;"); break;
+		case '"': PUT_LITERAL(buffer, "&quot;"); break;
+		case '\'': PUT_LITERAL(buffer, "&apos;"); break;
+		case '\n': PUT_LITERAL(buffer, "&#10;"); break;
+		default: break; // other C0 codes are not allowed in XML 1.0
+		}
+	}
+	put_bytes(buffer, text + start, length - start);
+}
+
+static void put_json_escaped(ExportBuffer *buffer, const char *text, int length)
+{
+	static const char hex_digit[] = "0123456789abcdef";
+	int               start       = 0;
+	int               i           = 0;
+	unsigned char     c           = 0;
+	char              escape[6]   = {'\\', 'u', '0', '0', 0, 0};
+
+	// clang-format off
+	for (i=0; i<length; i++)
+	{ // clang-format on
+		c = (unsigned char)text[i];
+		if ((c >= 0x20) && (c != '"') && (c != '\\'))
+			continue;
+
+		put_bytes(buffer, text + start, i - start);
+		start = i + 1;
+		switch (c)
+		{
+		case '"': PUT_LITERAL(buffer, "\\\""); break;
+		case '\\': PUT_LITERAL(buffer, "\\\\"); break;
+		case '\n': PUT_LITERAL(buffer, "\\n"); break;
+		case '\t': PUT_LITERAL(buffer, "\\t"); break;
+		default:
+			escape[4] = hex_digit[c >> 4];
+			escape[5] = hex_digit[c & 0x0F];
+			put_bytes(buffer, escape, sizeof(escape));
+			break;
+		}
+	}
+	put_bytes(buffer, text + start, length - start);
+}
+
+// "YYYYMMDDhhmmss +0000", days to civil date without gmtime (H. Hinnant's algorithm)
+static void put_xmltv_time(ExportBuffer *buffer, unsigned long utc_time)
+{
+	long         days         = utc_time / 86400;
+	unsigned int second       = utc_time % 86400;
+	long         era          = 0;
+	unsigned int day_of_era   = 0;
+	unsigned int year_of_era  = 0;
+	unsigned int day_of_year  = 0;
+	unsigned int month_offset = 0;
+	unsigned int day          = 0;
+	unsigned int month        = 0;
+	long         year         = 0;
+
+	days += 719468;
+	era          = days / 146097;
+	day_of_era   = days - era * 146097;
+	year_of_era  = (day_of_era - day_of_era / 1460 + day_of_era / 36524 - day_of_era / 146096) / 365;
+	day_of_year  = day_of_era - (365 * year_of_era + year_of_era / 4 - year_of_era / 100);
+	month_offset = (5 * day_of_year + 2) / 153;
+	day          = day_of_year - (153 * month_offset + 2) / 5 + 1;
+	month        = (month_offset < 10) ? month_offset + 3 : month_offset - 9;
+	year         = year_of_era + era * 400 + (month <= 2);
+
+	put_padded(buffer, year, 4);
+	put_padded(buffer, month, 2);
+	put_padded(buffer, day, 2);
+	put_padded(buffer, second / 3600, 2);
+	put_padded(buffer, (second / 60) % 60, 2);
+	put_padded(buffer, second % 60, 2);
+	PUT_LITERAL(buffer, " +0000");
+}
+
+static void put_language(ExportBuffer *buffer, unsigned int language_code)
+{
+	char language[3];
+
+	language[0] = (language_code >> 16) & 0xFF;
+	language[1] = (language_code >> 8) & 0xFF;
+	language[2] = (language_code >> 0) & 0xFF;
+	put_xml_escaped(buffer, language, 3);
+}
+
+//--------------------------------------------------------------------------------------------
+// Event text, decoded into scratch buffers without touching the string pool
+//--------------------------------------------------------------------------------------------
+static void get_event_text(const EitNode *eit_node, EventText *event_text)
+{
+	const unsigned char *buffer            = NULL;
+	int                  descriptor_length = 0;
+	int                  name_length       = 0;
+	int                  text_length       = 0;
+	int                  length_of_items   = 0;
+	int                  index             = 0;
+
+	event_text->language_code = 0;
+	event_text->title_length  = 0;
+	event_text->text_length   = 0;
+	event_text->title[0]      = '\0';
+	event_text->text[0]       = '\0';
+
+	buffer = find_descriptor(eit_node->descriptor_loop, SHORT_EVENT_DESCRIPTOR_TAG, 0, &descriptor_length);
+	if ((buffer != NULL) && (descriptor_length >= 5))
+	{
+		event_text->language_code = (buffer[0] << 16) | (buffer[1] << 8) | buffer[2];
+		name_length               = MIN(buffer[3], descriptor_length - 5);
+		text_length               = MIN(buffer[4 + name_length], descriptor_length - 5 - name_length);
+		event_text->title_length  = decode_dvb_string(buffer + 4, name_length, event_text->title, sizeof(event_text->title));
+		event_text->text_length   = decode_dvb_string(buffer + 5 + name_length, text_length, event_text->text, sizeof(event_text->text));
+	}
+
+	// the text of the extended descriptors continues across descriptor_number 0..last, it replaces the short text
+	for (index = 0; index < MAX_EXTENDED_DESCRIPTOR_COUNT; index++)
+	{
+		buffer = find_descriptor(eit_node->descriptor_loop, EXTENDED_EVENT_DESCRIPTOR_TAG, index, &descriptor_length);
+		if ((buffer == NULL) || (descriptor_length < 6))
+			break;
+
+		if (index == 0)
+			event_text->text_length = 0;
+
+		length_of_items = MIN(buffer[4], descriptor_length - 6);
+		text_length     = MIN(buffer[5 + length_of_items], descriptor_length - 6 - length_of_items);
+		event_text->text_length += decode_dvb_string(buffer + 6 + length_of_items, text_length,
+		                                             event_text->text + event_text->text_length,
+		                                             sizeof(event_text->text) - event_text->text_length);
+	}
+}
+
+//--------------------------------------------------------------------------------------------
+// Writers
+//--------------------------------------------------------------------------------------------
+static void put_channel_id(ExportBuffer *buffer, unsigned short service_id, unsigned short transport_stream_id, unsigned short original_network_id)
+{
+	put_unsigned(buffer, service_id);
+	put_char(buffer, '.');
+	put_unsigned(buffer, transport_stream_id);
+	put_char(buffer, '.');
+	put_unsigned(buffer, original_network_id);
+}
+
+static void write_xmltv_channel(ExportBuffer *buffer, const ProgramInfoNode *program_info_node)
+{
+	const char *service_name = get_string(program_info_node->service_name);
+
+	PUT_LITERAL(buffer, "  <channel id=\"");
+	put_channel_id(buffer, program_info_node->program_number, program_info_node->transport_stream_id, program_info_node->original_network_id);
+	PUT_LITERAL(buffer, "\">\n    <display-name>");
+	put_xml_escaped(buffer, service_name, get_string_length(program_info_node->service_name));
+	PUT_LITERAL(buffer, "</display-name>\n  </channel>\n");
+}
+
+static void write_xmltv_programme(ExportBuffer *buffer, const EitNode *eit_node, const EventText *event_text)
+{
+	PUT_LITERAL(buffer, "  <programme start=\"");
+	put_xmltv_time(buffer, eit_node->start_time);
+	PUT_LITERAL(buffer, "\" stop=\"");
+	put_xmltv_time(buffer, eit_node->start_time + eit_node->duration);
+	PUT_LITERAL(buffer, "\" channel=\"");
+	put_channel_id(buffer, eit_node->service_id, eit_node->transport_stream_id, eit_node->original_network_id);
+	PUT_LITERAL(buffer, "\">\n    <title lang=\"");
+	put_language(buffer, event_text->language_code);
+	PUT_LITERAL(buffer, "\">");
+	put_xml_escaped(buffer, event_text->title, event_text->title_length);
+	PUT_LITERAL(buffer, "</title>\n");
+	if (event_text->text_length > 0)
+	{
+		PUT_LITERAL(buffer, "    <desc lang=\"");
+		put_language(buffer, event_text->language_code);
+		PUT_LITERAL(buffer, "\">");
+		put_xml_escaped(buffer, event_text->text, event_text->text_length);
+		PUT_LITERAL(buffer, "</desc>\n");
+	}
+	PUT_LITERAL(buffer, "  </programme>\n");
+}
+
+static void write_json_service(ExportBuffer *buffer, const ProgramInfoNode *program_info_node)
+{
+	PUT_LITERAL(buffer, "{\"type\":\"service\",\"service_id\":");
+	put_unsigned(buffer, program_info_node->program_number);
+	PUT_LITERAL(buffer, ",\"transport_stream_id\":");
+	put_unsigned(buffer, program_info_node->transport_stream_id);
+	PUT_LITERAL(buffer, ",\"original_network_id\":");
+	put_unsigned(buffer, program_info_node->original_network_id);
+	PUT_LITERAL(buffer, ",\"service_type\":");
+	put_unsigned(buffer, program_info_node->service_type);
+	PUT_LITERAL(buffer, ",\"service_name\":\"");
+	put_json_escaped(buffer, get_string(program_info_node->service_name), get_string_length(program_info_node->service_name));
+	PUT_LITERAL(buffer, "\",\"provider_name\":\"");
+	put_json_escaped(buffer, get_string(program_info_node->service_provider_name), get_string_length(program_info_node->service_provider_name));
+	PUT_LITERAL(buffer, "\"}\n");
+}
+
+static void write_json_event(ExportBuffer *buffer, const EitNode *eit_node, const EventText *event_text)
+{
+	char language[3];
+
+	language[0] = (event_text->language_code >> 16) & 0xFF;
+	language[1] = (event_text->language_code >> 8) & 0xFF;
+	language[2] = (event_text->language_code >> 0) & 0xFF;
+
+	PUT_LITERAL(buffer, "{\"type\":\"event\",\"service_id\":");
+	put_unsigned(buffer, eit_node->service_id);
+	PUT_LITERAL(buffer, ",\"transport_stream_id\":");
+	put_unsigned(buffer, eit_node->transport_stream_id);
+	PUT_LITERAL(buffer, ",\"original_network_id\":");
+	put_unsigned(buffer, eit_node->original_network_id);
+	PUT_LITERAL(buffer, ",\"event_id\":");
+	put_unsigned(buffer, eit_node->event_id);
+	PUT_LITERAL(buffer, ",\"start_time\":");
+	put_unsigned(buffer, eit_node->start_time);
+	PUT_LITERAL(buffer, ",\"duration\":");
+	put_unsigned(buffer, eit_node->duration);
+	PUT_LITERAL(buffer, ",\"running_status\":");
+	put_unsigned(buffer, eit_node->running_status);
+	PUT_LITERAL(buffer, ",\"language\":\"");
+	put_json_escaped(buffer, (event_text->language_code != 0) ? language : "", (event_text->language_code != 0) ? 3 : 0);
+	PUT_LITERAL(buffer, "\",\"title\":\"");
+	put_json_escaped(buffer, event_text->title, event_text->title_length);
+	PUT_LITERAL(buffer, "\",\"text\":\"");
+	put_json_escaped(buffer, event_text->text, event_text->text_length);
+	PUT_LITERAL(buffer, "\"}\n");
+}
+
+//--------------------------------------------------------------------------------------------
+// Function
+//--------------------------------------------------------------------------------------------
+void set_epg_export_config(const EpgExportConfig *config)
+{
+	if (config == NULL)
+	{
+		memset(&epg_export_config, 0, sizeof(EpgExportConfig));
+		return;
+	}
+
+	epg_export_config = *config;
+	export_count      = 0;
+}
+
+// "epg.xml" stays for the first export, then "epg.1.xml", "epg.2.xml" ...
+static FILE *open_export_file(const char *file_name, ExportBuffer *buffer)
+{
+	char        numbered_name[EXPORT_FILE_NAME_LENGTH] = {0};
+	const char *extension                              = NULL;
+	const char *slash                                  = NULL;
+
+	if (export_count > 0)
+	{
+		extension = strrchr(file_name, '.');
+		slash     = strrchr(file_name, '/');
+		if ((extension == NULL) || ((slash != NULL) && (extension < slash)))
+			extension = file_name + strlen(file_name);
+
+		snprintf(numbered_name, sizeof(numbered_name), "%.*s.%d%s", (int)(extension - file_name), file_name, export_count, extension);
+		file_name = numbered_name;
+	}
+
+	buffer->fp         = fopen(file_name, "wb");
+	buffer->length     = 0;
+	buffer->error_code = 0;
+	if (buffer->fp == NULL)
+	{
+		LOG("open %s fail\n", file_name);
+		return NULL;
+	}
+
+	LOG("export epg to %s\n", file_name);
+	return buffer->fp;
+}
+
+static int close_export_file(ExportBuffer *buffer)
+{
+	int error_code = 0;
+
+	flush_export_buffer(buffer);
+	error_code = buffer->error_code;
+	if (fclose(buffer->fp) != 0)
+	{
+		error_code = EPG_EXPORT_WRITE_ERROR;
+	}
+	buffer->fp = NULL;
+	return error_code;
+}
+
+static int write_epg(ExportBuffer *xmltv_buffer, ExportBuffer *json_buffer, EventText *event_text, const ProgramInfoList *program_info_list)
+{
+	const ProgramInfoNode *current_program_info_node = NULL;
+	const EitNode         *eit_node                  = NULL;
+	int                    event_count               = 0;
+
+	if (xmltv_buffer->fp != NULL)
+	{
+		PUT_LITERAL(xmltv_buffer, "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<tv generator-info-name=\"demux_simulator\">\n");
+	}
+	for (current_program_info_node = program_info_list; current_program_info_node != NULL; current_program_info_node = current_program_info_node->next)
+	{
+		if (xmltv_buffer->fp != NULL)
+			write_xmltv_channel(xmltv_buffer, current_program_info_node);
+		if (json_buffer->fp != NULL)
+			write_json_service(json_buffer, current_program_info_node);
+	}
+
+	for (eit_node = get_eit_list(); eit_node != NULL; eit_node = eit_node->next)
+	{
+		get_event_text(eit_node, event_text);
+		if (xmltv_buffer->fp != NULL)
+			write_xmltv_programme(xmltv_buffer, eit_node, event_text);
+		if (json_buffer->fp != NULL)
+			write_json_event(json_buffer, eit_node, event_text);
+		event_count++;
+	}
+
+	if (xmltv_buffer->fp != NULL)
+	{
+		PUT_LITERAL(xmltv_buffer, "</tv>\n");
+	}
+	return event_count;
+}
+
+int export_epg(ProgramInfoList *program_info_list)
+{
+	ExportBuffer *xmltv_buffer = NULL;
+	ExportBuffer *json_buffer  = NULL;
+	EventText    *event_text   = NULL;
+	int           event_count  = 0;
+	int           error_code   = 0;
+
+	if ((epg_export_config.xmltv_file_name == NULL) && (epg_export_config.json_file_name == NULL))
+		return 0;
+
+	xmltv_buffer = (ExportBuffer *)calloc(1, sizeof(ExportBuffer));
+	json_buffer  = (ExportBuffer *)calloc(1, sizeof(ExportBuffer));
+	event_text   = (EventText *)malloc(sizeof(EventText));
+	if ((xmltv_buffer == NULL) || (json_buffer == NULL) || (event_text == NULL))
+	{
+		error_code = EPG_EXPORT_MALLOC_ERROR;
+	}
+	else if (((epg_export_config.xmltv_file_name != NULL) && (open_export_file(epg_export_config.xmltv_file_name, xmltv_buffer) == NULL)) ||
+	         ((epg_export_config.json_file_name != NULL) && (open_export_file(epg_export_config.json_file_name, json_buffer) == NULL)))
+	{
+		error_code = EPG_EXPORT_OPEN_ERROR;
+	}
+	else
+	{
+		event_count = write_epg(xmltv_buffer, json_buffer, event_text, program_info_list);
+	}
+
+	// a failed write is only reported when the file is closed
+	if ((xmltv_buffer != NULL) && (xmltv_buffer->fp != NULL) && (close_export_file(xmltv_buffer) < 0) && (error_code == 0))
+	{
+		error_code = EPG_EXPORT_WRITE_ERROR;
+	}
+	if ((json_buffer != NULL) && (json_buffer->fp != NULL) && (close_export_file(json_buffer) < 0) && (error_code == 0))
+	{
+		error_code = EPG_EXPORT_WRITE_ERROR;
+	}
+	if (error_code < 0)
+	{
+		LOG("export epg error, error_code : %d\n", error_code);
+	}
+	free(xmltv_buffer);
+	free(json_buffer);
+	free(event_text);
+
+	export_count++;
+	return (error_code < 0) ? error_code : event_count;
+}
@@ -0,0 +1,51 @@
+/**
+ * @file epg_export.h
+ *
+ * @brief Streaming EPG export as XMLTV and line-delimited JSON, written straight from the EIT list
+ *        through one reusable output buffer, so memory use does not depend on the size of the EPG.
+ *        Include integrate_data.h first.
+ *
+ * @author :Yujin Yu
+ * @date   :2025.05.18
+ */
+#ifndef EPG_EXPORT_H
+#define EPG_EXPORT_H
+
+#define EXPORT_BUFFER_SIZE      65536 // written with one fwrite when full
+#define EXPORT_TEXT_BUFFER_SIZE 16384 // decoded text of one event, 16 extended descriptors fit
+#define EXPORT_FILE_NAME_LENGTH 512
+
+typedef struct
+{
+	const char *xmltv_file_name; // NULL: no XMLTV
+	const char *json_file_name;  // NULL: no JSON, one object per line
+} EpgExportConfig;
+
+typedef struct
+{
+	FILE *fp;
+	int   length;
+	int   error_code;
+	char  data[EXPORT_BUFFER_SIZE];
+} ExportBuffer;
+
+//--------------------------------------------------------------------------------------------
+// Function declaration
+//--------------------------------------------------------------------------------------------
+/**
+ * @brief Select the files written by the following export_epg calls, NULL turns the export off
+ */
+void set_epg_export_config(const EpgExportConfig *config);
+
+/**
+ * @brief Write the services of the program list and every event of the EIT list in the current table context.
+ *        The first call writes the configured files, later calls (one per pcap stream) insert ".N" before the extension.
+ *
+ * @param program_info_list Overview from get_program_info_list, gives the channel names
+ *
+ * @return >=0: number of events written to each file
+ *         <0 : error code
+ */
+int export_epg(ProgramInfoList *program_info_list);
+
+#endif
@@ -1,577 +1,821 @@
-/*
- * @file get_eit_info.c
- *
- * @author :Yujin Yu
- * @date   :2025.04.16
- */
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-#include "ts_global.h"
-#include "slot_filter.h"
-#include "get_eit_info.h"
-
-EitList *eit_list = NULL;
-
-static void clear_eit_loop_info(EitNode *temp_eit_node)
-{
-	temp_eit_node->event_id       = 0;
-	temp_eit_node->start_time     = 0;
-	temp_eit_node->duration       = 0;
-	temp_eit_node->running_status = 0;
-	temp_eit_node->free_CA_mode   = 0;
-
-	temp_eit_node->short_event_descriptor_list        = NULL;
-	temp_eit_node->extended_event_descriptor_list     = NULL;
-	temp_eit_node->time_shifted_event_descriptor_list = NULL;
-
-	temp_eit_node->next = NULL;
-}
-
-void free_short_event_descriptor_list(ShortEventDescriptorList *short_event_descriptor_list)
-{
-	ShortEventDescriptorNode *next_short_event_descriptor_node = NULL;
-	while (short_event_descriptor_list != NULL)
-	{
-		next_short_event_descriptor_node = short_event_descriptor_list->next;
-		free(short_event_descriptor_list);
-		short_event_descriptor_list = next_short_event_descriptor_node;
-	}
-}
-
-void free_extended_event_descriptor_list(ExtendedEventDescriptorList *extended_event_descriptor_list)
-{
-	ExtendedEventDescriptorNode *next_extended_event_descriptor_node = NULL;
-	while (extended_event_descriptor_list != NULL)
-	{
-		next_extended_event_descriptor_node = extended_event_descriptor_list->next;
-		free(extended_event_descriptor_list);
-		extended_event_descriptor_list = next_extended_event_descriptor_node;
-	}
-}
-
-void free_time_shifted_event_descriptor_list(TimeShiftedEventDescriptorList *time_shifted_event_descriptor_list)
-{
-	TimeShiftedEventDescriptorNode *next_time_shifted_event_descriptor_node = NULL;
-	while (time_shifted_event_descriptor_list != NULL)
-	{
-		next_time_shifted_event_descriptor_node = time_shifted_event_descriptor_list->next;
-		free(time_shifted_event_descriptor_list);
-		time_shifted_event_descriptor_list = next_time_shifted_event_descriptor_node;
-	}
-}
-
-static void free_list_in_eit_node(EitNode *eit_node)
-{
-	free_short_event_descriptor_list(eit_node->short_event_descriptor_list);
-	free_extended_event_descriptor_list(eit_node->extended_event_descriptor_list);
-	free_time_shifted_event_descriptor_list(eit_node->time_shifted_event_descriptor_list);
-
-	return;
-}
-
-// Sort priority: service_id > transport_stream_id > original_network_id > start_time
-static EitList *delete_nodes_in_eit_list_by_time(EitList *eit_list, const EitNode *temp_eit_node)
-{
-	EitNode *current   = eit_list;
-	EitNode *prev      = NULL;
-	EitNode *to_delete = NULL;
-
-	const unsigned long start_time      = temp_eit_node->start_time;
-	const unsigned long end_time        = start_time + temp_eit_node->duration;
-	unsigned long       temp_start_time = 0;
-	unsigned long       temp_end_time   = 0;
-
-	if (temp_eit_node == NULL)
-	{
-		return eit_list;
-	}
-
-	while (current != NULL)
-	{
-		if (current->service_id > temp_eit_node->service_id)
-			break;
-
-		if ((current->service_id == temp_eit_node->service_id) &&
-		    (current->transport_stream_id == temp_eit_node->transport_stream_id) &&
-		    (current->original_network_id == temp_eit_node->original_network_id))
-		{
-			temp_start_time = current->start_time;
-			temp_end_time   = current->start_time + temp_eit_node->duration;
-
-			if (((temp_start_time >= start_time) && (temp_start_time <= end_time)) ||
-			    ((temp_end_time >= start_time) && (temp_end_time <= end_time)))
-			{
-				to_delete = current;
-
-				if (prev == NULL)
-				{
-					eit_list = current->next;
-				}
-				else
-				{
-					prev->next = current->next;
-				}
-
-				current = current->next;
-
-				free_list_in_eit_node(to_delete);
-				free(to_delete);
-
-				continue;
-			}
-		}
-
-		prev    = current;
-		current = current->next;
-	}
-
-	return eit_list;
-}
-
-ShortEventDescriptorList *add_short_event_descriptor_node_to_list(ShortEventDescriptorList *short_event_descriptor_list,
-                                                                  ShortEventDescriptorNode  temp_short_event_descriptor_node)
-{
-	ShortEventDescriptorNode *new_node = NULL;
-	ShortEventDescriptorNode *current  = short_event_descriptor_list;
-	while (current != NULL)
-	{
-		if ((current->ISO_639_language_code == temp_short_event_descriptor_node.ISO_639_language_code) &&
-		    (strncmp(current->name, temp_short_event_descriptor_node.name, 36) == 0) &&
-		    (strncmp(current->text, temp_short_event_descriptor_node.text, 36) == 0))
-		{
-			return short_event_descriptor_list;
-		}
-		current = current->next;
-	}
-
-	new_node = (ShortEventDescriptorNode *)malloc(sizeof(ShortEventDescriptorNode));
-	if (new_node == NULL)
-	{
-		LOG("malloc error\n");
-		return short_event_descriptor_list;
-	}
-
-	memcpy(new_node, &temp_short_event_descriptor_node, sizeof(ShortEventDescriptorNode));
-	new_node->next = short_event_descriptor_list;
-
-	return new_node;
-}
-
-ExtendedEventDescriptorList *add_extended_event_descriptor_node_list(ExtendedEventDescriptorList *extended_event_descriptor_list,
-                                                                     ExtendedEventDescriptorNode  temp_extended_event_descriptor_node)
-{
-	ExtendedEventDescriptorNode *new_extended_event_descriptor_node = (ExtendedEventDescriptorNode *)malloc(sizeof(ExtendedEventDescriptorNode));
-	if (new_extended_event_descriptor_node == NULL)
-	{
-		LOG("add_extended_event_descriptor_node_list malloc error\n");
-		return extended_event_descriptor_list;
-	}
-
-	memcpy(new_extended_event_descriptor_node, &temp_extended_event_descriptor_node, sizeof(ExtendedEventDescriptorNode));
-	new_extended_event_descriptor_node->next = extended_event_descriptor_list;
-
-	return new_extended_event_descriptor_node;
-}
-
-TimeShiftedEventDescriptorList *add_time_shifted_event_descriptor_node_list(TimeShiftedEventDescriptorList *time_shifted_event_descriptor_list,
-                                                                            TimeShiftedEventDescriptorNode  temp_time_shifted_event_descriptor_node)
-{
-	TimeShiftedEventDescriptorNode *new_time_shifted_event_descriptor_node = (TimeShiftedEventDescriptorNode *)malloc(sizeof(TimeShiftedEventDescriptorNode));
-	if (new_time_shifted_event_descriptor_node == NULL)
-	{
-		LOG("add_time_shifted_event_descriptor_node_list malloc error\n");
-		return time_shifted_event_descriptor_list;
-	}
-
-	memcpy(new_time_shifted_event_descriptor_node, &temp_time_shifted_event_descriptor_node, sizeof(TimeShiftedEventDescriptorNode));
-	new_time_shifted_event_descriptor_node->next = time_shifted_event_descriptor_list;
-
-	return new_time_shifted_event_descriptor_node;
-}
-
-static void parser_eit_descriptors(unsigned char *buffer, int max_read_position, EitNode *temp_eit_node)
-{
-	int           read_position      = 0;
-	unsigned char descriptors_tag    = 0;
-	unsigned char descriptors_length = 0;
-	unsigned char name_length        = 0;
-	unsigned char text_length        = 0;
-	unsigned char item_length        = 0;
-	unsigned char copy_length        = 0;
-
-	ShortEventDescriptorNode       temp_short_event_descriptor_node;        // 0x4D
-	ExtendedEventDescriptorNode    temp_extended_event_descriptor_node;     // 0x4E
-	TimeShiftedEventDescriptorNode temp_time_shifted_event_descriptor_node; // 0x4F
-
-	while (read_position < max_read_position)
-	{
-		descriptors_tag    = buffer[read_position + 0];
-		descriptors_length = buffer[read_position + 1];
-		read_position += 2;
-
-		if (descriptors_length + read_position > max_read_position)
-			break;
-
-		switch (descriptors_tag)
-		{
-		case 0x4D:
-			// LOG("0x4D\n");
-			memset(&temp_short_event_descriptor_node, 0, sizeof(ShortEventDescriptorNode));
-			temp_short_event_descriptor_node.ISO_639_language_code = (buffer[read_position + 0] << 16) |
-			                                                         (buffer[read_position + 1] << 8) |
-			                                                         (buffer[read_position + 2] << 0);
-
-			name_length = buffer[read_position + 3];
-			read_position += 4;
-
-			copy_length = (name_length > descriptors_length - read_position) ? (descriptors_length - read_position) : name_length;
-			memcpy(temp_short_event_descriptor_node.name, buffer + read_position, copy_length);
-			temp_short_event_descriptor_node.name[copy_length] = '\0';
-			read_position += copy_length;
-
-			text_length = buffer[read_position];
-			read_position += 1;
-
-			copy_length = (text_length > descriptors_length - read_position) ? (descriptors_length - read_position) : text_length;
-			memcpy(temp_short_event_descriptor_node.text, buffer + read_position, copy_length + 1);
-			temp_short_event_descriptor_node.text[copy_length + 1] = '\0';
-			read_position += copy_length;
-
-			temp_eit_node->short_event_descriptor_list = add_short_event_descriptor_node_to_list(temp_eit_node->short_event_descriptor_list,
-			                                                                                     temp_short_event_descriptor_node);
-
-			break;
-
-		case 0x4E:
-			// LOG("0x4E\n");
-			memset(&temp_extended_event_descriptor_node, 0, sizeof(ExtendedEventDescriptorNode));
-			temp_extended_event_descriptor_node.descriptor_number      = (buffer[read_position + 0] >> 4) & 0x0F;
-			temp_extended_event_descriptor_node.last_descriptor_number = (buffer[read_position + 0] >> 0) & 0x0F;
-			temp_extended_event_descriptor_node.ISO_639_language_code  = (buffer[read_position + 1] << 16) |
-			                                                            (buffer[read_position + 2] << 8) |
-			                                                            (buffer[read_position + 3] << 0);
-			item_length = buffer[read_position + 4];
-			if (item_length > 0)
-			{
-				// parse_item_of_extended_event_descriptor(buffer + read_position + 5, item_length, &temp_extended_event_descriptor_node);
-				memcpy(temp_extended_event_descriptor_node.item, buffer + read_position + 5, item_length);
-			}
-
-			read_position += 5 + item_length;
-
-			text_length = buffer[read_position + 0];
-			read_position += 1;
-
-			copy_length = (text_length > descriptors_length - read_position) ? (descriptors_length - read_position) : text_length;
-			memcpy(temp_extended_event_descriptor_node.text, buffer + read_position, copy_length);
-			temp_extended_event_descriptor_node.text[copy_length] = '\0';
-			read_position += copy_length;
-
-			temp_eit_node->extended_event_descriptor_list = add_extended_event_descriptor_node_list(temp_eit_node->extended_event_descriptor_list,
-			                                                                                        temp_extended_event_descriptor_node);
-
-			break;
-
-		case 0x4F:
-			// LOG("0x4F\n");
-			memset(&temp_time_shifted_event_descriptor_node, 0, sizeof(TimeShiftedEventDescriptorNode));
-			temp_time_shifted_event_descriptor_node.reference_service_id = (buffer[read_position + 0] << 8) | buffer[read_position + 1];
-			temp_time_shifted_event_descriptor_node.reference_event_id   = (buffer[read_position + 2] << 8) | buffer[read_position + 3];
-			read_position += 4;
-
-			temp_eit_node->time_shifted_event_descriptor_list = add_time_shifted_event_descriptor_node_list(temp_eit_node->time_shifted_event_descriptor_list,
-			                                                                                                temp_time_shifted_event_descriptor_node);
-
-			break;
-
-		default:
-			break;
-		}
-	}
-
-	return;
-}
-
-static int parse_eit_info(unsigned char *buffer, int max_read_position, EitNode *temp_eit_node)
-{
-	int descriptors_length_count = 0;
-	int read_position            = 0;
-
-	if (max_read_position < 12)
-	{
-		return -1;
-	}
-
-	temp_eit_node->event_id = buffer[read_position + 0] << 8 | buffer[1];
-
-	temp_eit_node->start_time = ((buffer[read_position + 2] << 24) << 8) |
-	                            (buffer[read_position + 3] << 24) |
-	                            (buffer[read_position + 4] << 16) |
-	                            (buffer[read_position + 5] << 8) |
-	                            (buffer[read_position + 6] << 0);
-
-	temp_eit_node->duration = (buffer[read_position + 7] << 16) |
-	                          (buffer[read_position + 8] << 8) |
-	                          (buffer[read_position + 9] << 0);
-
-	temp_eit_node->running_status = (buffer[read_position + 10] >> 5) & 0x07;
-	temp_eit_node->free_CA_mode   = (buffer[read_position + 10] >> 4) & 0x01;
-	descriptors_length_count      = (buffer[read_position + 10] & 0x0F) | buffer[read_position + 11];
-	read_position += 12;
-
-	if (descriptors_length_count >= 2)
-	{
-		parser_eit_descriptors(buffer + read_position, descriptors_length_count, temp_eit_node);
-	}
-
-	return 12 + descriptors_length_count;
-}
-
-// Sort priority: service_id > transport_stream_id > original_network_id > start_time
-static int compare_nodes(const EitNode *a, const EitNode *b)
-{
-	if (a->service_id != b->service_id)
-		return a->service_id - b->service_id;
-
-	if (a->transport_stream_id != b->transport_stream_id)
-		return a->transport_stream_id - b->transport_stream_id;
-
-	if (a->original_network_id != b->original_network_id)
-		return a->original_network_id - b->original_network_id;
-
-	return a->start_time - b->start_time;
-}
-
-static EitList *add_eit_node_to_list(EitList *eit_list, EitNode temp_eit_node)
-{
-	EitNode *current  = eit_list;
-	EitNode *new_node = NULL;
-
-	new_node = malloc(sizeof(EitNode));
-	if (new_node == NULL)
-	{
-		LOG("malloc error in add_eit_node_to_list\n");
-		return eit_list;
-	}
-
-	memcpy(new_node, &temp_eit_node, sizeof(EitNode));
-	new_node->short_event_descriptor_list        = temp_eit_node.short_event_descriptor_list;
-	new_node->extended_event_descriptor_list     = temp_eit_node.extended_event_descriptor_list;
-	new_node->time_shifted_event_descriptor_list = temp_eit_node.time_shifted_event_descriptor_list;
-	new_node->next                               = NULL;
-
-	// 插入头部或空链表
-	if ((eit_list == NULL) || (compare_nodes(new_node, eit_list) < 0))
-	{
-		new_node->next = eit_list;
-		return new_node;
-	}
-
-	// 查找插入位置
-	while ((current->next != NULL) && (compare_nodes(new_node, current->next) >= 0))
-	{
-		current = current->next;
-	}
-
-	// 插入节点
-	new_node->next = current->next;
-	current->next  = new_node;
-
-	return eit_list;
-}
-
-int eit_callback(Slot *slot, int filter_index, unsigned char *section_buffer, unsigned short pid)
-{
-	SectionHead section_header = {0};
-	EitNode     temp_eit_node  = {0};
-
-	int max_read_position = 0;
-	int read_position     = 0;
-	int copy_length       = 0;
-
-	get_section_header(section_buffer, &section_header);
-	if (section_header.section_length < EIT_HEADER_LENGTH + EIT_CRC_LENGTH)
-	{
-		return SDT_CALLBACK_SECTION_LENGTH_ERROR;
-	}
-
-	temp_eit_node.service_id                         = (section_buffer[3] << 8) | section_buffer[4];
-	temp_eit_node.transport_stream_id                = (section_buffer[8] << 8) | section_buffer[9];
-	temp_eit_node.original_network_id                = (section_buffer[10] << 8) | section_buffer[11];
-	temp_eit_node.segment_last_section_number        = section_buffer[12];
-	temp_eit_node.last_table_id                      = section_buffer[13];
-	temp_eit_node.short_event_descriptor_list        = NULL;
-	temp_eit_node.extended_event_descriptor_list     = NULL;
-	temp_eit_node.time_shifted_event_descriptor_list = NULL;
-
-	read_position     = EIT_HEADER_LENGTH;
-	max_read_position = section_header.section_length - EIT_CRC_LENGTH;
-
-	while (read_position + 12 <= max_read_position)
-	{
-		clear_eit_loop_info(&temp_eit_node);
-
-		copy_length = parse_eit_info(section_buffer + read_position, max_read_position - read_position, &temp_eit_node);
-		if (copy_length < 0)
-			break;
-		read_position += copy_length;
-		eit_list = delete_nodes_in_eit_list_by_time(eit_list, &temp_eit_node);
-		eit_list = add_eit_node_to_list(eit_list, temp_eit_node);
-	}
-
-	return 0;
-}
-
-void init_eit_resource(Slot *slot)
-{
-	unsigned char eit_filter_match[FILTER_MASK_LENGTH] = {0x47, 0x00, 0x12, 0x00, 0x4E, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
-	unsigned char eit_filter_mask[FILTER_MASK_LENGTH]  = {0xFF, 0x1F, 0xFF, 0x00, 0xFE, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
-
-	// unsigned char eit_table_ids[2] = {0x4E, 0x6F};
-	int eit_filter_index = 0;
-
-	if (slot->ts_file == NULL)
-	{
-		LOG("Invalid parameters, error code : %d\n", EIT_INIT_PARAM_ERROR);
-		return;
-	}
-
-	// alloc_filter thrice
-	eit_filter_index = alloc_filter(slot, eit_filter_match, eit_filter_mask, EIT_CRC_CHECK, eit_callback);
-	if (eit_filter_index < 0)
-	{
-		LOG("alloc_filter error\n");
-		return;
-	}
-
-	eit_filter_match[4] = 0x50;
-	eit_filter_mask[4]  = 0xF0;
-	eit_filter_index    = alloc_filter(slot, eit_filter_match, eit_filter_mask, EIT_CRC_CHECK, eit_callback);
-	if (eit_filter_index < 0)
-	{
-		LOG("alloc_filter error\n");
-		return;
-	}
-
-	eit_filter_match[4] = 0x60;
-	eit_filter_mask[4]  = 0xF0;
-	eit_filter_index    = alloc_filter(slot, eit_filter_match, eit_filter_mask, EIT_CRC_CHECK, eit_callback);
-	if (eit_filter_index < 0)
-	{
-		LOG("alloc_filter error\n");
-		return;
-	}
-
-	return;
-}
-
-void free_eit_resource(void)
-{
-	// does not have status
-	// and the filters of eit should be free at the end of file
-}
-
-EitList *get_eit_list(void)
-{
-	return eit_list;
-}
-
-void free_eit_list(EitList *eit_list)
-{
-	EitNode *next_eit_node = NULL;
-	while (eit_list != NULL)
-	{
-		next_eit_node = eit_list->next;
-		free_list_in_eit_node(eit_list);
-		free(eit_list);
-		eit_list = next_eit_node;
-	}
-
-	return;
-}
-
-void printf_eit_list(EitList *eit_list)
-{
-	EitNode                        *eit_node                           = eit_list;
-	ShortEventDescriptorNode       *short_event_descriptor_node        = NULL;
-	ExtendedEventDescriptorNode    *extended_event_descriptor_node     = NULL;
-	TimeShiftedEventDescriptorNode *time_shifted_event_descriptor_node = NULL;
-
-	if (eit_node == NULL)
-	{
-		LOG("EIT list is empty!\n");
-		return;
-	}
-
-	LOG("========================================== EIT Information ====================================================\n");
-	LOG("EIT list:\n");
-	while (eit_node != NULL)
-	{
-		// if ((eit_node->short_event_descriptor_list == NULL) &&
-		//     (eit_node->extended_event_descriptor_list == NULL) &&
-		//     (eit_node->time_shifted_event_descriptor_list == NULL))
-		// {
-		// 	eit_node = eit_node->next;
-		// 	continue;
-		// }
-
-		LOG("-----------------------------------------------------------------------------------------------------------\n");
-		LOG("service_id: 0x%04X | transport_stream_id: 0x%04X | original_network_id: 0x%04X | start_time: %010lu\n",
-		    eit_node->service_id,
-		    eit_node->transport_stream_id,
-		    eit_node->original_network_id,
-		    eit_node->start_time);
-
-		LOG("event_id: 0x%04X | duration: %8u sec | running_status: %d | free_CA_mode: %d\n",
-		    eit_node->event_id,
-		    eit_node->duration,
-		    eit_node->running_status,
-		    eit_node->free_CA_mode);
-		LOG("\t---------------------------------------------------------------------------------------------------\n");
-
-		// 打印短事件描述符 (0x4D)
-		short_event_descriptor_node = eit_node->short_event_descriptor_list;
-		while (short_event_descriptor_node != NULL)
-		{
-			LOG("\t[1] [Short Event] language: %c%c%c| Name: %s | Text: %s\n",
-			    (short_event_descriptor_node->ISO_639_language_code >> 16) & 0xFF,
-			    (short_event_descriptor_node->ISO_639_language_code >> 8) & 0xFF,
-			    (short_event_descriptor_node->ISO_639_language_code >> 0) & 0xFF,
-			    short_event_descriptor_node->name,
-			    short_event_descriptor_node->text);
-			short_event_descriptor_node = short_event_descriptor_node->next;
-		}
-
-		// 打印扩展事件描述符 (0x4E)
-		extended_event_descriptor_node = eit_node->extended_event_descriptor_list;
-		while (extended_event_descriptor_node != NULL)
-		{
-			LOG("\t[2] [Extended Event] language: %c%c%c | Desc Num: %d/%d | Text: %s\n",
-			    (extended_event_descriptor_node->ISO_639_language_code >> 16) & 0xFF,
-			    (extended_event_descriptor_node->ISO_639_language_code >> 8) & 0xFF,
-			    (extended_event_descriptor_node->ISO_639_language_code >> 0) & 0xFF,
-			    extended_event_descriptor_node->descriptor_number,
-			    extended_event_descriptor_node->last_descriptor_number,
-			    extended_event_descriptor_node->text);
-
-			LOG("\t[2.1]item:%s\n", extended_event_descriptor_node->item);
-
-			extended_event_descriptor_node = extended_event_descriptor_node->next;
-		}
-
-		// 打印时移事件描述符 (0x4F)
-		time_shifted_event_descriptor_node = eit_node->time_shifted_event_descriptor_list;
-		while (time_shifted_event_descriptor_node != NULL)
-		{
-			LOG("\t[3] [Time Shifted] reference_service_id: 0x%04X | reference_event_idt: 0x%04X\n",
-			    time_shifted_event_descriptor_node->reference_service_id,
-			    time_shifted_event_descriptor_node->reference_event_id);
-			time_shifted_event_descriptor_node = time_shifted_event_descriptor_node->next;
-		}
-
-		eit_node = eit_node->next;
-	}
-
-	DOUBLE_LINE
-}
+/*
+ * @file get_eit_info.c
+ *
+ * @author :Yujin Yu
+ * @date   :2025.04.16
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <time.h>
+#include "ts_global.h"
+#include "slot_filter.h"
+#include "section_store.h"
+#include "string_pool.h"
+#include "dvb_charset.h"
+#include "get_sdt_info.h"
+#include "get_eit_info.h"
+#include "table_context.h"
+#include "instrument.h"
+#include "logger.h"
+#include "memory_account.h"
+
+// configuration shared by every demux context, not table state
+static EitServiceSelection eit_service_selection = {0};
+
+#define BCD_INVALID 0xFF
+#define BCD_ROW(tens)                                                                                      \
+	(tens) * 10 + 0, (tens) * 10 + 1, (tens) * 10 + 2, (tens) * 10 + 3, (tens) * 10 + 4, (tens) * 10 + 5, \
+	(tens) * 10 + 6, (tens) * 10 + 7, (tens) * 10 + 8, (tens) * 10 + 9,                                   \
+	BCD_INVALID, BCD_INVALID, BCD_INVALID, BCD_INVALID, BCD_INVALID, BCD_INVALID
+#define BCD_INVALID_ROW                                                                                    \
+	BCD_INVALID, BCD_INVALID, BCD_INVALID, BCD_INVALID, BCD_INVALID, BCD_INVALID, BCD_INVALID, BCD_INVALID, \
+	BCD_INVALID, BCD_INVALID, BCD_INVALID, BCD_INVALID, BCD_INVALID, BCD_INVALID, BCD_INVALID, BCD_INVALID
+
+// Two BCD digits to binary in one lookup, nibbles above 9 give BCD_INVALID
+static const unsigned char bcd_table[256] = {
+	BCD_ROW(0), BCD_ROW(1), BCD_ROW(2), BCD_ROW(3), BCD_ROW(4), BCD_ROW(5), BCD_ROW(6), BCD_ROW(7), BCD_ROW(8), BCD_ROW(9),
+	BCD_INVALID_ROW, BCD_INVALID_ROW, BCD_INVALID_ROW, BCD_INVALID_ROW, BCD_INVALID_ROW, BCD_INVALID_ROW,
+};
+
+unsigned int decode_bcd_duration(const unsigned char *buffer)
+{
+	unsigned int hour   = bcd_table[buffer[0]];
+	unsigned int minute = bcd_table[buffer[1]];
+	unsigned int second = bcd_table[buffer[2]];
+
+	if ((hour == BCD_INVALID) || (minute == BCD_INVALID) || (second == BCD_INVALID))
+		return EIT_UNDEFINED_TIME;
+
+	return hour * 3600 + minute * 60 + second;
+}
+
+unsigned long decode_utc_time(const unsigned char *buffer)
+{
+	unsigned int mjd = (buffer[0] << 8) | buffer[1];
+
+	if (mjd < MJD_UNIX_EPOCH)
+		return EIT_UNDEFINED_TIME;
+
+	if ((bcd_table[buffer[2]] == BCD_INVALID) || (bcd_table[buffer[3]] == BCD_INVALID) || (bcd_table[buffer[4]] == BCD_INVALID))
+		return EIT_UNDEFINED_TIME;
+
+	return (unsigned long)(mjd - MJD_UNIX_EPOCH) * 86400 + decode_bcd_duration(buffer + 2);
+}
+
+char *format_utc_time(unsigned long utc_time, char *string)
+{
+	time_t    time_value = (time_t)utc_time;
+	struct tm utc        = {0};
+
+	if ((utc_time == EIT_UNDEFINED_TIME) || (gmtime_r(&time_value, &utc) == NULL))
+	{
+		snprintf(string, UTC_TIME_STRING_SIZE, "undefined");
+		return string;
+	}
+
+	strftime(string, UTC_TIME_STRING_SIZE, "%Y-%m-%d %H:%M:%S", &utc);
+	return string;
+}
+
+static void clear_eit_loop_info(EitNode *temp_eit_node)
+{
+	temp_eit_node->event_id       = 0;
+	temp_eit_node->start_time     = 0;
+	temp_eit_node->duration       = 0;
+	temp_eit_node->running_status = 0;
+	temp_eit_node->free_CA_mode   = 0;
+
+	temp_eit_node->descriptor_loop.offset = 0;
+	temp_eit_node->descriptor_loop.length = 0;
+
+	temp_eit_node->next = NULL;
+}
+
+void account_eit_node(const EitNode *eit_node, int sign)
+{
+	const SectionStore *store = &get_table_context()->section_store;
+
+	add_memory(MEMORY_SUBSYSTEM_EIT, sign * (long long)sizeof(EitNode), sign * eit_node->descriptor_loop.length, sign);
+	if (eit_node->descriptor_loop.offset + eit_node->descriptor_loop.length <= store->length)
+	{
+		add_eit_descriptor_memory(store->data + eit_node->descriptor_loop.offset, eit_node->descriptor_loop.length, sign);
+	}
+}
+
+// Drop the events of the same service whose [start, start + duration) overlaps the new event or start at the same time
+static EitList *delete_nodes_in_eit_list_by_time(EitList *eit_list, const EitNode *temp_eit_node)
+{
+	EitNode *current   = eit_list;
+	EitNode *prev      = NULL;
+	EitNode *to_delete = NULL;
+
+	unsigned long start_time      = 0;
+	unsigned long end_time        = 0;
+	unsigned long temp_start_time = 0;
+	unsigned long temp_end_time   = 0;
+
+	if (temp_eit_node == NULL)
+	{
+		return eit_list;
+	}
+
+	start_time = temp_eit_node->start_time;
+	end_time   = start_time + temp_eit_node->duration;
+
+	while (current != NULL)
+	{
+		if (current->service_id > temp_eit_node->service_id)
+			break;
+
+		if ((current->service_id == temp_eit_node->service_id) &&
+		    (current->transport_stream_id == temp_eit_node->transport_stream_id) &&
+		    (current->original_network_id == temp_eit_node->original_network_id))
+		{
+			temp_start_time = current->start_time;
+			temp_end_time   = current->start_time + current->duration;
+
+			if ((temp_start_time == start_time) || ((temp_start_time < end_time) && (temp_end_time > start_time)))
+			{
+				to_delete = current;
+
+				if (prev == NULL)
+				{
+					eit_list = current->next;
+				}
+				else
+				{
+					prev->next = current->next;
+				}
+
+				current = current->next;
+
+				account_eit_node(to_delete, -1);
+				free(to_delete);
+
+				continue;
+			}
+		}
+
+		prev    = current;
+		current = current->next;
+	}
+
+	return eit_list;
+}
+
+// Intern the UTF-8 form of a length prefixed text, the length is clipped to the bytes left in the descriptor
+static int intern_descriptor_string(const unsigned char *buffer, int length, int max_length, StringHandle *handle)
+{
+	int intern_length = MIN(length, max_length);
+
+	if (intern_length < 0)
+		intern_length = 0;
+
+	return intern_dvb_string(&get_table_context()->string_pool, buffer, intern_length, handle);
+}
+
+// Append a separator to the item scratch buffer
+static int append_item_separator(char *string, int write_position, const char *separator)
+{
+	int copy_length = MIN((int)strlen(separator), DVB_DECODE_BUFFER_SIZE - 1 - write_position);
+
+	if (copy_length <= 0)
+		return write_position;
+
+	memcpy(string + write_position, separator, copy_length);
+	return write_position + copy_length;
+}
+
+// Append one item text, every item carries its own character table selector
+static int append_item_string(char *string, int write_position, const unsigned char *buffer, int length)
+{
+	return write_position + decode_dvb_string(buffer, length, string + write_position, DVB_DECODE_BUFFER_SIZE - write_position);
+}
+
+int get_short_event_descriptor(DescriptorLoop descriptor_loop, int index, ShortEventDescriptor *descriptor)
+{
+	const unsigned char *buffer            = NULL;
+	int                  descriptor_length = 0;
+	int                  name_length       = 0;
+	int                  text_length       = 0;
+
+	buffer = find_descriptor(descriptor_loop, SHORT_EVENT_DESCRIPTOR_TAG, index, &descriptor_length);
+	if ((buffer == NULL) || (descriptor_length < 5))
+	{
+		return 0;
+	}
+
+	descriptor->ISO_639_language_code = (buffer[0] << 16) | (buffer[1] << 8) | buffer[2];
+
+	name_length = MIN(buffer[3], descriptor_length - 5);
+	text_length = buffer[4 + name_length];
+	if ((intern_descriptor_string(buffer + 4, name_length, name_length, &descriptor->name) < 0) ||
+	    (intern_descriptor_string(buffer + 5 + name_length, text_length, descriptor_length - 5 - name_length, &descriptor->text) < 0))
+	{
+		return 0;
+	}
+	return 1;
+}
+
+int get_extended_event_descriptor(DescriptorLoop descriptor_loop, int index, ExtendedEventDescriptor *descriptor)
+{
+	const unsigned char *buffer              = NULL;
+	int                  descriptor_length   = 0;
+	int                  length_of_items     = 0;
+	int                  read_position       = 0;
+	int                  item_write_position = 0;
+	int                  length              = 0;
+	char                 item[DVB_DECODE_BUFFER_SIZE];
+
+	buffer = find_descriptor(descriptor_loop, EXTENDED_EVENT_DESCRIPTOR_TAG, index, &descriptor_length);
+	if ((buffer == NULL) || (descriptor_length < 6))
+	{
+		return 0;
+	}
+
+	descriptor->descriptor_number      = (buffer[0] >> 4) & 0x0F;
+	descriptor->last_descriptor_number = (buffer[0] >> 0) & 0x0F;
+	descriptor->ISO_639_language_code  = (buffer[1] << 16) | (buffer[2] << 8) | buffer[3];
+
+	length_of_items = MIN(buffer[4], descriptor_length - 6);
+
+	// items become "description: item; description: item"
+	read_position = 5;
+	while (read_position < 5 + length_of_items)
+	{
+		length = MIN(buffer[read_position], 5 + length_of_items - read_position - 1);
+		if (item_write_position > 0)
+		{
+			item_write_position = append_item_separator(item, item_write_position, "; ");
+		}
+		item_write_position = append_item_string(item, item_write_position, buffer + read_position + 1, length);
+		read_position += 1 + length;
+		if (read_position >= 5 + length_of_items)
+			break;
+
+		length              = MIN(buffer[read_position], 5 + length_of_items - read_position - 1);
+		item_write_position = append_item_separator(item, item_write_position, ": ");
+		item_write_position = append_item_string(item, item_write_position, buffer + read_position + 1, length);
+		read_position += 1 + length;
+	}
+
+	read_position = 5 + length_of_items;
+	if ((intern_string(&get_table_context()->string_pool, item, item_write_position, &descriptor->item) < 0) ||
+	    (intern_descriptor_string(buffer + read_position + 1, buffer[read_position], descriptor_length - read_position - 1, &descriptor->text) < 0))
+	{
+		return 0;
+	}
+	return 1;
+}
+
+int get_time_shifted_event_descriptor(DescriptorLoop descriptor_loop, int index, TimeShiftedEventDescriptor *descriptor)
+{
+	const unsigned char *buffer            = NULL;
+	int                  descriptor_length = 0;
+
+	buffer = find_descriptor(descriptor_loop, TIME_SHIFTED_EVENT_DESCRIPTOR_TAG, index, &descriptor_length);
+	if ((buffer == NULL) || (descriptor_length < 4))
+	{
+		return 0;
+	}
+
+	descriptor->reference_service_id = (buffer[0] << 8) | buffer[1];
+	descriptor->reference_event_id   = (buffer[2] << 8) | buffer[3];
+	return 1;
+}
+
+// Fixed part of one event, the descriptor loop stays in the section and is only measured
+static int parse_eit_info(unsigned char *buffer, int max_read_position, EitNode *temp_eit_node, int *descriptors_loop_length)
+{
+	int read_position = 0;
+
+	if (max_read_position < 12)
+	{
+		return -1;
+	}
+
+	temp_eit_node->event_id = buffer[read_position + 0] << 8 | buffer[1];
+
+	temp_eit_node->start_time = decode_utc_time(buffer + read_position + 2);
+	temp_eit_node->duration   = decode_bcd_duration(buffer + read_position + 7);
+
+	temp_eit_node->running_status = (buffer[read_position + 10] >> 5) & 0x07;
+	temp_eit_node->free_CA_mode   = (buffer[read_position + 10] >> 4) & 0x01;
+	*descriptors_loop_length      = ((buffer[read_position + 10] & 0x0F) << 8) | buffer[read_position + 11];
+
+	if (12 + *descriptors_loop_length > max_read_position)
+	{
+		return -1;
+	}
+
+	return 12 + *descriptors_loop_length;
+}
+
+// The same event with the same descriptors is already in the list, the section is a repetition
+static int is_event_unchanged(EitList *eit_list, const EitNode *temp_eit_node, const unsigned char *descriptors, int descriptors_loop_length)
+{
+	const SectionStore *store    = &get_table_context()->section_store;
+	EitNode            *eit_node = eit_list;
+
+	while ((eit_node != NULL) && (eit_node->service_id <= temp_eit_node->service_id))
+	{
+		if ((eit_node->service_id == temp_eit_node->service_id) &&
+		    (eit_node->event_id == temp_eit_node->event_id) &&
+		    (eit_node->transport_stream_id == temp_eit_node->transport_stream_id) &&
+		    (eit_node->original_network_id == temp_eit_node->original_network_id))
+		{
+			return (eit_node->start_time == temp_eit_node->start_time) &&
+			       (eit_node->duration == temp_eit_node->duration) &&
+			       (eit_node->running_status == temp_eit_node->running_status) &&
+			       (eit_node->descriptor_loop.length == descriptors_loop_length) &&
+			       (memcmp(store->data + eit_node->descriptor_loop.offset, descriptors, descriptors_loop_length) == 0);
+		}
+		eit_node = eit_node->next;
+	}
+	return 0;
+}
+
+// Sort priority: service_id > transport_stream_id > original_network_id > start_time
+static int compare_nodes(const EitNode *a, const EitNode *b)
+{
+	if (a->service_id != b->service_id)
+		return a->service_id - b->service_id;
+
+	if (a->transport_stream_id != b->transport_stream_id)
+		return a->transport_stream_id - b->transport_stream_id;
+
+	if (a->original_network_id != b->original_network_id)
+		return a->original_network_id - b->original_network_id;
+
+	if (a->start_time != b->start_time)
+		return (a->start_time < b->start_time) ? -1 : 1;
+
+	return 0;
+}
+
+typedef struct
+{
+	unsigned long end_time;
+	long long     bytes;
+} EvictionKey;
+
+static int compare_eviction_key(const void *a, const void *b)
+{
+	const EvictionKey *key_a = (const EvictionKey *)a;
+	const EvictionKey *key_b = (const EvictionKey *)b;
+
+	if (key_a->end_time != key_b->end_time)
+		return (key_a->end_time < key_b->end_time) ? -1 : 1;
+	return 0;
+}
+
+/**
+ * @brief Drop the events that end first until bytes more fit under the EIT cap. One scan picks a whole batch,
+ *        MEMORY_EVICTION_HEADROOM of the cap is freed on top, so the following events find room without a scan
+ *
+ * @return 1: room made
+ *         0: the events ending no later than the new one are not enough, nothing is dropped
+ */
+static int make_room_for_event(TableContext *table_context, const EitNode *temp_eit_node, long long bytes)
+{
+	const MemoryUsage *usage           = &get_memory_account()->usage_array[MEMORY_SUBSYSTEM_EIT];
+	EvictionKey       *key_array       = NULL;
+	EitNode           *current         = NULL;
+	EitNode           *prev            = NULL;
+	EitNode           *to_delete       = NULL;
+	unsigned long      end_time        = temp_eit_node->start_time + temp_eit_node->duration;
+	unsigned long      threshold       = 0;
+	long long          needed_bytes    = 0;
+	long long          freed_bytes     = 0;
+	int                candidate_count = 0;
+	int                i               = 0;
+
+	if (is_memory_cap_reached(MEMORY_SUBSYSTEM_EIT, bytes) == 0)
+		return 1;
+
+	// only events ending no later than the new one are dropped for it
+	for (current = table_context->eit_list; current != NULL; current = current->next)
+	{
+		if (current->start_time + current->duration <= end_time)
+			candidate_count++;
+	}
+
+	needed_bytes = usage->live_bytes + bytes - (long long)usage->cap_bytes;
+	key_array    = (EvictionKey *)malloc((candidate_count + 1) * sizeof(EvictionKey));
+	if (key_array == NULL)
+	{
+		LOG_ERROR(LOGGER_CATEGORY_EIT, "malloc error in make_room_for_event\n");
+		return 0;
+	}
+
+	for (current = table_context->eit_list; current != NULL; current = current->next)
+	{
+		if (current->start_time + current->duration <= end_time)
+		{
+			key_array[i].end_time = current->start_time + current->duration;
+			key_array[i].bytes    = sizeof(EitNode) + current->descriptor_loop.length;
+			i++;
+		}
+	}
+	qsort(key_array, candidate_count, sizeof(EvictionKey), compare_eviction_key);
+
+	// the batch ends at the first end time that covers what is needed plus the headroom, or with the last candidate
+	// clang-format off
+	for (i=0; (i<candidate_count) && (freed_bytes<needed_bytes + (long long)(usage->cap_bytes / MEMORY_EVICTION_HEADROOM)); i++)
+	{ // clang-format on
+		freed_bytes += key_array[i].bytes;
+		threshold = key_array[i].end_time;
+	}
+	free(key_array);
+
+	if (freed_bytes < needed_bytes)
+		return 0;
+
+	for (prev = NULL, current = table_context->eit_list; current != NULL;)
+	{
+		if (current->start_time + current->duration <= threshold)
+		{
+			to_delete = current;
+			current   = current->next;
+			if (prev == NULL)
+				table_context->eit_list = current;
+			else
+				prev->next = current;
+
+			account_eit_node(to_delete, -1);
+			free(to_delete);
+			count_memory_evicted(MEMORY_SUBSYSTEM_EIT);
+			continue;
+		}
+
+		prev    = current;
+		current = current->next;
+	}
+	return 1;
+}
+
+// Copy the descriptor loops still referenced by the SDT and EIT lists into a new store, so dropped events give their bytes back.
+// Only while the tables are acquired, the program info keeps offsets of its own once it is built
+static int compact_section_store(TableContext *table_context)
+{
+	SectionStore         store       = {0};
+	const unsigned char *data        = table_context->section_store.data;
+	SdtNode             *sdt_node    = NULL;
+	EitNode             *eit_node    = NULL;
+	unsigned int         live_length = 0;
+	int                  error_code  = 0;
+
+	for (sdt_node = table_context->sdt_list; sdt_node != NULL; sdt_node = sdt_node->next)
+	{
+		live_length += sdt_node->descriptor_loop.length;
+	}
+	for (eit_node = table_context->eit_list; eit_node != NULL; eit_node = eit_node->next)
+	{
+		live_length += eit_node->descriptor_loop.length;
+	}
+
+	// reserved in one go, so no append below can fail half way through the lists
+	if ((error_code = section_store_reserve(&store, MAX(live_length * 2, SECTION_STORE_INITIAL_CAPACITY))) < 0)
+		return error_code;
+
+	for (sdt_node = table_context->sdt_list; sdt_node != NULL; sdt_node = sdt_node->next)
+	{
+		section_store_append(&store, data + sdt_node->descriptor_loop.offset, sdt_node->descriptor_loop.length, &sdt_node->descriptor_loop);
+	}
+	for (eit_node = table_context->eit_list; eit_node != NULL; eit_node = eit_node->next)
+	{
+		section_store_append(&store, data + eit_node->descriptor_loop.offset, eit_node->descriptor_loop.length, &eit_node->descriptor_loop);
+	}
+
+	count_memory_compaction((long long)table_context->section_store.length - store.length);
+	free_section_store(&table_context->section_store);
+	table_context->section_store = store;
+	return 0;
+}
+
+// The store is compacted only under an EIT cap, without one it grows with the stream as before.
+// The store is per context, so it is measured against the loops of this context, not the process wide account
+static int is_compaction_needed(const TableContext *table_context)
+{
+	const MemoryAccount *account = get_memory_account();
+
+	return (account->usage_array[MEMORY_SUBSYSTEM_EIT].cap_bytes != 0) &&
+	       ((long long)table_context->section_store.length > MEMORY_COMPACTION_RATIO * table_context->descriptor_bytes + SECTION_STORE_INITIAL_CAPACITY);
+}
+
+static EitList *add_eit_node_to_list(EitList *eit_list, EitNode temp_eit_node)
+{
+	EitNode *current  = eit_list;
+	EitNode *new_node = NULL;
+
+	new_node = malloc(sizeof(EitNode));
+	if (new_node == NULL)
+	{
+		LOG_ERROR(LOGGER_CATEGORY_EIT, "malloc error in add_eit_node_to_list\n");
+		return eit_list;
+	}
+
+	memcpy(new_node, &temp_eit_node, sizeof(EitNode));
+	new_node->next = NULL;
+	account_eit_node(new_node, 1);
+
+	// 插入头部或空链表
+	if ((eit_list == NULL) || (compare_nodes(new_node, eit_list) < 0))
+	{
+		new_node->next = eit_list;
+		return new_node;
+	}
+
+	// 查找插入位置
+	while ((current->next != NULL) && (compare_nodes(new_node, current->next) >= 0))
+	{
+		current = current->next;
+	}
+
+	// 插入节点
+	new_node->next = current->next;
+	current->next  = new_node;
+
+	return eit_list;
+}
+
+/**
+ * @brief The filter only compares the header bytes that are in the packet the section starts in,
+ *        a header straddling two packets passes it unchecked, so the selection is checked again here
+ *
+ * @return 1: the service is selected
+ *         0: not selected
+ */
+static int is_service_selected(const EitNode *temp_eit_node)
+{
+	int i = 0;
+
+	if ((eit_service_selection.transport_stream_id != 0) && (eit_service_selection.transport_stream_id != temp_eit_node->transport_stream_id))
+		return 0;
+
+	if ((eit_service_selection.original_network_id != 0) && (eit_service_selection.original_network_id != temp_eit_node->original_network_id))
+		return 0;
+
+	if (eit_service_selection.service_count == 0)
+		return 1;
+
+	// clang-format off
+	for (i=0; i<eit_service_selection.service_count; i++)
+	{ // clang-format on
+		if (eit_service_selection.service_id_array[i] == temp_eit_node->service_id)
+			return 1;
+	}
+	return 0;
+}
+
+int eit_callback(Slot *slot, int filter_index, unsigned char *section_buffer, unsigned short pid)
+{
+	TableContext *table_context  = get_table_context();
+	SectionHead   section_header = {0};
+	EitNode       temp_eit_node  = {0};
+
+	int max_read_position       = 0;
+	int read_position           = 0;
+	int copy_length             = 0;
+	int descriptors_loop_length = 0;
+	int error_code              = 0;
+
+	get_section_header(section_buffer, &section_header);
+	if ((section_header.table_id < EIT_TABLE_ID_MIN) || (section_header.table_id > EIT_TABLE_ID_MAX))
+	{
+		return 0;
+	}
+
+	if (section_header.section_length < EIT_HEADER_LENGTH + EIT_CRC_LENGTH)
+	{
+		return SDT_CALLBACK_SECTION_LENGTH_ERROR;
+	}
+
+	temp_eit_node.service_id                  = (section_buffer[3] << 8) | section_buffer[4];
+	temp_eit_node.transport_stream_id         = (section_buffer[8] << 8) | section_buffer[9];
+	temp_eit_node.original_network_id         = (section_buffer[10] << 8) | section_buffer[11];
+	temp_eit_node.segment_last_section_number = section_buffer[12];
+	temp_eit_node.last_table_id               = section_buffer[13];
+
+	if (is_service_selected(&temp_eit_node) == 0)
+	{
+		return 0;
+	}
+
+	read_position     = EIT_HEADER_LENGTH;
+	max_read_position = section_header.section_length - EIT_CRC_LENGTH;
+
+	while (read_position + 12 <= max_read_position)
+	{
+		clear_eit_loop_info(&temp_eit_node);
+
+		copy_length = parse_eit_info(section_buffer + read_position, max_read_position - read_position, &temp_eit_node, &descriptors_loop_length);
+		if (copy_length < 0)
+			break;
+
+		// EIT repeats all the time, an unchanged event costs one compare and no store space
+		if (is_event_unchanged(table_context->eit_list, &temp_eit_node, section_buffer + read_position + 12, descriptors_loop_length) == 1)
+		{
+			INSTRUMENT_COUNT(unchanged_event_count, 1);
+			read_position += copy_length;
+			continue;
+		}
+
+		// the events it replaces go first, so they are not counted against the cap
+		table_context->eit_list = delete_nodes_in_eit_list_by_time(table_context->eit_list, &temp_eit_node);
+		if (make_room_for_event(table_context, &temp_eit_node, sizeof(EitNode) + descriptors_loop_length) == 0)
+		{
+			count_memory_refused(MEMORY_SUBSYSTEM_EIT);
+			read_position += copy_length;
+			continue;
+		}
+
+		if ((is_compaction_needed(table_context) == 1) && ((error_code = compact_section_store(table_context)) < 0))
+			return error_code;
+
+		error_code = section_store_append(&table_context->section_store, section_buffer + read_position + 12, descriptors_loop_length, &temp_eit_node.descriptor_loop);
+		if (error_code < 0)
+			return error_code;
+
+		read_position += copy_length;
+		table_context->eit_list = add_eit_node_to_list(table_context->eit_list, temp_eit_node);
+	}
+
+	return 0;
+}
+
+void set_eit_service_selection(const EitServiceSelection *selection)
+{
+	if (selection == NULL)
+	{
+		memset(&eit_service_selection, 0, sizeof(EitServiceSelection));
+		return;
+	}
+
+	eit_service_selection               = *selection;
+	eit_service_selection.service_count = MIN(selection->service_count, MAX_EIT_SELECTED_SERVICE_COUNT);
+}
+
+void init_eit_resource(Slot *slot)
+{
+	// table_id 0x40..0x7F positive, bits 0x30 negative: 0x70..0x7F are dropped, 0x40..0x4D in eit_callback
+	// bytes 7..8 service_id, 12..13 transport_stream_id, 14..15 original_network_id
+	unsigned char eit_filter_match[FILTER_MASK_LENGTH] = {0x47, 0x00, 0x12, 0x00, 0x70, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+	unsigned char eit_filter_mask[FILTER_MASK_LENGTH]  = {0xFF, 0x1F, 0xFF, 0x00, 0xF0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+	unsigned char eit_filter_mode[FILTER_MASK_LENGTH]  = {0x00, 0x00, 0x00, 0x00, 0x30, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+
+	int eit_filter_index = 0;
+	int i                = 0;
+
+	if (slot == NULL)
+	{
+		LOG("Invalid parameters, error code : %d\n", EIT_INIT_PARAM_ERROR);
+		return;
+	}
+
+	if (eit_service_selection.transport_stream_id != 0)
+	{
+		eit_filter_match[12] = eit_service_selection.transport_stream_id >> 8;
+		eit_filter_match[13] = eit_service_selection.transport_stream_id & 0xFF;
+		eit_filter_mask[12]  = 0xFF;
+		eit_filter_mask[13]  = 0xFF;
+	}
+
+	if (eit_service_selection.original_network_id != 0)
+	{
+		eit_filter_match[14] = eit_service_selection.original_network_id >> 8;
+		eit_filter_match[15] = eit_service_selection.original_network_id & 0xFF;
+		eit_filter_mask[14]  = 0xFF;
+		eit_filter_mask[15]  = 0xFF;
+	}
+
+	// one filter for present/following and schedule, actual and other
+	if (eit_service_selection.service_count == 0)
+	{
+		eit_filter_index = alloc_filter_with_mode(slot, eit_filter_match, eit_filter_mask, eit_filter_mode, EIT_CRC_CHECK, eit_callback);
+		if (eit_filter_index < 0)
+		{
+			LOG_ERROR(LOGGER_CATEGORY_EIT, "alloc_filter error, error code : %d\n", EIT_INIT_ALLOC_FILTER_ERROR);
+		}
+		return;
+	}
+
+	// and one per selected service
+	eit_filter_mask[7] = 0xFF;
+	eit_filter_mask[8] = 0xFF;
+
+	// clang-format off
+	for (i=0; i<eit_service_selection.service_count; i++)
+	{ // clang-format on
+		eit_filter_match[7] = eit_service_selection.service_id_array[i] >> 8;
+		eit_filter_match[8] = eit_service_selection.service_id_array[i] & 0xFF;
+
+		eit_filter_index = alloc_filter_with_mode(slot, eit_filter_match, eit_filter_mask, eit_filter_mode, EIT_CRC_CHECK, eit_callback);
+		if (eit_filter_index < 0)
+		{
+			LOG_ERROR(LOGGER_CATEGORY_EIT, "alloc_filter error, error code : %d\n", EIT_INIT_ALLOC_FILTER_ERROR);
+			return;
+		}
+	}
+
+	return;
+}
+
+void free_eit_resource(void)
+{
+	// does not have status
+	// and the filters of eit should be free at the end of file
+}
+
+EitList *get_eit_list(void)
+{
+	return get_table_context()->eit_list;
+}
+
+void free_eit_list(EitList *eit_list)
+{
+	EitNode *next_eit_node = NULL;
+	while (eit_list != NULL)
+	{
+		next_eit_node = eit_list->next;
+		account_eit_node(eit_list, -1);
+		free(eit_list);
+		eit_list = next_eit_node;
+	}
+
+	return;
+}
+
+void printf_eit_list(EitList *eit_list)
+{
+	EitNode                   *eit_node                = eit_list;
+	ShortEventDescriptor       short_event_descriptor  = {0};
+	ExtendedEventDescriptor    extended_descriptor     = {0};
+	TimeShiftedEventDescriptor time_shifted_descriptor = {0};
+	int                        index                   = 0;
+	char                       time_string[UTC_TIME_STRING_SIZE];
+
+	if (eit_node == NULL)
+	{
+		LOG("EIT list is empty!\n");
+		return;
+	}
+
+	LOG("========================================== EIT Information ====================================================\n");
+	LOG("EIT list:\n");
+	while (eit_node != NULL)
+	{
+		LOG("-----------------------------------------------------------------------------------------------------------\n");
+		LOG("service_id: 0x%04X | transport_stream_id: 0x%04X | original_network_id: 0x%04X | start_time: %s\n",
+		    eit_node->service_id,
+		    eit_node->transport_stream_id,
+		    eit_node->original_network_id,
+		    format_utc_time(eit_node->start_time, time_string));
+
+		LOG("event_id: 0x%04X | duration: %8u sec | running_status: %d | free_CA_mode: %d\n",
+		    eit_node->event_id,
+		    eit_node->duration,
+		    eit_node->running_status,
+		    eit_node->free_CA_mode);
+		LOG("\t---------------------------------------------------------------------------------------------------\n");
+
+		// 打印短事件描述符 (0x4D)
+		for (index = 0; get_short_event_descriptor(eit_node->descriptor_loop, index, &short_event_descriptor) == 1; index++)
+		{
+			LOG("\t[1] [Short Event] language: %c%c%c| Name: %s | Text: %s\n",
+			    (short_event_descriptor.ISO_639_language_code >> 16) & 0xFF,
+			    (short_event_descriptor.ISO_639_language_code >> 8) & 0xFF,
+			    (short_event_descriptor.ISO_639_language_code >> 0) & 0xFF,
+			    get_string(short_event_descriptor.name),
+			    get_string(short_event_descriptor.text));
+		}
+
+		// 打印扩展事件描述符 (0x4E)
+		for (index = 0; get_extended_event_descriptor(eit_node->descriptor_loop, index, &extended_descriptor) == 1; index++)
+		{
+			LOG("\t[2] [Extended Event] language: %c%c%c | Desc Num: %d/%d | Text: %s\n",
+			    (extended_descriptor.ISO_639_language_code >> 16) & 0xFF,
+			    (extended_descriptor.ISO_639_language_code >> 8) & 0xFF,
+			    (extended_descriptor.ISO_639_language_code >> 0) & 0xFF,
+			    extended_descriptor.descriptor_number,
+			    extended_descriptor.last_descriptor_number,
+			    get_string(extended_descriptor.text));
+
+			LOG("\t[2.1]item:%s\n", get_string(extended_descriptor.item));
+		}
+
+		// 打印时移事件描述符 (0x4F)
+		for (index = 0; get_time_shifted_event_descriptor(eit_node->descriptor_loop, index, &time_shifted_descriptor) == 1; index++)
+		{
+			LOG("\t[3] [Time Shifted] reference_service_id: 0x%04X | reference_event_idt: 0x%04X\n",
+			    time_shifted_descriptor.reference_service_id,
+			    time_shifted_descriptor.reference_event_id);
+		}
+
+		eit_node = eit_node->next;
+	}
+
+	DOUBLE_LINE
+}
@@ -1,96 +1,147 @@
-/*
- * @file get_eit_info.h
- *
- * @author :Yujin Yu
- * @date   :2025.04.16
- */
-#ifndef GET_EIT_INFO_H
-#define GET_EIT_INFO_H
-
-#define EIT_PID           0x0012
-#define EIT_HEADER_LENGTH 14
-#define EIT_CRC_CHECK     1
-#define EIT_CRC_LENGTH    4
-
-#define MAX_DESCRIPTOR_STRING_LENGTH 256
-
-//---------------------------------------------------------------------0x4D
-typedef struct ShortEventDescriptorNode
-{
-	unsigned int ISO_639_language_code; // 24
-	char         name[MAX_DESCRIPTOR_STRING_LENGTH];
-	char         text[MAX_DESCRIPTOR_STRING_LENGTH];
-
-	struct ShortEventDescriptorNode *next;
-} ShortEventDescriptorNode, ShortEventDescriptorList;
-
-//---------------------------------------------------------------------0x4E
-typedef struct ExtendedEventDescriptorNode
-{
-	unsigned char descriptor_number;      // 4
-	unsigned char last_descriptor_number; // 4
-	unsigned int  ISO_639_language_code;  // 24
-	unsigned char item[MAX_DESCRIPTOR_STRING_LENGTH];
-	unsigned char text[MAX_DESCRIPTOR_STRING_LENGTH];
-
-	struct ExtendedEventDescriptorNode *next;
-} ExtendedEventDescriptorNode, ExtendedEventDescriptorList;
-
-//---------------------------------------------------------------------0x4F
-typedef struct TimeShiftedEventDescriptorNode
-{
-	unsigned char  descriptor_length;    // 8
-	unsigned short reference_service_id; // 16
-	unsigned short reference_event_id;   // 16
-
-	struct TimeShiftedEventDescriptorNode *next;
-} TimeShiftedEventDescriptorNode, TimeShiftedEventDescriptorList;
-
-//---------------------------------------------------------------------EitNode
-typedef struct EitNode
-{
-	unsigned short service_id;                  // 16
-	unsigned short transport_stream_id;         // 16
-	unsigned short original_network_id;         // 16
-	unsigned char  segment_last_section_number; // 8
-	unsigned char  last_table_id;               // 8
-
-	// loop
-	unsigned short event_id;       // 16
-	unsigned long  start_time;     // 40
-	unsigned int   duration;       // 24
-	unsigned char  running_status; // 3
-	unsigned char  free_CA_mode;   // 1
-
-	// descriptor of loop
-	ShortEventDescriptorList       *short_event_descriptor_list;        // 0x4D
-	ExtendedEventDescriptorList    *extended_event_descriptor_list;     // 0x4E
-	TimeShiftedEventDescriptorList *time_shifted_event_descriptor_list; // 0x4F
-
-	struct EitNode *next;
-} EitNode, EitList;
-
-//--------------------------------------------------------------------------------------------
-// Function declaration
-//--------------------------------------------------------------------------------------------
-int eit_callback(Slot *slot, int filter_index, unsigned char *section_buffer, unsigned short pid);
-
-void init_eit_resource(Slot *slot);
-void free_eit_resource(void);
-
-EitList *get_eit_list(void);
-void     printf_eit_list(EitList *eit_list);
-void     free_eit_list(EitList *eit_list);
-
-ShortEventDescriptorList       *add_short_event_descriptor_node_to_list(ShortEventDescriptorList *short_event_descriptor_list,
-                                                                        ShortEventDescriptorNode  temp_short_event_descriptor_node);
-ExtendedEventDescriptorList    *add_extended_event_descriptor_node_list(ExtendedEventDescriptorList *extended_event_descriptor_list,
-                                                                        ExtendedEventDescriptorNode  temp_extended_event_descriptor_node);
-TimeShiftedEventDescriptorList *add_time_shifted_event_descriptor_node_list(TimeShiftedEventDescriptorList *time_shifted_event_descriptor_list,
-                                                                            TimeShiftedEventDescriptorNode  temp_time_shifted_event_descriptor_node);
-
-void free_short_event_descriptor_list(ShortEventDescriptorList *short_event_descriptor_list);
-void free_extended_event_descriptor_list(ExtendedEventDescriptorList *extended_event_descriptor_list);
-void free_time_shifted_event_descriptor_list(TimeShiftedEventDescriptorList *time_shifted_event_descriptor_list);
-
+/*
+ * @file get_eit_info.h
+ *
+ * @author :Yujin Yu
+ * @date   :2025.04.16
+ */
+#ifndef GET_EIT_INFO_H
+#define GET_EIT_INFO_H
+
+#define EIT_PID           0x0012
+#define EIT_HEADER_LENGTH 14
+#define EIT_CRC_CHECK     1
+#define EIT_CRC_LENGTH    4
+#define EIT_TABLE_ID_MIN  0x4E // present/following actual
+#define EIT_TABLE_ID_MAX  0x6F // last schedule other
+
+#define MAX_EIT_SELECTED_SERVICE_COUNT 16 // one filter per selected service
+
+#define MJD_UNIX_EPOCH       40587 // 1970-01-01
+#define EIT_UNDEFINED_TIME   0     // start_time or duration coded as all ones, or not valid BCD
+#define UTC_TIME_STRING_SIZE 20    // "YYYY-MM-DD HH:MM:SS"
+
+//---------------------------------------------------------------------0x4D
+#define SHORT_EVENT_DESCRIPTOR_TAG        0x4D
+#define EXTENDED_EVENT_DESCRIPTOR_TAG     0x4E
+#define TIME_SHIFTED_EVENT_DESCRIPTOR_TAG 0x4F
+
+// Descriptors are decoded on access from the descriptor loop of an event,
+// their text is decoded to UTF-8 and interned in the string pool of the current table context
+typedef struct
+{
+	unsigned int ISO_639_language_code; // 24
+	StringHandle name;
+	StringHandle text;
+} ShortEventDescriptor;
+
+//---------------------------------------------------------------------0x4E
+typedef struct
+{
+	unsigned char descriptor_number;      // 4
+	unsigned char last_descriptor_number; // 4
+	unsigned int  ISO_639_language_code;  // 24
+	StringHandle  item;
+	StringHandle  text;
+} ExtendedEventDescriptor;
+
+//---------------------------------------------------------------------0x4F
+typedef struct
+{
+	unsigned short reference_service_id; // 16
+	unsigned short reference_event_id;   // 16
+} TimeShiftedEventDescriptor;
+
+//---------------------------------------------------------------------EitNode
+typedef struct EitNode
+{
+	unsigned short service_id;                  // 16
+	unsigned short transport_stream_id;         // 16
+	unsigned short original_network_id;         // 16
+	unsigned char  segment_last_section_number; // 8
+	unsigned char  last_table_id;               // 8
+
+	// loop
+	unsigned short event_id;       // 16
+	unsigned long  start_time;     // 40, MJD + BCD in the section, UTC epoch seconds here
+	unsigned int   duration;       // 24, BCD in the section, seconds here
+	unsigned char  running_status; // 3
+	unsigned char  free_CA_mode;   // 1
+
+	DescriptorLoop descriptor_loop; // 0x4D, 0x4E, 0x4F ... in the section store
+
+	struct EitNode *next;
+} EitNode, EitList;
+
+// Services whose EIT is acquired, everything else is dropped by the filter bank, or by eit_callback when the header straddles two packets
+typedef struct
+{
+	unsigned short original_network_id; // 0: any network
+	unsigned short transport_stream_id; // 0: any transport stream
+	int            service_count;       // 0: every service
+	unsigned short service_id_array[MAX_EIT_SELECTED_SERVICE_COUNT];
+} EitServiceSelection;
+
+//--------------------------------------------------------------------------------------------
+// Function declaration
+//--------------------------------------------------------------------------------------------
+/**
+ * @brief Restrict the EIT filters installed by the following init_eit_resource calls
+ *
+ * @param selection Services to keep, NULL acquires the EIT of every service again
+ */
+void set_eit_service_selection(const EitServiceSelection *selection);
+
+int eit_callback(Slot *slot, int filter_index, unsigned char *section_buffer, unsigned short pid);
+
+void init_eit_resource(Slot *slot);
+void free_eit_resource(void);
+
+EitList *get_eit_list(void);
+void     printf_eit_list(EitList *eit_list);
+void     free_eit_list(EitList *eit_list);
+
+/**
+ * @brief Add an event and its descriptors to the memory account, or take them out with sign -1
+ *
+ * The descriptor loop is read from the section store of the current table context.
+ */
+void account_eit_node(const EitNode *eit_node, int sign);
+
+/**
+ * @brief Decode a 40 bit MJD + BCD UTC time (EN 300 468 Annex C)
+ *
+ * @param buffer 5 bytes, MJD 16 bits then hour, minute and second in BCD
+ *
+ * @return UTC seconds since 1970-01-01, EIT_UNDEFINED_TIME if undefined or not valid BCD
+ */
+unsigned long decode_utc_time(const unsigned char *buffer);
+
+/**
+ * @brief Decode a 24 bit BCD duration hhmmss
+ *
+ * @return seconds, EIT_UNDEFINED_TIME if undefined or not valid BCD
+ */
+unsigned int decode_bcd_duration(const unsigned char *buffer);
+
+/**
+ * @brief Format UTC seconds as "YYYY-MM-DD HH:MM:SS" into a buffer of UTC_TIME_STRING_SIZE bytes
+ *
+ * @return string
+ */
+char *format_utc_time(unsigned long utc_time, char *string);
+
+/**
+ * @brief Decode the index-th descriptor of its kind from the descriptor loop of an event
+ *
+ * @param descriptor_loop EitNode.descriptor_loop or EventDataNode.descriptor_loop of the current table context
+ * @param index           0 for the first descriptor of this kind
+ * @param descriptor      Output
+ *
+ * @return 1: decoded
+ *         0: no such descriptor
+ */
+int get_short_event_descriptor(DescriptorLoop descriptor_loop, int index, ShortEventDescriptor *descriptor);
+int get_extended_event_descriptor(DescriptorLoop descriptor_loop, int index, ExtendedEventDescriptor *descriptor);
+int get_time_shifted_event_descriptor(DescriptorLoop descriptor_loop, int index, TimeShiftedEventDescriptor *descriptor);
+
 #endif
\ No newline at end of file
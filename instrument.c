@@ -0,0 +1,240 @@
+/**
+ * @file instrument.c
+ *
+ * @author :Yujin Yu
+ * @date   :2025.05.28
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <time.h>
+#include <pthread.h>
+#include "ts_global.h"
+#include "instrument.h"
+#include "memory_account.h"
+
+static const char *table_name_array[INSTRUMENT_TABLE_COUNT] = {"pat", "pmt", "sdt", "eit_pf", "eit_schedule", "other"};
+
+const char *get_instrument_table_name(int table_type)
+{
+	return ((table_type >= 0) && (table_type < INSTRUMENT_TABLE_COUNT)) ? table_name_array[table_type] : "unknown";
+}
+
+#if ENABLE_INSTRUMENT
+
+__thread InstrumentCounters *instrument_counters          = NULL;
+volatile sig_atomic_t        is_instrument_dump_requested = 0;
+
+static pthread_mutex_t     instrument_mutex                             = PTHREAD_MUTEX_INITIALIZER;
+static InstrumentCounters *instrument_counters_list                     = NULL;
+static int                 instrument_thread_count                      = 0;
+static char                instrument_file_name[INSTRUMENT_PATH_LENGTH] = {0};
+static unsigned long long  start_ticks                                  = 0; // ticks and ns at init_instrument, for the tick rate
+static unsigned long long  start_ns                                     = 0;
+
+static const char *timer_name_array[INSTRUMENT_TIMER_COUNT] = {"io", "dispatch", "crc"};
+
+//--------------------------------------------------------------------------------------------
+unsigned long long get_instrument_clock_ticks(void)
+{
+	struct timespec now = {0};
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (unsigned long long)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+InstrumentCounters *register_instrument_thread(void)
+{
+	static InstrumentCounters fallback_counters; // counted into when calloc fails, never dumped
+
+	InstrumentCounters *counters = (InstrumentCounters *)calloc(1, sizeof(InstrumentCounters));
+
+	if (counters == NULL)
+		return &fallback_counters;
+
+	pthread_mutex_lock(&instrument_mutex);
+	counters->thread_index   = instrument_thread_count++;
+	counters->next           = instrument_counters_list;
+	instrument_counters_list = counters;
+	pthread_mutex_unlock(&instrument_mutex);
+
+	instrument_counters = counters;
+	return counters;
+}
+
+// ns per tick, measured over the time since init_instrument, or over a short wait if that is too short
+static double get_ns_per_tick(void)
+{
+	struct timespec    wait_time     = {0, 5000000};
+	unsigned long long first_ticks   = start_ticks;
+	unsigned long long first_ns      = start_ns;
+	unsigned long long elapsed_ticks = 0;
+	unsigned long long elapsed_ns    = 0;
+
+#if !defined(__x86_64__) && !defined(__i386__)
+	return 1.0;
+#endif
+
+	if ((first_ns == 0) || (get_instrument_clock_ticks() - first_ns < 1000000))
+	{
+		first_ticks = get_instrument_ticks();
+		first_ns    = get_instrument_clock_ticks();
+		nanosleep(&wait_time, NULL);
+	}
+
+	elapsed_ticks = get_instrument_ticks() - first_ticks;
+	elapsed_ns    = get_instrument_clock_ticks() - first_ns;
+	return (elapsed_ticks == 0) ? 1.0 : (double)elapsed_ns / elapsed_ticks;
+}
+
+static void add_timer(InstrumentTimer *total, const InstrumentTimer *timer)
+{
+	total->count += timer->count;
+	total->ticks += timer->ticks;
+	total->max_ticks = MAX(total->max_ticks, timer->max_ticks);
+}
+
+static void add_counters(InstrumentCounters *total, const InstrumentCounters *counters)
+{
+	int i = 0;
+
+	total->packet_count += counters->packet_count;
+	total->filter_hit_count += counters->filter_hit_count;
+	total->section_count += counters->section_count;
+	total->crc_error_count += counters->crc_error_count;
+	total->duplicate_packet_count += counters->duplicate_packet_count;
+	total->repeated_section_count += counters->repeated_section_count;
+	total->unchanged_event_count += counters->unchanged_event_count;
+
+	// clang-format off
+	for (i=0; i<INSTRUMENT_TABLE_COUNT; i++)
+	{ // clang-format on
+		add_timer(&total->callback_timer_array[i], &counters->callback_timer_array[i]);
+	}
+	// clang-format off
+	for (i=0; i<INSTRUMENT_TIMER_COUNT; i++)
+	{ // clang-format on
+		add_timer(&total->timer_array[i], &counters->timer_array[i]);
+	}
+}
+
+static void write_timer_json(FILE *output_fp, const char *name, const InstrumentTimer *timer, double ns_per_tick, int is_last)
+{
+	fprintf(output_fp, "\"%s\": {\"count\": %llu, \"total_ns\": %.0f, \"mean_ns\": %.1f, \"max_ns\": %.0f}%s", name, timer->count, timer->ticks * ns_per_tick,
+	        (timer->count == 0) ? 0.0 : timer->ticks * ns_per_tick / timer->count, timer->max_ticks * ns_per_tick, (is_last == 1) ? "" : ", ");
+}
+
+static void write_counters_json(FILE *output_fp, const InstrumentCounters *counters, double ns_per_tick, const char *indent)
+{
+	int i = 0;
+
+	fprintf(output_fp, "%s\"packets\": %llu, \"filter_hits\": %llu, \"sections\": %llu, \"crc_errors\": %llu,\n", indent, counters->packet_count,
+	        counters->filter_hit_count, counters->section_count, counters->crc_error_count);
+	fprintf(output_fp, "%s\"duplicate_packets\": %llu, \"repeated_sections\": %llu, \"unchanged_events\": %llu,\n", indent, counters->duplicate_packet_count,
+	        counters->repeated_section_count, counters->unchanged_event_count);
+
+	fprintf(output_fp, "%s\"timers\": {", indent);
+	// clang-format off
+	for (i=0; i<INSTRUMENT_TIMER_COUNT; i++)
+	{ // clang-format on
+		write_timer_json(output_fp, timer_name_array[i], &counters->timer_array[i], ns_per_tick, i == INSTRUMENT_TIMER_COUNT - 1);
+	}
+	fprintf(output_fp, "},\n%s\"callbacks\": {", indent);
+	// clang-format off
+	for (i=0; i<INSTRUMENT_TABLE_COUNT; i++)
+	{ // clang-format on
+		write_timer_json(output_fp, table_name_array[i], &counters->callback_timer_array[i], ns_per_tick, i == INSTRUMENT_TABLE_COUNT - 1);
+	}
+	fprintf(output_fp, "}");
+}
+
+void write_instrument_json(FILE *output_fp)
+{
+	InstrumentCounters  total       = {0};
+	InstrumentCounters *counters    = NULL;
+	double              ns_per_tick = get_ns_per_tick();
+
+	// the counters are read while their threads go on, each value is exact but they may be a few packets apart
+	pthread_mutex_lock(&instrument_mutex);
+	fprintf(output_fp, "{\n  \"ns_per_tick\": %.6f,\n  \"threads\": [\n", ns_per_tick);
+	for (counters = instrument_counters_list; counters != NULL; counters = counters->next)
+	{
+		add_counters(&total, counters);
+		fprintf(output_fp, "    {\"thread\": %d,\n", counters->thread_index);
+		write_counters_json(output_fp, counters, ns_per_tick, "     ");
+		fprintf(output_fp, "}%s\n", (counters->next != NULL) ? "," : "");
+	}
+	pthread_mutex_unlock(&instrument_mutex);
+
+	fprintf(output_fp, "  ],\n  \"total\": {\n");
+	write_counters_json(output_fp, &total, ns_per_tick, "    ");
+	fprintf(output_fp, "\n  },\n  \"memory\": ");
+	write_memory_json(output_fp, "  ");
+	fprintf(output_fp, "\n}\n");
+}
+
+void dump_instrument(void)
+{
+	FILE *output_fp = NULL;
+
+	is_instrument_dump_requested = 0;
+	if (instrument_file_name[0] == '\0')
+		return;
+
+	if ((output_fp = fopen(instrument_file_name, "w")) == NULL)
+	{
+		LOG("open %s fail, error code : %d\n", instrument_file_name, INSTRUMENT_OPEN_ERROR);
+		return;
+	}
+	write_instrument_json(output_fp);
+	fclose(output_fp);
+}
+
+static void request_instrument_dump(int signal_number)
+{
+	(void)signal_number;
+	is_instrument_dump_requested = 1;
+}
+
+int init_instrument(const char *file_name)
+{
+	struct sigaction action = {0};
+
+	if ((file_name == NULL) || (file_name[0] == '\0') || (strlen(file_name) >= INSTRUMENT_PATH_LENGTH))
+	{
+		return INSTRUMENT_PARAM_ERROR;
+	}
+
+	snprintf(instrument_file_name, sizeof(instrument_file_name), "%s", file_name);
+	start_ticks = get_instrument_ticks();
+	start_ns    = get_instrument_clock_ticks();
+
+	action.sa_handler = request_instrument_dump;
+	action.sa_flags   = SA_RESTART;
+	sigemptyset(&action.sa_mask);
+	sigaction(SIGUSR1, &action, NULL);
+
+	atexit(dump_instrument);
+	return 0;
+}
+
+#else
+
+int init_instrument(const char *file_name)
+{
+	(void)file_name;
+	LOG("built with ENABLE_INSTRUMENT 0, no counters to dump\n");
+	return INSTRUMENT_DISABLED_ERROR;
+}
+
+void write_instrument_json(FILE *output_fp)
+{
+	// the memory account does not depend on ENABLE_INSTRUMENT
+	fprintf(output_fp, "{\n  \"memory\": ");
+	write_memory_json(output_fp, "  ");
+	fprintf(output_fp, "\n}\n");
+}
+
+#endif
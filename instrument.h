@@ -0,0 +1,151 @@
+/**
+ * @file instrument.h
+ *
+ * @brief Counters and timers of the demux hot path. Every thread counts into a block of its own, the blocks
+ *        are only summed when the JSON dump is written (at exit, or on SIGUSR1 while running). Building with
+ *        ENABLE_INSTRUMENT 0 turns every INSTRUMENT_ macro into nothing. Include <signal.h> first.
+ *
+ * @author :Yujin Yu
+ * @date   :2025.05.28
+ */
+#ifndef INSTRUMENT_H
+#define INSTRUMENT_H
+
+//--------------------------------------------------------------------------------------------
+// macro definition
+//--------------------------------------------------------------------------------------------
+#ifndef ENABLE_INSTRUMENT
+#define ENABLE_INSTRUMENT 1 // 1 counters and timers built in, 0 compiled out
+#endif
+
+#define INSTRUMENT_PATH_LENGTH 512
+
+// Tables a section is counted under, by table_id
+enum
+{
+	INSTRUMENT_TABLE_PAT = 0,
+	INSTRUMENT_TABLE_PMT,
+	INSTRUMENT_TABLE_SDT,
+	INSTRUMENT_TABLE_EIT_PF,       // 0x4E, 0x4F
+	INSTRUMENT_TABLE_EIT_SCHEDULE, // 0x50..0x6F
+	INSTRUMENT_TABLE_OTHER,
+	INSTRUMENT_TABLE_COUNT,
+};
+
+enum
+{
+	INSTRUMENT_TIMER_IO = 0,   // fread of section_filter, recvmmsg of the UDP input
+	INSTRUMENT_TIMER_DISPATCH, // filter_ts_packets, the section callbacks included
+	INSTRUMENT_TIMER_CRC,
+	INSTRUMENT_TIMER_COUNT,
+};
+
+typedef struct
+{
+	unsigned long long count;
+	unsigned long long ticks;
+	unsigned long long max_ticks;
+} InstrumentTimer;
+
+// One per thread, never freed so the dump still sees threads that have ended
+typedef struct InstrumentCounters
+{
+	unsigned long long packet_count;           // packets read
+	unsigned long long filter_hit_count;       // packets whose header matched a filter
+	unsigned long long section_count;          // sections assembled, before the CRC check
+	unsigned long long crc_error_count;
+	unsigned long long duplicate_packet_count; // same continuity counter twice, the packet is dropped
+	unsigned long long repeated_section_count; // section already seen in this version, dropped by the callback
+	unsigned long long unchanged_event_count;  // EIT event already stored unchanged
+
+	InstrumentTimer timer_array[INSTRUMENT_TIMER_COUNT];
+	InstrumentTimer callback_timer_array[INSTRUMENT_TABLE_COUNT]; // count is the number of callbacks of the table type
+
+	int                        thread_index;
+	struct InstrumentCounters *next;
+} InstrumentCounters;
+
+static inline int get_instrument_table_type(unsigned char table_id)
+{
+	if (table_id == 0x00)
+		return INSTRUMENT_TABLE_PAT;
+	if (table_id == 0x02)
+		return INSTRUMENT_TABLE_PMT;
+	if ((table_id == 0x42) || (table_id == 0x46))
+		return INSTRUMENT_TABLE_SDT;
+	if ((table_id == 0x4E) || (table_id == 0x4F))
+		return INSTRUMENT_TABLE_EIT_PF;
+	if ((table_id >= 0x50) && (table_id <= 0x6F))
+		return INSTRUMENT_TABLE_EIT_SCHEDULE;
+	return INSTRUMENT_TABLE_OTHER;
+}
+
+const char *get_instrument_table_name(int table_type); // "pat", "pmt", "sdt", "eit_pf", "eit_schedule", "other"
+
+#if ENABLE_INSTRUMENT
+extern __thread InstrumentCounters *instrument_counters;
+extern volatile sig_atomic_t        is_instrument_dump_requested; // set by the SIGUSR1 handler
+
+InstrumentCounters *register_instrument_thread(void);
+unsigned long long  get_instrument_clock_ticks(void);
+void                dump_instrument(void);
+
+// rdtsc where there is one, converted to ns with the rate measured since init_instrument
+static inline unsigned long long get_instrument_ticks(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	return __builtin_ia32_rdtsc();
+#else
+	return get_instrument_clock_ticks();
+#endif
+}
+
+static inline void add_instrument_time(InstrumentTimer *timer, unsigned long long start_ticks)
+{
+	unsigned long long ticks = get_instrument_ticks() - start_ticks;
+
+	timer->count++;
+	timer->ticks += ticks;
+	if (ticks > timer->max_ticks)
+		timer->max_ticks = ticks;
+}
+
+#define INSTRUMENT_COUNTERS ((instrument_counters != NULL) ? instrument_counters : register_instrument_thread())
+
+#define INSTRUMENT_COUNT(field, n)              (INSTRUMENT_COUNTERS->field += (n))
+#define INSTRUMENT_DECLARE_TIMER(start)         unsigned long long start = 0
+#define INSTRUMENT_DECLARE_TABLE_TYPE(name, id) int name = get_instrument_table_type(id)
+#define INSTRUMENT_START(start)                 ((start) = get_instrument_ticks())
+#define INSTRUMENT_STOP(timer_index, start)     add_instrument_time(&INSTRUMENT_COUNTERS->timer_array[timer_index], (start))
+#define INSTRUMENT_CALLBACK(table_type, start)  add_instrument_time(&INSTRUMENT_COUNTERS->callback_timer_array[table_type], (start))
+#define INSTRUMENT_POLL()                       ((is_instrument_dump_requested != 0) ? dump_instrument() : (void)0)
+#else
+#define INSTRUMENT_COUNT(field, n)
+#define INSTRUMENT_DECLARE_TIMER(start)
+#define INSTRUMENT_DECLARE_TABLE_TYPE(name, id)
+#define INSTRUMENT_START(start)
+#define INSTRUMENT_STOP(timer_index, start)
+#define INSTRUMENT_CALLBACK(table_type, start)
+#define INSTRUMENT_POLL()
+#endif
+
+//--------------------------------------------------------------------------------------------
+// Function declaration
+//--------------------------------------------------------------------------------------------
+
+/**
+ * @brief Dump the counters to file_name at exit and whenever SIGUSR1 arrives, the file is replaced each time
+ *
+ * The signal only sets a flag, the dump is written by the thread that next feeds a slot.
+ *
+ * @return 0: successful
+ *         <0: error code
+ */
+int init_instrument(const char *file_name);
+
+/**
+ * @brief Write the counters of every thread, their sum and the memory account as JSON
+ */
+void write_instrument_json(FILE *output_fp);
+
+#endif
@@ -1,581 +1,670 @@
-/*
- * @file get_eit_info.c
- *
- * @author :Yujin Yu
- * @date   :2025.04.16
- */
-#include <stdio.h>
-#include <stdlib.h>
-#include <string.h>
-#include "ts_global.h"
-#include "slot_filter.h"
-#include "get_pat_info.h"
-#include "get_pmt_info.h"
-#include "get_sdt_info.h"
-#include "get_eit_info.h"
-#include "integrate_data.h"
-
-static EventDataList *add_event_data_node_to_list(EventDataList *event_data_list, EventDataNode temp_event_data_node)
-{
-	EventDataNode *new_node = (EventDataNode *)malloc(sizeof(EventDataNode));
-	if (new_node == NULL)
-	{
-		LOG("malloc failed for new_node\n");
-		return event_data_list;
-	}
-
-	memcpy(new_node, &temp_event_data_node, sizeof(EventDataNode));
-	new_node->next = NULL;
-
-	if (event_data_list == NULL || new_node->start_time < event_data_list->start_time)
-	{
-		new_node->next = event_data_list;
-		return new_node;
-	}
-
-	EventDataNode *current = event_data_list;
-	while (current->next != NULL && current->next->start_time < new_node->start_time)
-	{
-		current = current->next;
-	}
-
-	new_node->next = current->next;
-	current->next  = new_node;
-
-	return event_data_list;
-}
-
-static ProgramInfoList *add_program_info_node_to_list(ProgramInfoList *program_info_list, ProgramInfoNode temp_program_info_node)
-{
-	ProgramInfoNode *new_node = (ProgramInfoNode *)malloc(sizeof(ProgramInfoNode));
-	if (new_node == NULL)
-	{
-		LOG("new_node is null\n");
-		return program_info_list;
-	}
-
-	memcpy(new_node, &temp_program_info_node, sizeof(ProgramInfoNode));
-	new_node->prev = NULL;
-	new_node->next = NULL;
-
-	if (program_info_list == NULL)
-	{
-		return new_node;
-	}
-
-	ProgramInfoNode *current = program_info_list;
-	ProgramInfoNode *prev    = NULL;
-
-	while (current != NULL && current->program_number < new_node->program_number)
-	{
-		prev    = current;
-		current = current->next;
-	}
-
-	if (prev == NULL)
-	{
-		new_node->next          = program_info_list;
-		program_info_list->prev = new_node;
-		return new_node;
-	}
-	else
-	{
-		prev->next     = new_node;
-		new_node->prev = prev;
-		new_node->next = current;
-		if (current != NULL)
-		{
-			current->prev = new_node;
-		}
-		return program_info_list;
-	}
-}
-
-static PmtNode *find_node_in_pmt_list_by_program_number(PmtList *pmt_list, unsigned short program_number)
-{
-	PmtNode *current_pmt_node = pmt_list;
-	while (current_pmt_node != NULL)
-	{
-		if (current_pmt_node->program_number == program_number)
-		{
-			return current_pmt_node;
-		}
-		current_pmt_node = current_pmt_node->next;
-	}
-	return NULL;
-}
-
-static int is_target_stream_type(unsigned char stream_type)
-{
-	switch (stream_type)
-	{
-	// Video stream
-	case 0x01: // MPEG-1 Video
-	case 0x02: // MPEG-2 Video
-	case 0x1B: // H.264  Video
-	case 0x24: // H.265  Video
-		return 1;
-
-	// Audio stream
-	case 0x03: // MPEG-1 Audio
-	case 0x04: // MPEG-2 Audio
-	case 0x0F: // AAC    Audio
-	case 0x80: // PCM    Audio
-	case 0x81: // AC-3   Audio
-	case 0x82: // DTS    Audio
-	case 0x83: // TrueHD Audio
-	case 0x84: // E-AC-3 Audio
-	case 0x86: // DTS-HD Master Audio
-		return 1;
-
-	// Subtitle stream
-	case 0x90: // PGS  Subtitle
-	case 0x92: // Text Subtitle
-		return 1;
-
-	// Metadata stream
-	case 0x05: // MPEG-2 Private Sections
-	case 0x06: // PES Private Data
-	case 0x0D: // MPEG-4 SL
-	case 0x11: // LATM AAC Audio
-	case 0x1C: // MPEG-4 Video
-		return 1;
-
-		// 0x81-0x8F User private stream
-
-	default:
-		return 0;
-	}
-}
-
-// by pmt and pat
-static ProgramInfoList *init_program_info_list(ProgramInfoList *program_info_list, PatList *pat_list)
-{
-	PatNode        *pat_node               = NULL;
-	ProgramInfoNode temp_program_info_node = {0};
-
-	PmtList   *pmt_list    = NULL;
-	PmtNode   *pmt_node    = NULL;
-	PmtESNode *pmt_es_node = NULL;
-
-	pmt_list = get_pmt_list();
-	if (pmt_list == NULL)
-	{
-		LOG("pmt_list is null\n");
-		return NULL;
-	}
-	// printf_pmt_list(pmt_list);
-
-	pat_node = pat_list;
-	while (pat_node != NULL)
-	{
-		pmt_node = find_node_in_pmt_list_by_program_number(pmt_list, pat_node->program_number);
-		if (pmt_node != NULL)
-		{
-			memset(&temp_program_info_node, 0, sizeof(ProgramInfoNode));
-
-			temp_program_info_node.program_number      = pat_node->program_number;
-			temp_program_info_node.transport_stream_id = pat_node->transport_stream_id;
-			temp_program_info_node.pcr_pid             = pmt_node->pcr_pid;
-
-			pmt_es_node = pmt_node->es_info_list;
-			while (pmt_es_node != NULL)
-			{
-				if (is_target_stream_type(pmt_es_node->stream_type) == 1)
-				{
-					temp_program_info_node.es_info_list = add_pmt_es_node_to_list(temp_program_info_node.es_info_list, *pmt_es_node);
-				}
-
-				pmt_es_node = pmt_es_node->next;
-			}
-
-			program_info_list = add_program_info_node_to_list(program_info_list, temp_program_info_node);
-		}
-
-		pat_node = pat_node->next;
-	}
-
-	free_pmt_list(pmt_list);
-
-	return program_info_list;
-}
-
-static int add_sdt_info_to_program_info_list(ProgramInfoList *program_info_list)
-{
-	SdtList         *sdt_list                  = NULL;
-	ProgramInfoNode *current_program_info_node = NULL;
-	SdtNode         *current_sdt_node          = NULL;
-
-	sdt_list = get_sdt_list();
-	if (sdt_list == NULL)
-	{
-		LOG("sdt_list is null\n");
-		return -1;
-	}
-	// printf_sdt_list(sdt_list);
-
-	current_sdt_node = sdt_list;
-	while (current_sdt_node != NULL)
-	{
-		current_program_info_node = program_info_list;
-		while (current_program_info_node != NULL)
-		{
-			if ((current_program_info_node->program_number == current_sdt_node->service_id) &&
-			    (current_program_info_node->transport_stream_id == current_sdt_node->transport_stream_id) &&
-			    (current_sdt_node->table_id == 0x42))
-			{
-				break;
-			}
-
-			current_program_info_node = current_program_info_node->next;
-		}
-
-		if (current_program_info_node != NULL)
-		{
-			current_program_info_node->original_network_id = current_sdt_node->original_network_id;
-			current_program_info_node->service_type        = current_sdt_node->service_descriptor_list->service_type;
-
-			memcpy(current_program_info_node->service_provider_name,
-			       current_sdt_node->service_descriptor_list->service_provider_name,
-			       sizeof(current_program_info_node->service_provider_name));
-
-			memcpy(current_program_info_node->service_name,
-			       current_sdt_node->service_descriptor_list->service_name,
-			       sizeof(current_program_info_node->service_name));
-		}
-
-		current_sdt_node = current_sdt_node->next;
-	}
-
-	free_sdt_list(sdt_list);
-
-	return 0;
-}
-
-static int is_unmodified(const char *str, int size)
-{
-	int i = 0;
-
-	// clang-format off
-	for (i=0; i<size; i++)
-	{ // clang-format on
-		if (str[i] != 0)
-		{
-			return 0;
-		}
-	}
-	return 1;
-}
-
-// for those services which have no sdt info
-static void add_infomation_to_program_info_list(ProgramInfoList *program_info_list)
-{
-	ProgramInfoNode *current_program_info_node = program_info_list;
-
-	int null_service_provider_name_count = 0;
-	int null_service_name_count          = 0;
-
-	while (current_program_info_node != NULL)
-	{
-		if (is_unmodified(current_program_info_node->service_provider_name, MAX_NAME_LENGTH))
-		{
-			null_service_provider_name_count++;
-			snprintf(current_program_info_node->service_provider_name, MAX_NAME_LENGTH, "provider_name_%d", null_service_provider_name_count);
-			LOG("service_provider_name:%s\n", current_program_info_node->service_provider_name);
-		}
-		if (is_unmodified(current_program_info_node->service_name, MAX_NAME_LENGTH))
-		{
-			null_service_name_count++;
-			snprintf(current_program_info_node->service_name, MAX_NAME_LENGTH, "service_name_%d", null_service_name_count);
-			LOG("service_name:%s\n", current_program_info_node->service_name);
-		}
-		current_program_info_node = current_program_info_node->next;
-	}
-
-	return;
-}
-
-static int add_eit_info_to_program_info_list(ProgramInfoList *program_info_list)
-{
-	EitList         *eit_list                  = NULL;
-	ProgramInfoNode *current_program_info_node = NULL;
-	EventDataNode    temp_event_data_node      = {0};
-
-	EitNode                        *eit_node                           = NULL;
-	ShortEventDescriptorNode       *short_event_descriptor_node        = NULL;
-	ExtendedEventDescriptorNode    *extended_event_descriptor_node     = NULL;
-	TimeShiftedEventDescriptorNode *time_shifted_event_descriptor_node = NULL;
-
-	eit_list = get_eit_list();
-	if (eit_list == NULL)
-	{
-		LOG("eit_list is null\n");
-		return -1;
-	}
-	// printf_eit_list(eit_list);
-
-	eit_node = eit_list;
-	while (eit_node != NULL)
-	{
-		current_program_info_node = program_info_list;
-		while (current_program_info_node != NULL)
-		{
-			if ((current_program_info_node->program_number == eit_node->service_id) &&
-			    (current_program_info_node->transport_stream_id == eit_node->transport_stream_id) &&
-			    (current_program_info_node->original_network_id == eit_node->original_network_id))
-			{
-				break;
-			}
-			current_program_info_node = current_program_info_node->next;
-		}
-
-		if (current_program_info_node != NULL)
-		{
-			memset(&temp_event_data_node, 0, sizeof(EventDataNode));
-
-			temp_event_data_node.event_id   = eit_node->event_id;
-			temp_event_data_node.start_time = eit_node->start_time;
-			temp_event_data_node.duration   = eit_node->duration;
-
-			short_event_descriptor_node = eit_node->short_event_descriptor_list;
-			while (short_event_descriptor_node != NULL)
-			{
-				if (strncmp(current_program_info_node->service_name, short_event_descriptor_node->name, 3) == 0)
-				{
-					temp_event_data_node.short_event_descriptor_list = add_short_event_descriptor_node_to_list(
-					    temp_event_data_node.short_event_descriptor_list, *short_event_descriptor_node);
-				}
-				short_event_descriptor_node = short_event_descriptor_node->next;
-			}
-
-			extended_event_descriptor_node = eit_node->extended_event_descriptor_list;
-			while (extended_event_descriptor_node != NULL)
-			{
-				temp_event_data_node.extended_event_descriptor_list = add_extended_event_descriptor_node_list(
-				    temp_event_data_node.extended_event_descriptor_list, *extended_event_descriptor_node);
-
-				extended_event_descriptor_node = extended_event_descriptor_node->next;
-			}
-
-			time_shifted_event_descriptor_node = eit_node->time_shifted_event_descriptor_list;
-			while (time_shifted_event_descriptor_node != NULL)
-			{
-				temp_event_data_node.time_shifted_event_descriptor_list = add_time_shifted_event_descriptor_node_list(
-				    temp_event_data_node.time_shifted_event_descriptor_list, *time_shifted_event_descriptor_node);
-
-				time_shifted_event_descriptor_node = time_shifted_event_descriptor_node->next;
-			}
-
-			current_program_info_node->event_data_list = add_event_data_node_to_list(current_program_info_node->event_data_list, temp_event_data_node);
-		}
-
-		eit_node = eit_node->next;
-	}
-
-	free_eit_list(eit_list);
-
-	return 0;
-}
-
-ProgramInfoList *get_program_info_list(void)
-{
-	ProgramInfoList *program_info_list = NULL;
-	PatList         *pat_list          = NULL;
-	int              error_code        = 0;
-
-	pat_list = get_pat_list();
-	if (pat_list == NULL)
-	{
-		LOG("pat_list is null\n");
-		return NULL;
-	}
-	// printf_pat_list(pat_list);
-
-	program_info_list = init_program_info_list(program_info_list, pat_list);
-	if (program_info_list == NULL)
-	{
-		LOG("init_program_info_list error\n");
-	}
-	else
-	{
-		error_code = add_sdt_info_to_program_info_list(program_info_list);
-		if (error_code < 0)
-		{
-			LOG("add_sdt_info_to_program_info_list error\n");
-		}
-		else
-		{
-			add_infomation_to_program_info_list(program_info_list);
-			error_code = add_eit_info_to_program_info_list(program_info_list);
-			if (error_code < 0)
-			{
-				LOG("add_eit_info_to_program_info_list error\n");
-			}
-		}
-	}
-	free_pat_list(pat_list);
-	return program_info_list;
-}
-
-static void free_event_data_list(EventDataList *event_data_list)
-{
-	EventDataNode *next_event_data_node = NULL;
-	while (event_data_list != NULL)
-	{
-		free_short_event_descriptor_list(event_data_list->short_event_descriptor_list);
-		free_extended_event_descriptor_list(event_data_list->extended_event_descriptor_list);
-		free_time_shifted_event_descriptor_list(event_data_list->time_shifted_event_descriptor_list);
-
-		next_event_data_node = event_data_list->next;
-		free(event_data_list);
-		event_data_list = next_event_data_node;
-	}
-
-	return;
-}
-
-void free_program_info_list(ProgramInfoList *program_info_list)
-{
-	ProgramInfoNode *next_program_info_node = NULL;
-	while (program_info_list != NULL)
-	{
-		free_event_data_list(program_info_list->event_data_list);
-		free_pmt_es_list(program_info_list->es_info_list);
-
-		next_program_info_node = program_info_list->next;
-		free(program_info_list);
-		program_info_list = next_program_info_node;
-	}
-
-	return;
-}
-
-ProgramInfoNode *find_program_info_by_program_number(ProgramInfoList *program_info_list, int program_number)
-{
-	ProgramInfoNode *current_program_info_node = program_info_list;
-
-	while (current_program_info_node != NULL)
-	{
-		if (current_program_info_node->program_number == program_number)
-		{
-			break;
-		}
-		current_program_info_node = current_program_info_node->next;
-	}
-	return current_program_info_node;
-}
-
-void printf_program_list(ProgramInfoList *program_info_list)
-{
-	ProgramInfoNode *current_program_info_node = program_info_list;
-
-	DOUBLE_LINE
-	LOG("program_number |  service_name   |     provider_name       | pcr_pid \n");
-	SINGLE_LINE
-	while (current_program_info_node != NULL)
-	{
-		LOG("      %5d    | %-15s |     %-15s     | 0x%04X \n",
-		    current_program_info_node->program_number,
-		    current_program_info_node->service_name,
-		    current_program_info_node->service_provider_name,
-		    current_program_info_node->pcr_pid);
-		current_program_info_node = current_program_info_node->next;
-	}
-	DOUBLE_LINE
-}
-
-void printf_eit_descriptor(EventDataNode *event_data_node)
-{
-	ShortEventDescriptorNode       *short_event_descriptor_node        = NULL;
-	ExtendedEventDescriptorNode    *extended_event_descriptor_node     = NULL;
-	TimeShiftedEventDescriptorNode *time_shifted_event_descriptor_node = NULL;
-
-	LOG("\t[EIT]start_time:%010lu | duration:%u\n",
-	    event_data_node->start_time,
-	    event_data_node->duration);
-
-	// 打印短事件描述符 (0x4D)
-	short_event_descriptor_node = event_data_node->short_event_descriptor_list;
-	while (short_event_descriptor_node != NULL)
-	{
-		LOG("\t   [1] [Short Event] language : %c%c%c | Name: %s | Text: %s\n",
-		    (short_event_descriptor_node->ISO_639_language_code >> 16) & 0xFF,
-		    (short_event_descriptor_node->ISO_639_language_code >> 8) & 0xFF,
-		    (short_event_descriptor_node->ISO_639_language_code >> 0) & 0xFF,
-		    short_event_descriptor_node->name,
-		    short_event_descriptor_node->text);
-
-		short_event_descriptor_node = short_event_descriptor_node->next;
-	}
-
-	// 打印扩展事件描述符 (0x4E)
-	extended_event_descriptor_node = event_data_node->extended_event_descriptor_list;
-	while (extended_event_descriptor_node != NULL)
-	{
-		LOG("\t   [2] [Extended Event] language: %c%c%c | Desc Num: %d/%d | Text: %s\n",
-		    (extended_event_descriptor_node->ISO_639_language_code >> 16) & 0xFF,
-		    (extended_event_descriptor_node->ISO_639_language_code >> 8) & 0xFF,
-		    (extended_event_descriptor_node->ISO_639_language_code >> 0) & 0xFF,
-		    extended_event_descriptor_node->descriptor_number,
-		    extended_event_descriptor_node->last_descriptor_number,
-		    extended_event_descriptor_node->text);
-
-		LOG("\t\t[2.1]item:%s\n", extended_event_descriptor_node->item);
-
-		extended_event_descriptor_node = extended_event_descriptor_node->next;
-	}
-
-	// 打印时移事件描述符 (0x4F)
-	time_shifted_event_descriptor_node = event_data_node->time_shifted_event_descriptor_list;
-	while (time_shifted_event_descriptor_node != NULL)
-	{
-		LOG("\t   [3] [Time Shifted] reference_service_id: 0x%04X | reference_event_idt: 0x%04X\n",
-		    time_shifted_event_descriptor_node->reference_service_id,
-		    time_shifted_event_descriptor_node->reference_event_id);
-
-		time_shifted_event_descriptor_node = time_shifted_event_descriptor_node->next;
-	}
-
-	return;
-}
-
-void printf_more_program_info(ProgramInfoNode *program_info_node)
-{
-	PmtESNode     *current_es_node         = NULL;
-	EventDataNode *current_event_data_node = NULL;
-
-	if (program_info_node == NULL)
-	{
-		LOG("program_info_node is null\n");
-		return ;
-	}
-
-	SINGLE_LINE
-	LOG("program_number:%d | service_name:%s | provider_name:%s\n",
-	    program_info_node->program_number,
-	    program_info_node->service_name,
-	    program_info_node->service_provider_name);
-
-	LOG("\t[PMT]pcr_pid:0x%04X\n", program_info_node->pcr_pid);
-	current_es_node = program_info_node->es_info_list;
-	while (current_es_node != NULL)
-	{
-		LOG("\t   [PMT->ES]stream_type:0x%02X | elementary_pid:0x%04X\n",
-		    current_es_node->stream_type,
-		    current_es_node->elementary_pid);
-
-		current_es_node = current_es_node->next;
-	}
-
-	LOG("\t----------------------------------------------------------------------------------------\n");
-	current_event_data_node = program_info_node->event_data_list;
-	while (current_event_data_node != NULL)
-	{
-		printf_eit_descriptor(current_event_data_node);
-
-		current_event_data_node = current_event_data_node->next;
-	}
-
-	SINGLE_LINE
-	return ;
-}
+/*
+ * @file get_eit_info.c
+ *
+ * @author :Yujin Yu
+ * @date   :2025.04.16
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ts_global.h"
+#include "slot_filter.h"
+#include "get_pat_info.h"
+#include "get_pmt_info.h"
+#include "section_store.h"
+#include "string_pool.h"
+#include "get_sdt_info.h"
+#include "get_eit_info.h"
+#include "integrate_data.h"
+#include "table_context.h"
+#include "logger.h"
+#include "memory_account.h"
+
+#define SERVICE_KEY(onid, tsid, sid) (((unsigned long long)(onid) << 32) | ((unsigned long long)(tsid) << 16) | (sid))
+
+// Open addressing map from a service key to a node, NULL value marks a free slot
+typedef struct
+{
+	unsigned long long key;
+	void              *value;
+} ServiceMapEntry;
+
+typedef struct
+{
+	ServiceMapEntry *entry_array;
+	unsigned int     capacity; // power of two, at least twice the number of entries
+} ServiceMap;
+
+static unsigned int get_service_map_position(const ServiceMap *service_map, unsigned long long key)
+{
+	return (unsigned int)((key * 0x9E3779B97F4A7C15ull) >> 32) & (service_map->capacity - 1);
+}
+
+static int init_service_map(ServiceMap *service_map, int entry_count)
+{
+	service_map->capacity = 16;
+	while (service_map->capacity < (unsigned int)entry_count * 2)
+	{
+		service_map->capacity *= 2;
+	}
+
+	service_map->entry_array = (ServiceMapEntry *)calloc(service_map->capacity, sizeof(ServiceMapEntry));
+	if (service_map->entry_array == NULL)
+	{
+		LOG("calloc failed for service map\n");
+		return -1;
+	}
+	return 0;
+}
+
+static void free_service_map(ServiceMap *service_map)
+{
+	free(service_map->entry_array);
+	service_map->entry_array = NULL;
+	service_map->capacity    = 0;
+}
+
+// The first node stored for a key is kept, like the first match of a linear scan
+static void put_service_map(ServiceMap *service_map, unsigned long long key, void *value)
+{
+	unsigned int position = get_service_map_position(service_map, key);
+
+	while (service_map->entry_array[position].value != NULL)
+	{
+		if (service_map->entry_array[position].key == key)
+			return;
+		position = (position + 1) & (service_map->capacity - 1);
+	}
+	service_map->entry_array[position].key   = key;
+	service_map->entry_array[position].value = value;
+}
+
+static void *get_service_map(const ServiceMap *service_map, unsigned long long key)
+{
+	unsigned int position = get_service_map_position(service_map, key);
+
+	while (service_map->entry_array[position].value != NULL)
+	{
+		if (service_map->entry_array[position].key == key)
+			return service_map->entry_array[position].value;
+		position = (position + 1) & (service_map->capacity - 1);
+	}
+	return NULL;
+}
+
+static int compare_program_info_node(const void *a, const void *b)
+{
+	const ProgramInfoNode *node_a = *(ProgramInfoNode *const *)a;
+	const ProgramInfoNode *node_b = *(ProgramInfoNode *const *)b;
+
+	if (node_a->program_number != node_b->program_number)
+		return (node_a->program_number < node_b->program_number) ? -1 : 1;
+	if (node_a->transport_stream_id != node_b->transport_stream_id)
+		return (node_a->transport_stream_id < node_b->transport_stream_id) ? -1 : 1;
+	return 0;
+}
+
+static int compare_event_data_node(const void *a, const void *b)
+{
+	const EventDataNode *node_a = (const EventDataNode *)a;
+	const EventDataNode *node_b = (const EventDataNode *)b;
+
+	if (node_a->start_time != node_b->start_time)
+		return (node_a->start_time < node_b->start_time) ? -1 : 1;
+	if (node_a->event_id != node_b->event_id)
+		return (node_a->event_id < node_b->event_id) ? -1 : 1;
+	return 0;
+}
+
+int is_target_stream_type(unsigned char stream_type)
+{
+	switch (stream_type)
+	{
+	// Video stream
+	case 0x01: // MPEG-1 Video
+	case 0x02: // MPEG-2 Video
+	case 0x1B: // H.264  Video
+	case 0x24: // H.265  Video
+		return 1;
+
+	// Audio stream
+	case 0x03: // MPEG-1 Audio
+	case 0x04: // MPEG-2 Audio
+	case 0x0F: // AAC    Audio
+	case 0x80: // PCM    Audio
+	case 0x81: // AC-3   Audio
+	case 0x82: // DTS    Audio
+	case 0x83: // TrueHD Audio
+	case 0x84: // E-AC-3 Audio
+	case 0x86: // DTS-HD Master Audio
+		return 1;
+
+	// Subtitle stream
+	case 0x90: // PGS  Subtitle
+	case 0x92: // Text Subtitle
+		return 1;
+
+	// Metadata stream
+	case 0x05: // MPEG-2 Private Sections
+	case 0x06: // PES Private Data
+	case 0x0D: // MPEG-4 SL
+	case 0x11: // LATM AAC Audio
+	case 0x1C: // MPEG-4 Video
+		return 1;
+
+		// 0x81-0x8F User private stream
+
+	default:
+		return 0;
+	}
+}
+
+// by pmt and pat, pmt is looked up by program_number and the program list is sorted once at the end.
+// Only the overview is filled, the es list is copied from the kept pmt node when the program is opened
+static ProgramInfoList *init_program_info_list(PatList *pat_list)
+{
+	ProgramInfoList  *program_info_list  = NULL;
+	ProgramInfoNode **program_info_array = NULL;
+	ProgramInfoNode  *new_node           = NULL;
+	PatNode          *pat_node           = NULL;
+	ServiceMap        pmt_map            = {0};
+
+	PmtList *pmt_list = NULL;
+	PmtNode *pmt_node = NULL;
+
+	int pat_count     = 0;
+	int pmt_count     = 0;
+	int program_count = 0;
+	int i             = 0;
+
+	pmt_list = get_pmt_list();
+	if (pmt_list == NULL)
+	{
+		LOG("pmt_list is null\n");
+		return NULL;
+	}
+	// printf_pmt_list(pmt_list);
+
+	for (pmt_node = pmt_list; pmt_node != NULL; pmt_node = pmt_node->next)
+	{
+		pmt_count++;
+	}
+	for (pat_node = pat_list; pat_node != NULL; pat_node = pat_node->next)
+	{
+		pat_count++;
+	}
+
+	program_info_array = (ProgramInfoNode **)malloc(pat_count * sizeof(ProgramInfoNode *));
+	if ((program_info_array == NULL) || (init_service_map(&pmt_map, pmt_count) < 0))
+	{
+		LOG("malloc failed for program join\n");
+		free(program_info_array);
+		return NULL;
+	}
+
+	for (pmt_node = pmt_list; pmt_node != NULL; pmt_node = pmt_node->next)
+	{
+		put_service_map(&pmt_map, pmt_node->program_number, pmt_node);
+	}
+
+	for (pat_node = pat_list; pat_node != NULL; pat_node = pat_node->next)
+	{
+		pmt_node = (PmtNode *)get_service_map(&pmt_map, pat_node->program_number);
+		if (pmt_node == NULL)
+			continue;
+
+		if (is_memory_cap_reached(MEMORY_SUBSYSTEM_PROGRAM_INFO, sizeof(ProgramInfoNode)) == 1)
+		{
+			count_memory_refused(MEMORY_SUBSYSTEM_PROGRAM_INFO);
+			break;
+		}
+
+		new_node = (ProgramInfoNode *)calloc(1, sizeof(ProgramInfoNode));
+		if (new_node == NULL)
+		{
+			LOG("new_node is null\n");
+			continue;
+		}
+		add_memory(MEMORY_SUBSYSTEM_PROGRAM_INFO, sizeof(ProgramInfoNode), 0, 1);
+
+		new_node->program_number      = pat_node->program_number;
+		new_node->transport_stream_id = pat_node->transport_stream_id;
+		new_node->pcr_pid             = pmt_node->pcr_pid;
+		new_node->pmt_node            = pmt_node;
+
+		program_info_array[program_count++] = new_node;
+	}
+
+	qsort(program_info_array, program_count, sizeof(ProgramInfoNode *), compare_program_info_node);
+	// clang-format off
+	for (i=0; i<program_count; i++)
+	{ // clang-format on
+		program_info_array[i]->prev = (i > 0) ? program_info_array[i - 1] : NULL;
+		program_info_array[i]->next = (i + 1 < program_count) ? program_info_array[i + 1] : NULL;
+	}
+	program_info_list = (program_count > 0) ? program_info_array[0] : NULL;
+
+	free(program_info_array);
+	free_service_map(&pmt_map);
+
+	return program_info_list;
+}
+
+// Map every program by (onid, tsid, service_id), onid is 0 until the SDT has been joined
+static int build_program_map(ServiceMap *program_map, ProgramInfoList *program_info_list)
+{
+	ProgramInfoNode *current_program_info_node = NULL;
+	int              program_count             = 0;
+
+	for (current_program_info_node = program_info_list; current_program_info_node != NULL; current_program_info_node = current_program_info_node->next)
+	{
+		program_count++;
+	}
+
+	if (init_service_map(program_map, program_count) < 0)
+		return -1;
+
+	for (current_program_info_node = program_info_list; current_program_info_node != NULL; current_program_info_node = current_program_info_node->next)
+	{
+		put_service_map(program_map,
+		                SERVICE_KEY(current_program_info_node->original_network_id,
+		                            current_program_info_node->transport_stream_id,
+		                            current_program_info_node->program_number),
+		                current_program_info_node);
+	}
+	return 0;
+}
+
+static int add_sdt_info_to_program_info_list(ProgramInfoList *program_info_list)
+{
+	SdtList          *sdt_list                  = NULL;
+	ProgramInfoNode  *current_program_info_node = NULL;
+	SdtNode          *current_sdt_node          = NULL;
+	ServiceDescriptor service_descriptor        = {0};
+	ServiceMap        program_map               = {0};
+
+	sdt_list = get_sdt_list();
+	if (sdt_list == NULL)
+	{
+		LOG("sdt_list is null\n");
+		return -1;
+	}
+	// printf_sdt_list(sdt_list);
+
+	if (build_program_map(&program_map, program_info_list) < 0)
+	{
+		return -1;
+	}
+
+	current_sdt_node = sdt_list;
+	while (current_sdt_node != NULL)
+	{
+		current_program_info_node = NULL;
+		if (current_sdt_node->table_id == 0x42)
+		{
+			current_program_info_node = (ProgramInfoNode *)get_service_map(&program_map, SERVICE_KEY(0, current_sdt_node->transport_stream_id, current_sdt_node->service_id));
+		}
+
+		if (current_program_info_node != NULL)
+		{
+			current_program_info_node->original_network_id = current_sdt_node->original_network_id;
+
+			if (get_service_descriptor(current_sdt_node->descriptor_loop, &service_descriptor) == 1)
+			{
+				current_program_info_node->service_type          = service_descriptor.service_type;
+				current_program_info_node->service_provider_name = service_descriptor.service_provider_name;
+				current_program_info_node->service_name          = service_descriptor.service_name;
+			}
+		}
+
+		current_sdt_node = current_sdt_node->next;
+	}
+
+	free_service_map(&program_map);
+	free_sdt_list(sdt_list);
+	get_table_context()->sdt_list = NULL;
+
+	return 0;
+}
+
+// for those services which have no sdt info
+static void add_infomation_to_program_info_list(ProgramInfoList *program_info_list)
+{
+	ProgramInfoNode *current_program_info_node = program_info_list;
+
+	StringPool      *string_pool               = &get_table_context()->string_pool;
+
+	int  null_service_provider_name_count = 0;
+	int  null_service_name_count          = 0;
+	int  name_length                      = 0;
+	char name[32];
+
+	while (current_program_info_node != NULL)
+	{
+		if (current_program_info_node->service_provider_name == 0)
+		{
+			null_service_provider_name_count++;
+			name_length = snprintf(name, sizeof(name), "provider_name_%d", null_service_provider_name_count);
+			intern_string(string_pool, name, name_length, &current_program_info_node->service_provider_name);
+			LOG_DEBUG(LOGGER_CATEGORY_SDT, "service_provider_name:%s\n", get_string(current_program_info_node->service_provider_name));
+		}
+		if (current_program_info_node->service_name == 0)
+		{
+			null_service_name_count++;
+			name_length = snprintf(name, sizeof(name), "service_name_%d", null_service_name_count);
+			intern_string(string_pool, name, name_length, &current_program_info_node->service_name);
+			LOG_DEBUG(LOGGER_CATEGORY_SDT, "service_name:%s\n", get_string(current_program_info_node->service_name));
+		}
+		current_program_info_node = current_program_info_node->next;
+	}
+
+	return;
+}
+
+// One walk over the eit list records where the events of every program start, the list is sorted by
+// (service_id, transport_stream_id, original_network_id) so the events of a service are contiguous
+static int index_eit_list(ProgramInfoList *program_info_list)
+{
+	EitNode         *eit_node                  = NULL;
+	ProgramInfoNode *current_program_info_node = NULL;
+	ServiceMap       program_map               = {0};
+
+	if (build_program_map(&program_map, program_info_list) < 0)
+	{
+		LOG("malloc failed for event index\n");
+		return -1;
+	}
+
+	for (eit_node = get_eit_list(); eit_node != NULL; eit_node = eit_node->next)
+	{
+		current_program_info_node = (ProgramInfoNode *)get_service_map(&program_map, SERVICE_KEY(eit_node->original_network_id, eit_node->transport_stream_id, eit_node->service_id));
+		if (current_program_info_node == NULL)
+			continue;
+
+		if (current_program_info_node->eit_node == NULL)
+		{
+			current_program_info_node->eit_node = eit_node;
+		}
+		current_program_info_node->eit_count++;
+	}
+
+	for (current_program_info_node = program_info_list; current_program_info_node != NULL; current_program_info_node = current_program_info_node->next)
+	{
+		current_program_info_node->is_eit_indexed = 1;
+	}
+
+	free_service_map(&program_map);
+	return 0;
+}
+
+// Copy the events of one service into its array and sort them in bulk
+static int add_eit_info_to_program_info_node(ProgramInfoNode *program_info_node)
+{
+	EitNode       *eit_node        = program_info_node->eit_node;
+	EventDataNode *event_data_node = NULL;
+	int            i               = 0;
+
+	if (program_info_node->eit_count == 0)
+		return 0;
+
+	// the program is still shown, only without its events
+	if (is_memory_cap_reached(MEMORY_SUBSYSTEM_PROGRAM_INFO, program_info_node->eit_count * sizeof(EventDataNode)) == 1)
+	{
+		count_memory_refused(MEMORY_SUBSYSTEM_PROGRAM_INFO);
+		return -1;
+	}
+
+	program_info_node->event_data_array = (EventDataNode *)malloc(program_info_node->eit_count * sizeof(EventDataNode));
+	if (program_info_node->event_data_array == NULL)
+	{
+		LOG("malloc failed for event_data_array\n");
+		return -1;
+	}
+	add_memory(MEMORY_SUBSYSTEM_PROGRAM_INFO, program_info_node->eit_count * sizeof(EventDataNode), 0, 0);
+
+	for (; (eit_node != NULL) && (program_info_node->event_data_count < program_info_node->eit_count); eit_node = eit_node->next)
+	{
+		if ((eit_node->service_id != program_info_node->program_number) ||
+		    (eit_node->transport_stream_id != program_info_node->transport_stream_id) ||
+		    (eit_node->original_network_id != program_info_node->original_network_id))
+		{
+			continue;
+		}
+
+		event_data_node = &program_info_node->event_data_array[program_info_node->event_data_count++];
+		memset(event_data_node, 0, sizeof(EventDataNode));
+
+		event_data_node->event_id        = eit_node->event_id;
+		event_data_node->start_time      = eit_node->start_time;
+		event_data_node->duration        = eit_node->duration;
+		event_data_node->descriptor_loop = eit_node->descriptor_loop;
+	}
+
+	event_data_node = program_info_node->event_data_array;
+	qsort(event_data_node, program_info_node->event_data_count, sizeof(EventDataNode), compare_event_data_node);
+	// clang-format off
+	for (i=0; i<program_info_node->event_data_count; i++)
+	{ // clang-format on
+		event_data_node[i].next = (i + 1 < program_info_node->event_data_count) ? &event_data_node[i + 1] : NULL;
+	}
+	program_info_node->event_data_list = (program_info_node->event_data_count > 0) ? event_data_node : NULL;
+
+	return 0;
+}
+
+int materialize_program_info(ProgramInfoList *program_info_list, ProgramInfoNode *program_info_node)
+{
+	PmtESNode *pmt_es_node = NULL;
+
+	if (program_info_node == NULL)
+		return -1;
+
+	if (program_info_node->is_materialized)
+		return 0;
+
+	if (program_info_node->pmt_node != NULL)
+	{
+		pmt_es_node = program_info_node->pmt_node->es_info_list;
+		while (pmt_es_node != NULL)
+		{
+			if (is_target_stream_type(pmt_es_node->stream_type) == 1)
+			{
+				program_info_node->es_info_list = add_pmt_es_node_to_list(program_info_node->es_info_list, *pmt_es_node);
+			}
+
+			pmt_es_node = pmt_es_node->next;
+		}
+	}
+
+	if ((program_info_node->is_eit_indexed == 0) && (index_eit_list(program_info_list) < 0))
+		return -1;
+
+	add_eit_info_to_program_info_node(program_info_node);
+
+	program_info_node->is_materialized = 1;
+	return 0;
+}
+
+ProgramInfoList *get_program_info_list(void)
+{
+	ProgramInfoList *program_info_list = NULL;
+	PatList         *pat_list          = NULL;
+	int              error_code        = 0;
+
+	pat_list = get_pat_list();
+	if (pat_list == NULL)
+	{
+		LOG("pat_list is null\n");
+		return NULL;
+	}
+	// printf_pat_list(pat_list);
+
+	program_info_list = init_program_info_list(pat_list);
+	if (program_info_list == NULL)
+	{
+		LOG("init_program_info_list error\n");
+	}
+	else
+	{
+		error_code = add_sdt_info_to_program_info_list(program_info_list);
+		if (error_code < 0)
+		{
+			LOG("add_sdt_info_to_program_info_list error\n");
+		}
+		else
+		{
+			add_infomation_to_program_info_list(program_info_list);
+		}
+	}
+	free_pat_list(pat_list);
+	get_table_context()->pat_list = NULL;
+	return program_info_list;
+}
+
+void free_program_info_list(ProgramInfoList *program_info_list)
+{
+	ProgramInfoNode *next_program_info_node = NULL;
+	while (program_info_list != NULL)
+	{
+		if (program_info_list->event_data_array != NULL)
+			add_memory(MEMORY_SUBSYSTEM_PROGRAM_INFO, -(long long)(program_info_list->eit_count * sizeof(EventDataNode)), 0, 0);
+		free(program_info_list->event_data_array);
+		free_pmt_es_list(program_info_list->es_info_list);
+
+		next_program_info_node = program_info_list->next;
+		add_memory(MEMORY_SUBSYSTEM_PROGRAM_INFO, -(long long)sizeof(ProgramInfoNode), 0, -1);
+		free(program_info_list);
+		program_info_list = next_program_info_node;
+	}
+
+	// the pmt and eit lists were kept for the programs opened later
+	free_pmt_list(get_table_context()->pmt_list);
+	get_table_context()->pmt_list = NULL;
+	free_eit_list(get_table_context()->eit_list);
+	get_table_context()->eit_list = NULL;
+
+	return;
+}
+
+ProgramInfoNode *find_program_info_by_program_number(ProgramInfoList *program_info_list, int program_number)
+{
+	ProgramInfoNode *current_program_info_node = program_info_list;
+
+	while (current_program_info_node != NULL)
+	{
+		if (current_program_info_node->program_number == program_number)
+		{
+			break;
+		}
+		current_program_info_node = current_program_info_node->next;
+	}
+	return current_program_info_node;
+}
+
+void printf_program_list(ProgramInfoList *program_info_list)
+{
+	ProgramInfoNode *current_program_info_node = program_info_list;
+
+	DOUBLE_LINE
+	LOG("program_number |  service_name   |     provider_name       | pcr_pid \n");
+	SINGLE_LINE
+	while (current_program_info_node != NULL)
+	{
+		LOG("      %5d    | %-15s |     %-15s     | 0x%04X \n",
+		    current_program_info_node->program_number,
+		    get_string(current_program_info_node->service_name),
+		    get_string(current_program_info_node->service_provider_name),
+		    current_program_info_node->pcr_pid);
+		current_program_info_node = current_program_info_node->next;
+	}
+	DOUBLE_LINE
+}
+
+void printf_eit_descriptor(EventDataNode *event_data_node)
+{
+	ShortEventDescriptor       short_event_descriptor  = {0};
+	ExtendedEventDescriptor    extended_descriptor     = {0};
+	TimeShiftedEventDescriptor time_shifted_descriptor = {0};
+	int                        index                   = 0;
+	char                       time_string[UTC_TIME_STRING_SIZE];
+
+	LOG("\t[EIT]start_time:%s | duration:%u\n",
+	    format_utc_time(event_data_node->start_time, time_string),
+	    event_data_node->duration);
+
+	// 打印短事件描述符 (0x4D)
+	for (index = 0; get_short_event_descriptor(event_data_node->descriptor_loop, index, &short_event_descriptor) == 1; index++)
+	{
+		LOG("\t   [1] [Short Event] language : %c%c%c | Name: %s | Text: %s\n",
+		    (short_event_descriptor.ISO_639_language_code >> 16) & 0xFF,
+		    (short_event_descriptor.ISO_639_language_code >> 8) & 0xFF,
+		    (short_event_descriptor.ISO_639_language_code >> 0) & 0xFF,
+		    get_string(short_event_descriptor.name),
+		    get_string(short_event_descriptor.text));
+	}
+
+	// 打印扩展事件描述符 (0x4E)
+	for (index = 0; get_extended_event_descriptor(event_data_node->descriptor_loop, index, &extended_descriptor) == 1; index++)
+	{
+		LOG("\t   [2] [Extended Event] language: %c%c%c | Desc Num: %d/%d | Text: %s\n",
+		    (extended_descriptor.ISO_639_language_code >> 16) & 0xFF,
+		    (extended_descriptor.ISO_639_language_code >> 8) & 0xFF,
+		    (extended_descriptor.ISO_639_language_code >> 0) & 0xFF,
+		    extended_descriptor.descriptor_number,
+		    extended_descriptor.last_descriptor_number,
+		    get_string(extended_descriptor.text));
+
+		LOG("\t\t[2.1]item:%s\n", get_string(extended_descriptor.item));
+	}
+
+	// 打印时移事件描述符 (0x4F)
+	for (index = 0; get_time_shifted_event_descriptor(event_data_node->descriptor_loop, index, &time_shifted_descriptor) == 1; index++)
+	{
+		LOG("\t   [3] [Time Shifted] reference_service_id: 0x%04X | reference_event_idt: 0x%04X\n",
+		    time_shifted_descriptor.reference_service_id,
+		    time_shifted_descriptor.reference_event_id);
+	}
+
+	return;
+}
+
+void printf_more_program_info(ProgramInfoNode *program_info_node)
+{
+	PmtESNode     *current_es_node         = NULL;
+	EventDataNode *current_event_data_node = NULL;
+
+	if (program_info_node == NULL)
+	{
+		LOG("program_info_node is null\n");
+		return ;
+	}
+
+	SINGLE_LINE
+	LOG("program_number:%d | service_name:%s | provider_name:%s\n",
+	    program_info_node->program_number,
+	    get_string(program_info_node->service_name),
+	    get_string(program_info_node->service_provider_name));
+
+	LOG("\t[PMT]pcr_pid:0x%04X\n", program_info_node->pcr_pid);
+	current_es_node = program_info_node->es_info_list;
+	while (current_es_node != NULL)
+	{
+		LOG("\t   [PMT->ES]stream_type:0x%02X | elementary_pid:0x%04X\n",
+		    current_es_node->stream_type,
+		    current_es_node->elementary_pid);
+
+		current_es_node = current_es_node->next;
+	}
+
+	LOG("\t----------------------------------------------------------------------------------------\n");
+	current_event_data_node = program_info_node->event_data_list;
+	while (current_event_data_node != NULL)
+	{
+		printf_eit_descriptor(current_event_data_node);
+
+		current_event_data_node = current_event_data_node->next;
+	}
+
+	SINGLE_LINE
+	return ;
+}
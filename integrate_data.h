@@ -1,48 +1,78 @@
-#ifndef INTEGRATE_DATA_H
-#define INTEGRATE_DATA_H
-
-typedef struct EventDataNode
-{
-	unsigned short event_id;   // eit
-	unsigned long  start_time; // eit
-	unsigned int   duration;   // eit
-
-	ShortEventDescriptorList       *short_event_descriptor_list;        // eit
-	ExtendedEventDescriptorList    *extended_event_descriptor_list;     // eit
-	TimeShiftedEventDescriptorList *time_shifted_event_descriptor_list; // eit
-
-	struct EventDataNode *next;
-} EventDataNode, EventDataList;
-
-typedef struct ProgramInfoNode
-{
-	unsigned short program_number; // pat, pmt, sdt(service_id), eit(service_id)
-
-	unsigned short transport_stream_id; // pat, sdt, eit
-	unsigned short original_network_id; //      sdt, eit
-
-	unsigned short pcr_pid;      // pmt
-	PmtESList     *es_info_list; // pmt
-
-	unsigned char service_type;                           // sdt
-	char          service_provider_name[MAX_NAME_LENGTH]; // sdt
-	char          service_name[MAX_NAME_LENGTH];          // sdt
-
-	EventDataList *event_data_list;
-
-	struct ProgramInfoNode *prev;
-	struct ProgramInfoNode *next;
-} ProgramInfoNode, ProgramInfoList;
-
-//--------------------------------------------------------------------------------------------
-// Function declaration
-//--------------------------------------------------------------------------------------------
-ProgramInfoList *get_program_info_list(void);
-void             free_program_info_list(ProgramInfoList *program_info_list);
-
-ProgramInfoNode *find_program_info_by_program_number(ProgramInfoList *program_info_list, int program_number);
-
-void printf_program_list(ProgramInfoList *program_info_list);
-void printf_more_program_info(ProgramInfoNode *program_info_node);
-
-#endif
+#ifndef INTEGRATE_DATA_H
+#define INTEGRATE_DATA_H
+
+typedef struct EventDataNode
+{
+	unsigned short event_id;   // eit
+	unsigned long  start_time; // eit, UTC epoch seconds
+	unsigned int   duration;   // eit, seconds
+
+	DescriptorLoop descriptor_loop; // eit, decoded when the event is shown
+
+	struct EventDataNode *next; // next element of the same event_data_array
+} EventDataNode, EventDataList;
+
+typedef struct ProgramInfoNode
+{
+	unsigned short program_number; // pat, pmt, sdt(service_id), eit(service_id)
+
+	unsigned short transport_stream_id; // pat, sdt, eit
+	unsigned short original_network_id; //      sdt, eit
+
+	unsigned short pcr_pid;      // pmt
+	PmtNode       *pmt_node;     // pmt, kept in the table context until the list is freed
+	PmtESList     *es_info_list; // pmt, copied when the program is opened
+
+	unsigned char service_type;          // sdt
+	StringHandle  service_provider_name; // sdt, interned
+	StringHandle  service_name;          // sdt, interned
+
+	EitNode       *eit_node;         // eit, first event of the service in the kept eit list
+	int            eit_count;
+	EventDataList *event_data_list;  // first element of event_data_array
+	EventDataNode *event_data_array; // events of the service sorted by start_time, built when the program is opened
+	int            event_data_count;
+
+	unsigned char is_eit_indexed;
+	unsigned char is_materialized;
+
+	struct ProgramInfoNode *prev;
+	struct ProgramInfoNode *next;
+} ProgramInfoNode, ProgramInfoList;
+
+//--------------------------------------------------------------------------------------------
+// Function declaration
+//--------------------------------------------------------------------------------------------
+/**
+ * @brief Build the overview of all programs: program number, names, type and pcr pid.
+ *        The pmt and eit lists stay in the table context until free_program_info_list.
+ *
+ * @return the program list sorted by program_number, NULL if PAT or PMT is missing
+ */
+ProgramInfoList *get_program_info_list(void);
+void             free_program_info_list(ProgramInfoList *program_info_list);
+
+/**
+ * @brief Build the es list and the event schedule of one program on its first open, later calls reuse them
+ *
+ * @param program_info_list List the program belongs to, its eit index is built on the first call
+ * @param program_info_node Program to open
+ *
+ * @return 0: successful
+ *         <0: error
+ */
+int materialize_program_info(ProgramInfoList *program_info_list, ProgramInfoNode *program_info_node);
+
+ProgramInfoNode *find_program_info_by_program_number(ProgramInfoList *program_info_list, int program_number);
+
+/**
+ * @return 1: video or audio stream shown in the program details
+ *         0: other stream
+ */
+int is_target_stream_type(unsigned char stream_type);
+
+void printf_program_list(ProgramInfoList *program_info_list);
+void printf_more_program_info(ProgramInfoNode *program_info_node);
+void printf_eit_descriptor(EventDataNode *event_data_node);
+
+#endif
@@ -0,0 +1,121 @@
+/**
+ * @file latency.c
+ *
+ * @author :Yujin Yu
+ * @date   :2025.05.30
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <time.h>
+#include "ts_global.h"
+#include "instrument.h"
+#include "latency.h"
+
+//--------------------------------------------------------------------------------------------
+unsigned long long get_latency_ns(void)
+{
+	struct timespec now = {0};
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (unsigned long long)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+// Values below 16 have a bucket each, above that the top 5 bits pick one of 16 buckets per power of two
+static int get_bucket_index(unsigned long long value)
+{
+	int shift = 0;
+
+	if (value < LATENCY_SUB_BUCKET_COUNT)
+		return (int)value;
+
+	shift = 63 - __builtin_clzll(value) - LATENCY_SUB_BUCKET_BITS;
+	return LATENCY_SUB_BUCKET_COUNT * (shift + 1) + (int)((value >> shift) - LATENCY_SUB_BUCKET_COUNT);
+}
+
+static unsigned long long get_bucket_upper_edge(int index)
+{
+	int shift = 0;
+
+	if (index < LATENCY_SUB_BUCKET_COUNT)
+		return (unsigned long long)index;
+
+	shift = index / LATENCY_SUB_BUCKET_COUNT - 1;
+	return ((unsigned long long)(index % LATENCY_SUB_BUCKET_COUNT + LATENCY_SUB_BUCKET_COUNT + 1) << shift) - 1;
+}
+
+void record_latency(LatencyStats *stats, unsigned char table_id, unsigned long long latency_ns)
+{
+	LatencyHistogram *histogram = &stats->histogram_array[get_instrument_table_type(table_id)];
+
+	histogram->count++;
+	histogram->total_ns += latency_ns;
+	histogram->bucket_array[get_bucket_index(latency_ns)]++;
+	if (latency_ns > histogram->max_ns)
+		histogram->max_ns = latency_ns;
+}
+
+unsigned long long get_latency_percentile(const LatencyHistogram *histogram, double percentile)
+{
+	unsigned long long target_count = 0;
+	unsigned long long count        = 0;
+	int                i            = 0;
+
+	if (histogram->count == 0)
+		return 0;
+
+	// rank of the sample, rounded up so p100 is the largest one
+	target_count = (unsigned long long)(histogram->count * percentile / 100.0 + 0.999999);
+	target_count = MIN(MAX(target_count, 1), histogram->count);
+
+	// clang-format off
+	for (i=0; i<LATENCY_BUCKET_COUNT; i++)
+	{ // clang-format on
+		count += histogram->bucket_array[i];
+		if (count >= target_count)
+			break;
+	}
+	return MIN(get_bucket_upper_edge(i), histogram->max_ns);
+}
+
+void printf_latency_stats(const LatencyStats *stats)
+{
+	const LatencyHistogram *histogram = NULL;
+	int                     i         = 0;
+
+	DOUBLE_LINE
+	LOG("section to callback latency (us)\n");
+	LOG("%-14s %10s %10s %10s %10s %10s %10s\n", "table", "count", "mean", "p50", "p99", "p99.9", "max");
+	SINGLE_LINE
+	// clang-format off
+	for (i=0; i<INSTRUMENT_TABLE_COUNT; i++)
+	{ // clang-format on
+		histogram = &stats->histogram_array[i];
+		if (histogram->count == 0)
+			continue;
+
+		LOG("%-14s %10llu %10.1f %10.1f %10.1f %10.1f %10.1f\n", get_instrument_table_name(i), histogram->count, histogram->total_ns / 1000.0 / histogram->count,
+		    get_latency_percentile(histogram, 50) / 1000.0, get_latency_percentile(histogram, 99) / 1000.0,
+		    get_latency_percentile(histogram, 99.9) / 1000.0, histogram->max_ns / 1000.0);
+	}
+}
+
+void write_latency_json(FILE *output_fp, const LatencyStats *stats)
+{
+	const LatencyHistogram *histogram = NULL;
+	int                     i         = 0;
+
+	fprintf(output_fp, "{\n");
+	// clang-format off
+	for (i=0; i<INSTRUMENT_TABLE_COUNT; i++)
+	{ // clang-format on
+		histogram = &stats->histogram_array[i];
+		fprintf(output_fp, "  \"%s\": {\"count\": %llu, \"mean_ns\": %.1f, \"p50_ns\": %llu, \"p99_ns\": %llu, \"p999_ns\": %llu, \"max_ns\": %llu}%s\n",
+		        get_instrument_table_name(i), histogram->count, (histogram->count == 0) ? 0.0 : (double)histogram->total_ns / histogram->count,
+		        get_latency_percentile(histogram, 50), get_latency_percentile(histogram, 99), get_latency_percentile(histogram, 99.9), histogram->max_ns,
+		        (i + 1 < INSTRUMENT_TABLE_COUNT) ? "," : "");
+	}
+	fprintf(output_fp, "}\n");
+}
@@ -0,0 +1,58 @@
+/**
+ * @file latency.h
+ *
+ * @brief Time from the packet a section starts in entering filter_ts_packets to the return of its section_callback,
+ *        per table type. Samples go into log-bucket histograms in the style of HdrHistogram: 16 linear
+ *        sub-buckets per power of two, so every value is kept to within 1/16 and recording is one clock
+ *        read and one increment. Works at run time, a slot without LatencyStats attached does nothing.
+ *
+ * @author :Yujin Yu
+ * @date   :2025.05.30
+ */
+#ifndef LATENCY_H
+#define LATENCY_H
+
+//--------------------------------------------------------------------------------------------
+// macro definition
+//--------------------------------------------------------------------------------------------
+#define LATENCY_SUB_BUCKET_BITS  4
+#define LATENCY_SUB_BUCKET_COUNT (1 << LATENCY_SUB_BUCKET_BITS)
+#define LATENCY_BUCKET_COUNT     (LATENCY_SUB_BUCKET_COUNT * (64 - LATENCY_SUB_BUCKET_BITS + 1)) // ns up to 2^64
+
+typedef struct
+{
+	unsigned long long count;
+	unsigned long long total_ns;
+	unsigned long long max_ns;
+	unsigned long long bucket_array[LATENCY_BUCKET_COUNT];
+} LatencyHistogram;
+
+// By INSTRUMENT_TABLE_ type of the section's table_id
+typedef struct LatencyStats
+{
+	LatencyHistogram histogram_array[INSTRUMENT_TABLE_COUNT];
+} LatencyStats;
+
+//--------------------------------------------------------------------------------------------
+// Function declaration
+//--------------------------------------------------------------------------------------------
+unsigned long long get_latency_ns(void); // CLOCK_MONOTONIC
+
+/**
+ * @brief Add one sample to the histogram of the table type of table_id
+ */
+void record_latency(LatencyStats *stats, unsigned char table_id, unsigned long long latency_ns);
+
+/**
+ * @brief Value at or below which the given share of the samples lie, to within one bucket
+ *
+ * @param percentile 0..100, for example 99.9
+ *
+ * @return upper edge of the bucket, never more than the largest sample; 0 without samples
+ */
+unsigned long long get_latency_percentile(const LatencyHistogram *histogram, double percentile);
+
+void printf_latency_stats(const LatencyStats *stats);
+void write_latency_json(FILE *output_fp, const LatencyStats *stats);
+
+#endif
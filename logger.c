@@ -0,0 +1,257 @@
+/**
+ * @file logger.c
+ *
+ * @author :Yujin Yu
+ * @date   :2025.06.02
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <stdarg.h>
+#include <time.h>
+#include <pthread.h>
+#include "ts_global.h"
+#include "logger.h"
+
+volatile unsigned char logger_level_array[LOGGER_CATEGORY_COUNT] = {LOGGER_LEVEL_WARN, LOGGER_LEVEL_WARN, LOGGER_LEVEL_WARN,
+                                                                    LOGGER_LEVEL_WARN, LOGGER_LEVEL_WARN, LOGGER_LEVEL_WARN};
+
+static __thread LoggerRing *logger_ring = NULL;
+
+static pthread_mutex_t    logger_mutex       = PTHREAD_MUTEX_INITIALIZER; // ring registration only
+static LoggerRing        *logger_ring_list   = NULL;
+static int                logger_ring_count  = 0;
+static pthread_t          logger_thread;
+static int                is_logger_running  = 0;
+static int                is_logger_stopping = 0;
+static FILE              *logger_output_fp   = NULL;
+static unsigned long long logger_start_ns    = 0;
+
+static const char *level_name_array[]                         = {"OFF", "ERROR", "WARN", "INFO", "DEBUG"};
+static const char *category_name_array[LOGGER_CATEGORY_COUNT] = {"demux", "pat", "pmt", "sdt", "eit", "io"};
+
+//--------------------------------------------------------------------------------------------
+static unsigned long long get_logger_ns(void)
+{
+	struct timespec now = {0};
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (unsigned long long)now.tv_sec * 1000000000ULL + now.tv_nsec;
+}
+
+static LoggerRing *register_logger_ring(void)
+{
+	LoggerRing *ring = (LoggerRing *)calloc(1, sizeof(LoggerRing));
+
+	if (ring == NULL)
+		return NULL;
+
+	pthread_mutex_lock(&logger_mutex);
+	ring->thread_index = logger_ring_count++;
+	ring->next         = logger_ring_list;
+	// the background thread walks the list without the lock, publish the ring only once it is complete
+	__atomic_store_n(&logger_ring_list, ring, __ATOMIC_RELEASE);
+	pthread_mutex_unlock(&logger_mutex);
+
+	logger_ring = ring;
+	return ring;
+}
+
+void write_logger_record(LoggerCategory category, LoggerLevel level, const char *format, ...)
+{
+	LoggerRing        *ring        = logger_ring;
+	LoggerRecord      *record      = NULL;
+	unsigned long long write_index = 0;
+	va_list            args;
+	int                length      = 0;
+
+	if ((ring == NULL) && ((ring = register_logger_ring()) == NULL))
+		return;
+
+	write_index = ring->write_index;
+	if (write_index - __atomic_load_n(&ring->read_index, __ATOMIC_ACQUIRE) >= LOGGER_RING_SIZE)
+	{
+		ring->dropped_count++;
+		return;
+	}
+
+	record           = &ring->record_array[write_index & (LOGGER_RING_SIZE - 1)];
+	record->time_ns  = get_logger_ns();
+	record->level    = (unsigned char)level;
+	record->category = (unsigned char)category;
+
+	va_start(args, format);
+	length = vsnprintf(record->message, sizeof(record->message), format, args);
+	va_end(args);
+	length = MIN(MAX(length, 0), LOGGER_MESSAGE_LENGTH - 1);
+
+	// the callers' LOG strings end in a newline, the writer adds its own
+	while ((length > 0) && (record->message[length - 1] == '\n'))
+	{
+		length--;
+	}
+	record->length = (unsigned short)length;
+
+	__atomic_store_n(&ring->write_index, write_index + 1, __ATOMIC_RELEASE);
+}
+
+// Write every record that is in the rings now, returns how many were written
+static int drain_logger_rings(void)
+{
+	LoggerRing         *ring        = NULL;
+	const LoggerRecord *record      = NULL;
+	unsigned long long  read_index  = 0;
+	unsigned long long  write_index = 0;
+	unsigned long long  elapsed_ns  = 0;
+	int                 write_count = 0;
+
+	for (ring = __atomic_load_n(&logger_ring_list, __ATOMIC_ACQUIRE); ring != NULL; ring = ring->next)
+	{
+		read_index  = ring->read_index;
+		write_index = __atomic_load_n(&ring->write_index, __ATOMIC_ACQUIRE);
+		for (; read_index != write_index; read_index++)
+		{
+			record     = &ring->record_array[read_index & (LOGGER_RING_SIZE - 1)];
+			elapsed_ns = (record->time_ns > logger_start_ns) ? record->time_ns - logger_start_ns : 0;
+			fprintf(logger_output_fp, "[%6llu.%06llu] %-5s %-5s %.*s\n", elapsed_ns / 1000000000ULL, elapsed_ns / 1000ULL % 1000000ULL,
+			        level_name_array[record->level], category_name_array[record->category], (int)record->length, record->message);
+			write_count++;
+		}
+		__atomic_store_n(&ring->read_index, read_index, __ATOMIC_RELEASE);
+	}
+
+	if (write_count > 0)
+		fflush(logger_output_fp);
+	return write_count;
+}
+
+static void *logger_thread_main(void *argument)
+{
+	struct timespec idle_time = {0, LOGGER_IDLE_SLEEP_NS};
+
+	(void)argument;
+	while (__atomic_load_n(&is_logger_stopping, __ATOMIC_ACQUIRE) == 0)
+	{
+		if (drain_logger_rings() == 0)
+			nanosleep(&idle_time, NULL);
+	}
+	drain_logger_rings();
+	return NULL;
+}
+
+int init_logger(const char *file_name)
+{
+	if (is_logger_running == 1)
+		return 0;
+
+	logger_output_fp = stderr;
+	if ((file_name != NULL) && ((logger_output_fp = fopen(file_name, "a")) == NULL))
+	{
+		logger_output_fp = stderr;
+		LOG("open %s fail, error code : %d\n", file_name, LOGGER_OPEN_ERROR);
+		return LOGGER_OPEN_ERROR;
+	}
+
+	logger_start_ns    = get_logger_ns();
+	is_logger_stopping = 0;
+	if (pthread_create(&logger_thread, NULL, logger_thread_main, NULL) != 0)
+	{
+		LOG("pthread_create fail, error code : %d\n", LOGGER_THREAD_ERROR);
+		return LOGGER_THREAD_ERROR;
+	}
+
+	is_logger_running = 1;
+	atexit(close_logger);
+	return 0;
+}
+
+void close_logger(void)
+{
+	LoggerRing        *ring          = NULL;
+	unsigned long long dropped_count = 0;
+
+	if (is_logger_running == 0)
+		return;
+
+	__atomic_store_n(&is_logger_stopping, 1, __ATOMIC_RELEASE);
+	pthread_join(logger_thread, NULL);
+	is_logger_running = 0;
+
+	for (ring = logger_ring_list; ring != NULL; ring = ring->next)
+	{
+		dropped_count += ring->dropped_count;
+	}
+	if (dropped_count > 0)
+	{
+		fprintf(logger_output_fp, "logger: %llu records dropped, the rings were full\n", dropped_count);
+	}
+
+	if (logger_output_fp != stderr)
+		fclose(logger_output_fp);
+	logger_output_fp = NULL;
+}
+
+void set_logger_level(LoggerCategory category, LoggerLevel level)
+{
+	if ((category >= 0) && (category < LOGGER_CATEGORY_COUNT))
+		logger_level_array[category] = (unsigned char)level;
+}
+
+static int find_name(const char *name, int length, const char **name_array, int name_count)
+{
+	int i = 0;
+
+	// clang-format off
+	for (i=0; i<name_count; i++)
+	{ // clang-format on
+		if ((strncasecmp(name, name_array[i], length) == 0) && (name_array[i][length] == '\0'))
+			return i;
+	}
+	return -1;
+}
+
+int parse_logger_options(const char *options)
+{
+	const char *category_position = NULL;
+	const char *end               = NULL;
+	int         level             = 0;
+	int         category          = 0;
+	int         length            = 0;
+
+	if (options == NULL)
+		return LOGGER_PARAM_ERROR;
+
+	category_position = strchr(options, ':');
+	length            = (category_position == NULL) ? (int)strlen(options) : (int)(category_position - options);
+	if ((level = find_name(options, length, level_name_array, ARRAY_SIZE(level_name_array))) < 0)
+	{
+		LOG("unknown log level %.*s\n", length, options);
+		return LOGGER_PARAM_ERROR;
+	}
+
+	if (category_position == NULL)
+	{
+		// clang-format off
+		for (category=0; category<LOGGER_CATEGORY_COUNT; category++)
+		{ // clang-format on
+			set_logger_level((LoggerCategory)category, (LoggerLevel)level);
+		}
+		return 0;
+	}
+
+	for (category_position++; *category_position != '\0'; category_position = (*end == ',') ? end + 1 : end)
+	{
+		end    = strchr(category_position, ',');
+		end    = (end == NULL) ? category_position + strlen(category_position) : end;
+		length = (int)(end - category_position);
+		if ((category = find_name(category_position, length, category_name_array, LOGGER_CATEGORY_COUNT)) < 0)
+		{
+			LOG("unknown log category %.*s\n", length, category_position);
+			return LOGGER_PARAM_ERROR;
+		}
+		set_logger_level((LoggerCategory)category, (LoggerLevel)level);
+	}
+	return 0;
+}
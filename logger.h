@@ -0,0 +1,113 @@
+/**
+ * @file logger.h
+ *
+ * @brief Leveled, categorized log records that never block the demux. A record is rendered into a ring owned
+ *        by the calling thread (single producer, single consumer, no lock), a background thread adds the
+ *        time, level and category and writes it out. When a ring is full the record is counted and dropped.
+ *        LOG stays the synchronous printf of the tables and the browser; LOG_RECORD is for the hot paths.
+ *
+ * @author :Yujin Yu
+ * @date   :2025.06.02
+ */
+#ifndef LOGGER_H
+#define LOGGER_H
+
+//--------------------------------------------------------------------------------------------
+// macro definition
+//--------------------------------------------------------------------------------------------
+#define LOGGER_RING_SIZE      1024 // records per thread, power of two
+#define LOGGER_MESSAGE_LENGTH 240
+#define LOGGER_IDLE_SLEEP_NS  1000000 // background thread waits this long when every ring is empty
+
+typedef enum
+{
+	LOGGER_LEVEL_OFF = 0,
+	LOGGER_LEVEL_ERROR,
+	LOGGER_LEVEL_WARN,
+	LOGGER_LEVEL_INFO,
+	LOGGER_LEVEL_DEBUG,
+} LoggerLevel;
+
+typedef enum
+{
+	LOGGER_CATEGORY_DEMUX = 0, // filters, section assembly
+	LOGGER_CATEGORY_PAT,
+	LOGGER_CATEGORY_PMT,
+	LOGGER_CATEGORY_SDT,
+	LOGGER_CATEGORY_EIT,
+	LOGGER_CATEGORY_IO, // file, socket
+	LOGGER_CATEGORY_COUNT,
+} LoggerCategory;
+
+typedef struct
+{
+	unsigned long long time_ns;
+	unsigned char      level;
+	unsigned char      category;
+	unsigned short     length;
+	char               message[LOGGER_MESSAGE_LENGTH];
+} LoggerRecord;
+
+// One per thread, the owner only moves write_index and the background thread only moves read_index
+typedef struct LoggerRing
+{
+	LoggerRecord       record_array[LOGGER_RING_SIZE];
+	unsigned long long write_index;
+	unsigned long long read_index;
+	unsigned long long dropped_count; // records lost to a full ring
+	int                thread_index;
+	struct LoggerRing *next;
+} LoggerRing;
+
+// Most verbose level written, by category; read on every LOG_RECORD without a lock
+extern volatile unsigned char logger_level_array[LOGGER_CATEGORY_COUNT];
+
+#define LOG_RECORD(category, level, ...)                                       \
+	do                                                                     \
+	{                                                                      \
+		if ((level) <= logger_level_array[category])                   \
+			write_logger_record((category), (level), __VA_ARGS__); \
+	} while (0)
+
+#define LOG_ERROR(category, ...) LOG_RECORD(category, LOGGER_LEVEL_ERROR, __VA_ARGS__)
+#define LOG_WARN(category, ...)  LOG_RECORD(category, LOGGER_LEVEL_WARN, __VA_ARGS__)
+#define LOG_INFO(category, ...)  LOG_RECORD(category, LOGGER_LEVEL_INFO, __VA_ARGS__)
+#define LOG_DEBUG(category, ...) LOG_RECORD(category, LOGGER_LEVEL_DEBUG, __VA_ARGS__)
+
+//--------------------------------------------------------------------------------------------
+// Function declaration
+//--------------------------------------------------------------------------------------------
+
+/**
+ * @brief Start the background thread, records are written to file_name or stderr when it is NULL
+ *
+ * Records made before this stay in their rings and are written once the thread runs.
+ *
+ * @return 0: successful
+ *         <0: error code
+ */
+int init_logger(const char *file_name);
+
+/**
+ * @brief Write what is left in the rings, stop the background thread and report dropped records
+ */
+void close_logger(void);
+
+/**
+ * @brief Apply "level[:category,category...]", without categories the level applies to all of them
+ *
+ * Levels are off, error, warn, info and debug; categories are demux, pat, pmt, sdt, eit and io.
+ *
+ * @return 0: successful
+ *         <0: unknown level or category
+ */
+int parse_logger_options(const char *options);
+
+void set_logger_level(LoggerCategory category, LoggerLevel level);
+
+/**
+ * @brief Render the record into the ring of the calling thread, use LOG_RECORD so disabled levels cost one compare
+ */
+void write_logger_record(LoggerCategory category, LoggerLevel level, const char *format, ...) __attribute__((format(printf, 3, 4)));
+
+#endif
@@ -1,96 +1,939 @@
-/**
- * @file main.c
- *
- * @author :Yujin Yu
- * @date   :2025.03.05
- */
-
-#include <stdio.h>
-#include "ts_global.h"
-#include "ts_analyzer.h"
-#include "pid_save.h"
-#include "slot_filter.h"
-#include "get_pat_info.h"
-#include "get_pmt_info.h"
-#include "get_sdt_info.h"
-#include "get_eit_info.h"
-#include "integrate_data.h"
-#include "user.h"
-
-void process_table_info(Slot *slot)
-{
-	int error_code = 0;
-
-	if (fseek(slot->ts_file, slot->start_position, SEEK_SET) != 0)
-	{
-		LOG("%s:%d fseek error\n", __FILE__, __LINE__);
-	}
-
-	// step4
-	init_pat_resource(slot);
-	init_sdt_resource(slot);
-	init_eit_resource(slot); // should be free at the end of file
-
-	if ((error_code = section_filter(slot)) < 0)
-	{
-		LOG("error_code = %d\n", error_code);
-	}
-
-	// For insurance purposes, actually they had been released in their callback
-	free_pat_resource();
-	free_pmt_resource(); // which was init in pat_callback of get_pat_info.c
-	free_sdt_resource();
-	free_eit_resource(); // null, should be free at the end of file
-
-	external_interface(slot->ts_file, slot->start_position, slot->packet_size);
-
-	return;
-}
-
-void process_ts_file(FILE *input_fp)
-{
-	Slot         slot                = {0};
-	int          packet_size         = 0;
-	long         first_sync_position = 0;
-
-	// step1
-	packet_size = detect_ts_packet_size(input_fp, &first_sync_position);
-	if (packet_size < 0)
-	{
-		LOG("[step1 fail]: error code : %d\n", packet_size);
-		return;
-	}
-
-	DOUBLE_LINE
-	slot = init_slot(input_fp, (unsigned char)packet_size, first_sync_position);
-	LOG("[step1 success]: Packet length: %d bytes, First packet offset: %ld bytes\n", slot.packet_size, slot.start_position);
-	SINGLE_LINE;
-
-	process_table_info(&slot);
-	
-	clear_slot(&slot);
-	return;
-}
-
-int main(void)
-{
-	FILE *input_fp = NULL;
-
-	// const char *input_file = "C:\\Users\\Administrator\\Desktop\\training\\test_code_stream\\canal.ts";
-	// const char *input_file = "C:\\Users\\Administrator\\Desktop\\training\\test_code_stream\\ukdigital.ts";
-	// const char *input_file = "C:\\Users\\Administrator\\Desktop\\training\\test_code_stream\\black_border.ts";
-	const char *input_file ="C:\\Users\\YYJ\\Desktop\\code\\ukdigital\\ukdigital.ts";
-	
-
-	input_fp = fopen(input_file, "rb");
-	if (input_fp == NULL)
-	{
-		LOG("open input_file fail, error_code : %d\n", OPEN_INPUT_FILE_ERROR);
-		return -1;
-	}
-
-	process_ts_file(input_fp);
-
-	fclose(input_fp);
-	return 0;
-}
+/**
+ * @file main.c
+ *
+ * @author :Yujin Yu
+ * @date   :2025.03.05
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <limits.h>
+#include "ts_global.h"
+#include "ts_analyzer.h"
+#include "pid_save.h"
+#include "slot_filter.h"
+#include "get_pat_info.h"
+#include "get_pmt_info.h"
+#include "section_store.h"
+#include "string_pool.h"
+#include "get_sdt_info.h"
+#include "get_eit_info.h"
+#include "integrate_data.h"
+#include "user.h"
+#include "epg_export.h"
+#include "snapshot.h"
+#include "section_log.h"
+#include "udp_input.h"
+#include "table_context.h"
+#include "pcap_input.h"
+#include "benchmark.h"
+#include "ts_generator.h"
+#include "throughput.h"
+#include "instrument.h"
+#include "latency.h"
+#include "logger.h"
+#include "memory_account.h"
+
+#define UDP_DEFAULT_DURATION 10 // seconds
+
+static const char *snapshot_file_name    = NULL; // --snapshot=path, written after a scan and reused while the input is unchanged
+static const char *section_log_file_name = NULL; // --section-log=path, every section of a file or UDP scan is appended
+
+static int             is_benchmark_mode = 0; // --benchmark[=name], run the microbenchmarks instead of demuxing
+static BenchmarkConfig benchmark_config  = {0};
+
+static const char *generate_file_name = NULL; // --generate=path, write a synthetic stream instead of demuxing
+static const char *generate_options   = NULL; // --generate-options=key=value,...
+
+static const char *logger_file_name = NULL; // --log-file=path, stderr otherwise
+
+static int         is_latency_mode   = 0;    // --latency[=path], section to callback latency of file and UDP scans
+static const char *latency_file_name = NULL; // JSON written next to the printed table
+
+static int         is_throughput_mode = 0;    // --throughput[=key=value,...], run the end-to-end sweep instead of demuxing
+static const char *throughput_options = NULL;
+
+static int is_memory_mode = 0; // --memory or --memory-caps=..., print the table memory after a file or UDP scan
+
+/**
+ * @brief Give the slot latency histograms when --latency was asked for
+ */
+void attach_latency_stats(Slot *slot)
+{
+	if (is_latency_mode == 1)
+	{
+		slot->latency_stats = (LatencyStats *)calloc(1, sizeof(LatencyStats));
+	}
+}
+
+/**
+ * @brief Print and write the latency of the scan, then release the histograms
+ */
+void report_latency_stats(Slot *slot)
+{
+	FILE *output_fp = NULL;
+
+	if (slot->latency_stats == NULL)
+		return;
+
+	printf_latency_stats(slot->latency_stats);
+	if ((latency_file_name != NULL) && ((output_fp = fopen(latency_file_name, "w")) != NULL))
+	{
+		write_latency_json(output_fp, slot->latency_stats);
+		fclose(output_fp);
+	}
+	else if (latency_file_name != NULL)
+	{
+		LOG("open %s fail, error code : %d\n", latency_file_name, OPEN_OUTPUT_FILE_ERROR);
+	}
+
+	free(slot->latency_stats);
+	slot->latency_stats = NULL;
+}
+
+void process_table_info(Slot *slot)
+{
+	SectionLog section_log = {0};
+	int        error_code  = 0;
+
+	if (fseek(slot->ts_file, slot->start_position, SEEK_SET) != 0)
+	{
+		LOG("%s:%d fseek error\n", __FILE__, __LINE__);
+	}
+
+	// step4
+	init_pat_resource(slot);
+	init_sdt_resource(slot);
+	init_eit_resource(slot); // should be free at the end of file
+
+	if ((section_log_file_name != NULL) && (open_section_log(&section_log, section_log_file_name) == 0))
+	{
+		slot->section_log = &section_log;
+	}
+
+	attach_latency_stats(slot);
+	if ((error_code = section_filter(slot)) < 0)
+	{
+		LOG("error_code = %d\n", error_code);
+	}
+	report_latency_stats(slot);
+	if (is_memory_mode == 1)
+	{
+		printf_memory_account();
+	}
+
+	if (slot->section_log != NULL)
+	{
+		close_section_log(&section_log);
+		slot->section_log = NULL;
+	}
+
+	// For insurance purposes, actually they had been released in their callback
+	free_pat_resource();
+	free_pmt_resource(); // which was init in pat_callback of get_pat_info.c
+	free_sdt_resource();
+	free_eit_resource(); // null, should be free at the end of file
+
+	if (snapshot_file_name != NULL)
+	{
+		save_snapshot(snapshot_file_name, slot->ts_file, slot->packet_size, slot->start_position);
+	}
+
+	external_interface(slot->ts_file, slot->start_position, slot->packet_size);
+
+	return;
+}
+
+/**
+ * @brief Skip the scan when the snapshot was taken from this very file
+ *
+ * @return 1: the tables were restored and browsed
+ *         0: the file has to be scanned
+ */
+int process_snapshot(FILE *input_fp)
+{
+	Snapshot snapshot = {0};
+
+	if ((snapshot_file_name == NULL) || (open_snapshot(snapshot_file_name, &snapshot) < 0))
+		return 0;
+
+	if ((is_snapshot_of(&snapshot, input_fp) != 1) || (restore_snapshot(&snapshot) < 0))
+	{
+		LOG("snapshot %s does not match the input, scanning\n", snapshot_file_name);
+		close_snapshot(&snapshot);
+		return 0;
+	}
+
+	DOUBLE_LINE
+	LOG("[step1 skipped]: tables restored from %s\n", snapshot_file_name);
+	external_interface(input_fp, snapshot.header->source.start_position, (unsigned char)snapshot.header->source.packet_size);
+	close_snapshot(&snapshot);
+	return 1;
+}
+
+void process_ts_file(FILE *input_fp)
+{
+	Slot         slot                = {0};
+	int          packet_size         = 0;
+	long         first_sync_position = 0;
+
+	if (process_snapshot(input_fp) == 1)
+		return;
+
+	// step1
+	packet_size = detect_ts_packet_size(input_fp, &first_sync_position);
+	if (packet_size < 0)
+	{
+		LOG("[step1 fail]: error code : %d\n", packet_size);
+		return;
+	}
+
+	DOUBLE_LINE
+	slot = init_slot(input_fp, (unsigned char)packet_size, first_sync_position);
+	LOG("[step1 success]: Packet length: %d bytes, First packet offset: %ld bytes\n", slot.packet_size, slot.start_position);
+	SINGLE_LINE;
+
+	process_table_info(&slot);
+	
+	clear_slot(&slot);
+	return;
+}
+
+/**
+ * @brief Acquire the tables from udp://address:port or rtp://address:port, "@" or an empty address means any
+ */
+int process_udp_input(const char *url, int seconds)
+{
+	UdpInput      udp_input     = {0};
+	Slot          slot          = {0};
+	SectionLog    section_log   = {0};
+	UdpInputMode  mode          = UDP_MODE_AUTO;
+	char          address[64]   = {0};
+	const char   *host          = url + 6; // skip "udp://" or "rtp://"
+	const char   *port_position = NULL;
+	int           error_code    = 0;
+
+	if (strncmp(url, "rtp://", 6) == 0)
+		mode = UDP_MODE_RTP;
+
+	if (host[0] == '@')
+		host++;
+
+	port_position = strrchr(host, ':');
+	if ((port_position == NULL) || (port_position - host >= (int)sizeof(address)))
+	{
+		LOG("invalid url %s, expected udp://address:port\n", url);
+		return UDP_INPUT_PARAM_ERROR;
+	}
+	memcpy(address, host, port_position - host);
+
+	if ((error_code = udp_input_open(&udp_input, address, (unsigned short)atoi(port_position + 1), NULL, mode)) < 0)
+	{
+		LOG("udp_input_open fail, error code : %d\n", error_code);
+		return error_code;
+	}
+
+	DOUBLE_LINE
+	slot = init_slot(NULL, UDP_TS_PACKET_SIZE, 0);
+	LOG("receiving %s for %d seconds\n", url, seconds);
+
+	init_pat_resource(&slot);
+	init_sdt_resource(&slot);
+	init_eit_resource(&slot);
+
+	if ((section_log_file_name != NULL) && (open_section_log(&section_log, section_log_file_name) == 0))
+	{
+		slot.section_log = &section_log;
+	}
+
+	attach_latency_stats(&slot);
+	if ((error_code = udp_input_run(&udp_input, &slot, seconds)) < 0)
+	{
+		LOG("error_code = %d\n", error_code);
+	}
+	report_latency_stats(&slot);
+	if (is_memory_mode == 1)
+	{
+		printf_memory_account();
+	}
+	close_section_log(&section_log);
+	slot.section_log = NULL;
+	printf_udp_input_stats(&udp_input.stats);
+	udp_input_close(&udp_input);
+
+	free_pat_resource();
+	free_pmt_resource();
+	free_sdt_resource();
+	free_eit_resource();
+
+	// no file to extract from, "save" is refused by the interface
+	external_interface(NULL, 0, slot.packet_size);
+
+	clear_slot(&slot);
+	return error_code;
+}
+
+/**
+ * @brief Demux every UDP destination of a capture into its own context, filter is "address:port" or NULL
+ */
+int process_pcap_input(const char *file_name, const char *filter)
+{
+	PcapInput         pcap_input    = {0};
+	const PcapStream *stream        = NULL;
+	char              address[64]   = {0};
+	const char       *port_position = NULL;
+	unsigned short    port          = 0;
+	int               error_code    = 0;
+	int               i             = 0;
+
+	if (filter != NULL)
+	{
+		port_position = strrchr(filter, ':');
+		if (port_position == NULL)
+			port_position = filter + strlen(filter);
+		else
+			port = (unsigned short)atoi(port_position + 1);
+
+		if (port_position - filter >= (int)sizeof(address))
+		{
+			LOG("invalid filter %s, expected address:port\n", filter);
+			return PCAP_INPUT_PARAM_ERROR;
+		}
+		memcpy(address, filter, port_position - filter);
+	}
+
+	if ((error_code = pcap_input_open(&pcap_input, file_name, address, port)) < 0)
+	{
+		LOG("pcap_input_open fail, error code : %d\n", error_code);
+		return error_code;
+	}
+
+	DOUBLE_LINE
+	if ((error_code = pcap_input_run(&pcap_input)) < 0)
+	{
+		LOG("error_code = %d\n", error_code);
+	}
+	printf_pcap_input_stats(&pcap_input);
+
+	// clang-format off
+	for (i=0; i<pcap_input.stream_count; i++)
+	{ // clang-format on
+		stream = &pcap_input.stream_array[i];
+		LOG("[stream %d] %u.%u.%u.%u:%u\n", i,
+		    (stream->destination_address >> 24) & 0xFF, (stream->destination_address >> 16) & 0xFF,
+		    (stream->destination_address >> 8) & 0xFF, (stream->destination_address >> 0) & 0xFF,
+		    stream->destination_port);
+
+		switch_table_context(stream->table_context);
+		free_pat_resource();
+		free_pmt_resource();
+		free_sdt_resource();
+		free_eit_resource();
+		external_interface(NULL, 0, PCAP_TS_PACKET_SIZE);
+	}
+	switch_table_context(NULL);
+
+	pcap_input_close(&pcap_input);
+	return error_code;
+}
+
+/**
+ * @brief Run a section log through the table callbacks, no TS input and no packet filtering
+ */
+int process_section_log(const char *file_name)
+{
+	Slot      slot         = {0};
+	long long record_count = 0;
+
+	DOUBLE_LINE
+	slot = init_slot(NULL, TS_PACKET_SIZE, 0);
+
+	init_pat_resource(&slot);
+	init_sdt_resource(&slot);
+	init_eit_resource(&slot);
+
+	record_count = replay_section_log(file_name, &slot);
+	if (record_count < 0)
+	{
+		LOG("replay %s fail, error code : %lld\n", file_name, record_count);
+	}
+	else
+	{
+		LOG("replayed %lld sections from %s\n", record_count, file_name);
+	}
+
+	free_pat_resource();
+	free_pmt_resource();
+	free_sdt_resource();
+	free_eit_resource();
+
+	external_interface(NULL, 0, slot.packet_size);
+
+	clear_slot(&slot);
+	return (record_count < 0) ? (int)record_count : 0;
+}
+
+/**
+ * @brief Write the synthetic stream asked for by --generate and --generate-options
+ */
+int process_generate(void)
+{
+	TsGeneratorConfig config     = {0};
+	TsGeneratorStats  stats      = {0};
+	int               error_code = 0;
+
+	init_ts_generator_config(&config);
+	if ((generate_options != NULL) && ((error_code = parse_ts_generator_options(&config, generate_options)) < 0))
+	{
+		LOG("invalid --generate-options=%s, error code : %d\n", generate_options, error_code);
+		return error_code;
+	}
+
+	if ((error_code = generate_ts_file(generate_file_name, &config, &stats)) < 0)
+	{
+		LOG("generate %s fail, error code : %d\n", generate_file_name, error_code);
+		return error_code;
+	}
+
+	DOUBLE_LINE
+	LOG("generated %s, seed %u, %d programs, %d byte packets\n", generate_file_name, config.seed, config.program_count, config.packet_size);
+	printf_ts_generator_stats(&stats);
+	return 0;
+}
+
+/**
+ * @brief Run the sweep asked for by --throughput
+ *
+ * @return >=0: number of points that regressed against the baseline
+ *         <0 : error code
+ */
+int process_throughput(void)
+{
+	ThroughputConfig config     = {0};
+	int              error_code = 0;
+
+	init_throughput_config(&config);
+	if ((throughput_options != NULL) && ((error_code = parse_throughput_options(&config, throughput_options)) < 0))
+	{
+		LOG("invalid --throughput=%s, error code : %d\n", throughput_options, error_code);
+		return error_code;
+	}
+
+	if ((error_code = run_throughput_sweep(&config)) > 0)
+	{
+		LOG("%d points regressed against %s\n", error_code, config.baseline_file_name);
+	}
+	return error_code;
+}
+
+/**
+ * @brief Read one id of an EIT option, 0..0xFFFF followed by separator or the end of the string
+ *
+ * @return Position after the id, NULL when it is not a number or out of range
+ */
+static const char *parse_eit_id(const char *read_position, char separator, unsigned short *id)
+{
+	char         *end_position = NULL;
+	unsigned long number       = 0;
+
+	if ((*read_position < '0') || (*read_position > '9'))
+		return NULL;
+
+	number = strtoul(read_position, &end_position, 0);
+	if ((number > 0xFFFF) || ((*end_position != separator) && (*end_position != '\0')))
+		return NULL;
+
+	*id = (unsigned short)number;
+	return end_position;
+}
+
+/**
+ * @brief Take the EIT options out of argv: --eit-services=sid,sid,... --eit-onid=N --eit-tsid=N
+ *
+ * @return >=0: number of arguments left in argv
+ *         <0 : malformed id, id above 0xFFFF or more than MAX_EIT_SELECTED_SERVICE_COUNT services
+ */
+int parse_eit_options(int argc, char *argv[])
+{
+	EitServiceSelection selection      = {0};
+	const char         *read_position  = NULL;
+	int                 is_option_used = 0;
+	int                 left_count     = 0;
+	int                 i              = 0;
+
+	// clang-format off
+	for (i=0; i<argc; i++)
+	{ // clang-format on
+		if (strncmp(argv[i], "--eit-services=", 15) == 0)
+		{
+			read_position = argv[i] + 15;
+			do
+			{
+				if (selection.service_count == MAX_EIT_SELECTED_SERVICE_COUNT)
+				{
+					LOG("invalid %s, at most %d services\n", argv[i], MAX_EIT_SELECTED_SERVICE_COUNT);
+					return EIT_SELECTION_PARAM_ERROR;
+				}
+
+				read_position = parse_eit_id(read_position, ',', &selection.service_id_array[selection.service_count++]);
+				if (read_position == NULL)
+				{
+					LOG("invalid %s, expected --eit-services=sid,sid,... with sid 0..0xFFFF\n", argv[i]);
+					return EIT_SELECTION_PARAM_ERROR;
+				}
+			} while (*read_position++ == ',');
+			is_option_used = 1;
+		}
+		else if ((strncmp(argv[i], "--eit-onid=", 11) == 0) || (strncmp(argv[i], "--eit-tsid=", 11) == 0))
+		{
+			if (parse_eit_id(argv[i] + 11, '\0', (argv[i][6] == 'o') ? &selection.original_network_id : &selection.transport_stream_id) == NULL)
+			{
+				LOG("invalid %s, expected 0..0xFFFF\n", argv[i]);
+				return EIT_SELECTION_PARAM_ERROR;
+			}
+			is_option_used = 1;
+		}
+		else
+		{
+			argv[left_count++] = argv[i];
+		}
+	}
+
+	if (is_option_used == 1)
+	{
+		set_eit_service_selection(&selection);
+	}
+	return left_count;
+}
+
+/**
+ * @brief Take --events-range=start,end out of argv, UTC epoch seconds
+ *
+ * @return >=0: number of arguments left in argv
+ *         <0 : invalid range
+ */
+int parse_event_range_options(int argc, char *argv[])
+{
+	unsigned long start_time   = 0;
+	unsigned long end_time     = 0;
+	char         *end_position = NULL;
+	int           left_count   = 0;
+	int           i            = 0;
+
+	// clang-format off
+	for (i=0; i<argc; i++)
+	{ // clang-format on
+		if (strncmp(argv[i], "--events-range=", 15) == 0)
+		{
+			start_time = strtoul(argv[i] + 15, &end_position, 0);
+			if ((end_position == argv[i] + 15) || (*end_position != ','))
+			{
+				LOG("invalid %s, expected --events-range=start,end\n", argv[i]);
+				return PROGRAM_CATALOG_PARAM_ERROR;
+			}
+
+			end_time = strtoul(end_position + 1, &end_position, 0);
+			if ((*end_position != '\0') || (end_time < start_time))
+			{
+				LOG("invalid %s, expected --events-range=start,end\n", argv[i]);
+				return PROGRAM_CATALOG_PARAM_ERROR;
+			}
+			set_event_range(start_time, end_time);
+		}
+		else
+		{
+			argv[left_count++] = argv[i];
+		}
+	}
+	return left_count;
+}
+
+/**
+ * @brief Take the EPG export options out of argv: --xmltv=path --json=path
+ *
+ * @return Number of arguments left in argv
+ */
+int parse_export_options(int argc, char *argv[])
+{
+	EpgExportConfig config         = {0};
+	int             is_option_used = 0;
+	int             left_count     = 0;
+	int             i              = 0;
+
+	// clang-format off
+	for (i=0; i<argc; i++)
+	{ // clang-format on
+		if (strncmp(argv[i], "--xmltv=", 8) == 0)
+		{
+			config.xmltv_file_name = argv[i] + 8;
+			is_option_used         = 1;
+		}
+		else if (strncmp(argv[i], "--json=", 7) == 0)
+		{
+			config.json_file_name = argv[i] + 7;
+			is_option_used        = 1;
+		}
+		else
+		{
+			argv[left_count++] = argv[i];
+		}
+	}
+
+	if (is_option_used == 1)
+	{
+		set_epg_export_config(&config);
+	}
+	return left_count;
+}
+
+/**
+ * @brief Take --snapshot=path out of argv
+ *
+ * @return Number of arguments left in argv
+ */
+int parse_snapshot_options(int argc, char *argv[])
+{
+	int left_count = 0;
+	int i          = 0;
+
+	// clang-format off
+	for (i=0; i<argc; i++)
+	{ // clang-format on
+		if (strncmp(argv[i], "--snapshot=", 11) == 0)
+		{
+			snapshot_file_name = argv[i] + 11;
+		}
+		else
+		{
+			argv[left_count++] = argv[i];
+		}
+	}
+	return left_count;
+}
+
+/**
+ * @brief Take --section-log=path out of argv
+ *
+ * @return Number of arguments left in argv
+ */
+int parse_section_log_options(int argc, char *argv[])
+{
+	int left_count = 0;
+	int i          = 0;
+
+	// clang-format off
+	for (i=0; i<argc; i++)
+	{ // clang-format on
+		if (strncmp(argv[i], "--section-log=", 14) == 0)
+		{
+			section_log_file_name = argv[i] + 14;
+		}
+		else
+		{
+			argv[left_count++] = argv[i];
+		}
+	}
+	return left_count;
+}
+
+/**
+ * @brief Take the benchmark options out of argv: --benchmark[=name] --benchmark-output=path --benchmark-max-events=N
+ *
+ * @return >=0: number of arguments left in argv
+ *         <0 : invalid --benchmark-max-events
+ */
+int parse_benchmark_options(int argc, char *argv[])
+{
+	char *end_position = NULL;
+	long  number       = 0;
+	int   left_count   = 0;
+	int   i            = 0;
+
+	// clang-format off
+	for (i=0; i<argc; i++)
+	{ // clang-format on
+		if ((strcmp(argv[i], "--benchmark") == 0) || (strncmp(argv[i], "--benchmark=", 12) == 0))
+		{
+			benchmark_config.name_filter = (argv[i][11] == '=') ? argv[i] + 12 : NULL;
+			is_benchmark_mode            = 1;
+		}
+		else if (strncmp(argv[i], "--benchmark-output=", 19) == 0)
+		{
+			benchmark_config.output_file_name = argv[i] + 19;
+		}
+		else if (strncmp(argv[i], "--benchmark-max-events=", 23) == 0)
+		{
+			number = strtol(argv[i] + 23, &end_position, 10);
+			if ((end_position == argv[i] + 23) || (*end_position != '\0') || (number < 1) || (number > INT_MAX))
+			{
+				LOG("invalid %s, expected --benchmark-max-events=1..%d\n", argv[i], INT_MAX);
+				return BENCHMARK_PARAM_ERROR;
+			}
+			benchmark_config.max_event_count = (int)number;
+		}
+		else
+		{
+			argv[left_count++] = argv[i];
+		}
+	}
+	return left_count;
+}
+
+/**
+ * @brief Take the generator options out of argv: --generate=path --generate-options=key=value,...
+ *
+ * @return Number of arguments left in argv
+ */
+int parse_generator_options(int argc, char *argv[])
+{
+	int left_count = 0;
+	int i          = 0;
+
+	// clang-format off
+	for (i=0; i<argc; i++)
+	{ // clang-format on
+		if (strncmp(argv[i], "--generate=", 11) == 0)
+		{
+			generate_file_name = argv[i] + 11;
+		}
+		else if (strncmp(argv[i], "--generate-options=", 19) == 0)
+		{
+			generate_options = argv[i] + 19;
+		}
+		else
+		{
+			argv[left_count++] = argv[i];
+		}
+	}
+	return left_count;
+}
+
+/**
+ * @brief Take --throughput[=key=value,...] out of argv
+ *
+ * @return Number of arguments left in argv
+ */
+int parse_throughput_mode_options(int argc, char *argv[])
+{
+	int left_count = 0;
+	int i          = 0;
+
+	// clang-format off
+	for (i=0; i<argc; i++)
+	{ // clang-format on
+		if ((strcmp(argv[i], "--throughput") == 0) || (strncmp(argv[i], "--throughput=", 13) == 0))
+		{
+			throughput_options = (argv[i][12] == '=') ? argv[i] + 13 : NULL;
+			is_throughput_mode = 1;
+		}
+		else
+		{
+			argv[left_count++] = argv[i];
+		}
+	}
+	return left_count;
+}
+
+/**
+ * @brief Take --instrument=path out of argv and start the counters
+ *
+ * @return >=0: number of arguments left in argv
+ *         <0 : error code of init_instrument
+ */
+int parse_instrument_options(int argc, char *argv[])
+{
+	int left_count = 0;
+	int error_code = 0;
+	int i          = 0;
+
+	// clang-format off
+	for (i=0; i<argc; i++)
+	{ // clang-format on
+		if (strncmp(argv[i], "--instrument=", 13) == 0)
+		{
+			if ((error_code = init_instrument(argv[i] + 13)) < 0)
+			{
+				LOG("--instrument=%s failed, error code : %d\n", argv[i] + 13, error_code);
+				return error_code;
+			}
+		}
+		else
+		{
+			argv[left_count++] = argv[i];
+		}
+	}
+	return left_count;
+}
+
+/**
+ * @brief Take --latency[=path] out of argv
+ *
+ * @return Number of arguments left in argv
+ */
+int parse_latency_options(int argc, char *argv[])
+{
+	int left_count = 0;
+	int i          = 0;
+
+	// clang-format off
+	for (i=0; i<argc; i++)
+	{ // clang-format on
+		if ((strcmp(argv[i], "--latency") == 0) || (strncmp(argv[i], "--latency=", 10) == 0))
+		{
+			latency_file_name = (argv[i][9] == '=') ? argv[i] + 10 : NULL;
+			is_latency_mode   = 1;
+		}
+		else
+		{
+			argv[left_count++] = argv[i];
+		}
+	}
+	return left_count;
+}
+
+/**
+ * @brief Take the logger options out of argv: --log=level[:category,...] --log-file=path
+ *
+ * @return >=0: number of arguments left in argv
+ *         <0 : unknown level or category
+ */
+int parse_log_options(int argc, char *argv[])
+{
+	int left_count = 0;
+	int error_code = 0;
+	int i          = 0;
+
+	// clang-format off
+	for (i=0; i<argc; i++)
+	{ // clang-format on
+		if (strncmp(argv[i], "--log=", 6) == 0)
+		{
+			if ((error_code = parse_logger_options(argv[i] + 6)) < 0)
+			{
+				LOG("invalid %s, expected --log=level[:category,...]\n", argv[i]);
+				return error_code;
+			}
+		}
+		else if (strncmp(argv[i], "--log-file=", 11) == 0)
+		{
+			logger_file_name = argv[i] + 11;
+		}
+		else
+		{
+			argv[left_count++] = argv[i];
+		}
+	}
+	return left_count;
+}
+
+/**
+ * @brief Take the memory options out of argv: --memory --memory-caps=subsystem=KB,...
+ *
+ * @return >=0: number of arguments left in argv
+ *         <0 : unknown subsystem or size
+ */
+int parse_memory_options(int argc, char *argv[])
+{
+	int left_count = 0;
+	int error_code = 0;
+	int i          = 0;
+
+	// clang-format off
+	for (i=0; i<argc; i++)
+	{ // clang-format on
+		if (strcmp(argv[i], "--memory") == 0)
+		{
+			is_memory_mode = 1;
+		}
+		else if (strncmp(argv[i], "--memory-caps=", 14) == 0)
+		{
+			if ((error_code = parse_memory_caps(argv[i] + 14)) < 0)
+			{
+				LOG("invalid %s, expected --memory-caps=pat=KB,pmt=KB,sdt=KB,eit=KB,program=KB\n", argv[i]);
+				return error_code;
+			}
+			is_memory_mode = 1;
+		}
+		else
+		{
+			argv[left_count++] = argv[i];
+		}
+	}
+	return left_count;
+}
+
+int main(int argc, char *argv[])
+{
+	FILE *input_fp = NULL;
+
+	// const char *input_file = "C:\\Users\\Administrator\\Desktop\\training\\test_code_stream\\canal.ts";
+	// const char *input_file = "C:\\Users\\Administrator\\Desktop\\training\\test_code_stream\\ukdigital.ts";
+	// const char *input_file = "C:\\Users\\Administrator\\Desktop\\training\\test_code_stream\\black_border.ts";
+	const char *input_file ="C:\\Users\\YYJ\\Desktop\\code\\ukdigital\\ukdigital.ts";
+
+	if ((argc = parse_eit_options(argc, argv)) < 0)
+		return -1;
+	argc = parse_export_options(argc, argv);
+	argc = parse_snapshot_options(argc, argv);
+	argc = parse_section_log_options(argc, argv);
+	if ((argc = parse_benchmark_options(argc, argv)) < 0)
+		return -1;
+	argc = parse_generator_options(argc, argv);
+	argc = parse_throughput_mode_options(argc, argv);
+	if ((argc = parse_instrument_options(argc, argv)) < 0)
+		return -1;
+	argc = parse_latency_options(argc, argv);
+	if ((argc = parse_log_options(argc, argv)) < 0)
+		return -1;
+	if ((argc = parse_memory_options(argc, argv)) < 0)
+		return -1;
+	if ((argc = parse_event_range_options(argc, argv)) < 0)
+		return -1;
+	init_logger(logger_file_name);
+	if (is_benchmark_mode == 1)
+	{
+		return (run_benchmarks(&benchmark_config) < 0) ? -1 : 0;
+	}
+
+	if (generate_file_name != NULL)
+	{
+		return (process_generate() < 0) ? -1 : 0;
+	}
+
+	if (is_throughput_mode == 1)
+	{
+		return (process_throughput() != 0) ? -1 : 0;
+	}
+
+	if (argc > 1)
+		input_file = argv[1];
+
+	if ((strncmp(input_file, "udp://", 6) == 0) || (strncmp(input_file, "rtp://", 6) == 0))
+	{
+		return (process_udp_input(input_file, (argc > 2) ? atoi(argv[2]) : UDP_DEFAULT_DURATION) < 0) ? -1 : 0;
+	}
+
+	if (is_section_log_file(input_file) == 1)
+	{
+		return (process_section_log(input_file) < 0) ? -1 : 0;
+	}
+
+	if (is_pcap_file(input_file) == 1)
+	{
+		return (process_pcap_input(input_file, (argc > 2) ? argv[2] : NULL) < 0) ? -1 : 0;
+	}
+
+	input_fp = fopen(input_file, "rb");
+	if (input_fp == NULL)
+	{
+		LOG("open input_file fail, error_code : %d\n", OPEN_INPUT_FILE_ERROR);
+		return -1;
+	}
+
+	process_ts_file(input_fp);
+
+	fclose(input_fp);
+	return 0;
+}
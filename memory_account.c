@@ -0,0 +1,239 @@
+/**
+ * @file memory_account.c
+ *
+ * @author :Yujin Yu
+ * @date   :2025.06.04
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include "ts_global.h"
+#include "section_store.h"
+#include "string_pool.h"
+#include "table_context.h"
+#include "logger.h"
+#include "memory_account.h"
+
+static MemoryAccount memory_account = {0};
+
+static const char *subsystem_name_array[MEMORY_SUBSYSTEM_COUNT]   = {"pat", "pmt", "sdt", "eit", "program"};
+static const char *descriptor_name_array[MEMORY_DESCRIPTOR_COUNT] = {"short_event", "extended_event", "time_shifted_event",
+                                                                     "component", "content", "parental_rating", "other"};
+
+static const LoggerCategory category_array[MEMORY_SUBSYSTEM_COUNT] = {LOGGER_CATEGORY_PAT, LOGGER_CATEGORY_PMT, LOGGER_CATEGORY_SDT,
+                                                                      LOGGER_CATEGORY_EIT, LOGGER_CATEGORY_DEMUX};
+
+//--------------------------------------------------------------------------------------------
+MemoryAccount *get_memory_account(void)
+{
+	return &memory_account;
+}
+
+void add_memory(MemorySubsystem subsystem, long long node_bytes, long long descriptor_bytes, int node_count)
+{
+	MemoryUsage *usage = &memory_account.usage_array[subsystem];
+
+	usage->live_bytes += node_bytes + descriptor_bytes;
+	usage->descriptor_bytes += descriptor_bytes;
+	usage->node_count += node_count;
+
+	// the section store of each context is compacted against its own live loops
+	if ((subsystem == MEMORY_SUBSYSTEM_SDT) || (subsystem == MEMORY_SUBSYSTEM_EIT))
+		get_table_context()->descriptor_bytes += descriptor_bytes;
+
+	if (usage->live_bytes > usage->peak_bytes)
+		usage->peak_bytes = usage->live_bytes;
+	if (usage->node_count > usage->peak_node_count)
+		usage->peak_node_count = usage->node_count;
+}
+
+static MemoryDescriptorType get_descriptor_type(unsigned char descriptor_tag)
+{
+	switch (descriptor_tag)
+	{
+	case 0x4D:
+		return MEMORY_DESCRIPTOR_SHORT_EVENT;
+	case 0x4E:
+		return MEMORY_DESCRIPTOR_EXTENDED_EVENT;
+	case 0x4F:
+		return MEMORY_DESCRIPTOR_TIME_SHIFTED_EVENT;
+	case 0x50:
+		return MEMORY_DESCRIPTOR_COMPONENT;
+	case 0x54:
+		return MEMORY_DESCRIPTOR_CONTENT;
+	case 0x55:
+		return MEMORY_DESCRIPTOR_PARENTAL_RATING;
+	default:
+		return MEMORY_DESCRIPTOR_OTHER;
+	}
+}
+
+void add_eit_descriptor_memory(const unsigned char *buffer, int length, int sign)
+{
+	MemoryDescriptorType type          = MEMORY_DESCRIPTOR_OTHER;
+	int                  read_position = 0;
+	int                  size          = 0;
+
+	while (read_position < length)
+	{
+		// a truncated last descriptor still takes its bytes, it is counted as other
+		size = (read_position + 2 <= length) ? MIN(2 + buffer[read_position + 1], length - read_position) : length - read_position;
+		type = (size >= 2) ? get_descriptor_type(buffer[read_position]) : MEMORY_DESCRIPTOR_OTHER;
+
+		memory_account.descriptor_bytes_array[type] += sign * size;
+		memory_account.descriptor_count_array[type] += sign;
+		read_position += size;
+	}
+}
+
+int is_memory_cap_reached(MemorySubsystem subsystem, long long bytes)
+{
+	const MemoryUsage *usage = &memory_account.usage_array[subsystem];
+
+	return (usage->cap_bytes != 0) && (usage->live_bytes + bytes > (long long)usage->cap_bytes);
+}
+
+void count_memory_refused(MemorySubsystem subsystem)
+{
+	MemoryUsage *usage = &memory_account.usage_array[subsystem];
+
+	if (usage->refused_count++ == 0)
+	{
+		LOG_WARN(category_array[subsystem], "%s reached its cap of %llu bytes, new nodes are not stored\n", subsystem_name_array[subsystem], usage->cap_bytes);
+	}
+}
+
+void count_memory_evicted(MemorySubsystem subsystem)
+{
+	MemoryUsage *usage = &memory_account.usage_array[subsystem];
+
+	if (usage->evicted_count++ == 0)
+	{
+		LOG_WARN(category_array[subsystem], "%s reached its cap of %llu bytes, the oldest nodes are dropped\n", subsystem_name_array[subsystem], usage->cap_bytes);
+	}
+}
+
+void count_memory_compaction(long long reclaimed_bytes)
+{
+	memory_account.compaction_count++;
+	memory_account.reclaimed_bytes += reclaimed_bytes;
+}
+
+void set_memory_cap(MemorySubsystem subsystem, unsigned long long cap_bytes)
+{
+	if ((subsystem >= 0) && (subsystem < MEMORY_SUBSYSTEM_COUNT))
+		memory_account.usage_array[subsystem].cap_bytes = cap_bytes;
+}
+
+int parse_memory_caps(const char *options)
+{
+	const char        *position   = options;
+	const char        *end        = NULL;
+	char              *number_end = NULL;
+	unsigned long long cap_kb     = 0;
+	int                length     = 0;
+	int                subsystem  = 0;
+
+	if (options == NULL)
+		return MEMORY_PARAM_ERROR;
+
+	while (*position != '\0')
+	{
+		if ((end = strchr(position, '=')) == NULL)
+		{
+			LOG("invalid memory cap %s, expected subsystem=KB\n", position);
+			return MEMORY_PARAM_ERROR;
+		}
+
+		length = (int)(end - position);
+		// clang-format off
+		for (subsystem=0; subsystem<MEMORY_SUBSYSTEM_COUNT; subsystem++)
+		{ // clang-format on
+			if ((strncasecmp(position, subsystem_name_array[subsystem], length) == 0) && (subsystem_name_array[subsystem][length] == '\0'))
+				break;
+		}
+		if (subsystem == MEMORY_SUBSYSTEM_COUNT)
+		{
+			LOG("unknown memory subsystem %.*s\n", length, position);
+			return MEMORY_PARAM_ERROR;
+		}
+
+		cap_kb = strtoull(end + 1, &number_end, 10);
+		if ((number_end == end + 1) || ((*number_end != ',') && (*number_end != '\0')))
+		{
+			LOG("invalid memory cap %s\n", end + 1);
+			return MEMORY_PARAM_ERROR;
+		}
+
+		set_memory_cap((MemorySubsystem)subsystem, cap_kb * 1024);
+		position = (*number_end == ',') ? number_end + 1 : number_end;
+	}
+	return 0;
+}
+
+void printf_memory_account(void)
+{
+	const MemoryUsage *usage       = NULL;
+	long long          total_bytes = 0;
+	long long          total_peak  = 0;
+	int                i           = 0;
+
+	DOUBLE_LINE
+	LOG("table memory (bytes)\n");
+	LOG("%-10s %12s %12s %10s %12s %12s %10s %10s\n", "subsystem", "live", "descriptors", "nodes", "peak", "cap", "refused", "evicted");
+	SINGLE_LINE
+	// clang-format off
+	for (i=0; i<MEMORY_SUBSYSTEM_COUNT; i++)
+	{ // clang-format on
+		usage = &memory_account.usage_array[i];
+		total_bytes += usage->live_bytes;
+		total_peak += usage->peak_bytes;
+		LOG("%-10s %12lld %12lld %10lld %12lld %12llu %10llu %10llu\n", subsystem_name_array[i], usage->live_bytes, usage->descriptor_bytes,
+		    usage->node_count, usage->peak_bytes, usage->cap_bytes, usage->refused_count, usage->evicted_count);
+	}
+	SINGLE_LINE
+	LOG("%-10s %12lld %12s %10s %12lld\n", "total", total_bytes, "", "", total_peak);
+
+	LOG("\nEIT descriptors: ");
+	// clang-format off
+	for (i=0; i<MEMORY_DESCRIPTOR_COUNT; i++)
+	{ // clang-format on
+		LOG("%s %lld/%lld%s", descriptor_name_array[i], memory_account.descriptor_bytes_array[i], memory_account.descriptor_count_array[i],
+		    (i + 1 < MEMORY_DESCRIPTOR_COUNT) ? ", " : "\n");
+	}
+	LOG("section store: %u of %u bytes used, %llu compactions gave back %llu bytes\n", get_table_context()->section_store.length,
+	    get_table_context()->section_store.capacity, memory_account.compaction_count, memory_account.reclaimed_bytes);
+}
+
+void write_memory_json(FILE *output_fp, const char *indent)
+{
+	const TableContext *table_context = get_table_context();
+	const MemoryUsage  *usage         = NULL;
+	int                 i             = 0;
+
+	fprintf(output_fp, "{\n");
+	// clang-format off
+	for (i=0; i<MEMORY_SUBSYSTEM_COUNT; i++)
+	{ // clang-format on
+		usage = &memory_account.usage_array[i];
+		fprintf(output_fp, "%s  \"%s\": {\"live_bytes\": %lld, \"descriptor_bytes\": %lld, \"nodes\": %lld, \"peak_bytes\": %lld, \"peak_nodes\": %lld, "
+		                   "\"cap_bytes\": %llu, \"refused\": %llu, \"evicted\": %llu},\n",
+		        indent, subsystem_name_array[i], usage->live_bytes, usage->descriptor_bytes, usage->node_count, usage->peak_bytes, usage->peak_node_count,
+		        usage->cap_bytes, usage->refused_count, usage->evicted_count);
+	}
+
+	fprintf(output_fp, "%s  \"eit_descriptors\": {", indent);
+	// clang-format off
+	for (i=0; i<MEMORY_DESCRIPTOR_COUNT; i++)
+	{ // clang-format on
+		fprintf(output_fp, "\"%s\": {\"bytes\": %lld, \"count\": %lld}%s", descriptor_name_array[i], memory_account.descriptor_bytes_array[i],
+		        memory_account.descriptor_count_array[i], (i + 1 < MEMORY_DESCRIPTOR_COUNT) ? ", " : "},\n");
+	}
+
+	fprintf(output_fp, "%s  \"section_store\": {\"length\": %u, \"capacity\": %u, \"compactions\": %llu, \"reclaimed_bytes\": %llu},\n", indent,
+	        table_context->section_store.length, table_context->section_store.capacity, memory_account.compaction_count, memory_account.reclaimed_bytes);
+	fprintf(output_fp, "%s  \"string_pool\": {\"length\": %u, \"capacity\": %u, \"strings\": %u}\n%s}", indent, table_context->string_pool.length,
+	        table_context->string_pool.capacity, table_context->string_pool.string_count, indent);
+}
@@ -0,0 +1,116 @@
+/**
+ * @file memory_account.h
+ *
+ * @brief Live bytes, node counts and peaks of the table lists, by subsystem. Every malloc and free of a
+ *        table node is accounted where it happens, so the numbers are exact and cost one add. A subsystem
+ *        can be given a cap: PAT, PMT, SDT and the program info stop storing new nodes once it is reached,
+ *        the EIT drops the events that end first, so an endless run of EIT versions stays bounded.
+ *        Accounting is process wide, the demux contexts of one process share the caps.
+ *
+ * @author :Yujin Yu
+ * @date   :2025.06.04
+ */
+#ifndef MEMORY_ACCOUNT_H
+#define MEMORY_ACCOUNT_H
+
+//--------------------------------------------------------------------------------------------
+// macro definition
+//--------------------------------------------------------------------------------------------
+#define MEMORY_COMPACTION_RATIO  2  // the section store is rewritten when it holds this many times the live descriptor loops
+#define MEMORY_EVICTION_HEADROOM 64 // an EIT eviction frees 1/16 of the cap beyond what the new event needs
+
+typedef enum
+{
+	MEMORY_SUBSYSTEM_PAT = 0,
+	MEMORY_SUBSYSTEM_PMT,          // PMT nodes and their ES nodes, those copied into opened programs included
+	MEMORY_SUBSYSTEM_SDT,          // service nodes and their descriptor loops
+	MEMORY_SUBSYSTEM_EIT,          // event nodes and their descriptor loops
+	MEMORY_SUBSYSTEM_PROGRAM_INFO, // integrated program nodes and their event arrays
+	MEMORY_SUBSYSTEM_COUNT,
+} MemorySubsystem;
+
+// Descriptors of the EIT descriptor loops, by tag
+typedef enum
+{
+	MEMORY_DESCRIPTOR_SHORT_EVENT = 0,    // 0x4D
+	MEMORY_DESCRIPTOR_EXTENDED_EVENT,     // 0x4E
+	MEMORY_DESCRIPTOR_TIME_SHIFTED_EVENT, // 0x4F
+	MEMORY_DESCRIPTOR_COMPONENT,          // 0x50
+	MEMORY_DESCRIPTOR_CONTENT,            // 0x54
+	MEMORY_DESCRIPTOR_PARENTAL_RATING,    // 0x55
+	MEMORY_DESCRIPTOR_OTHER,
+	MEMORY_DESCRIPTOR_COUNT,
+} MemoryDescriptorType;
+
+typedef struct
+{
+	long long          live_bytes;       // nodes and descriptor loops
+	long long          descriptor_bytes; // the descriptor loop part of live_bytes
+	long long          node_count;
+	long long          peak_bytes;
+	long long          peak_node_count;
+	unsigned long long cap_bytes;     // 0: no cap
+	unsigned long long refused_count; // nodes not stored because the cap was reached
+	unsigned long long evicted_count; // nodes dropped to get back under the cap
+} MemoryUsage;
+
+typedef struct
+{
+	MemoryUsage usage_array[MEMORY_SUBSYSTEM_COUNT];
+
+	long long descriptor_bytes_array[MEMORY_DESCRIPTOR_COUNT]; // live bytes of the EIT descriptors, tag and length included
+	long long descriptor_count_array[MEMORY_DESCRIPTOR_COUNT];
+
+	unsigned long long compaction_count; // section store rewrites
+	unsigned long long reclaimed_bytes;  // store bytes given back by them
+} MemoryAccount;
+
+//--------------------------------------------------------------------------------------------
+// Function declaration
+//--------------------------------------------------------------------------------------------
+MemoryAccount *get_memory_account(void);
+
+/**
+ * @brief Account an allocation, or a free with negative values
+ *
+ * @param node_bytes       sizeof of the nodes
+ * @param descriptor_bytes bytes of their descriptor loops in the section store
+ * @param node_count       number of nodes
+ */
+void add_memory(MemorySubsystem subsystem, long long node_bytes, long long descriptor_bytes, int node_count);
+
+/**
+ * @brief Account the descriptors of an EIT descriptor loop by tag, sign is 1 when the loop is stored and -1 when it is dropped
+ */
+void add_eit_descriptor_memory(const unsigned char *buffer, int length, int sign);
+
+/**
+ * @return 1: storing bytes more would go over the cap of the subsystem
+ *         0: no cap, or still room
+ */
+int is_memory_cap_reached(MemorySubsystem subsystem, long long bytes);
+
+void count_memory_refused(MemorySubsystem subsystem); // warns the first time
+void count_memory_evicted(MemorySubsystem subsystem);
+void count_memory_compaction(long long reclaimed_bytes);
+
+/**
+ * @brief Apply "subsystem=KB,subsystem=KB...", subsystems are pat, pmt, sdt, eit and program; 0 removes a cap
+ *
+ * @return 0: successful
+ *         <0: unknown subsystem or size
+ */
+int parse_memory_caps(const char *options);
+
+void set_memory_cap(MemorySubsystem subsystem, unsigned long long cap_bytes);
+
+void printf_memory_account(void);
+
+/**
+ * @brief Write the account and the section store and string pool of the current table context as one JSON object
+ *
+ * @param indent Prefix of every line after the first, so the object can be nested in another dump
+ */
+void write_memory_json(FILE *output_fp, const char *indent);
+
+#endif
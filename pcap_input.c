@@ -0,0 +1,586 @@
+/**
+ * @file pcap_input.c
+ *
+ * @brief Reads pcap and pcapng captures without copying: the file is mapped, every packet record is
+ *        decoded in place (Ethernet/SLL/raw IP -> IPv4 -> UDP -> optional RTP) and the TS packets are
+ *        run through the filter bank of the stream their UDP destination belongs to.
+ *
+ * @author :Yujin Yu
+ * @date   :2025.05.08
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <arpa/inet.h>
+#include "ts_global.h"
+#include "slot_filter.h"
+#include "section_store.h"
+#include "string_pool.h"
+#include "table_context.h"
+#include "get_pat_info.h"
+#include "get_sdt_info.h"
+#include "get_eit_info.h"
+#include "udp_input.h"
+#include "pcap_input.h"
+
+#define PCAP_GLOBAL_HEADER_LENGTH 24
+#define PCAP_RECORD_HEADER_LENGTH 16
+#define PCAPNG_SECTION_HEADER     0x0A0D0D0A
+#define PCAPNG_INTERFACE_BLOCK    0x00000001
+#define PCAPNG_PACKET_BLOCK       0x00000002 // obsolete
+#define PCAPNG_SIMPLE_BLOCK       0x00000003
+#define PCAPNG_ENHANCED_BLOCK     0x00000006
+#define PCAPNG_BYTE_ORDER_MAGIC   0x1A2B3C4D
+
+#define ETHERTYPE_IPV4 0x0800
+#define ETHERTYPE_VLAN 0x8100
+#define ETHERTYPE_QINQ 0x88A8
+#define IP_PROTOCOL_UDP 17
+
+static unsigned int read_u32(const unsigned char *buffer, int is_big_endian)
+{
+	if (is_big_endian == 1)
+		return ((unsigned int)buffer[0] << 24) | (buffer[1] << 16) | (buffer[2] << 8) | buffer[3];
+
+	return ((unsigned int)buffer[3] << 24) | (buffer[2] << 16) | (buffer[1] << 8) | buffer[0];
+}
+
+static unsigned short read_u16(const unsigned char *buffer, int is_big_endian)
+{
+	if (is_big_endian == 1)
+		return (buffer[0] << 8) | buffer[1];
+
+	return (buffer[1] << 8) | buffer[0];
+}
+
+int is_pcap_file(const char *file_name)
+{
+	FILE         *input_fp = NULL;
+	unsigned char magic[4] = {0};
+	unsigned int  value    = 0;
+	int           ret      = 0;
+
+	input_fp = fopen(file_name, "rb");
+	if (input_fp == NULL)
+		return 0;
+
+	if (fread(magic, 1, sizeof(magic), input_fp) == sizeof(magic))
+	{
+		value = read_u32(magic, 1);
+		if ((value == 0xA1B2C3D4) || (value == 0xD4C3B2A1) || // microsecond timestamps
+		    (value == 0xA1B23C4D) || (value == 0x4D3CB2A1) || // nanosecond timestamps
+		    (value == PCAPNG_SECTION_HEADER))
+		{
+			ret = 1;
+		}
+	}
+
+	fclose(input_fp);
+	return ret;
+}
+
+int pcap_input_open(PcapInput *pcap_input, const char *file_name, const char *filter_address, unsigned short filter_port)
+{
+	struct stat    file_status = {0};
+	struct in_addr address     = {0};
+	unsigned int   magic       = 0;
+
+	if ((pcap_input == NULL) || (file_name == NULL))
+	{
+		return PCAP_INPUT_PARAM_ERROR;
+	}
+
+	memset(pcap_input, 0, sizeof(PcapInput));
+	pcap_input->file_descriptor = -1;
+	pcap_input->filter_port     = filter_port;
+
+	if ((filter_address != NULL) && (filter_address[0] != '\0'))
+	{
+		if (inet_pton(AF_INET, filter_address, &address) != 1)
+		{
+			LOG("invalid address %s\n", filter_address);
+			return PCAP_INPUT_PARAM_ERROR;
+		}
+		pcap_input->filter_address = ntohl(address.s_addr);
+	}
+
+	pcap_input->file_descriptor = open(file_name, O_RDONLY);
+	if ((pcap_input->file_descriptor < 0) || (fstat(pcap_input->file_descriptor, &file_status) != 0))
+	{
+		perror("open");
+		pcap_input_close(pcap_input);
+		return PCAP_INPUT_OPEN_ERROR;
+	}
+
+	pcap_input->file_size = file_status.st_size;
+	if (pcap_input->file_size < PCAP_GLOBAL_HEADER_LENGTH)
+	{
+		pcap_input_close(pcap_input);
+		return PCAP_INPUT_FORMAT_ERROR;
+	}
+
+	pcap_input->file_data = mmap(NULL, pcap_input->file_size, PROT_READ, MAP_PRIVATE, pcap_input->file_descriptor, 0);
+	if (pcap_input->file_data == MAP_FAILED)
+	{
+		perror("mmap");
+		pcap_input->file_data = NULL;
+		pcap_input_close(pcap_input);
+		return PCAP_INPUT_MMAP_ERROR;
+	}
+	madvise(pcap_input->file_data, pcap_input->file_size, MADV_SEQUENTIAL);
+
+	magic = read_u32(pcap_input->file_data, 1);
+	if (magic == PCAPNG_SECTION_HEADER)
+	{
+		// the byte order is settled by each section header block while walking
+		pcap_input->is_pcapng = 1;
+		return 0;
+	}
+
+	if ((magic == 0xA1B2C3D4) || (magic == 0xA1B23C4D))
+	{
+		pcap_input->is_big_endian = 1;
+	}
+	else if ((magic == 0xD4C3B2A1) || (magic == 0x4D3CB2A1))
+	{
+		pcap_input->is_big_endian = 0;
+	}
+	else
+	{
+		pcap_input_close(pcap_input);
+		return PCAP_INPUT_FORMAT_ERROR;
+	}
+
+	pcap_input->link_type = (int)read_u32(pcap_input->file_data + 20, pcap_input->is_big_endian);
+	return 0;
+}
+
+/**
+ * @brief Find the IPv4 header behind the link layer header
+ *
+ * @return >=0: offset of the IPv4 header
+ *         <0 : not IPv4 or unknown link type
+ */
+static int get_ipv4_offset(const unsigned char *frame, int length, int link_type)
+{
+	unsigned short ether_type = 0;
+	unsigned int   family     = 0;
+	int            offset     = 0;
+
+	switch (link_type)
+	{
+	case LINKTYPE_ETHERNET:
+		if (length < 14)
+			return -1;
+		offset     = 12;
+		ether_type = (frame[offset] << 8) | frame[offset + 1];
+		while (((ether_type == ETHERTYPE_VLAN) || (ether_type == ETHERTYPE_QINQ)) && (offset + 6 <= length))
+		{
+			offset += 4;
+			ether_type = (frame[offset] << 8) | frame[offset + 1];
+		}
+		offset += 2;
+		break;
+
+	case LINKTYPE_LINUX_SLL:
+		if (length < 16)
+			return -1;
+		ether_type = (frame[14] << 8) | frame[15];
+		offset     = 16;
+		break;
+
+	case LINKTYPE_LINUX_SLL2:
+		if (length < 20)
+			return -1;
+		ether_type = (frame[0] << 8) | frame[1];
+		offset     = 20;
+		break;
+
+	case LINKTYPE_NULL:
+	case LINKTYPE_LOOP:
+		if (length < 4)
+			return -1;
+		// AF_INET is 2 on every platform, stored in host order (NULL) or network order (LOOP)
+		family     = read_u32(frame, 0);
+		ether_type = ((family == 2) || (family == 0x02000000)) ? ETHERTYPE_IPV4 : 0;
+		offset     = 4;
+		break;
+
+	case LINKTYPE_RAW:
+	case LINKTYPE_IPV4:
+		ether_type = ETHERTYPE_IPV4;
+		offset     = 0;
+		break;
+
+	default:
+		return -1;
+	}
+
+	if ((ether_type != ETHERTYPE_IPV4) || (offset + 20 > length) || ((frame[offset] >> 4) != 4))
+		return -1;
+
+	return offset;
+}
+
+static PcapStream *find_pcap_stream(PcapInput *pcap_input, unsigned int destination_address, unsigned short destination_port)
+{
+	int i = 0;
+
+	// clang-format off
+	for (i=0; i<pcap_input->stream_count; i++)
+	{ // clang-format on
+		if ((pcap_input->stream_array[i].destination_address == destination_address) &&
+		    (pcap_input->stream_array[i].destination_port == destination_port))
+		{
+			return &pcap_input->stream_array[i];
+		}
+	}
+
+	return NULL;
+}
+
+// Every new destination gets a slot and a table context of its own, the tables are installed into both
+static PcapStream *add_pcap_stream(PcapInput *pcap_input, unsigned int destination_address, unsigned short destination_port, int is_rtp)
+{
+	PcapStream *stream = NULL;
+
+	if (pcap_input->stream_count >= PCAP_MAX_STREAM_COUNT)
+		return NULL;
+
+	stream                = &pcap_input->stream_array[pcap_input->stream_count];
+	stream->slot          = (Slot *)malloc(sizeof(Slot));
+	stream->table_context = alloc_table_context();
+	if ((stream->slot == NULL) || (stream->table_context == NULL))
+	{
+		LOG("malloc error\n");
+		free(stream->slot);
+		free_table_context(stream->table_context);
+		memset(stream, 0, sizeof(PcapStream));
+		return NULL;
+	}
+
+	*stream->slot               = init_slot(NULL, PCAP_TS_PACKET_SIZE, 0);
+	stream->slot->table_context = stream->table_context;
+	stream->destination_address = destination_address;
+	stream->destination_port    = destination_port;
+	stream->is_rtp              = is_rtp;
+	pcap_input->stream_count++;
+
+	switch_table_context(stream->table_context);
+	init_pat_resource(stream->slot);
+	init_sdt_resource(stream->slot);
+	init_eit_resource(stream->slot);
+	switch_table_context(NULL);
+
+	return stream;
+}
+
+static void process_udp_payload(PcapStream *stream, unsigned char *payload, int length)
+{
+	unsigned short sequence_number = 0;
+	unsigned short sequence_gap    = 0;
+	int            read_position   = 0;
+	int            payload_end     = length;
+	int            run_count       = 0;
+
+	if (stream->is_rtp == 1)
+	{
+		read_position = parse_rtp_header(payload, length, &sequence_number, &payload_end);
+		if (read_position < 0)
+			return;
+
+		if (stream->is_rtp_sequence_valid == 1)
+		{
+			sequence_gap = (unsigned short)(sequence_number - stream->rtp_next_sequence);
+			if (sequence_gap >= 0x8000)
+				return; // duplicate or late, already counted as lost
+
+			stream->rtp_lost_count += sequence_gap;
+		}
+		stream->is_rtp_sequence_valid = 1;
+		stream->rtp_next_sequence     = sequence_number + 1;
+	}
+
+	stream->datagram_count++;
+	while (read_position + PCAP_TS_PACKET_SIZE <= payload_end)
+	{
+		if (payload[read_position] != SYNC_BYTE)
+		{
+			stream->sync_error_count++;
+			read_position += PCAP_TS_PACKET_SIZE;
+			continue;
+		}
+
+		// a datagram carries up to 7 packets, the aligned ones are decoded as one batch
+		run_count = 1;
+		while ((read_position + (run_count + 1) * PCAP_TS_PACKET_SIZE <= payload_end) &&
+		       (payload[read_position + run_count * PCAP_TS_PACKET_SIZE] == SYNC_BYTE))
+		{
+			run_count++;
+		}
+
+		filter_ts_packets(stream->slot, payload + read_position, run_count, PCAP_TS_PACKET_SIZE);
+		stream->ts_packet_count += run_count;
+		read_position += run_count * PCAP_TS_PACKET_SIZE;
+	}
+}
+
+static void process_pcap_frame(PcapInput *pcap_input, unsigned char *frame, int captured_length, int original_length, int link_type)
+{
+	PcapStream *stream = NULL;
+
+	unsigned int   destination_address = 0;
+	unsigned short destination_port    = 0;
+	unsigned short fragment_field      = 0;
+	unsigned short sequence_number     = 0;
+	int            ip_offset           = 0;
+	int            ip_header_length    = 0;
+	int            udp_offset          = 0;
+	int            udp_length          = 0;
+	int            payload_end         = 0;
+	int            rtp_header_length   = 0;
+
+	pcap_input->record_count++;
+	if (captured_length < original_length)
+	{
+		pcap_input->truncated_count++;
+	}
+
+	ip_offset = get_ipv4_offset(frame, captured_length, link_type);
+	if ((ip_offset < 0) || (frame[ip_offset + 9] != IP_PROTOCOL_UDP))
+	{
+		pcap_input->skipped_count++;
+		return;
+	}
+
+	fragment_field = (frame[ip_offset + 6] << 8) | frame[ip_offset + 7];
+	if ((fragment_field & 0x3FFF) != 0) // more fragments or a fragment offset
+	{
+		pcap_input->fragment_count++;
+		return;
+	}
+
+	ip_header_length = (frame[ip_offset] & 0x0F) * 4;
+	udp_offset       = ip_offset + ip_header_length;
+	if (udp_offset + 8 > captured_length)
+	{
+		pcap_input->skipped_count++;
+		return;
+	}
+
+	destination_address = read_u32(frame + ip_offset + 16, 1);
+	destination_port    = read_u16(frame + udp_offset + 2, 1);
+	udp_length          = read_u16(frame + udp_offset + 4, 1);
+	payload_end         = MIN(udp_offset + udp_length, captured_length);
+	pcap_input->udp_datagram_count++;
+
+	if (((pcap_input->filter_address != 0) && (pcap_input->filter_address != destination_address)) ||
+	    ((pcap_input->filter_port != 0) && (pcap_input->filter_port != destination_port)) ||
+	    (payload_end - (udp_offset + 8) <= 0))
+	{
+		pcap_input->skipped_count++;
+		return;
+	}
+
+	stream = find_pcap_stream(pcap_input, destination_address, destination_port);
+	if (stream == NULL)
+	{
+		// only destinations that carry TS, either directly or behind an RTP header, become streams
+		if (frame[udp_offset + 8] == SYNC_BYTE)
+		{
+			stream = add_pcap_stream(pcap_input, destination_address, destination_port, 0);
+		}
+		else
+		{
+			rtp_header_length = parse_rtp_header(frame + udp_offset + 8, payload_end - udp_offset - 8, &sequence_number, &udp_length);
+			if ((rtp_header_length >= 0) && (udp_offset + 8 + rtp_header_length < payload_end) &&
+			    (frame[udp_offset + 8 + rtp_header_length] == SYNC_BYTE))
+			{
+				stream = add_pcap_stream(pcap_input, destination_address, destination_port, 1);
+			}
+		}
+
+		if (stream == NULL)
+		{
+			pcap_input->skipped_count++;
+			return;
+		}
+	}
+
+	process_udp_payload(stream, frame + udp_offset + 8, payload_end - udp_offset - 8);
+}
+
+static int walk_pcap_records(PcapInput *pcap_input)
+{
+	long long    read_position   = PCAP_GLOBAL_HEADER_LENGTH;
+	unsigned int captured_length = 0;
+	unsigned int original_length = 0;
+
+	while (read_position + PCAP_RECORD_HEADER_LENGTH <= pcap_input->file_size)
+	{
+		captured_length = read_u32(pcap_input->file_data + read_position + 8, pcap_input->is_big_endian);
+		original_length = read_u32(pcap_input->file_data + read_position + 12, pcap_input->is_big_endian);
+		read_position += PCAP_RECORD_HEADER_LENGTH;
+
+		if (read_position + captured_length > pcap_input->file_size)
+		{
+			LOG("pcap record cut at file offset %lld\n", read_position);
+			break;
+		}
+
+		process_pcap_frame(pcap_input, pcap_input->file_data + read_position, (int)captured_length, (int)original_length, pcap_input->link_type);
+		read_position += captured_length;
+	}
+
+	return 0;
+}
+
+static int walk_pcapng_blocks(PcapInput *pcap_input)
+{
+	unsigned char *block           = NULL;
+	long long      read_position   = 0;
+	unsigned int   block_type      = 0;
+	unsigned int   block_length    = 0;
+	unsigned int   interface_id    = 0;
+	unsigned int   captured_length = 0;
+	unsigned int   original_length = 0;
+
+	while (read_position + 12 <= pcap_input->file_size)
+	{
+		block = pcap_input->file_data + read_position;
+
+		// the block type of a section header reads the same in both byte orders
+		block_type = read_u32(block, pcap_input->is_big_endian);
+		if (block_type == PCAPNG_SECTION_HEADER)
+		{
+			pcap_input->is_big_endian   = (read_u32(block + 8, 1) == PCAPNG_BYTE_ORDER_MAGIC) ? 1 : 0;
+			pcap_input->interface_count = 0;
+		}
+
+		block_length = read_u32(block + 4, pcap_input->is_big_endian);
+		if ((block_length < 12) || (read_position + block_length > pcap_input->file_size))
+		{
+			LOG("pcapng block cut at file offset %lld\n", read_position);
+			break;
+		}
+
+		switch (block_type)
+		{
+		case PCAPNG_INTERFACE_BLOCK:
+			if ((pcap_input->interface_count < PCAP_MAX_INTERFACE_COUNT) && (block_length >= 20))
+			{
+				pcap_input->interface_link_type[pcap_input->interface_count++] = read_u16(block + 8, pcap_input->is_big_endian);
+			}
+			break;
+
+		case PCAPNG_ENHANCED_BLOCK:
+		case PCAPNG_PACKET_BLOCK:
+			if (block_length < 32)
+				break;
+
+			if (block_type == PCAPNG_ENHANCED_BLOCK)
+				interface_id = read_u32(block + 8, pcap_input->is_big_endian);
+			else
+				interface_id = read_u16(block + 8, pcap_input->is_big_endian);
+
+			captured_length = read_u32(block + 20, pcap_input->is_big_endian);
+			original_length = read_u32(block + 24, pcap_input->is_big_endian);
+			if ((interface_id >= (unsigned int)pcap_input->interface_count) || (captured_length > block_length - 32))
+				break;
+
+			process_pcap_frame(pcap_input, block + 28, (int)captured_length, (int)original_length, pcap_input->interface_link_type[interface_id]);
+			break;
+
+		case PCAPNG_SIMPLE_BLOCK:
+			if ((block_length < 16) || (pcap_input->interface_count == 0))
+				break;
+
+			original_length = read_u32(block + 8, pcap_input->is_big_endian);
+			captured_length = MIN(original_length, block_length - 16);
+			process_pcap_frame(pcap_input, block + 12, (int)captured_length, (int)original_length, pcap_input->interface_link_type[0]);
+			break;
+
+		default:
+			break;
+		}
+
+		read_position += block_length;
+	}
+
+	return 0;
+}
+
+int pcap_input_run(PcapInput *pcap_input)
+{
+	int ret = 0;
+
+	if ((pcap_input == NULL) || (pcap_input->file_data == NULL))
+	{
+		return PCAP_INPUT_PARAM_ERROR;
+	}
+
+	if (pcap_input->is_pcapng == 1)
+		ret = walk_pcapng_blocks(pcap_input);
+	else
+		ret = walk_pcap_records(pcap_input);
+
+	switch_table_context(NULL);
+	return ret;
+}
+
+void pcap_input_close(PcapInput *pcap_input)
+{
+	int i = 0;
+
+	// clang-format off
+	for (i=0; i<pcap_input->stream_count; i++)
+	{ // clang-format on
+		if (pcap_input->stream_array[i].slot != NULL)
+		{
+			clear_slot(pcap_input->stream_array[i].slot); // PID set filters own their context pool
+		}
+		free(pcap_input->stream_array[i].slot);
+		free_table_context(pcap_input->stream_array[i].table_context);
+	}
+	pcap_input->stream_count = 0;
+
+	if (pcap_input->file_data != NULL)
+	{
+		munmap(pcap_input->file_data, pcap_input->file_size);
+		pcap_input->file_data = NULL;
+	}
+
+	if (pcap_input->file_descriptor >= 0)
+	{
+		close(pcap_input->file_descriptor);
+		pcap_input->file_descriptor = -1;
+	}
+}
+
+void printf_pcap_input_stats(const PcapInput *pcap_input)
+{
+	const PcapStream *stream = NULL;
+	int               i      = 0;
+
+	SINGLE_LINE
+	LOG("pcap input: records: %llu | UDP datagrams: %llu | skipped: %llu | fragments: %llu | truncated: %llu\n",
+	    pcap_input->record_count, pcap_input->udp_datagram_count, pcap_input->skipped_count,
+	    pcap_input->fragment_count, pcap_input->truncated_count);
+
+	// clang-format off
+	for (i=0; i<pcap_input->stream_count; i++)
+	{ // clang-format on
+		stream = &pcap_input->stream_array[i];
+		LOG("  [%d] %u.%u.%u.%u:%u %s | datagrams: %llu | TS packets: %llu | RTP lost: %llu | sync errors: %llu\n",
+		    i,
+		    (stream->destination_address >> 24) & 0xFF, (stream->destination_address >> 16) & 0xFF,
+		    (stream->destination_address >> 8) & 0xFF, (stream->destination_address >> 0) & 0xFF,
+		    stream->destination_port, (stream->is_rtp == 1) ? "RTP" : "UDP",
+		    stream->datagram_count, stream->ts_packet_count, stream->rtp_lost_count, stream->sync_error_count);
+	}
+	SINGLE_LINE
+}
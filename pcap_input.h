@@ -0,0 +1,104 @@
+/**
+ * @file pcap_input.h
+ *
+ * @brief Offline input from pcap/pcapng captures of UDP or RTP transport streams
+ *
+ * @author :Yujin Yu
+ * @date   :2025.05.08
+ */
+#ifndef PCAP_INPUT_H
+#define PCAP_INPUT_H
+
+//--------------------------------------------------------------------------------------------
+// macro definition
+//--------------------------------------------------------------------------------------------
+#define PCAP_MAX_STREAM_COUNT    16 // destination address:port pairs demuxed side by side
+#define PCAP_MAX_INTERFACE_COUNT 16 // pcapng interface description blocks per section
+#define PCAP_TS_PACKET_SIZE      188
+
+#define LINKTYPE_NULL       0
+#define LINKTYPE_ETHERNET   1
+#define LINKTYPE_RAW        101
+#define LINKTYPE_LOOP       108
+#define LINKTYPE_LINUX_SLL  113
+#define LINKTYPE_IPV4       228
+#define LINKTYPE_LINUX_SLL2 276
+
+struct TableContext;
+
+// One UDP destination carrying a transport stream, it owns a complete demux context
+typedef struct
+{
+	unsigned int         destination_address; // host byte order
+	unsigned short       destination_port;
+	int                  is_rtp;
+	int                  is_rtp_sequence_valid;
+	unsigned short       rtp_next_sequence;
+	unsigned long long   datagram_count;
+	unsigned long long   ts_packet_count;
+	unsigned long long   rtp_lost_count;
+	unsigned long long   sync_error_count;
+	Slot                *slot;
+	struct TableContext *table_context;
+} PcapStream;
+
+typedef struct
+{
+	int            file_descriptor;
+	unsigned char *file_data; // whole capture, mapped read only
+	long long      file_size;
+
+	int is_pcapng;
+	int is_big_endian;
+	int link_type;                                     // classic pcap
+	int interface_link_type[PCAP_MAX_INTERFACE_COUNT]; // pcapng, per interface of the current section
+	int interface_count;
+
+	unsigned int   filter_address; // host byte order, 0 accepts any destination
+	unsigned short filter_port;    // 0 accepts any port
+
+	PcapStream stream_array[PCAP_MAX_STREAM_COUNT];
+	int        stream_count;
+
+	unsigned long long record_count;
+	unsigned long long udp_datagram_count;
+	unsigned long long skipped_count;   // not IPv4/UDP, filtered out or not a transport stream
+	unsigned long long fragment_count;  // IP fragments are not reassembled
+	unsigned long long truncated_count; // records cut by the snap length
+} PcapInput;
+
+//--------------------------------------------------------------------------------------------
+// Function declaration
+//--------------------------------------------------------------------------------------------
+/**
+ * @brief Check the magic number of a file
+ *
+ * @return 1: pcap or pcapng file
+ *         0: anything else
+ */
+int is_pcap_file(const char *file_name);
+
+/**
+ * @brief Map a capture file and validate its header
+ *
+ * @param pcap_input     Pointer to the PcapInput structure to initialise
+ * @param file_name      pcap or pcapng file
+ * @param filter_address Only demux this IPv4 destination, NULL or "" for any
+ * @param filter_port    Only demux this UDP destination port, 0 for any
+ *
+ * @return 0: successful
+ *         <0: error code
+ */
+int pcap_input_open(PcapInput *pcap_input, const char *file_name, const char *filter_address, unsigned short filter_port);
+
+/**
+ * @brief Walk every record of the capture and feed the TS payload of each UDP destination into its own slot
+ *
+ * @return 0: successful
+ *         <0: error code
+ */
+int  pcap_input_run(PcapInput *pcap_input);
+void pcap_input_close(PcapInput *pcap_input);
+void printf_pcap_input_stats(const PcapInput *pcap_input);
+
+#endif
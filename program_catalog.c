@@ -0,0 +1,576 @@
+/**
+ * @file program_catalog.c
+ *
+ * @author :Yujin Yu
+ * @date   :2025.05.16
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ts_global.h"
+#include "slot_filter.h"
+#include "get_pat_info.h"
+#include "get_pmt_info.h"
+#include "section_store.h"
+#include "string_pool.h"
+#include "get_sdt_info.h"
+#include "get_eit_info.h"
+#include "integrate_data.h"
+#include "table_context.h"
+#include "program_catalog.h"
+
+#define CATALOG_ALIGNMENT 8
+
+// Hand out 8 byte aligned arrays from one block
+static void *carve_array(unsigned char **cursor, size_t size)
+{
+	void *array = *cursor;
+
+	*cursor += (size + CATALOG_ALIGNMENT - 1) & ~(size_t)(CATALOG_ALIGNMENT - 1);
+	return array;
+}
+
+static size_t get_array_size(size_t size)
+{
+	return (size + CATALOG_ALIGNMENT - 1) & ~(size_t)(CATALOG_ALIGNMENT - 1);
+}
+
+static int compare_eit_node_by_time(const void *a, const void *b)
+{
+	const EitNode *node_a = *(EitNode *const *)a;
+	const EitNode *node_b = *(EitNode *const *)b;
+
+	if (node_a->start_time != node_b->start_time)
+		return (node_a->start_time < node_b->start_time) ? -1 : 1;
+	if (node_a->event_id != node_b->event_id)
+		return (node_a->event_id < node_b->event_id) ? -1 : 1;
+	return 0;
+}
+
+typedef struct
+{
+	unsigned long start_time;
+	unsigned int  event_index;
+} EventTimeKey;
+
+static int compare_event_time_key(const void *a, const void *b)
+{
+	const EventTimeKey *key_a = (const EventTimeKey *)a;
+	const EventTimeKey *key_b = (const EventTimeKey *)b;
+
+	if (key_a->start_time != key_b->start_time)
+		return (key_a->start_time < key_b->start_time) ? -1 : 1;
+	return (key_a->event_index < key_b->event_index) ? -1 : (key_a->event_index > key_b->event_index);
+}
+
+// Order of the program list and of the eit list on (service_id, transport_stream_id)
+static int compare_program_with_event(const ProgramInfoNode *program_info_node, const EitNode *eit_node)
+{
+	if (program_info_node->program_number != eit_node->service_id)
+		return (program_info_node->program_number < eit_node->service_id) ? -1 : 1;
+	if (program_info_node->transport_stream_id != eit_node->transport_stream_id)
+		return (program_info_node->transport_stream_id < eit_node->transport_stream_id) ? -1 : 1;
+	return 0;
+}
+
+static int alloc_program_columns(ProgramCatalog *program_catalog, int program_count)
+{
+	unsigned char *cursor = NULL;
+	size_t         size   = 0;
+
+	size = get_array_size(program_count * sizeof(unsigned short)) * 4 +
+	       get_array_size(program_count * sizeof(unsigned char)) +
+	       get_array_size(program_count * sizeof(StringHandle)) * 2 +
+	       get_array_size((program_count + 1) * sizeof(unsigned int)) * 2;
+
+	program_catalog->program_block = malloc(size);
+	if (program_catalog->program_block == NULL)
+		return PROGRAM_CATALOG_MALLOC_ERROR;
+
+	cursor                                 = (unsigned char *)program_catalog->program_block;
+	program_catalog->program_number        = (unsigned short *)carve_array(&cursor, program_count * sizeof(unsigned short));
+	program_catalog->transport_stream_id   = (unsigned short *)carve_array(&cursor, program_count * sizeof(unsigned short));
+	program_catalog->original_network_id   = (unsigned short *)carve_array(&cursor, program_count * sizeof(unsigned short));
+	program_catalog->pcr_pid               = (unsigned short *)carve_array(&cursor, program_count * sizeof(unsigned short));
+	program_catalog->service_type          = (unsigned char *)carve_array(&cursor, program_count * sizeof(unsigned char));
+	program_catalog->service_name          = (StringHandle *)carve_array(&cursor, program_count * sizeof(StringHandle));
+	program_catalog->service_provider_name = (StringHandle *)carve_array(&cursor, program_count * sizeof(StringHandle));
+	program_catalog->es_begin              = (unsigned int *)carve_array(&cursor, (program_count + 1) * sizeof(unsigned int));
+	program_catalog->event_begin           = (unsigned int *)carve_array(&cursor, (program_count + 1) * sizeof(unsigned int));
+	program_catalog->program_count         = program_count;
+	return 0;
+}
+
+static int alloc_es_columns(ProgramCatalog *program_catalog, int es_count)
+{
+	unsigned char *cursor = NULL;
+	size_t         size   = 0;
+
+	size = get_array_size(es_count * sizeof(unsigned char)) +
+	       get_array_size(es_count * sizeof(unsigned short));
+
+	program_catalog->es_block = malloc(size + CATALOG_ALIGNMENT); // never 0 bytes
+	if (program_catalog->es_block == NULL)
+		return PROGRAM_CATALOG_MALLOC_ERROR;
+
+	cursor                          = (unsigned char *)program_catalog->es_block;
+	program_catalog->stream_type    = (unsigned char *)carve_array(&cursor, es_count * sizeof(unsigned char));
+	program_catalog->elementary_pid = (unsigned short *)carve_array(&cursor, es_count * sizeof(unsigned short));
+	program_catalog->es_count       = es_count;
+	return 0;
+}
+
+static int alloc_event_columns(ProgramCatalog *program_catalog, int event_count)
+{
+	unsigned char *cursor = NULL;
+	size_t         size   = 0;
+
+	size = get_array_size(event_count * sizeof(unsigned short)) +
+	       get_array_size(event_count * sizeof(unsigned long)) +
+	       get_array_size(event_count * sizeof(unsigned int)) * 3 +
+	       get_array_size(event_count * sizeof(DescriptorLoop));
+
+	program_catalog->event_block = malloc(size + CATALOG_ALIGNMENT);
+	if (program_catalog->event_block == NULL)
+		return PROGRAM_CATALOG_MALLOC_ERROR;
+
+	cursor                           = (unsigned char *)program_catalog->event_block;
+	program_catalog->event_id        = (unsigned short *)carve_array(&cursor, event_count * sizeof(unsigned short));
+	program_catalog->start_time      = (unsigned long *)carve_array(&cursor, event_count * sizeof(unsigned long));
+	program_catalog->duration        = (unsigned int *)carve_array(&cursor, event_count * sizeof(unsigned int));
+	program_catalog->descriptor_loop = (DescriptorLoop *)carve_array(&cursor, event_count * sizeof(DescriptorLoop));
+	program_catalog->event_program   = (unsigned int *)carve_array(&cursor, event_count * sizeof(unsigned int));
+	program_catalog->event_by_start  = (unsigned int *)carve_array(&cursor, event_count * sizeof(unsigned int));
+	program_catalog->event_count     = event_count;
+	return 0;
+}
+
+// Every stream of the pmt in program order, the browser filters them with is_target_stream_type on display
+static int fill_es_columns(ProgramCatalog *program_catalog, ProgramInfoList *program_info_list)
+{
+	ProgramInfoNode *current_program_info_node = NULL;
+	PmtESNode       *pmt_es_node               = NULL;
+	int              program_index             = 0;
+	int              es_count                  = 0;
+	int              error_code                = 0;
+
+	for (current_program_info_node = program_info_list; current_program_info_node != NULL; current_program_info_node = current_program_info_node->next)
+	{
+		for (pmt_es_node = (current_program_info_node->pmt_node != NULL) ? current_program_info_node->pmt_node->es_info_list : NULL; pmt_es_node != NULL; pmt_es_node = pmt_es_node->next)
+		{
+			es_count++;
+		}
+	}
+
+	if ((error_code = alloc_es_columns(program_catalog, es_count)) < 0)
+		return error_code;
+
+	es_count = 0;
+	for (current_program_info_node = program_info_list; current_program_info_node != NULL; current_program_info_node = current_program_info_node->next)
+	{
+		program_catalog->es_begin[program_index++] = es_count;
+		for (pmt_es_node = (current_program_info_node->pmt_node != NULL) ? current_program_info_node->pmt_node->es_info_list : NULL; pmt_es_node != NULL; pmt_es_node = pmt_es_node->next)
+		{
+			program_catalog->stream_type[es_count]    = pmt_es_node->stream_type;
+			program_catalog->elementary_pid[es_count] = pmt_es_node->elementary_pid;
+			es_count++;
+		}
+	}
+	program_catalog->es_begin[program_index] = es_count;
+	return 0;
+}
+
+static int build_event_time_index(ProgramCatalog *program_catalog)
+{
+	EventTimeKey *key_array = NULL;
+	int           i         = 0;
+
+	key_array = (EventTimeKey *)malloc((program_catalog->event_count + 1) * sizeof(EventTimeKey));
+	if (key_array == NULL)
+		return PROGRAM_CATALOG_MALLOC_ERROR;
+
+	// clang-format off
+	for (i=0; i<program_catalog->event_count; i++)
+	{ // clang-format on
+		key_array[i].start_time  = program_catalog->start_time[i];
+		key_array[i].event_index = i;
+	}
+
+	qsort(key_array, program_catalog->event_count, sizeof(EventTimeKey), compare_event_time_key);
+	// clang-format off
+	for (i=0; i<program_catalog->event_count; i++)
+	{ // clang-format on
+		program_catalog->event_by_start[i] = key_array[i].event_index;
+	}
+
+	free(key_array);
+	return 0;
+}
+
+// Merge join: the program list and the eit list are both ordered by (service_id, transport_stream_id)
+static int fill_event_columns(ProgramCatalog *program_catalog, ProgramInfoList *program_info_list)
+{
+	ProgramInfoNode *current_program_info_node = NULL;
+	EitNode         *eit_node                  = NULL;
+	EitNode        **event_node_array          = NULL;
+	int              program_index             = 0;
+	int              event_count               = 0;
+	int              eit_count                 = 0;
+	int              i                         = 0;
+	int              error_code                = 0;
+
+	for (eit_node = get_eit_list(); eit_node != NULL; eit_node = eit_node->next)
+	{
+		eit_count++;
+	}
+
+	event_node_array = (EitNode **)malloc((eit_count + 1) * sizeof(EitNode *));
+	if (event_node_array == NULL)
+		return PROGRAM_CATALOG_MALLOC_ERROR;
+
+	current_program_info_node = program_info_list;
+	eit_node                  = get_eit_list();
+	while (current_program_info_node != NULL)
+	{
+		program_catalog->event_begin[program_index] = event_count;
+
+		while ((eit_node != NULL) && (compare_program_with_event(current_program_info_node, eit_node) > 0))
+		{
+			eit_node = eit_node->next;
+		}
+		while ((eit_node != NULL) && (compare_program_with_event(current_program_info_node, eit_node) == 0))
+		{
+			if (eit_node->original_network_id == current_program_info_node->original_network_id)
+			{
+				event_node_array[event_count++] = eit_node;
+			}
+			eit_node = eit_node->next;
+		}
+
+		// the eit list is not ordered by time reliably, sort each program's range on its own
+		qsort(event_node_array + program_catalog->event_begin[program_index],
+		      event_count - program_catalog->event_begin[program_index],
+		      sizeof(EitNode *),
+		      compare_eit_node_by_time);
+
+		current_program_info_node = current_program_info_node->next;
+		program_index++;
+	}
+	program_catalog->event_begin[program_index] = event_count;
+
+	if ((error_code = alloc_event_columns(program_catalog, event_count)) < 0)
+	{
+		free(event_node_array);
+		return error_code;
+	}
+
+	// clang-format off
+	for (i=0; i<event_count; i++)
+	{ // clang-format on
+		program_catalog->event_id[i]        = event_node_array[i]->event_id;
+		program_catalog->start_time[i]      = event_node_array[i]->start_time;
+		program_catalog->duration[i]        = event_node_array[i]->duration;
+		program_catalog->descriptor_loop[i] = event_node_array[i]->descriptor_loop;
+		program_catalog->max_duration       = MAX(program_catalog->max_duration, event_node_array[i]->duration);
+	}
+	// clang-format off
+	for (program_index=0; program_index<program_catalog->program_count; program_index++)
+	{ // clang-format on
+		for (i = program_catalog->event_begin[program_index]; i < (int)program_catalog->event_begin[program_index + 1]; i++)
+		{
+			program_catalog->event_program[i] = program_index;
+		}
+	}
+
+	free(event_node_array);
+	return build_event_time_index(program_catalog);
+}
+
+int build_program_catalog(ProgramInfoList *program_info_list, ProgramCatalog *program_catalog)
+{
+	ProgramInfoNode *current_program_info_node = NULL;
+	int              program_count             = 0;
+	int              i                         = 0;
+	int              error_code                = 0;
+
+	if (program_catalog == NULL)
+		return PROGRAM_CATALOG_PARAM_ERROR;
+
+	memset(program_catalog, 0, sizeof(ProgramCatalog));
+	for (current_program_info_node = program_info_list; current_program_info_node != NULL; current_program_info_node = current_program_info_node->next)
+	{
+		program_count++;
+	}
+
+	if ((error_code = alloc_program_columns(program_catalog, program_count)) < 0)
+		return error_code;
+
+	for (current_program_info_node = program_info_list, i = 0; current_program_info_node != NULL; current_program_info_node = current_program_info_node->next, i++)
+	{
+		program_catalog->program_number[i]        = current_program_info_node->program_number;
+		program_catalog->transport_stream_id[i]   = current_program_info_node->transport_stream_id;
+		program_catalog->original_network_id[i]   = current_program_info_node->original_network_id;
+		program_catalog->pcr_pid[i]               = current_program_info_node->pcr_pid;
+		program_catalog->service_type[i]          = current_program_info_node->service_type;
+		program_catalog->service_name[i]          = current_program_info_node->service_name;
+		program_catalog->service_provider_name[i] = current_program_info_node->service_provider_name;
+	}
+
+	if (((error_code = fill_es_columns(program_catalog, program_info_list)) < 0) ||
+	    ((error_code = fill_event_columns(program_catalog, program_info_list)) < 0))
+	{
+		free_program_catalog(program_catalog);
+		return error_code;
+	}
+
+	return 0;
+}
+
+void free_program_catalog(ProgramCatalog *program_catalog)
+{
+	if (program_catalog == NULL)
+		return;
+
+	free(program_catalog->program_block);
+	free(program_catalog->es_block);
+	free(program_catalog->event_block);
+	memset(program_catalog, 0, sizeof(ProgramCatalog));
+}
+
+int find_program_index(const ProgramCatalog *program_catalog, unsigned short program_number)
+{
+	int low  = 0;
+	int high = program_catalog->program_count - 1;
+	int mid  = 0;
+
+	while (low <= high)
+	{
+		mid = (low + high) / 2;
+		if (program_catalog->program_number[mid] == program_number)
+		{
+			while ((mid > 0) && (program_catalog->program_number[mid - 1] == program_number))
+			{
+				mid--; // first one, like the linear search of the program list
+			}
+			return mid;
+		}
+
+		if (program_catalog->program_number[mid] < program_number)
+			low = mid + 1;
+		else
+			high = mid - 1;
+	}
+	return -1;
+}
+
+int get_next_program_index(const ProgramCatalog *program_catalog, int program_index)
+{
+	return ((program_index >= 0) && (program_index + 1 < program_catalog->program_count)) ? program_index + 1 : -1;
+}
+
+int get_prev_program_index(const ProgramCatalog *program_catalog, int program_index)
+{
+	return ((program_index > 0) && (program_index < program_catalog->program_count)) ? program_index - 1 : -1;
+}
+
+// First position in [low, high) whose start_time is greater than time, positions map through index_array if given
+static int upper_bound_start_time(const ProgramCatalog *program_catalog, const unsigned int *index_array, int low, int high, unsigned long time)
+{
+	int mid = 0;
+
+	while (low < high)
+	{
+		mid = low + (high - low) / 2;
+		if (program_catalog->start_time[(index_array != NULL) ? index_array[mid] : (unsigned int)mid] <= time)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+	return low;
+}
+
+int get_now_next_event(const ProgramCatalog *program_catalog, int program_index, unsigned long now, int *now_event_index, int *next_event_index)
+{
+	int begin    = 0;
+	int end      = 0;
+	int position = 0;
+
+	if ((program_catalog == NULL) || (program_index < 0) || (program_index >= program_catalog->program_count) ||
+	    (now_event_index == NULL) || (next_event_index == NULL))
+	{
+		return PROGRAM_CATALOG_PARAM_ERROR;
+	}
+
+	begin    = program_catalog->event_begin[program_index];
+	end      = program_catalog->event_begin[program_index + 1];
+	position = upper_bound_start_time(program_catalog, NULL, begin, end, now);
+
+	*next_event_index = (position < end) ? position : -1;
+	*now_event_index  = -1;
+	if ((position > begin) && (now < program_catalog->start_time[position - 1] + program_catalog->duration[position - 1]))
+	{
+		*now_event_index = position - 1;
+	}
+	return 0;
+}
+
+int query_events_in_range(const ProgramCatalog *program_catalog, unsigned long start_time, unsigned long end_time, int *event_index_array, int max_count)
+{
+	unsigned long earliest_start = 0;
+	unsigned long event_start    = 0;
+	unsigned long event_end      = 0;
+	int           position       = 0;
+	int           match_count    = 0;
+	unsigned int  event_index    = 0;
+
+	if ((program_catalog == NULL) || ((event_index_array == NULL) && (max_count > 0)) || (end_time < start_time))
+	{
+		return PROGRAM_CATALOG_PARAM_ERROR;
+	}
+
+	// an event starting before start_time - max_duration has ended before start_time
+	earliest_start = (start_time > program_catalog->max_duration) ? start_time - program_catalog->max_duration : 0;
+	position       = (earliest_start > 0) ? upper_bound_start_time(program_catalog, program_catalog->event_by_start, 0, program_catalog->event_count, earliest_start - 1) : 0;
+
+	for (; position < program_catalog->event_count; position++)
+	{
+		event_index = program_catalog->event_by_start[position];
+		event_start = program_catalog->start_time[event_index];
+		if (event_start >= end_time)
+			break;
+
+		event_end = event_start + program_catalog->duration[event_index];
+		if ((event_end > start_time) || ((event_end == event_start) && (event_start >= start_time)))
+		{
+			if (match_count < max_count)
+			{
+				event_index_array[match_count] = event_index;
+			}
+			match_count++;
+		}
+	}
+	return match_count;
+}
+
+void printf_catalog_program(const ProgramCatalog *program_catalog, int program_index)
+{
+	EventDataNode event_data_node = {0};
+	int           i               = 0;
+
+	if ((program_index < 0) || (program_index >= program_catalog->program_count))
+		return;
+
+	SINGLE_LINE
+	LOG("program_number:%d | service_name:%s | provider_name:%s\n",
+	    program_catalog->program_number[program_index],
+	    get_string(program_catalog->service_name[program_index]),
+	    get_string(program_catalog->service_provider_name[program_index]));
+
+	LOG("\t[PMT]pcr_pid:0x%04X\n", program_catalog->pcr_pid[program_index]);
+	// the pmt list holds the streams in reverse, walking back gives the order of the section
+	for (i = (int)program_catalog->es_begin[program_index + 1] - 1; i >= (int)program_catalog->es_begin[program_index]; i--)
+	{
+		if (is_target_stream_type(program_catalog->stream_type[i]) == 0)
+			continue;
+
+		LOG("\t   [PMT->ES]stream_type:0x%02X | elementary_pid:0x%04X\n",
+		    program_catalog->stream_type[i],
+		    program_catalog->elementary_pid[i]);
+	}
+
+	LOG("\t----------------------------------------------------------------------------------------\n");
+	for (i = program_catalog->event_begin[program_index]; i < (int)program_catalog->event_begin[program_index + 1]; i++)
+	{
+		event_data_node.event_id        = program_catalog->event_id[i];
+		event_data_node.start_time      = program_catalog->start_time[i];
+		event_data_node.duration        = program_catalog->duration[i];
+		event_data_node.descriptor_loop = program_catalog->descriptor_loop[i];
+		printf_eit_descriptor(&event_data_node);
+	}
+
+	SINGLE_LINE
+}
+
+// One event: program, start, duration and the name of its first short event descriptor
+static void printf_catalog_event(const ProgramCatalog *program_catalog, const char *label, int event_index)
+{
+	ShortEventDescriptor short_event_descriptor = {0};
+	char                 time_string[UTC_TIME_STRING_SIZE];
+
+	if (event_index < 0)
+	{
+		LOG("\t[%s] none\n", label);
+		return;
+	}
+
+	get_short_event_descriptor(program_catalog->descriptor_loop[event_index], 0, &short_event_descriptor);
+	LOG("\t[%s] program_number:%d | start_time:%s | duration:%u | name:%s\n",
+	    label,
+	    program_catalog->program_number[program_catalog->event_program[event_index]],
+	    format_utc_time(program_catalog->start_time[event_index], time_string),
+	    program_catalog->duration[event_index],
+	    get_string(short_event_descriptor.name));
+}
+
+void printf_now_next_event(const ProgramCatalog *program_catalog, int program_index, unsigned long now)
+{
+	int now_event_index  = -1;
+	int next_event_index = -1;
+
+	if (get_now_next_event(program_catalog, program_index, now, &now_event_index, &next_event_index) < 0)
+		return;
+
+	printf_catalog_event(program_catalog, "now", now_event_index);
+	printf_catalog_event(program_catalog, "next", next_event_index);
+}
+
+int printf_events_in_range(const ProgramCatalog *program_catalog, unsigned long start_time, unsigned long end_time)
+{
+	int *event_index_array = NULL;
+	int  event_count       = 0;
+	int  i                 = 0;
+	char start_string[UTC_TIME_STRING_SIZE];
+	char end_string[UTC_TIME_STRING_SIZE];
+
+	if ((event_count = query_events_in_range(program_catalog, start_time, end_time, NULL, 0)) < 0)
+		return event_count;
+
+	event_index_array = (int *)malloc((event_count + 1) * sizeof(int));
+	if (event_index_array == NULL)
+		return PROGRAM_CATALOG_MALLOC_ERROR;
+	event_count = query_events_in_range(program_catalog, start_time, end_time, event_index_array, event_count);
+
+	DOUBLE_LINE
+	LOG("events from %s to %s: %d\n", format_utc_time(start_time, start_string), format_utc_time(end_time, end_string), event_count);
+	SINGLE_LINE
+	// clang-format off
+	for (i=0; i<event_count; i++)
+	{ // clang-format on
+		printf_catalog_event(program_catalog, "EIT", event_index_array[i]);
+	}
+	DOUBLE_LINE
+
+	free(event_index_array);
+	return event_count;
+}
+
+void printf_program_catalog(const ProgramCatalog *program_catalog)
+{
+	int i = 0;
+
+	DOUBLE_LINE
+	LOG("program_number |  service_name   |     provider_name       | pcr_pid |  es | events \n");
+	SINGLE_LINE
+	// clang-format off
+	for (i=0; i<program_catalog->program_count; i++)
+	{ // clang-format on
+		LOG("      %5d    | %-15s |     %-15s     | 0x%04X  | %3u | %6u \n",
+		    program_catalog->program_number[i],
+		    get_string(program_catalog->service_name[i]),
+		    get_string(program_catalog->service_provider_name[i]),
+		    program_catalog->pcr_pid[i],
+		    program_catalog->es_begin[i + 1] - program_catalog->es_begin[i],
+		    program_catalog->event_begin[i + 1] - program_catalog->event_begin[i]);
+	}
+	DOUBLE_LINE
+}
@@ -0,0 +1,131 @@
+/**
+ * @file program_catalog.h
+ *
+ * @brief Read-only catalog of programs, elementary streams and events in contiguous per-field arrays.
+ *        A program refers to its streams and events by index ranges, so walking the catalog for
+ *        printing, search or export reads the arrays front to back. Include integrate_data.h first.
+ *
+ * @author :Yujin Yu
+ * @date   :2025.05.16
+ */
+#ifndef PROGRAM_CATALOG_H
+#define PROGRAM_CATALOG_H
+
+typedef struct
+{
+	// programs, sorted by program_number
+	int             program_count;
+	unsigned short *program_number;
+	unsigned short *transport_stream_id;
+	unsigned short *original_network_id;
+	unsigned short *pcr_pid;
+	unsigned char  *service_type;
+	StringHandle   *service_name;
+	StringHandle   *service_provider_name;
+	unsigned int   *es_begin;    // program_count + 1 entries, streams of program i are [es_begin[i], es_begin[i + 1])
+	unsigned int   *event_begin; // program_count + 1 entries, events of program i are [event_begin[i], event_begin[i + 1])
+
+	// elementary streams
+	int             es_count;
+	unsigned char  *stream_type;
+	unsigned short *elementary_pid;
+
+	// events, sorted by start_time inside each program
+	int             event_count;
+	unsigned short *event_id;
+	unsigned long  *start_time; // UTC epoch seconds
+	unsigned int   *duration;   // seconds
+	DescriptorLoop *descriptor_loop;
+	unsigned int   *event_program;  // program index of each event
+	unsigned int   *event_by_start; // every event index ordered by start_time across all programs
+	unsigned int    max_duration;   // longest event, bounds the range search over event_by_start
+
+	void *program_block; // every array above lives in one of these three blocks
+	void *es_block;
+	void *event_block;
+} ProgramCatalog;
+
+//--------------------------------------------------------------------------------------------
+// Function declaration
+//--------------------------------------------------------------------------------------------
+/**
+ * @brief Build the catalog once after acquisition, from the overview list and the pmt and eit lists
+ *        that get_program_info_list keeps in the table context
+ *
+ * @param program_info_list Overview from get_program_info_list
+ * @param program_catalog   Output, released with free_program_catalog
+ *
+ * @return 0: successful
+ *         <0: error code
+ */
+int  build_program_catalog(ProgramInfoList *program_info_list, ProgramCatalog *program_catalog);
+void free_program_catalog(ProgramCatalog *program_catalog);
+
+/**
+ * @brief Index of a program by binary search over the sorted program numbers
+ *
+ * @return >=0: program index
+ *         -1 : not in the catalog
+ */
+int find_program_index(const ProgramCatalog *program_catalog, unsigned short program_number);
+
+/**
+ * @brief Neighbours of a program, the same order as next/prev of ProgramInfoNode
+ *
+ * @return >=0: program index
+ *         -1 : no next or prev program
+ */
+int get_next_program_index(const ProgramCatalog *program_catalog, int program_index);
+int get_prev_program_index(const ProgramCatalog *program_catalog, int program_index);
+
+/**
+ * @brief Running and following event of one program, binary search over the program's event range
+ *
+ * @param program_catalog  Catalog
+ * @param program_index    Program
+ * @param now              UTC epoch seconds
+ * @param now_event_index  Output, event with start_time <= now < start_time + duration, -1 if none
+ * @param next_event_index Output, first event starting after now, -1 if none
+ *
+ * @return 0: successful
+ *         <0: error code
+ */
+int get_now_next_event(const ProgramCatalog *program_catalog, int program_index, unsigned long now, int *now_event_index, int *next_event_index);
+
+/**
+ * @brief Events of all programs overlapping [start_time, end_time), ordered by start_time.
+ *        One binary search over event_by_start, then only events starting less than max_duration
+ *        before start_time are visited.
+ *
+ * @param event_index_array Output, event indices
+ * @param max_count         Capacity of event_index_array
+ *
+ * @return >=0: number of overlapping events, only the first max_count are written
+ *         <0 : error code
+ */
+int query_events_in_range(const ProgramCatalog *program_catalog, unsigned long start_time, unsigned long end_time, int *event_index_array, int max_count);
+
+/**
+ * @brief Detail view of one program, the same output as printf_more_program_info read from the catalog columns
+ */
+void printf_catalog_program(const ProgramCatalog *program_catalog, int program_index);
+
+/**
+ * @brief Print the running and the following event of a program, as found by get_now_next_event
+ */
+void printf_now_next_event(const ProgramCatalog *program_catalog, int program_index, unsigned long now);
+
+/**
+ * @brief Print the events of all programs overlapping [start_time, end_time), as found by query_events_in_range
+ *
+ * @return >=0: number of events printed
+ *         <0 : error code
+ */
+int printf_events_in_range(const ProgramCatalog *program_catalog, unsigned long start_time, unsigned long end_time);
+
+/**
+ * @brief Program list of the browser, with the number of streams and events of each program
+ */
+void printf_program_catalog(const ProgramCatalog *program_catalog);
+
+#endif
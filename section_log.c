@@ -0,0 +1,221 @@
+/**
+ * @file section_log.c
+ *
+ * @author :Yujin Yu
+ * @date   :2025.05.20
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "ts_global.h"
+#include "slot_filter.h"
+#include "section_log.h"
+
+static void put_u16(unsigned char *buffer, unsigned int value)
+{
+	buffer[0] = value & 0xFF;
+	buffer[1] = (value >> 8) & 0xFF;
+}
+
+static unsigned int get_u16(const unsigned char *buffer)
+{
+	return buffer[0] | (buffer[1] << 8);
+}
+
+static unsigned long long get_u64(const unsigned char *buffer)
+{
+	unsigned long long value = 0;
+	int                i     = 0;
+
+	// clang-format off
+	for (i=7; i>=0; i--)
+	{ // clang-format on
+		value = (value << 8) | buffer[i];
+	}
+	return value;
+}
+
+int open_section_log(SectionLog *section_log, const char *file_name)
+{
+	unsigned char header[SECTION_LOG_HEADER_LENGTH] = {0};
+
+	if ((section_log == NULL) || (file_name == NULL))
+	{
+		return SECTION_LOG_PARAM_ERROR;
+	}
+
+	memset(section_log, 0, sizeof(SectionLog));
+	section_log->buffer = (char *)malloc(SECTION_LOG_BUFFER_SIZE);
+	if (section_log->buffer == NULL)
+	{
+		return SECTION_LOG_MALLOC_ERROR;
+	}
+
+	// "a+b" writes always go to the end, reading lets an existing log be checked before records are added to it
+	section_log->fp = fopen(file_name, "a+b");
+	if (section_log->fp == NULL)
+	{
+		LOG("open %s fail\n", file_name);
+		free(section_log->buffer);
+		section_log->buffer = NULL;
+		return SECTION_LOG_OPEN_ERROR;
+	}
+	setvbuf(section_log->fp, section_log->buffer, _IOFBF, SECTION_LOG_BUFFER_SIZE);
+
+	fseek(section_log->fp, 0, SEEK_END);
+	if (ftell(section_log->fp) == 0)
+	{
+		memcpy(header, SECTION_LOG_MAGIC, 8);
+		put_u16(header + 8, SECTION_LOG_VERSION);
+		if (fwrite(header, 1, SECTION_LOG_HEADER_LENGTH, section_log->fp) != SECTION_LOG_HEADER_LENGTH)
+		{
+			section_log->error_code = SECTION_LOG_WRITE_ERROR;
+		}
+	}
+	else
+	{
+		// records are only appended to a log of the same format, anything else is left untouched
+		fseek(section_log->fp, 0, SEEK_SET);
+		if ((fread(header, 1, SECTION_LOG_HEADER_LENGTH, section_log->fp) != SECTION_LOG_HEADER_LENGTH) ||
+		    (memcmp(header, SECTION_LOG_MAGIC, 8) != 0) || (get_u16(header + 8) != SECTION_LOG_VERSION))
+		{
+			LOG("%s is not a version %d section log\n", file_name, SECTION_LOG_VERSION);
+			fclose(section_log->fp);
+			free(section_log->buffer);
+			memset(section_log, 0, sizeof(SectionLog));
+			return SECTION_LOG_FORMAT_ERROR;
+		}
+		fseek(section_log->fp, 0, SEEK_END);
+	}
+	return section_log->error_code;
+}
+
+void write_section_log(SectionLog *section_log, unsigned long long offset, unsigned short pid, const unsigned char *section_buffer, int section_length)
+{
+	unsigned char record[SECTION_LOG_RECORD_LENGTH] = {0};
+	int           i                                 = 0;
+
+	if ((section_log->fp == NULL) || (section_log->error_code < 0))
+		return;
+
+	// clang-format off
+	for (i=0; i<8; i++)
+	{ // clang-format on
+		record[i] = (offset >> (i * 8)) & 0xFF;
+	}
+	put_u16(record + 8, pid);
+	put_u16(record + 10, section_length);
+
+	if ((fwrite(record, 1, SECTION_LOG_RECORD_LENGTH, section_log->fp) != SECTION_LOG_RECORD_LENGTH) ||
+	    (fwrite(section_buffer, 1, section_length, section_log->fp) != (size_t)section_length))
+	{
+		section_log->error_code = SECTION_LOG_WRITE_ERROR;
+		return;
+	}
+	section_log->section_count++;
+	section_log->byte_count += SECTION_LOG_RECORD_LENGTH + section_length;
+}
+
+int close_section_log(SectionLog *section_log)
+{
+	int error_code = 0;
+
+	if ((section_log == NULL) || (section_log->fp == NULL))
+		return 0;
+
+	error_code = section_log->error_code;
+	if (fclose(section_log->fp) != 0)
+	{
+		error_code = SECTION_LOG_WRITE_ERROR;
+	}
+	LOG("section log: %llu sections, %llu bytes\n", section_log->section_count, section_log->byte_count);
+
+	free(section_log->buffer);
+	memset(section_log, 0, sizeof(SectionLog));
+	return error_code;
+}
+
+int is_section_log_file(const char *file_name)
+{
+	FILE         *fp                                = NULL;
+	unsigned char header[SECTION_LOG_HEADER_LENGTH] = {0};
+	int           is_section_log                    = 0;
+
+	fp = fopen(file_name, "rb");
+	if (fp == NULL)
+		return 0;
+
+	if ((fread(header, 1, SECTION_LOG_HEADER_LENGTH, fp) == SECTION_LOG_HEADER_LENGTH) && (memcmp(header, SECTION_LOG_MAGIC, 8) == 0))
+		is_section_log = 1;
+
+	fclose(fp);
+	return is_section_log;
+}
+
+long long replay_section_log(const char *file_name, Slot *slot)
+{
+	const unsigned char *file_data       = NULL;
+	unsigned long long   read_position   = SECTION_LOG_HEADER_LENGTH;
+	long long            record_count    = 0;
+	int                  file_descriptor = -1;
+	int                  section_length  = 0;
+	struct stat          file_status;
+	unsigned char        section_buffer[MAX_SECTION_LENGTH];
+
+	if ((file_name == NULL) || (slot == NULL))
+	{
+		return SECTION_LOG_PARAM_ERROR;
+	}
+
+	file_descriptor = open(file_name, O_RDONLY);
+	if ((file_descriptor < 0) || (fstat(file_descriptor, &file_status) != 0))
+	{
+		perror("open");
+		if (file_descriptor >= 0)
+			close(file_descriptor);
+		return SECTION_LOG_OPEN_ERROR;
+	}
+
+	if ((file_status.st_size < SECTION_LOG_HEADER_LENGTH) ||
+	    ((file_data = mmap(NULL, file_status.st_size, PROT_READ, MAP_PRIVATE, file_descriptor, 0)) == MAP_FAILED))
+	{
+		close(file_descriptor);
+		return SECTION_LOG_FORMAT_ERROR;
+	}
+	madvise((void *)file_data, file_status.st_size, MADV_SEQUENTIAL);
+
+	if ((memcmp(file_data, SECTION_LOG_MAGIC, 8) != 0) || (get_u16(file_data + 8) != SECTION_LOG_VERSION))
+	{
+		LOG("%s is not a version %d section log\n", file_name, SECTION_LOG_VERSION);
+		munmap((void *)file_data, file_status.st_size);
+		close(file_descriptor);
+		return SECTION_LOG_FORMAT_ERROR;
+	}
+
+	while (read_position + SECTION_LOG_RECORD_LENGTH <= (unsigned long long)file_status.st_size)
+	{
+		section_length = get_u16(file_data + read_position + 10);
+		if ((section_length < 3) || (section_length > MAX_SECTION_LENGTH) ||
+		    (read_position + SECTION_LOG_RECORD_LENGTH + section_length > (unsigned long long)file_status.st_size))
+		{
+			LOG("section log truncated at %llu\n", read_position);
+			break;
+		}
+
+		// the callbacks take a writable buffer, the mapping stays read only
+		memcpy(section_buffer, file_data + read_position + SECTION_LOG_RECORD_LENGTH, section_length);
+		slot->packet_offset = get_u64(file_data + read_position);
+		replay_section(slot, get_u16(file_data + read_position + 8) & 0x1FFF, section_buffer, section_length);
+
+		read_position += SECTION_LOG_RECORD_LENGTH + section_length;
+		record_count++;
+	}
+
+	munmap((void *)file_data, file_status.st_size);
+	close(file_descriptor);
+	return record_count;
+}
@@ -0,0 +1,78 @@
+/**
+ * @file section_log.h
+ *
+ * @brief Append-only log of the sections handed to the table callbacks, and a replay driver that runs a log
+ *        through the callbacks again without any TS input. Include slot_filter.h first.
+ *
+ *        File layout, little endian:
+ *        header : "DMXSLOG" 0, version (2), reserved (2)
+ *        record : input offset of the packet the section started in (8), PID (2), section length (2), section bytes
+ *
+ * @author :Yujin Yu
+ * @date   :2025.05.20
+ */
+#ifndef SECTION_LOG_H
+#define SECTION_LOG_H
+
+//--------------------------------------------------------------------------------------------
+// macro definition
+//--------------------------------------------------------------------------------------------
+#define SECTION_LOG_MAGIC         "DMXSLOG" // 8 bytes with the terminator
+#define SECTION_LOG_VERSION       1
+#define SECTION_LOG_HEADER_LENGTH 12
+#define SECTION_LOG_RECORD_LENGTH 12     // in front of the section bytes
+#define SECTION_LOG_BUFFER_SIZE   262144 // stdio buffer, records go out in large writes
+
+typedef struct SectionLog
+{
+	FILE              *fp;
+	char              *buffer; // SECTION_LOG_BUFFER_SIZE, given to setvbuf
+	unsigned long long section_count;
+	unsigned long long byte_count;
+	int                error_code; // first write error, later records are dropped
+} SectionLog;
+
+//--------------------------------------------------------------------------------------------
+// Function declaration
+//--------------------------------------------------------------------------------------------
+/**
+ * @brief Open a log for appending, the header is written when the file is new and checked when it is not
+ *
+ * @return 0: successful
+ *         SECTION_LOG_FORMAT_ERROR: the file exists but is not a section log of this version
+ *         <0: error code
+ */
+int open_section_log(SectionLog *section_log, const char *file_name);
+
+/**
+ * @brief Append one section, called from section_filter after the CRC check of the filter passed
+ */
+void write_section_log(SectionLog *section_log, unsigned long long offset, unsigned short pid, const unsigned char *section_buffer, int section_length);
+
+/**
+ * @return 0: every record reached the file
+ *         <0: error code
+ */
+int close_section_log(SectionLog *section_log);
+
+/**
+ * @brief Check the magic number of a file
+ *
+ * @return 1: section log
+ *         0: anything else
+ */
+int is_section_log_file(const char *file_name);
+
+/**
+ * @brief Map a log and push every record through the filters of the slot, the callbacks install and release
+ *        filters exactly as they do for a capture, so PMT and EIT sections only reach them after the PAT did
+ *
+ * @param file_name Section log
+ * @param slot      Slot with the PAT, SDT and EIT filters installed
+ *
+ * @return >=0: number of records replayed
+ *         <0 : error code
+ */
+long long replay_section_log(const char *file_name, Slot *slot);
+
+#endif
@@ -0,0 +1,113 @@
+/**
+ * @file section_store.c
+ *
+ * @author :Yujin Yu
+ * @date   :2025.05.12
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ts_global.h"
+#include "section_store.h"
+#include "string_pool.h"
+#include "table_context.h"
+
+int section_store_append(SectionStore *store, const unsigned char *buffer, int length, DescriptorLoop *descriptor_loop)
+{
+	unsigned char *data     = NULL;
+	unsigned int   capacity = 0;
+
+	if ((store == NULL) || (buffer == NULL) || (length < 0) || (length > 0xFFFF) || (descriptor_loop == NULL))
+	{
+		return SECTION_STORE_PARAM_ERROR;
+	}
+
+	if (store->length + length > store->capacity)
+	{
+		capacity = (store->capacity == 0) ? SECTION_STORE_INITIAL_CAPACITY : store->capacity;
+		while (store->length + length > capacity)
+		{
+			capacity *= 2;
+		}
+
+		data = (unsigned char *)realloc(store->data, capacity);
+		if (data == NULL)
+		{
+			return SECTION_STORE_MALLOC_ERROR;
+		}
+		store->data     = data;
+		store->capacity = capacity;
+	}
+
+	memcpy(store->data + store->length, buffer, length);
+	descriptor_loop->offset = store->length;
+	descriptor_loop->length = (unsigned short)length;
+	store->length += length;
+
+	return 0;
+}
+
+int section_store_reserve(SectionStore *store, unsigned int capacity)
+{
+	unsigned char *data = NULL;
+
+	if (store == NULL)
+	{
+		return SECTION_STORE_PARAM_ERROR;
+	}
+
+	if (capacity <= store->capacity)
+		return 0;
+
+	data = (unsigned char *)realloc(store->data, capacity);
+	if (data == NULL)
+	{
+		return SECTION_STORE_MALLOC_ERROR;
+	}
+	store->data     = data;
+	store->capacity = capacity;
+
+	return 0;
+}
+
+void free_section_store(SectionStore *store)
+{
+	if (store == NULL)
+		return;
+
+	free(store->data);
+	memset(store, 0, sizeof(SectionStore));
+}
+
+const unsigned char *find_descriptor_in_buffer(const unsigned char *buffer, int length, unsigned char descriptor_tag, int index, int *descriptor_length)
+{
+	int read_position = 0;
+
+	while (read_position + 2 <= length)
+	{
+		if (read_position + 2 + buffer[read_position + 1] > length)
+			break;
+
+		if ((buffer[read_position] == descriptor_tag) && (index-- == 0))
+		{
+			*descriptor_length = buffer[read_position + 1];
+			return buffer + read_position + 2;
+		}
+
+		read_position += 2 + buffer[read_position + 1];
+	}
+
+	return NULL;
+}
+
+const unsigned char *find_descriptor(DescriptorLoop descriptor_loop, unsigned char descriptor_tag, int index, int *descriptor_length)
+{
+	const SectionStore *store = &get_table_context()->section_store;
+
+	if ((descriptor_loop.length == 0) || (descriptor_loop.offset + descriptor_loop.length > store->length))
+	{
+		return NULL;
+	}
+
+	return find_descriptor_in_buffer(store->data + descriptor_loop.offset, descriptor_loop.length, descriptor_tag, index, descriptor_length);
+}
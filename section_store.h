@@ -0,0 +1,71 @@
+/**
+ * @file section_store.h
+ *
+ * @brief Compact append-only store for the descriptor loops of validated sections.
+ *        Table nodes keep an offset into it and descriptors are decoded when they are read.
+ *
+ * @author :Yujin Yu
+ * @date   :2025.05.12
+ */
+#ifndef SECTION_STORE_H
+#define SECTION_STORE_H
+
+#define SECTION_STORE_INITIAL_CAPACITY 65536 // bytes, doubled when full
+
+typedef struct
+{
+	unsigned char *data;
+	unsigned int   length;
+	unsigned int   capacity;
+} SectionStore;
+
+// A descriptor loop kept in the section store of the current table context
+typedef struct
+{
+	unsigned int   offset;
+	unsigned short length; // 0: no descriptors
+} DescriptorLoop;
+
+//--------------------------------------------------------------------------------------------
+// Function declaration
+//--------------------------------------------------------------------------------------------
+/**
+ * @brief Copy bytes into the store
+ *
+ * @param store          Pointer to the SectionStore structure
+ * @param buffer         Bytes to keep
+ * @param length         Number of bytes
+ * @param descriptor_loop Output, where the bytes are kept
+ *
+ * @return 0: successful
+ *         <0: error code
+ */
+int  section_store_append(SectionStore *store, const unsigned char *buffer, int length, DescriptorLoop *descriptor_loop);
+void free_section_store(SectionStore *store);
+
+/**
+ * @brief Grow the store to at least capacity bytes, appends up to that size cannot fail afterwards
+ *
+ * @return 0: successful
+ *         <0: error code
+ */
+int section_store_reserve(SectionStore *store, unsigned int capacity);
+
+/**
+ * @brief Find a descriptor in a descriptor loop of the current table context
+ *
+ * @param descriptor_loop   Loop returned by section_store_append
+ * @param descriptor_tag    Tag to look for
+ * @param index             0 for the first descriptor with this tag, 1 for the second ...
+ * @param descriptor_length Output, length of the descriptor body
+ *
+ * @return body of the descriptor, NULL if there is no such descriptor
+ */
+const unsigned char *find_descriptor(DescriptorLoop descriptor_loop, unsigned char descriptor_tag, int index, int *descriptor_length);
+
+/**
+ * @brief Same walk as find_descriptor over a loop that is not in the section store, e.g. a mapped snapshot
+ */
+const unsigned char *find_descriptor_in_buffer(const unsigned char *buffer, int length, unsigned char descriptor_tag, int index, int *descriptor_length);
+
+#endif
@@ -1,343 +1,998 @@
-/**
- * @file slot_filter.c
- *
- * @author :Yujin Yu
- * @date   :2025.04.14
- */
-#include <stdio.h>
-#include <string.h>
-#include <stdlib.h>
-#include "ts_global.h"
-#include "slot_filter.h"
-
-static unsigned int crc32_table[256];
-static int          crc_table_generated = 0;
-
-// Generate CRC32 lookup table
-static void generate_crc32_table(void)
-{
-	unsigned int polynomial = 0x04C11DB7;
-	unsigned int crc        = 0;
-	int          i = 0, j = 0;
-
-	// clang-format off
-	for (i=0; i<256; i++)
-	{
-		crc = i << 24;
-		for (j=0; j<8; j++)
-		{ // clang-format on
-			crc = (crc & 0x80000000) ? (crc << 1) ^ polynomial : crc << 1;
-		}
-		crc32_table[i] = crc;
-	}
-}
-
-// Calculate CRC32 value
-static unsigned int calculate_crc32(const unsigned char *data, int length)
-{
-	unsigned int  crc = 0xFFFFFFFF;
-	unsigned char pos = 0;
-	int           i   = 0;
-
-	if (0 == crc_table_generated)
-	{
-		generate_crc32_table();
-		crc_table_generated = 1;
-	}
-
-	// clang-format off
-	for (i=0; i<length; i++)
-	{ // clang-format on
-		pos = (unsigned char)((crc >> 24) ^ data[i]);
-		crc = (crc << 8) ^ crc32_table[pos];
-	}
-	return crc; // Note: No final XOR
-}
-
-// CRC verification function
-static int crc_check(const unsigned char *data, int length)
-{
-	unsigned int computed_crc = 0;
-	unsigned int stored_crc   = 0;
-	if (length < 4)
-		return 0;
-
-	/* Calculate CRC for first length-4 bytes */
-	computed_crc = calculate_crc32(data, length - 4);
-
-	/* Extract stored CRC value (big-endian) */
-	stored_crc = ((unsigned int)data[length - 4] << 24) |
-	             ((unsigned int)data[length - 3] << 16) |
-	             ((unsigned int)data[length - 2] << 8) |
-	             ((unsigned int)data[length - 1] << 0);
-
-	if (computed_crc == stored_crc)
-		return 1;
-
-	return 0;
-}
-
-Slot init_slot(FILE *ts_file, unsigned char packet_size, unsigned int start_position)
-{
-	Slot slot = {0};
-
-	slot.ts_file        = ts_file;
-	slot.packet_size    = packet_size;
-	slot.start_position = start_position;
-
-	return slot;
-}
-
-void clear_slot(Slot *slot)
-{
-	memset(slot, 0, sizeof(Slot));
-}
-
-int alloc_filter(Slot *slot, unsigned char *filter_match, unsigned char *filter_mask, int is_crc_check, parse_callback section_callback)
-{
-	int i = 0;
-
-	// clang-format off
-	for (i=0; i<MAX_FILTER_COUNT; i++)
-	{ // clang-format on
-		if (slot->filter_array[i].is_used == 0)
-		{
-			memset(&slot->filter_array[i], 0, sizeof(Filter));
-			memcpy(slot->filter_array[i].filter_match, filter_match, FILTER_MASK_LENGTH);
-			memcpy(slot->filter_array[i].filter_mask, filter_mask, FILTER_MASK_LENGTH);
-			slot->filter_array[i].is_used          = 1;
-			slot->filter_array[i].is_CRC_check     = is_crc_check;
-			slot->filter_array[i].section_callback = section_callback;
-			return i;
-		}
-	}
-
-	LOG("No available filter slots\n");
-	return -1;
-}
-
-void clear_filter(Slot *slot, int index)
-{
-	memset(&slot->filter_array[index], 0, sizeof(Filter));
-}
-
-static void get_packet_header(unsigned char *buffer, TSPacketHead *packet_header)
-{
-	packet_header->sync_byte                    = buffer[0];
-	packet_header->transport_error_indicator    = buffer[1] >> 7;
-	packet_header->payload_unit_start_indicator = (buffer[1] >> 6) & 0x01;
-	packet_header->transport_priority           = (buffer[1] >> 5) & 0x01;
-	packet_header->PID                          = ((buffer[1] & 0x1F) << 8) | buffer[2];
-	packet_header->transport_scrambling_control = (buffer[3] >> 6) & 0x03;
-	packet_header->adaptation_field_control     = (buffer[3] >> 4) & 0x03;
-	packet_header->continuity_counter           = buffer[3] & 0x0F;
-}
-
-void get_section_header(unsigned char *buffer, SectionHead *section_header)
-{
-	section_header->table_id            = buffer[0];
-	section_header->section_length      = (((buffer[1] & 0x0F) << 8) | buffer[2]) + 3;
-	section_header->version_number      = (buffer[5] >> 2) & 0x1F;
-	section_header->section_number      = buffer[6];
-	section_header->last_section_number = buffer[7];
-}
-
-/**
- * @brief Get payload start position
- *
- * @param packet_header Pointer to TSPacketHead structure containing TS packet header info
- * @param packet_buffer  buffer containing TS packet data
- *
- * @return Payload start position
- */
-static int get_payload_start_position(TSPacketHead *packet_header, unsigned char *packet_buffer)
-{
-	int section_start_position = 0;
-
-	switch (packet_header->adaptation_field_control)
-	{
-	case 0:
-		return 0;
-	case 1:
-		section_start_position = 4;
-		break;
-	case 2:
-		return 0;
-	case 3:
-		section_start_position = 4 + 1 + packet_buffer[4];
-		break;
-	default:
-		break;
-	}
-
-	if (packet_header->payload_unit_start_indicator == 1)
-	{
-		section_start_position += 1 + packet_buffer[section_start_position];
-	}
-
-	return section_start_position;
-}
-
-int compare_packet_header(unsigned char *packet_buffer, unsigned char *filter_match, unsigned char *filter_mask)
-{
-	const int packet_header_length = 4;
-	int       i                    = 0;
-
-	// clang-format off
-	for (i=0; i<packet_header_length; i++)
-	{ // clang-format on
-		if ((packet_buffer[i] & filter_mask[i]) != (filter_match[i] & filter_mask[i]))
-		{
-			return 0;
-		}
-	}
-	return 1;
-}
-
-int compare_section_header(unsigned char *packet_buffer, unsigned char *filter_match, unsigned char *filter_mask)
-{
-	const int packet_header_length = 4;
-	int       i                    = 0;
-
-	// clang-format off
-	for (i=0; i<FILTER_MASK_LENGTH; i++)
-	{ // clang-format on
-		if ((packet_buffer[i] & filter_mask[i + packet_header_length]) != (filter_match[i + packet_header_length] & filter_mask[i + packet_header_length]))
-		{
-			return 0;
-		}
-	}
-	return 1;
-}
-
-int calculate_copy_length(int payload_start_position, int packet_size, int section_length, int payload_length_count)
-{
-	int copy_length = packet_size - payload_start_position;
-
-	if (section_length < copy_length + payload_length_count)
-	{
-		copy_length = section_length - payload_length_count;
-	}
-	else if (payload_length_count + copy_length > MAX_SECTION_LENGTH)
-	{
-		copy_length = MAX_SECTION_LENGTH - payload_length_count;
-	}
-
-	return copy_length;
-}
-
-void write_to_section_buffer(Filter *filter, unsigned char *packet_buffer, int payload_start_position, int copy_length)
-{
-	memcpy(filter->section_buffer + filter->payload_length_count, packet_buffer + payload_start_position, copy_length);
-}
-
-// int is_slot_no_used(Slot *slot)
-// {
-// 	int i = 0;
-
-// 	// clang-format off
-// 	for (i=0; i<MAX_FILTER_COUNT; i++)
-// 	{ // clang-format on
-// 		if (slot->filter_array[i].is_used == 1)
-// 			return 0;
-// 	}
-// 	return 1;
-// }
-
-int section_filter(Slot *slot)
-{
-	TSPacketHead  packet_header      = {0};
-	SectionHead   section_header     = {0};
-	unsigned char packet_buffer[204] = {0};
-
-	int payload_start_position = 0;
-	int copy_length            = 0;
-	int index                  = 0;
-	int ret                    = 0;
-
-	if (slot->ts_file == NULL)
-	{
-		return FILTER_PARAM_ERROR;
-	}
-
-	while (fread(packet_buffer, 1, slot->packet_size, slot->ts_file) == slot->packet_size)
-	{
-		// clang-format off
-		for (index=0; index<MAX_FILTER_COUNT; index++)
-		{ // clang-format on
-			if (slot->filter_array[index].is_used == 0)
-			{
-				continue;
-			}
-
-			if (compare_packet_header(packet_buffer, slot->filter_array[index].filter_match, slot->filter_array[index].filter_mask) == 0)
-				continue;
-
-			get_packet_header(packet_buffer, &packet_header);
-
-			payload_start_position = get_payload_start_position(&packet_header, packet_buffer);
-			if ((payload_start_position < 4) || (payload_start_position > slot->packet_size - 1))
-				continue;
-
-			if (packet_header.payload_unit_start_indicator == 1)
-			{
-				if (compare_section_header(packet_buffer + payload_start_position, slot->filter_array[index].filter_match, slot->filter_array[index].filter_mask) == 0)
-					continue;
-
-				get_section_header(packet_buffer + payload_start_position, &section_header);
-
-				slot->filter_array[index].is_write_flag        = 1;
-				slot->filter_array[index].section_length       = section_header.section_length;
-				slot->filter_array[index].payload_length_count = 0;
-				memset(slot->filter_array[index].section_buffer, 0, MAX_SECTION_LENGTH);
-			}
-
-			// if(packet_header.PID==0x12)
-			// {
-			// 	if (section_header.table_id == 0x4e || (section_header.table_id >= 0x50 && section_header.table_id <= 0x5f))
-			// 	{
-			// 		LOG("eit Table_id is 0x%02X\n", section_header.table_id);
-			// 	}
-			// }
-
-			if (slot->filter_array[index].is_write_flag == 0)
-				continue;
-
-			copy_length = calculate_copy_length(payload_start_position, slot->packet_size,
-			                                    slot->filter_array[index].section_length, slot->filter_array[index].payload_length_count);
-
-			write_to_section_buffer(&slot->filter_array[index], packet_buffer, payload_start_position, copy_length);
-			slot->filter_array[index].payload_length_count += copy_length;
-
-			if (slot->filter_array[index].payload_length_count < section_header.section_length)
-				continue;
-
-			if (slot->filter_array[index].is_CRC_check == 1)
-			{
-				if (crc_check(slot->filter_array[index].section_buffer, slot->filter_array[index].payload_length_count) != 1)
-				{
-					memset(slot->filter_array[index].section_buffer, 0, MAX_SECTION_LENGTH);
-					slot->filter_array[index].is_write_flag        = 0;
-					slot->filter_array[index].payload_length_count = 0;
-					continue;
-				}
-			}
-
-			if ((ret = slot->filter_array[index].section_callback(slot, index,slot->filter_array[index].section_buffer, packet_header.PID)) < 0)
-			{
-				LOG("error code : %d\n",ret);
-			}
-			memset(slot->filter_array[index].section_buffer, 0, MAX_SECTION_LENGTH);
-			slot->filter_array[index].is_write_flag        = 0;
-			slot->filter_array[index].payload_length_count = 0;
-		}
-	}
-
-	if (fseek(slot->ts_file, slot->start_position, SEEK_SET) != 0)
-	{
-		LOG("fseek error\n");
-	}
-
-	LOG("file end\n");
-	return 0;
-}
+/**
+ * @file slot_filter.c
+ *
+ * @author :Yujin Yu
+ * @date   :2025.04.14
+ */
+#include <stdio.h>
+#include <string.h>
+#include <signal.h>
+#include <stdlib.h>
+#include "ts_global.h"
+#include "ts_analyzer.h"
+#include "slot_filter.h"
+#include "section_log.h"
+#include "section_store.h"
+#include "string_pool.h"
+#include "table_context.h"
+#include "instrument.h"
+#include "latency.h"
+#include "logger.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+static unsigned int crc32_table[256];
+static int          crc_table_generated = 0;
+
+// Generate CRC32 lookup table
+static void generate_crc32_table(void)
+{
+	unsigned int polynomial = 0x04C11DB7;
+	unsigned int crc        = 0;
+	int          i = 0, j = 0;
+
+	// clang-format off
+	for (i=0; i<256; i++)
+	{
+		crc = i << 24;
+		for (j=0; j<8; j++)
+		{ // clang-format on
+			crc = (crc & 0x80000000) ? (crc << 1) ^ polynomial : crc << 1;
+		}
+		crc32_table[i] = crc;
+	}
+}
+
+// Calculate CRC32 value
+unsigned int calculate_crc32(const unsigned char *data, int length)
+{
+	unsigned int  crc = 0xFFFFFFFF;
+	unsigned char pos = 0;
+	int           i   = 0;
+
+	if (0 == crc_table_generated)
+	{
+		generate_crc32_table();
+		crc_table_generated = 1;
+	}
+
+	// clang-format off
+	for (i=0; i<length; i++)
+	{ // clang-format on
+		pos = (unsigned char)((crc >> 24) ^ data[i]);
+		crc = (crc << 8) ^ crc32_table[pos];
+	}
+	return crc; // Note: No final XOR
+}
+
+// CRC verification function
+int crc_check(const unsigned char *data, int length)
+{
+	unsigned int computed_crc = 0;
+	unsigned int stored_crc   = 0;
+	if (length < 4)
+		return 0;
+
+	/* Calculate CRC for first length-4 bytes */
+	computed_crc = calculate_crc32(data, length - 4);
+
+	/* Extract stored CRC value (big-endian) */
+	stored_crc = ((unsigned int)data[length - 4] << 24) |
+	             ((unsigned int)data[length - 3] << 16) |
+	             ((unsigned int)data[length - 2] << 8) |
+	             ((unsigned int)data[length - 1] << 0);
+
+	if (computed_crc == stored_crc)
+		return 1;
+
+	return 0;
+}
+
+// Blocks of a size class are chained through their first bytes while they are free
+static unsigned char *get_section_buffer(Slot *slot, int section_length, unsigned short *buffer_size)
+{
+	SectionBufferPool *pool         = &slot->section_buffer_pool;
+	int                size_class   = (section_length <= SECTION_BUFFER_SMALL_SIZE) ? 0 : 1;
+	unsigned char     *block        = pool->free_list[size_class];
+
+	*buffer_size = (size_class == 0) ? SECTION_BUFFER_SMALL_SIZE : MAX_SECTION_LENGTH;
+	if (block != NULL)
+	{
+		memcpy(&pool->free_list[size_class], block, sizeof(unsigned char *));
+		return block;
+	}
+
+	block = (unsigned char *)malloc(*buffer_size);
+	if (block != NULL)
+	{
+		pool->block_count[size_class]++;
+	}
+	return block;
+}
+
+static void put_section_buffer(Slot *slot, unsigned char *block, unsigned short buffer_size)
+{
+	SectionBufferPool *pool       = &slot->section_buffer_pool;
+	int                size_class = (buffer_size == SECTION_BUFFER_SMALL_SIZE) ? 0 : 1;
+
+	memcpy(block, &pool->free_list[size_class], sizeof(unsigned char *));
+	pool->free_list[size_class] = block;
+}
+
+static void reset_section(Slot *slot, SectionContext *section)
+{
+	if (section->section_buffer != NULL)
+	{
+		put_section_buffer(slot, section->section_buffer, section->buffer_size);
+		section->section_buffer = NULL;
+	}
+	section->is_write_flag        = 0;
+	section->payload_length_count = 0;
+}
+
+Slot init_slot(FILE *ts_file, unsigned char packet_size, unsigned int start_position)
+{
+	Slot slot = {0};
+
+	slot.ts_file        = ts_file;
+	slot.packet_size    = packet_size;
+	slot.start_position = start_position;
+
+	return slot;
+}
+
+void clear_slot(Slot *slot)
+{
+	unsigned char *block = NULL;
+	int            i     = 0;
+
+	// clang-format off
+	for (i=0; i<MAX_FILTER_COUNT; i++)
+	{ // clang-format on
+		clear_filter(slot, i);
+	}
+
+	// clang-format off
+	for (i=0; i<SECTION_BUFFER_CLASS_COUNT; i++)
+	{ // clang-format on
+		while ((block = slot->section_buffer_pool.free_list[i]) != NULL)
+		{
+			memcpy(&slot->section_buffer_pool.free_list[i], block, sizeof(unsigned char *));
+			free(block);
+		}
+	}
+	memset(slot, 0, sizeof(Slot));
+}
+
+// Split match/mask/mode into the positive and negative vectors used by compare_filter
+static void compile_filter(Filter *filter)
+{
+	int i = 0;
+
+	// clang-format off
+	for (i=0; i<FILTER_MASK_LENGTH; i++)
+	{ // clang-format on
+		filter->positive_mask[i]  = filter->filter_mask[i] & ~filter->filter_mode[i];
+		filter->positive_match[i] = filter->filter_match[i] & filter->positive_mask[i];
+		filter->negative_mask[i]  = filter->filter_mask[i] & filter->filter_mode[i];
+		filter->negative_match[i] = filter->filter_match[i] & filter->negative_mask[i];
+		if (filter->negative_mask[i] != 0)
+			filter->is_negative_match = 1;
+	}
+
+	memcpy(&filter->header_mask, filter->positive_mask, sizeof(unsigned int));
+	memcpy(&filter->header_match, filter->positive_match, sizeof(unsigned int));
+}
+
+int alloc_filter(Slot *slot, unsigned char *filter_match, unsigned char *filter_mask, int is_crc_check, parse_callback section_callback)
+{
+	return alloc_filter_with_mode(slot, filter_match, filter_mask, NULL, is_crc_check, section_callback);
+}
+
+int alloc_filter_with_mode(Slot *slot, unsigned char *filter_match, unsigned char *filter_mask, unsigned char *filter_mode, int is_crc_check, parse_callback section_callback)
+{
+	int i = 0;
+
+	// clang-format off
+	for (i=0; i<MAX_FILTER_COUNT; i++)
+	{ // clang-format on
+		if (slot->filter_array[i].is_used == 0)
+		{
+			memset(&slot->filter_array[i], 0, sizeof(Filter));
+			memcpy(slot->filter_array[i].filter_match, filter_match, FILTER_MASK_LENGTH);
+			memcpy(slot->filter_array[i].filter_mask, filter_mask, FILTER_MASK_LENGTH);
+			if (filter_mode != NULL)
+			{
+				memcpy(slot->filter_array[i].filter_mode, filter_mode, FILTER_MASK_LENGTH);
+			}
+			compile_filter(&slot->filter_array[i]);
+			slot->filter_array[i].is_used          = 1;
+			slot->filter_array[i].is_CRC_check     = is_crc_check;
+			slot->filter_array[i].section_callback = section_callback;
+			return i;
+		}
+	}
+
+	LOG_WARN(LOGGER_CATEGORY_DEMUX, "No available filter slots\n");
+	return -1;
+}
+
+void clear_filter(Slot *slot, int index)
+{
+	PidSet *pid_set = slot->filter_array[index].pid_set;
+	int     i       = 0;
+
+	reset_section(slot, &slot->filter_array[index].section);
+	if (pid_set != NULL)
+	{
+		// clang-format off
+		for (i=0; i<pid_set->context_count; i++)
+		{ // clang-format on
+			reset_section(slot, &pid_set->context_array[i]);
+		}
+		free(pid_set->context_array);
+		free(pid_set);
+	}
+	memset(&slot->filter_array[index], 0, sizeof(Filter));
+}
+
+int alloc_pid_set_filter(Slot *slot, unsigned char *filter_match, unsigned char *filter_mask, int is_crc_check, parse_callback section_callback)
+{
+	unsigned char pid_set_mask[FILTER_MASK_LENGTH];
+	PidSet       *pid_set = NULL;
+	int           index   = 0;
+
+	if ((slot == NULL) || (filter_match == NULL) || (filter_mask == NULL))
+	{
+		return FILTER_PARAM_ERROR;
+	}
+
+	pid_set = (PidSet *)calloc(1, sizeof(PidSet));
+	if (pid_set == NULL)
+	{
+		return FILTER_MALLOC_ERROR;
+	}
+
+	// the PID bits are decided by the bitmap
+	memcpy(pid_set_mask, filter_mask, FILTER_MASK_LENGTH);
+	pid_set_mask[1] &= 0xE0;
+	pid_set_mask[2] = 0x00;
+
+	index = alloc_filter(slot, filter_match, pid_set_mask, is_crc_check, section_callback);
+	if (index < 0)
+	{
+		free(pid_set);
+		return index;
+	}
+
+	slot->filter_array[index].pid_set = pid_set;
+	return index;
+}
+
+int add_pid_to_filter(Slot *slot, int index, unsigned short pid)
+{
+	PidSet         *pid_set       = NULL;
+	SectionContext *context_array = NULL;
+	int             capacity      = 0;
+
+	if ((slot == NULL) || (index < 0) || (index >= MAX_FILTER_COUNT) || (pid >= MAX_PID_COUNT) ||
+	    ((pid_set = slot->filter_array[index].pid_set) == NULL))
+	{
+		return FILTER_PARAM_ERROR;
+	}
+
+	// a PID that was in the set before keeps its reassembly context
+	if (pid_set->context_index[pid] == 0)
+	{
+		if (pid_set->context_count == pid_set->context_capacity)
+		{
+			capacity      = (pid_set->context_capacity == 0) ? PID_SET_INITIAL_CAPACITY : pid_set->context_capacity * 2;
+			context_array = (SectionContext *)realloc(pid_set->context_array, capacity * sizeof(SectionContext));
+			if (context_array == NULL)
+			{
+				return FILTER_MALLOC_ERROR;
+			}
+			pid_set->context_array    = context_array;
+			pid_set->context_capacity = capacity;
+		}
+
+		pid_set->context_count++;
+		pid_set->context_index[pid] = pid_set->context_count;
+	}
+	else
+	{
+		reset_section(slot, &pid_set->context_array[pid_set->context_index[pid] - 1]);
+	}
+
+	memset(&pid_set->context_array[pid_set->context_index[pid] - 1], 0, sizeof(SectionContext));
+	pid_set->pid_bitmap[pid >> 3] |= (1 << (pid & 0x07));
+	return 0;
+}
+
+void remove_pid_from_filter(Slot *slot, int index, unsigned short pid)
+{
+	PidSet *pid_set = NULL;
+
+	if ((slot == NULL) || (index < 0) || (index >= MAX_FILTER_COUNT) || (pid >= MAX_PID_COUNT) ||
+	    ((pid_set = slot->filter_array[index].pid_set) == NULL))
+	{
+		return;
+	}
+
+	pid_set->pid_bitmap[pid >> 3] &= ~(1 << (pid & 0x07));
+}
+
+void get_section_header(unsigned char *buffer, SectionHead *section_header)
+{
+	section_header->table_id            = buffer[0];
+	section_header->section_length      = (((buffer[1] & 0x0F) << 8) | buffer[2]) + 3;
+	section_header->version_number      = (buffer[5] >> 2) & 0x1F;
+	section_header->section_number      = buffer[6];
+	section_header->last_section_number = buffer[7];
+}
+
+/**
+ * @brief Get payload start position
+ *
+ * @param adaptation_field_control Decoded adaptation_field_control of the packet
+ * @param packet_buffer            buffer containing TS packet data
+ *
+ * @return Payload start position, the pointer field of a PUSI packet is the first payload byte
+ *         0: no payload
+ */
+static int get_payload_start_position(unsigned char adaptation_field_control, const unsigned char *packet_buffer)
+{
+	switch (adaptation_field_control)
+	{
+	case 1:
+		return 4;
+	case 3:
+		return 4 + 1 + packet_buffer[4];
+	default:
+		return 0;
+	}
+}
+
+#if defined(__SSE2__) || defined(__ARM_NEON)
+#define FILTER_COMPARE_SIMD 1
+
+#if defined(__ARM_NEON) && !defined(__SSE2__)
+// Any byte non-zero, vmaxvq_u8 is AArch64 only so the two halves are tested as 64-bit lanes
+static inline int is_any_byte_set(uint8x16_t value)
+{
+	uint64x2_t lanes = vreinterpretq_u64_u8(value);
+
+	return (vgetq_lane_u64(lanes, 0) | vgetq_lane_u64(lanes, 1)) != 0;
+}
+#endif
+
+// 0xFF for the first n bytes when loaded from filter_window + FILTER_MASK_LENGTH - n
+static const unsigned char filter_window[FILTER_MASK_LENGTH * 2] = {
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00};
+#endif
+
+/**
+ * @brief Match the packet header and the first section bytes against the whole filter
+ *
+ * Filter bytes 0..3 are the TS header, bytes 4..15 are section bytes 0..11 as far as they are
+ * inside this packet, the missing bytes are left out of the compare.
+ *
+ * @return 1: match
+ *         0: no match
+ */
+static int compare_filter(const Filter *filter, const unsigned char *packet_buffer, const unsigned char *section_buffer, int available_length)
+{
+	const int     packet_header_length = 4;
+	unsigned char data[FILTER_MASK_LENGTH] = {0};
+	int           data_length              = packet_header_length + MIN(FILTER_MASK_LENGTH - packet_header_length, available_length);
+#ifdef FILTER_COMPARE_SIMD
+	const unsigned char *window = filter_window + FILTER_MASK_LENGTH - data_length;
+#endif
+
+	memcpy(data, packet_buffer, packet_header_length);
+	memcpy(data + packet_header_length, section_buffer, data_length - packet_header_length);
+
+#if defined(__SSE2__)
+	__m128i value    = _mm_loadu_si128((const __m128i *)data);
+	__m128i in_range = _mm_loadu_si128((const __m128i *)window);
+	__m128i mask     = _mm_and_si128(_mm_loadu_si128((const __m128i *)filter->positive_mask), in_range);
+	__m128i match    = _mm_and_si128(_mm_loadu_si128((const __m128i *)filter->positive_match), in_range);
+
+	if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(value, mask), match)) != 0xFFFF)
+		return 0;
+
+	if (filter->is_negative_match == 1)
+	{
+		mask  = _mm_and_si128(_mm_loadu_si128((const __m128i *)filter->negative_mask), in_range);
+		match = _mm_and_si128(_mm_loadu_si128((const __m128i *)filter->negative_match), in_range);
+
+		// no negative byte inside this packet, nothing to decide on
+		if (_mm_movemask_epi8(_mm_cmpeq_epi8(mask, _mm_setzero_si128())) == 0xFFFF)
+			return 1;
+
+		if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(value, mask), match)) == 0xFFFF)
+			return 0;
+	}
+	return 1;
+#elif defined(__ARM_NEON)
+	uint8x16_t value    = vld1q_u8(data);
+	uint8x16_t in_range = vld1q_u8(window);
+	uint8x16_t mask     = vandq_u8(vld1q_u8(filter->positive_mask), in_range);
+	uint8x16_t match    = vandq_u8(vld1q_u8(filter->positive_match), in_range);
+	uint8x16_t differ   = veorq_u8(vandq_u8(value, mask), match);
+
+	if (is_any_byte_set(differ) == 1)
+		return 0;
+
+	if (filter->is_negative_match == 1)
+	{
+		mask   = vandq_u8(vld1q_u8(filter->negative_mask), in_range);
+		match  = vandq_u8(vld1q_u8(filter->negative_match), in_range);
+		differ = veorq_u8(vandq_u8(value, mask), match);
+
+		if ((is_any_byte_set(mask) == 1) && (is_any_byte_set(differ) == 0))
+			return 0;
+	}
+	return 1;
+#else
+	int is_negative_checked = 0;
+	int is_negative_differ  = 0;
+	int i                   = 0;
+
+	// clang-format off
+	for (i=0; i<data_length; i++)
+	{ // clang-format on
+		if ((data[i] & filter->positive_mask[i]) != filter->positive_match[i])
+			return 0;
+
+		if (filter->negative_mask[i] != 0)
+		{
+			is_negative_checked = 1;
+			if ((data[i] & filter->negative_mask[i]) != filter->negative_match[i])
+				is_negative_differ = 1;
+		}
+	}
+
+	if ((is_negative_checked == 1) && (is_negative_differ == 0))
+		return 0;
+	return 1;
+#endif
+}
+
+// The section state of a PID in a PID set filter, or the filter's own one; NULL when the PID left the set
+static SectionContext *get_section_context(Filter *filter, unsigned short pid)
+{
+	if (filter->pid_set == NULL)
+		return &filter->section;
+
+	if ((filter->pid_set->pid_bitmap[pid >> 3] & (1 << (pid & 0x07))) == 0)
+		return NULL;
+
+	return &filter->pid_set->context_array[filter->pid_set->context_index[pid] - 1];
+}
+
+// Category of the callback error of a section, by table_id
+static LoggerCategory get_logger_category(unsigned char table_id)
+{
+	switch (get_instrument_table_type(table_id))
+	{
+	case INSTRUMENT_TABLE_PAT:
+		return LOGGER_CATEGORY_PAT;
+	case INSTRUMENT_TABLE_PMT:
+		return LOGGER_CATEGORY_PMT;
+	case INSTRUMENT_TABLE_SDT:
+		return LOGGER_CATEGORY_SDT;
+	case INSTRUMENT_TABLE_EIT_PF:
+	case INSTRUMENT_TABLE_EIT_SCHEDULE:
+		return LOGGER_CATEGORY_EIT;
+	default:
+		return LOGGER_CATEGORY_DEMUX;
+	}
+}
+
+static void call_section_callback(Slot *slot, int index, unsigned char *section_buffer, int section_length, unsigned short pid, unsigned long long section_offset,
+                                  unsigned long long start_ns)
+{
+	Filter       *filter   = &slot->filter_array[index];
+	unsigned char table_id = section_buffer[0]; // the callback may release the buffer's filter
+	int           ret      = 0;
+
+	INSTRUMENT_DECLARE_TIMER(start_ticks);
+	INSTRUMENT_DECLARE_TABLE_TYPE(table_type, table_id);
+	INSTRUMENT_COUNT(section_count, 1);
+	if (filter->is_CRC_check == 1)
+	{
+		INSTRUMENT_START(start_ticks);
+		ret = crc_check(section_buffer, section_length);
+		INSTRUMENT_STOP(INSTRUMENT_TIMER_CRC, start_ticks);
+		if (ret != 1)
+		{
+			INSTRUMENT_COUNT(crc_error_count, 1);
+			return;
+		}
+	}
+
+	if (slot->section_log != NULL)
+	{
+		write_section_log(slot->section_log, section_offset, pid, section_buffer, section_length);
+	}
+
+	INSTRUMENT_START(start_ticks);
+	ret = filter->section_callback(slot, index, section_buffer, pid);
+	INSTRUMENT_CALLBACK(table_type, start_ticks);
+	if ((slot->latency_stats != NULL) && (start_ns != 0))
+	{
+		record_latency(slot->latency_stats, table_id, get_latency_ns() - start_ns);
+	}
+	if (ret < 0)
+	{
+		LOG_WARN(get_logger_category(table_id), "table 0x%02X on PID 0x%04X, error code : %d\n", table_id, pid, ret);
+	}
+}
+
+static void deliver_section(Slot *slot, int index, SectionContext *section, unsigned short pid)
+{
+	unsigned char *section_buffer = section->section_buffer;
+	unsigned short buffer_size    = section->buffer_size;
+
+	// detach first, the callback may release the filter or change its PID set
+	section->section_buffer = NULL;
+	reset_section(slot, section);
+
+	call_section_callback(slot, index, section_buffer, section->section_length, pid, section->start_offset, section->start_ns);
+	put_section_buffer(slot, section_buffer, buffer_size);
+}
+
+// Append payload bytes to the section in progress, the section is delivered once it is complete
+static void append_to_section(Slot *slot, int index, SectionContext *section, const unsigned char *payload, int length, unsigned short pid)
+{
+	int copy_length = MIN(length, section->section_length - section->payload_length_count);
+
+	memcpy(section->section_buffer + section->payload_length_count, payload, copy_length);
+	section->payload_length_count += copy_length;
+
+	if (section->payload_length_count >= section->section_length)
+	{
+		deliver_section(slot, index, section, pid);
+	}
+}
+
+// Section state after a callback ran, NULL once the filter or the PID is gone
+static SectionContext *get_active_section_context(Slot *slot, int index, unsigned short pid)
+{
+	if (slot->filter_array[index].is_used == 0)
+		return NULL;
+
+	return get_section_context(&slot->filter_array[index], pid);
+}
+
+/**
+ * @brief Check the continuity counter of a payload carrying packet
+ *
+ * @return 1: packet continues the stream of this filter
+ *         0: duplicate packet, ignore it
+ *        -1: packets were lost, the section in progress is broken
+ */
+static int check_continuity_counter(SectionContext *section, unsigned char continuity_counter)
+{
+	int ret = 1;
+
+	if (section->is_continuity_valid == 1)
+	{
+		if (continuity_counter == section->continuity_counter)
+			return 0;
+
+		if (continuity_counter != ((section->continuity_counter + 1) & 0x0F))
+			ret = -1;
+	}
+
+	section->is_continuity_valid = 1;
+	section->continuity_counter  = continuity_counter;
+	return ret;
+}
+
+// Start every matching section that begins in this packet, several short sections may share one packet
+static void start_sections_in_packet(Slot *slot, int index, const unsigned char *packet_buffer, int section_position, unsigned short pid)
+{
+	Filter         *filter         = &slot->filter_array[index];
+	SectionContext *section        = NULL;
+	int             section_length = 0;
+
+	while ((section_position + 3 <= TS_PACKET_SIZE) && (packet_buffer[section_position] != 0xFF))
+	{
+		section_length = (((packet_buffer[section_position + 1] & 0x0F) << 8) | packet_buffer[section_position + 2]) + 3;
+
+		if ((section_length <= MAX_SECTION_LENGTH) &&
+		    (compare_filter(filter, packet_buffer, packet_buffer + section_position, TS_PACKET_SIZE - section_position) == 1))
+		{
+			if ((section = get_active_section_context(slot, index, pid)) == NULL)
+				return;
+
+			// a section that ends inside this packet is handed over from the packet memory
+			if (section_position + section_length <= TS_PACKET_SIZE)
+			{
+				call_section_callback(slot, index, (unsigned char *)packet_buffer + section_position, section_length, pid, slot->packet_offset, slot->feed_ns);
+				section_position += section_length;
+				continue;
+			}
+
+			section->section_buffer = get_section_buffer(slot, section_length, &section->buffer_size);
+			if (section->section_buffer == NULL)
+				return;
+
+			section->is_write_flag        = 1;
+			section->section_length       = section_length;
+			section->payload_length_count = 0;
+			section->start_offset         = slot->packet_offset;
+			section->start_ns             = slot->feed_ns;
+
+			append_to_section(slot, index, section, packet_buffer + section_position, TS_PACKET_SIZE - section_position, pid);
+		}
+
+		section_position += section_length;
+	}
+}
+
+// int is_slot_no_used(Slot *slot)
+// {
+// 	int i = 0;
+
+// 	// clang-format off
+// 	for (i=0; i<MAX_FILTER_COUNT; i++)
+// 	{ // clang-format on
+// 		if (slot->filter_array[i].is_used == 1)
+// 			return 0;
+// 	}
+// 	return 1;
+// }
+
+static void decode_packet_header(PacketBatch *batch, int i)
+{
+	const unsigned char *byte = batch->packet[i];
+
+	batch->pid[i]                          = ((byte[1] & 0x1F) << 8) | byte[2];
+	batch->transport_error_indicator[i]    = byte[1] >> 7;
+	batch->payload_unit_start_indicator[i] = (byte[1] >> 6) & 0x01;
+	batch->transport_scrambling_control[i] = (byte[3] >> 6) & 0x03;
+	batch->adaptation_field_control[i]     = (byte[3] >> 4) & 0x03;
+	batch->continuity_counter[i]           = byte[3] & 0x0F;
+}
+
+#if (defined(__SSE2__) || defined(__ARM_NEON)) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+#define PACKET_BATCH_SIMD 1
+
+// On little endian hosts header = b0 | b1 << 8 | b2 << 16 | b3 << 24, 8 headers are split per pass
+static void decode_packet_header_x8(PacketBatch *batch, int i)
+{
+#if defined(__SSE2__)
+	__m128i low  = _mm_loadu_si128((const __m128i *)&batch->header[i]);
+	__m128i high = _mm_loadu_si128((const __m128i *)&batch->header[i + 4]);
+
+#define DECODE_FIELD(shift, mask) \
+	_mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(low, shift), _mm_set1_epi32(mask)), \
+	                _mm_and_si128(_mm_srli_epi32(high, shift), _mm_set1_epi32(mask)))
+#define STORE_BYTES(array, field) _mm_storel_epi64((__m128i *)&(array)[i], _mm_packus_epi16(field, field))
+
+	__m128i pid = _mm_or_si128(_mm_packs_epi32(_mm_and_si128(low, _mm_set1_epi32(0x1F00)), _mm_and_si128(high, _mm_set1_epi32(0x1F00))),
+	                           DECODE_FIELD(16, 0xFF));
+	_mm_storeu_si128((__m128i *)&batch->pid[i], pid);
+
+	STORE_BYTES(batch->transport_error_indicator, DECODE_FIELD(15, 0x01));
+	STORE_BYTES(batch->payload_unit_start_indicator, DECODE_FIELD(14, 0x01));
+	STORE_BYTES(batch->transport_scrambling_control, DECODE_FIELD(30, 0x03));
+	STORE_BYTES(batch->adaptation_field_control, DECODE_FIELD(28, 0x03));
+	STORE_BYTES(batch->continuity_counter, DECODE_FIELD(24, 0x0F));
+#else
+	uint32x4_t low  = vld1q_u32(&batch->header[i]);
+	uint32x4_t high = vld1q_u32(&batch->header[i + 4]);
+
+#define DECODE_FIELD(shift, mask) \
+	vcombine_u16(vmovn_u32(vandq_u32(vshrq_n_u32(low, shift), vdupq_n_u32(mask))), \
+	             vmovn_u32(vandq_u32(vshrq_n_u32(high, shift), vdupq_n_u32(mask))))
+#define STORE_BYTES(array, field) vst1_u8(&(array)[i], vmovn_u16(field))
+
+	uint16x8_t pid = vorrq_u16(vcombine_u16(vmovn_u32(vandq_u32(low, vdupq_n_u32(0x1F00))), vmovn_u32(vandq_u32(high, vdupq_n_u32(0x1F00)))),
+	                           DECODE_FIELD(16, 0xFF));
+	vst1q_u16(&batch->pid[i], pid);
+
+	STORE_BYTES(batch->transport_error_indicator, DECODE_FIELD(15, 0x01));
+	STORE_BYTES(batch->payload_unit_start_indicator, DECODE_FIELD(14, 0x01));
+	STORE_BYTES(batch->transport_scrambling_control, DECODE_FIELD(30, 0x03));
+	STORE_BYTES(batch->adaptation_field_control, DECODE_FIELD(28, 0x03));
+	STORE_BYTES(batch->continuity_counter, DECODE_FIELD(24, 0x0F));
+#endif
+#undef DECODE_FIELD
+#undef STORE_BYTES
+}
+#endif
+
+void decode_packet_batch(PacketBatch *batch, const unsigned char *buffer, int packet_count, int packet_stride)
+{
+	int i = 0;
+
+	batch->count = packet_count;
+
+	// clang-format off
+	for (i=0; i<packet_count; i++)
+	{ // clang-format on
+		batch->packet[i] = buffer + i * packet_stride;
+		memcpy(&batch->header[i], batch->packet[i], sizeof(unsigned int));
+	}
+
+	i = 0;
+#ifdef PACKET_BATCH_SIMD
+	// clang-format off
+	for (; i+8<=packet_count; i+=8)
+	{ // clang-format on
+		decode_packet_header_x8(batch, i);
+	}
+#endif
+
+	// clang-format off
+	for (; i<packet_count; i++)
+	{ // clang-format on
+		decode_packet_header(batch, i);
+	}
+}
+
+// Section assembly of one packet for one filter whose header already matched
+static void filter_batch_packet(Slot *slot, int index, SectionContext *section, const PacketBatch *batch, int i)
+{
+	const unsigned char *packet_buffer = batch->packet[i];
+	unsigned short       pid           = batch->pid[i];
+
+	int payload_start_position = 0;
+	int pointer_field          = 0;
+
+	payload_start_position = get_payload_start_position(batch->adaptation_field_control[i], packet_buffer);
+	if ((payload_start_position < 4) || (payload_start_position >= TS_PACKET_SIZE))
+		return;
+
+	switch (check_continuity_counter(section, batch->continuity_counter[i]))
+	{
+	case 0:
+		INSTRUMENT_COUNT(duplicate_packet_count, 1);
+		return;
+	case -1:
+		reset_section(slot, section);
+		break;
+	default:
+		break;
+	}
+
+	if (batch->transport_error_indicator[i] == 1)
+	{
+		reset_section(slot, section);
+		return;
+	}
+
+	if (batch->payload_unit_start_indicator[i] == 0)
+	{
+		if (section->is_write_flag == 1)
+		{
+			append_to_section(slot, index, section, packet_buffer + payload_start_position, TS_PACKET_SIZE - payload_start_position, pid);
+		}
+		return;
+	}
+
+	pointer_field = packet_buffer[payload_start_position];
+	payload_start_position += 1;
+	if (payload_start_position + pointer_field > TS_PACKET_SIZE)
+	{
+		reset_section(slot, section);
+		return;
+	}
+
+	// the bytes in front of the pointer field finish the previous section
+	if ((section->is_write_flag == 1) && (pointer_field > 0))
+	{
+		append_to_section(slot, index, section, packet_buffer + payload_start_position, pointer_field, pid);
+		if ((section = get_active_section_context(slot, index, pid)) == NULL)
+			return;
+	}
+
+	if (section->is_write_flag == 1)
+	{
+		reset_section(slot, section);
+	}
+
+	start_sections_in_packet(slot, index, packet_buffer, payload_start_position + pointer_field, pid);
+}
+
+// Packets stay in stream order, a filter allocated by a callback sees the packets that follow
+static void dispatch_packet_batch(Slot *slot, const PacketBatch *batch, unsigned long long batch_offset)
+{
+	Filter         *filter  = NULL;
+	SectionContext *section = NULL;
+	int             i = 0, index = 0;
+
+	// clang-format off
+	for (i=0; i<batch->count; i++)
+	{
+		if (slot->section_log != NULL)
+			slot->packet_offset = batch_offset + (batch->packet[i] - batch->packet[0]);
+
+		for (index=0; index<MAX_FILTER_COUNT; index++)
+		{ // clang-format on
+			filter = &slot->filter_array[index];
+			if ((filter->is_used == 0) || ((batch->header[i] & filter->header_mask) != filter->header_match))
+				continue;
+
+			if ((section = get_section_context(filter, batch->pid[i])) == NULL)
+				continue;
+
+			INSTRUMENT_COUNT(filter_hit_count, 1);
+			filter_batch_packet(slot, index, section, batch, i);
+		}
+	}
+}
+
+void filter_ts_packets(Slot *slot, const unsigned char *buffer, int packet_count, int packet_stride)
+{
+	PacketBatch        batch;
+	int                batch_count  = 0;
+	unsigned long long batch_offset = slot->packet_offset;
+
+	INSTRUMENT_DECLARE_TIMER(start_ticks);
+	INSTRUMENT_START(start_ticks);
+	switch_table_context(slot->table_context);
+	if (slot->latency_stats != NULL)
+	{
+		slot->feed_ns = get_latency_ns();
+	}
+
+	while (packet_count > 0)
+	{
+		batch_count = MIN(packet_count, PACKET_BATCH_SIZE);
+		decode_packet_batch(&batch, buffer, batch_count, packet_stride);
+		dispatch_packet_batch(slot, &batch, batch_offset);
+
+		buffer += batch_count * packet_stride;
+		packet_count -= batch_count;
+		batch_offset += batch_count * packet_stride;
+	}
+	slot->packet_offset = batch_offset;
+	INSTRUMENT_STOP(INSTRUMENT_TIMER_DISPATCH, start_ticks);
+}
+
+void filter_ts_packet(Slot *slot, const unsigned char *packet_buffer)
+{
+	filter_ts_packets(slot, packet_buffer, 1, TS_PACKET_SIZE);
+}
+
+int feed_slot(Slot *slot, const unsigned char *buffer, int length)
+{
+	const unsigned char *sync_position = NULL;
+
+	int read_position = 0;
+	int copy_length   = 0;
+	int packet_count  = 0;
+	int run_count     = 0;
+
+	if ((slot == NULL) || (buffer == NULL) || (length < 0) || (slot->packet_size < TS_PACKET_SIZE))
+	{
+		return FILTER_PARAM_ERROR;
+	}
+
+	// finish the packet that the previous chunk ended in, it always starts with a sync byte
+	if (slot->partial_length > 0)
+	{
+		copy_length = MIN(slot->packet_size - slot->partial_length, length);
+		memcpy(slot->partial_packet + slot->partial_length, buffer, copy_length);
+		slot->partial_length += copy_length;
+		read_position = copy_length;
+
+		if (slot->partial_length < slot->packet_size)
+		{
+			slot->feed_offset += length;
+			return 0;
+		}
+
+		slot->packet_offset = slot->feed_offset + copy_length - slot->packet_size;
+		filter_ts_packet(slot, slot->partial_packet);
+		slot->partial_length = 0;
+		packet_count++;
+	}
+
+	while (read_position < length)
+	{
+		if (buffer[read_position] != SYNC_BYTE)
+		{
+			slot->sync_loss_count++;
+			sync_position = memchr(buffer + read_position, SYNC_BYTE, length - read_position);
+			if (sync_position == NULL)
+				break;
+
+			read_position = (int)(sync_position - buffer);
+			continue;
+		}
+
+		if (length - read_position < slot->packet_size)
+		{
+			slot->partial_length = length - read_position;
+			memcpy(slot->partial_packet, buffer + read_position, slot->partial_length);
+			break;
+		}
+
+		// every packet of the run starts with the sync byte, the whole run is filtered in batches
+		run_count = 1;
+		while ((read_position + (run_count + 1) * slot->packet_size <= length) &&
+		       (buffer[read_position + run_count * slot->packet_size] == SYNC_BYTE))
+		{
+			run_count++;
+		}
+
+		slot->packet_offset = slot->feed_offset + read_position;
+		filter_ts_packets(slot, buffer + read_position, run_count, slot->packet_size);
+		read_position += run_count * slot->packet_size;
+		packet_count += run_count;
+	}
+
+	slot->feed_offset += length;
+	INSTRUMENT_COUNT(packet_count, packet_count);
+	INSTRUMENT_POLL();
+	return packet_count;
+}
+
+int section_filter(Slot *slot)
+{
+	unsigned char read_buffer[FEED_BUFFER_SIZE];
+	size_t        read_length = 0;
+
+	INSTRUMENT_DECLARE_TIMER(start_ticks);
+
+	if (slot->ts_file == NULL)
+	{
+		return FILTER_PARAM_ERROR;
+	}
+
+	slot->partial_length = 0;
+	slot->feed_offset    = slot->start_position;
+	INSTRUMENT_START(start_ticks);
+	while ((read_length = fread(read_buffer, 1, sizeof(read_buffer), slot->ts_file)) > 0)
+	{
+		INSTRUMENT_STOP(INSTRUMENT_TIMER_IO, start_ticks);
+		feed_slot(slot, read_buffer, (int)read_length);
+		INSTRUMENT_START(start_ticks);
+	}
+
+	if (fseek(slot->ts_file, slot->start_position, SEEK_SET) != 0)
+	{
+		LOG_ERROR(LOGGER_CATEGORY_IO, "fseek error\n");
+	}
+
+	LOG("file end\n");
+	return 0;
+}
+
+int replay_section(Slot *slot, unsigned short pid, unsigned char *section_buffer, int section_length)
+{
+	unsigned char packet_header[4] = {SYNC_BYTE, 0x40 | ((pid >> 8) & 0x1F), pid & 0xFF, 0x10}; // payload_unit_start, payload only
+	unsigned int  header           = 0;
+	Filter       *filter           = NULL;
+	int           delivered_count  = 0;
+	int           index            = 0;
+
+	memcpy(&header, packet_header, sizeof(header));
+	switch_table_context(slot->table_context);
+
+	// clang-format off
+	for (index=0; index<MAX_FILTER_COUNT; index++)
+	{ // clang-format on
+		filter = &slot->filter_array[index];
+		if ((filter->is_used == 0) || ((header & filter->header_mask) != filter->header_match) || (get_section_context(filter, pid) == NULL))
+			continue;
+
+		if (compare_filter(filter, packet_header, section_buffer, section_length) == 1)
+		{
+			call_section_callback(slot, index, section_buffer, section_length, pid, slot->packet_offset, 0);
+			delivered_count++;
+		}
+	}
+	return delivered_count;
+}
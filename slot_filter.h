@@ -1,86 +1,264 @@
-/**
- * @file slot_filter.h
- *
- * @author :Yujin Yu
- * @date   :2025.04.14
- */
-#ifndef SLOT_FILTER_H
-#define SLOT_FILTER_H
-
-//---------------------------------------------------------------------------------------------------------------------
-
-#define FILTER_MASK_LENGTH 16
-#define MAX_SECTION_LENGTH 4096
-#define MAX_FILTER_COUNT   32
-
-//---------------------------------------------------------------------------------------------------------------------
-typedef struct
-{
-	unsigned sync_byte                   : 8;
-	unsigned transport_error_indicator   : 1;
-	unsigned payload_unit_start_indicator: 1;
-	unsigned transport_priority          : 1;
-	unsigned PID                         : 13;
-	unsigned transport_scrambling_control: 2;
-	unsigned adaptation_field_control    : 2;
-	unsigned continuity_counter          : 4;
-} TSPacketHead; // total 4byte
-
-typedef struct
-{
-	unsigned table_id           : 8;
-	unsigned section_length     : 12;
-	unsigned version_number     : 5;
-	unsigned section_number     : 8;
-	unsigned last_section_number: 8;
-} SectionHead;
-
-typedef struct Slot   Slot;
-typedef struct Filter Filter;
-
-typedef int (*parse_callback)(Slot *slot, int filter_index, unsigned char *section_buffer, unsigned short pid);
-
-struct Filter
-{
-	int            is_used;
-	unsigned char  filter_match[FILTER_MASK_LENGTH];
-	unsigned char  filter_mask[FILTER_MASK_LENGTH];
-	parse_callback section_callback;
-	int            is_CRC_check;
-	int            is_write_flag;
-	unsigned short section_length;
-	unsigned char  section_buffer[MAX_SECTION_LENGTH];
-	unsigned short payload_length_count;
-};
-
-struct Slot
-{
-	FILE         *ts_file;
-	unsigned char packet_size;
-	long          start_position;
-	Filter        filter_array[MAX_FILTER_COUNT];
-};
-
-//---------------------------------------------------------------------------------------------------------------------
-Slot init_slot(FILE *ts_file, unsigned char packet_size, unsigned int start_position);
-void clear_slot(Slot *slot);
-
-/**
- * @brief Allocate a filter slot
- *
- * @param slot             Pointer to the Slot structure
- * @param filter_match     Filter match pattern
- * @param filter_mask      Filter mask
- * @param is_crc_check     Flag to indicate if CRC check is required
- * @param section_callback Callback function for section processing
- *
- * @return >0 :Index of the allocated filter
- *         <0 :failure, no filter available
- */
-int  alloc_filter(Slot *slot, unsigned char *filter_match, unsigned char *filter_mask, int is_crc_check, parse_callback section_callback);
-void clear_filter(Slot *slot, int index);
-
-int  section_filter(Slot *slot);
-void get_section_header(unsigned char *buffer, SectionHead *section_header);
-
-#endif
+/**
+ * @file slot_filter.h
+ *
+ * @author :Yujin Yu
+ * @date   :2025.04.14
+ */
+#ifndef SLOT_FILTER_H
+#define SLOT_FILTER_H
+
+//---------------------------------------------------------------------------------------------------------------------
+
+#define FILTER_MASK_LENGTH 16
+#define MAX_SECTION_LENGTH 4096
+#define MAX_FILTER_COUNT   32
+#define MAX_PACKET_SIZE    204
+#define FEED_BUFFER_SIZE   (MAX_PACKET_SIZE * 320) // bytes section_filter reads per fread
+#define PACKET_BATCH_SIZE  64                      // packets whose headers are decoded together
+#define MAX_PID_COUNT      8192
+
+#define SECTION_BUFFER_SMALL_SIZE  1024 // PAT, PMT and most SDT sections fit, EIT takes the 4096 class
+#define SECTION_BUFFER_CLASS_COUNT 2
+#define PID_SET_INITIAL_CAPACITY 16                  // reassembly contexts, doubled when a PID set fills up
+
+//---------------------------------------------------------------------------------------------------------------------
+typedef struct
+{
+	unsigned sync_byte                   : 8;
+	unsigned transport_error_indicator   : 1;
+	unsigned payload_unit_start_indicator: 1;
+	unsigned transport_priority          : 1;
+	unsigned PID                         : 13;
+	unsigned transport_scrambling_control: 2;
+	unsigned adaptation_field_control    : 2;
+	unsigned continuity_counter          : 4;
+} TSPacketHead; // total 4byte
+
+// Headers of up to PACKET_BATCH_SIZE packets, one array per field
+typedef struct
+{
+	int                  count;
+	const unsigned char *packet[PACKET_BATCH_SIZE];
+	unsigned int         header[PACKET_BATCH_SIZE]; // bytes 0..3 as stored in memory, compared against Filter.header_match
+	unsigned short       pid[PACKET_BATCH_SIZE];
+	unsigned char        payload_unit_start_indicator[PACKET_BATCH_SIZE];
+	unsigned char        transport_error_indicator[PACKET_BATCH_SIZE];
+	unsigned char        transport_scrambling_control[PACKET_BATCH_SIZE];
+	unsigned char        adaptation_field_control[PACKET_BATCH_SIZE];
+	unsigned char        continuity_counter[PACKET_BATCH_SIZE];
+} PacketBatch;
+
+typedef struct
+{
+	unsigned table_id           : 8;
+	unsigned section_length     : 12;
+	unsigned version_number     : 5;
+	unsigned section_number     : 8;
+	unsigned last_section_number: 8;
+} SectionHead;
+
+typedef struct Slot   Slot;
+typedef struct Filter Filter;
+
+struct TableContext;
+struct SectionLog;
+struct LatencyStats;
+
+typedef int (*parse_callback)(Slot *slot, int filter_index, unsigned char *section_buffer, unsigned short pid);
+
+// Reassembly state of one section stream
+typedef struct
+{
+	int                is_write_flag;
+	unsigned short     section_length;
+	unsigned short     payload_length_count;
+	unsigned char      continuity_counter;
+	unsigned char      is_continuity_valid;
+	unsigned short     buffer_size;
+	unsigned char     *section_buffer; // from the slot's pool while a section spans packets, NULL otherwise
+	unsigned long long start_offset;   // input offset of the packet the section started in, for the section log
+	unsigned long long start_ns;       // feed time of that packet, only set while latency stats are attached
+} SectionContext;
+
+// Reassembly buffers shared by all filters of a slot, never zeroed
+typedef struct
+{
+	unsigned char *free_list[SECTION_BUFFER_CLASS_COUNT];
+	int            block_count[SECTION_BUFFER_CLASS_COUNT]; // blocks allocated so far
+} SectionBufferPool;
+
+// PIDs matched by one filter, each PID reassembles into its own context
+typedef struct
+{
+	unsigned char   pid_bitmap[MAX_PID_COUNT / 8];
+	unsigned short  context_index[MAX_PID_COUNT]; // 0: no context yet, otherwise index + 1 into context_array
+	SectionContext *context_array;
+	int             context_count;
+	int             context_capacity;
+} PidSet;
+
+struct Filter
+{
+	int            is_used;
+	unsigned char  filter_match[FILTER_MASK_LENGTH];
+	unsigned char  filter_mask[FILTER_MASK_LENGTH];
+	unsigned char  filter_mode[FILTER_MASK_LENGTH]; // bit set: negative match, the bit has to differ
+
+	// compiled by alloc_filter, the 16 bytes are compared as one vector
+	unsigned char  positive_match[FILTER_MASK_LENGTH];
+	unsigned char  positive_mask[FILTER_MASK_LENGTH];
+	unsigned char  negative_match[FILTER_MASK_LENGTH];
+	unsigned char  negative_mask[FILTER_MASK_LENGTH];
+	int            is_negative_match;
+	unsigned int   header_match; // positive bytes 0..3 in memory order, already masked
+	unsigned int   header_mask;
+
+	parse_callback section_callback;
+	int            is_CRC_check;
+	SectionContext section; // PID set filters use the contexts of pid_set instead
+	PidSet        *pid_set; // NULL: single PID filter
+};
+
+struct Slot
+{
+	FILE                *ts_file;
+	unsigned char        packet_size;
+	long                 start_position;
+	struct TableContext *table_context; // NULL: default context
+	Filter               filter_array[MAX_FILTER_COUNT];
+	SectionBufferPool    section_buffer_pool;
+
+	// feed_slot state between two chunks
+	unsigned char      partial_packet[MAX_PACKET_SIZE];
+	int                partial_length;
+	unsigned long long sync_loss_count;
+
+	// input offsets, only looked at while a section log is attached
+	unsigned long long feed_offset;   // offset of the next byte given to feed_slot
+	unsigned long long packet_offset; // offset of the packet being filtered, the next one between calls
+	struct SectionLog *section_log;   // NULL: no log, every delivered section is appended otherwise
+
+	struct LatencyStats *latency_stats; // NULL: not measured, otherwise section to callback latency is recorded
+	unsigned long long   feed_ns;       // when the packets being filtered entered filter_ts_packets
+};
+
+//---------------------------------------------------------------------------------------------------------------------
+unsigned int calculate_crc32(const unsigned char *data, int length); // MPEG-2 CRC, no final XOR
+int          crc_check(const unsigned char *data, int length);       // 1: the last 4 bytes are the CRC of the rest
+
+Slot init_slot(FILE *ts_file, unsigned char packet_size, unsigned int start_position);
+void clear_slot(Slot *slot);
+
+/**
+ * @brief Allocate a filter slot
+ *
+ * @param slot             Pointer to the Slot structure
+ * @param filter_match     Filter match pattern
+ * @param filter_mask      Filter mask
+ * @param is_crc_check     Flag to indicate if CRC check is required
+ * @param section_callback Callback function for section processing
+ *
+ * @return >0 :Index of the allocated filter
+ *         <0 :failure, no filter available
+ */
+int alloc_filter(Slot *slot, unsigned char *filter_match, unsigned char *filter_mask, int is_crc_check, parse_callback section_callback);
+
+/**
+ * @brief Allocate a filter with negative match bits
+ *
+ * Like the section filters of set-top box demuxers: the bits of filter_mask that are clear in
+ * filter_mode have to be equal to filter_match, of the bits that are set in filter_mode at least
+ * one has to differ from filter_match. Negative bits are checked when a section starts.
+ *
+ * @param filter_mode Negative match bits, NULL is the same as alloc_filter
+ *
+ * @return >0 :Index of the allocated filter
+ *         <0 :failure, no filter available
+ */
+int  alloc_filter_with_mode(Slot *slot, unsigned char *filter_match, unsigned char *filter_mask, unsigned char *filter_mode, int is_crc_check, parse_callback section_callback);
+void clear_filter(Slot *slot, int index);
+
+/**
+ * @brief Allocate a filter that matches every PID of a set instead of the PID in filter_match
+ *
+ * The PID bits of filter_match/filter_mask are ignored, the other bytes work as in alloc_filter.
+ * The set starts empty, PIDs are added with add_pid_to_filter.
+ *
+ * @return >=0:Index of the allocated filter
+ *         <0 :error code or no filter available
+ */
+int alloc_pid_set_filter(Slot *slot, unsigned char *filter_match, unsigned char *filter_mask, int is_crc_check, parse_callback section_callback);
+
+/**
+ * @brief Add a PID to a PID set filter, its reassembly context comes from the filter's pool
+ *
+ * The pool doubles when it is full, so the filter never runs out of PIDs.
+ *
+ * @return 0 :successful
+ *         <0:error code
+ */
+int  add_pid_to_filter(Slot *slot, int index, unsigned short pid);
+void remove_pid_from_filter(Slot *slot, int index, unsigned short pid);
+
+/**
+ * @brief Run one TS packet through every used filter of the slot
+ *
+ * @param slot          Pointer to the Slot structure
+ * @param packet_buffer One complete TS packet of slot->packet_size bytes, starting with the sync byte
+ */
+void filter_ts_packet(Slot *slot, const unsigned char *packet_buffer);
+
+/**
+ * @brief Run packets laid out back to back through the filter bank
+ *
+ * The headers are decoded PACKET_BATCH_SIZE packets at a time, every filter then only compares
+ * the decoded header word instead of reading the packet again.
+ *
+ * @param slot          Pointer to the Slot structure
+ * @param buffer        First packet, it must start with the sync byte
+ * @param packet_count  Number of packets
+ * @param packet_stride Distance between two packets (188, 192 or 204)
+ */
+void filter_ts_packets(Slot *slot, const unsigned char *buffer, int packet_count, int packet_stride);
+
+/**
+ * @brief Decode the 4 byte headers of packet_count packets into batch, SSE2/NEON when available
+ *
+ * @param batch         Output, batch->packet[] is filled in as well
+ * @param buffer        First packet
+ * @param packet_count  Number of packets, at most PACKET_BATCH_SIZE
+ * @param packet_stride Distance between two packets
+ */
+void decode_packet_batch(PacketBatch *batch, const unsigned char *buffer, int packet_count, int packet_stride);
+
+/**
+ * @brief Push a chunk of a transport stream into the slot
+ *
+ * The chunk may start and end anywhere inside a packet, the incomplete packet at the end is kept in
+ * the slot and finished by the next call, sections in progress live in the filters. Nothing blocks
+ * and nothing is allocated, so any source can drive it: a file, a socket or an event loop.
+ *
+ * @param slot   Pointer to the Slot structure, packet_size must be set
+ * @param buffer Bytes of the stream
+ * @param length Number of bytes in buffer
+ *
+ * @return >=0: number of complete packets filtered
+ *         <0 : error code
+ */
+int feed_slot(Slot *slot, const unsigned char *buffer, int length);
+
+/**
+ * @brief Read slot->ts_file to the end in FEED_BUFFER_SIZE chunks and feed them into the slot
+ */
+int section_filter(Slot *slot);
+
+/**
+ * @brief Hand a complete section to every filter that would have matched it in a packet of this PID,
+ *        used to replay a section log without any TS input
+ *
+ * @return number of filters the section was delivered to
+ */
+int replay_section(Slot *slot, unsigned short pid, unsigned char *section_buffer, int section_length);
+void get_section_header(unsigned char *buffer, SectionHead *section_header);
+
+#endif
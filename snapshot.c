@@ -0,0 +1,753 @@
+/**
+ * @file snapshot.c
+ *
+ * @author :Yujin Yu
+ * @date   :2025.05.19
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "ts_global.h"
+#include "slot_filter.h"
+#include "get_pat_info.h"
+#include "get_pmt_info.h"
+#include "section_store.h"
+#include "string_pool.h"
+#include "dvb_charset.h"
+#include "get_sdt_info.h"
+#include "get_eit_info.h"
+#include "table_context.h"
+#include "snapshot.h"
+#include "memory_account.h"
+
+#define SNAPSHOT_FILE_NAME_LENGTH 512
+
+#define ALIGN_SNAPSHOT_OFFSET(offset) (((offset) + SNAPSHOT_ALIGNMENT - 1) & ~(unsigned long long)(SNAPSHOT_ALIGNMENT - 1))
+
+// Record counts and descriptor bytes of the current table context
+typedef struct
+{
+	unsigned int pat_count;
+	unsigned int pmt_count;
+	unsigned int es_count;
+	unsigned int service_count;
+	unsigned int event_count;
+	unsigned int descriptor_size;
+} SnapshotLayout;
+
+//--------------------------------------------------------------------------------------------
+// PMT descriptors, only DescriptorCollection is kept after parsing so it is encoded back to descriptor bytes
+//--------------------------------------------------------------------------------------------
+static int get_descriptor_collection_length(const DescriptorCollection *collection)
+{
+	int length = collection->private_data_specifier_count * 6;
+	int i      = 0;
+
+	// clang-format off
+	for (i=0; i<collection->subtitling_descriptor_count; i++)
+	{ // clang-format on
+		length += 2 + collection->subtitling_descriptors[i].subtitling_info_count * 8;
+	}
+	return length;
+}
+
+static int encode_descriptor_collection(const DescriptorCollection *collection, unsigned char *buffer)
+{
+	const SubtitlingInfo *info           = NULL;
+	unsigned int          specifier      = 0;
+	int                   write_position = 0;
+	int                   i              = 0;
+	int                   j              = 0;
+
+	// clang-format off
+	for (i=0; i<collection->private_data_specifier_count; i++)
+	{ // clang-format on
+		specifier                  = collection->private_data_specifiers[i].private_data_specifier;
+		buffer[write_position + 0] = DESCRIPTOR_PRIVATE_DATA_SPECIFIER;
+		buffer[write_position + 1] = 4;
+		buffer[write_position + 2] = (specifier >> 24) & 0xFF;
+		buffer[write_position + 3] = (specifier >> 16) & 0xFF;
+		buffer[write_position + 4] = (specifier >> 8) & 0xFF;
+		buffer[write_position + 5] = (specifier >> 0) & 0xFF;
+		write_position += 6;
+	}
+
+	// clang-format off
+	for (i=0; i<collection->subtitling_descriptor_count; i++)
+	{ // clang-format on
+		buffer[write_position + 0] = DESCRIPTOR_SUBTITLING;
+		buffer[write_position + 1] = collection->subtitling_descriptors[i].subtitling_info_count * 8;
+		write_position += 2;
+
+		// clang-format off
+		for (j=0; j<collection->subtitling_descriptors[i].subtitling_info_count; j++)
+		{ // clang-format on
+			info                       = &collection->subtitling_descriptors[i].subtitling_info[j];
+			buffer[write_position + 0] = (info->ISO_639_language_code >> 16) & 0xFF;
+			buffer[write_position + 1] = (info->ISO_639_language_code >> 8) & 0xFF;
+			buffer[write_position + 2] = (info->ISO_639_language_code >> 0) & 0xFF;
+			buffer[write_position + 3] = info->subtitling_type;
+			buffer[write_position + 4] = (info->composition_page_id >> 8) & 0xFF;
+			buffer[write_position + 5] = (info->composition_page_id >> 0) & 0xFF;
+			buffer[write_position + 6] = (info->ancillary_page_id >> 8) & 0xFF;
+			buffer[write_position + 7] = (info->ancillary_page_id >> 0) & 0xFF;
+			write_position += 8;
+		}
+	}
+	return write_position;
+}
+
+//--------------------------------------------------------------------------------------------
+// Writer
+//--------------------------------------------------------------------------------------------
+static void get_snapshot_layout(const TableContext *table_context, SnapshotLayout *layout)
+{
+	const PatNode   *pat_node = NULL;
+	const PmtNode   *pmt_node = NULL;
+	const PmtESNode *es_node  = NULL;
+	const SdtNode   *sdt_node = NULL;
+	const EitNode   *eit_node = NULL;
+
+	memset(layout, 0, sizeof(SnapshotLayout));
+
+	for (pat_node = table_context->pat_list; pat_node != NULL; pat_node = pat_node->next)
+	{
+		layout->pat_count++;
+	}
+	for (pmt_node = table_context->pmt_list; pmt_node != NULL; pmt_node = pmt_node->next)
+	{
+		layout->pmt_count++;
+		layout->descriptor_size += get_descriptor_collection_length(&pmt_node->program_descriptors);
+		for (es_node = pmt_node->es_info_list; es_node != NULL; es_node = es_node->next)
+		{
+			layout->es_count++;
+			layout->descriptor_size += get_descriptor_collection_length(&es_node->descriptors);
+		}
+	}
+	for (sdt_node = table_context->sdt_list; sdt_node != NULL; sdt_node = sdt_node->next)
+	{
+		layout->service_count++;
+		layout->descriptor_size += sdt_node->descriptor_loop.length;
+	}
+	for (eit_node = table_context->eit_list; eit_node != NULL; eit_node = eit_node->next)
+	{
+		layout->event_count++;
+		layout->descriptor_size += eit_node->descriptor_loop.length;
+	}
+}
+
+static void set_snapshot_table(SnapshotHeader *header, SnapshotTableType type, unsigned long long *offset, unsigned int count, unsigned int entry_size)
+{
+	header->table[type].offset     = *offset;
+	header->table[type].count      = count;
+	header->table[type].entry_size = entry_size;
+	*offset                        = ALIGN_SNAPSHOT_OFFSET(*offset + (unsigned long long)count * entry_size);
+}
+
+// Copy a loop of the section store into the descriptor data
+static void copy_descriptor_loop(const SectionStore *section_store, DescriptorLoop source_loop, unsigned char *descriptor_data,
+                                 unsigned int *descriptor_size, DescriptorLoop *descriptor_loop)
+{
+	descriptor_loop->offset = *descriptor_size;
+	descriptor_loop->length = 0;
+	if ((source_loop.length == 0) || (source_loop.offset + source_loop.length > section_store->length))
+		return;
+
+	memcpy(descriptor_data + *descriptor_size, section_store->data + source_loop.offset, source_loop.length);
+	descriptor_loop->length = source_loop.length;
+	*descriptor_size += source_loop.length;
+}
+
+static void encode_descriptor_loop(const DescriptorCollection *collection, unsigned char *descriptor_data, unsigned int *descriptor_size, DescriptorLoop *descriptor_loop)
+{
+	descriptor_loop->offset = *descriptor_size;
+	descriptor_loop->length = encode_descriptor_collection(collection, descriptor_data + *descriptor_size);
+	*descriptor_size += descriptor_loop->length;
+}
+
+static int intern_service_strings(StringPool *string_pool, const SdtNode *sdt_node, SnapshotService *service)
+{
+	ServiceDescriptor service_descriptor = {0};
+	int               error_code         = 0;
+
+	if (get_service_descriptor(sdt_node->descriptor_loop, &service_descriptor) != 1)
+		return 0;
+
+	service->service_type = service_descriptor.service_type;
+	if ((error_code = intern_string(string_pool, get_string(service_descriptor.service_provider_name),
+	                                get_string_length(service_descriptor.service_provider_name), &service->service_provider_name)) < 0)
+		return error_code;
+
+	return intern_string(string_pool, get_string(service_descriptor.service_name), get_string_length(service_descriptor.service_name), &service->service_name);
+}
+
+// Name and text are decoded straight from the short event descriptor, the context pool is left alone
+static int intern_event_strings(StringPool *string_pool, const EitNode *eit_node, SnapshotEvent *event, char *decode_buffer)
+{
+	const unsigned char *buffer            = NULL;
+	int                  descriptor_length = 0;
+	int                  name_length       = 0;
+	int                  text_length       = 0;
+	int                  error_code        = 0;
+
+	buffer = find_descriptor(eit_node->descriptor_loop, SHORT_EVENT_DESCRIPTOR_TAG, 0, &descriptor_length);
+	if ((buffer == NULL) || (descriptor_length < 5))
+		return 0;
+
+	event->ISO_639_language_code = (buffer[0] << 16) | (buffer[1] << 8) | buffer[2];
+	name_length                  = MIN(buffer[3], descriptor_length - 5);
+	text_length                  = MIN(buffer[4 + name_length], descriptor_length - 5 - name_length);
+
+	if ((error_code = intern_string(string_pool, decode_buffer, decode_dvb_string(buffer + 4, name_length, decode_buffer, DVB_DECODE_BUFFER_SIZE), &event->name)) < 0)
+		return error_code;
+
+	return intern_string(string_pool, decode_buffer, decode_dvb_string(buffer + 5 + name_length, text_length, decode_buffer, DVB_DECODE_BUFFER_SIZE), &event->text);
+}
+
+static int fill_snapshot(const TableContext *table_context, const SnapshotHeader *header, unsigned char *image, StringPool *string_pool)
+{
+	SnapshotPat     *pat             = (SnapshotPat *)(image + header->table[SNAPSHOT_PAT_TABLE].offset);
+	SnapshotPmt     *pmt             = (SnapshotPmt *)(image + header->table[SNAPSHOT_PMT_TABLE].offset);
+	SnapshotEs      *es              = (SnapshotEs *)(image + header->table[SNAPSHOT_ES_TABLE].offset);
+	SnapshotService *service         = (SnapshotService *)(image + header->table[SNAPSHOT_SERVICE_TABLE].offset);
+	SnapshotEvent   *event           = (SnapshotEvent *)(image + header->table[SNAPSHOT_EVENT_TABLE].offset);
+	unsigned char   *descriptor_data = image + header->table[SNAPSHOT_DESCRIPTOR_DATA].offset;
+	unsigned int     descriptor_size = 0;
+	unsigned int     es_index        = 0;
+	int              error_code      = 0;
+
+	const PatNode   *pat_node = NULL;
+	const PmtNode   *pmt_node = NULL;
+	const PmtESNode *es_node  = NULL;
+	const SdtNode   *sdt_node = NULL;
+	const EitNode   *eit_node = NULL;
+
+	char decode_buffer[DVB_DECODE_BUFFER_SIZE];
+
+	for (pat_node = table_context->pat_list; pat_node != NULL; pat_node = pat_node->next, pat++)
+	{
+		pat->transport_stream_id = pat_node->transport_stream_id;
+		pat->program_number      = pat_node->program_number;
+		pat->program_map_PID     = pat_node->program_map_PID;
+	}
+
+	for (pmt_node = table_context->pmt_list; pmt_node != NULL; pmt_node = pmt_node->next, pmt++)
+	{
+		pmt->program_number = pmt_node->program_number;
+		pmt->pcr_pid        = pmt_node->pcr_pid;
+		pmt->es_begin       = es_index;
+		encode_descriptor_loop(&pmt_node->program_descriptors, descriptor_data, &descriptor_size, &pmt->descriptor_loop);
+		for (es_node = pmt_node->es_info_list; es_node != NULL; es_node = es_node->next, es++, es_index++)
+		{
+			es->stream_type    = es_node->stream_type;
+			es->elementary_pid = es_node->elementary_pid;
+			encode_descriptor_loop(&es_node->descriptors, descriptor_data, &descriptor_size, &es->descriptor_loop);
+		}
+		pmt->es_count = es_index - pmt->es_begin;
+	}
+
+	for (sdt_node = table_context->sdt_list; sdt_node != NULL; sdt_node = sdt_node->next, service++)
+	{
+		service->table_id            = sdt_node->table_id;
+		service->running_status      = sdt_node->running_status;
+		service->flags               = (sdt_node->EIT_schedule_flag ? SNAPSHOT_EIT_SCHEDULE_FLAG : 0) |
+		                               (sdt_node->EIT_present_following_flag ? SNAPSHOT_EIT_PRESENT_FOLLOWING_FLAG : 0) |
+		                               (sdt_node->free_CA_mode ? SNAPSHOT_FREE_CA_MODE : 0);
+		service->transport_stream_id = sdt_node->transport_stream_id;
+		service->original_network_id = sdt_node->original_network_id;
+		service->service_id          = sdt_node->service_id;
+		copy_descriptor_loop(&table_context->section_store, sdt_node->descriptor_loop, descriptor_data, &descriptor_size, &service->descriptor_loop);
+		if ((error_code = intern_service_strings(string_pool, sdt_node, service)) < 0)
+			return error_code;
+	}
+
+	for (eit_node = table_context->eit_list; eit_node != NULL; eit_node = eit_node->next, event++)
+	{
+		event->start_time                  = eit_node->start_time;
+		event->duration                    = eit_node->duration;
+		event->service_id                  = eit_node->service_id;
+		event->transport_stream_id         = eit_node->transport_stream_id;
+		event->original_network_id         = eit_node->original_network_id;
+		event->event_id                    = eit_node->event_id;
+		event->running_status              = eit_node->running_status;
+		event->free_CA_mode                = eit_node->free_CA_mode;
+		event->segment_last_section_number = eit_node->segment_last_section_number;
+		event->last_table_id               = eit_node->last_table_id;
+		copy_descriptor_loop(&table_context->section_store, eit_node->descriptor_loop, descriptor_data, &descriptor_size, &event->descriptor_loop);
+		if ((error_code = intern_event_strings(string_pool, eit_node, event, decode_buffer)) < 0)
+			return error_code;
+	}
+
+	return 0;
+}
+
+static void get_snapshot_source(FILE *source_fp, unsigned char packet_size, long start_position, SnapshotSource *source)
+{
+	struct stat file_status;
+
+	memset(source, 0, sizeof(SnapshotSource));
+	if ((source_fp == NULL) || (fstat(fileno(source_fp), &file_status) != 0))
+		return;
+
+	source->file_size      = file_status.st_size;
+	source->modify_time    = file_status.st_mtime;
+	source->packet_size    = packet_size;
+	source->start_position = (unsigned int)start_position;
+}
+
+// The fixed tables are built in one block, the string data grows while they are filled and goes last
+static int write_snapshot_file(const char *file_name, const unsigned char *image, unsigned long long image_size, const StringPool *string_pool)
+{
+	FILE *fp         = NULL;
+	int   error_code = 0;
+
+	fp = fopen(file_name, "wb");
+	if (fp == NULL)
+	{
+		LOG("open %s fail\n", file_name);
+		return SNAPSHOT_OPEN_ERROR;
+	}
+
+	if ((fwrite(image, 1, image_size, fp) != image_size) ||
+	    (fwrite(string_pool->data, 1, string_pool->length, fp) != string_pool->length))
+	{
+		error_code = SNAPSHOT_WRITE_ERROR;
+	}
+	if (fclose(fp) != 0)
+	{
+		error_code = SNAPSHOT_WRITE_ERROR;
+	}
+	return error_code;
+}
+
+int save_snapshot(const char *file_name, FILE *source_fp, unsigned char packet_size, long start_position)
+{
+	const TableContext *table_context = get_table_context();
+	SnapshotLayout      layout        = {0};
+	StringPool          string_pool   = {0};
+	unsigned char      *image         = NULL;
+	unsigned long long  image_size    = ALIGN_SNAPSHOT_OFFSET(sizeof(SnapshotHeader));
+	int                 error_code    = 0;
+
+	SnapshotHeader header;
+	char           temp_file_name[SNAPSHOT_FILE_NAME_LENGTH] = {0};
+
+	if ((file_name == NULL) || (snprintf(temp_file_name, sizeof(temp_file_name), "%s.tmp", file_name) >= (int)sizeof(temp_file_name)))
+	{
+		return SNAPSHOT_PARAM_ERROR;
+	}
+
+	memset(&header, 0, sizeof(SnapshotHeader));
+	memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(header.magic));
+	header.version     = SNAPSHOT_VERSION;
+	header.header_size = sizeof(SnapshotHeader);
+	header.byte_order  = SNAPSHOT_BYTE_ORDER;
+	get_snapshot_source(source_fp, packet_size, start_position, &header.source);
+
+	get_snapshot_layout(table_context, &layout);
+	set_snapshot_table(&header, SNAPSHOT_PAT_TABLE, &image_size, layout.pat_count, sizeof(SnapshotPat));
+	set_snapshot_table(&header, SNAPSHOT_PMT_TABLE, &image_size, layout.pmt_count, sizeof(SnapshotPmt));
+	set_snapshot_table(&header, SNAPSHOT_ES_TABLE, &image_size, layout.es_count, sizeof(SnapshotEs));
+	set_snapshot_table(&header, SNAPSHOT_SERVICE_TABLE, &image_size, layout.service_count, sizeof(SnapshotService));
+	set_snapshot_table(&header, SNAPSHOT_EVENT_TABLE, &image_size, layout.event_count, sizeof(SnapshotEvent));
+	set_snapshot_table(&header, SNAPSHOT_DESCRIPTOR_DATA, &image_size, layout.descriptor_size, 1);
+
+	image = (unsigned char *)calloc(1, image_size);
+	if (image == NULL)
+	{
+		return SNAPSHOT_MALLOC_ERROR;
+	}
+
+	if ((error_code = fill_snapshot(table_context, &header, image, &string_pool)) == 0)
+	{
+		header.table[SNAPSHOT_STRING_DATA].offset     = image_size;
+		header.table[SNAPSHOT_STRING_DATA].count      = string_pool.length;
+		header.table[SNAPSHOT_STRING_DATA].entry_size = 1;
+		header.file_size                              = image_size + string_pool.length;
+		memcpy(image, &header, sizeof(SnapshotHeader));
+
+		error_code = write_snapshot_file(temp_file_name, image, image_size, &string_pool);
+	}
+
+	// readers that already mapped the old file keep it until they unmap
+	if ((error_code == 0) && (rename(temp_file_name, file_name) != 0))
+	{
+		perror("rename");
+		error_code = SNAPSHOT_WRITE_ERROR;
+	}
+	if (error_code < 0)
+	{
+		remove(temp_file_name);
+		LOG("save snapshot %s fail, error_code : %d\n", file_name, error_code);
+	}
+	else
+	{
+		LOG("snapshot %s: %u programs, %u services, %u events, %llu bytes\n", file_name, layout.pmt_count, layout.service_count, layout.event_count, header.file_size);
+	}
+
+	free_string_pool(&string_pool);
+	free(image);
+	return error_code;
+}
+
+//--------------------------------------------------------------------------------------------
+// Reader
+//--------------------------------------------------------------------------------------------
+static int check_snapshot_table(const Snapshot *snapshot, SnapshotTableType type, unsigned int entry_size)
+{
+	const SnapshotTable *table = &snapshot->header->table[type];
+
+	if ((table->entry_size != entry_size) || (table->offset % SNAPSHOT_ALIGNMENT != 0) || (table->offset > snapshot->file_size) ||
+	    ((unsigned long long)table->count * entry_size > snapshot->file_size - table->offset))
+	{
+		LOG("snapshot table %d out of bounds\n", type);
+		return SNAPSHOT_FORMAT_ERROR;
+	}
+	return 0;
+}
+
+static int check_snapshot(const Snapshot *snapshot)
+{
+	const SnapshotHeader *header    = snapshot->header;
+	const SnapshotPmt    *pmt_array = NULL;
+	unsigned int          i         = 0;
+
+	if ((snapshot->file_size < sizeof(SnapshotHeader)) || (memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic)) != 0))
+	{
+		LOG("not a snapshot file\n");
+		return SNAPSHOT_FORMAT_ERROR;
+	}
+	if ((header->version != SNAPSHOT_VERSION) || (header->header_size != sizeof(SnapshotHeader)) || (header->byte_order != SNAPSHOT_BYTE_ORDER))
+	{
+		LOG("snapshot version %u is not supported, expected %u on this byte order\n", header->version, SNAPSHOT_VERSION);
+		return SNAPSHOT_FORMAT_ERROR;
+	}
+	if (header->file_size != snapshot->file_size)
+	{
+		LOG("snapshot is truncated\n");
+		return SNAPSHOT_FORMAT_ERROR;
+	}
+
+	if ((check_snapshot_table(snapshot, SNAPSHOT_PAT_TABLE, sizeof(SnapshotPat)) < 0) ||
+	    (check_snapshot_table(snapshot, SNAPSHOT_PMT_TABLE, sizeof(SnapshotPmt)) < 0) ||
+	    (check_snapshot_table(snapshot, SNAPSHOT_ES_TABLE, sizeof(SnapshotEs)) < 0) ||
+	    (check_snapshot_table(snapshot, SNAPSHOT_SERVICE_TABLE, sizeof(SnapshotService)) < 0) ||
+	    (check_snapshot_table(snapshot, SNAPSHOT_EVENT_TABLE, sizeof(SnapshotEvent)) < 0) ||
+	    (check_snapshot_table(snapshot, SNAPSHOT_DESCRIPTOR_DATA, 1) < 0) ||
+	    (check_snapshot_table(snapshot, SNAPSHOT_STRING_DATA, 1) < 0))
+	{
+		return SNAPSHOT_FORMAT_ERROR;
+	}
+
+	// the ES ranges are the only indexes between tables, descriptor loops and strings are checked when used
+	pmt_array = (const SnapshotPmt *)(snapshot->file_data + header->table[SNAPSHOT_PMT_TABLE].offset);
+	// clang-format off
+	for (i=0; i<header->table[SNAPSHOT_PMT_TABLE].count; i++)
+	{ // clang-format on
+		if ((pmt_array[i].es_begin > header->table[SNAPSHOT_ES_TABLE].count) ||
+		    (pmt_array[i].es_count > header->table[SNAPSHOT_ES_TABLE].count - pmt_array[i].es_begin))
+		{
+			LOG("snapshot pmt %u has a bad es range\n", i);
+			return SNAPSHOT_FORMAT_ERROR;
+		}
+	}
+	return 0;
+}
+
+int open_snapshot(const char *file_name, Snapshot *snapshot)
+{
+	const SnapshotHeader *header    = NULL;
+	void                 *file_data = NULL;
+	struct stat           file_status;
+
+	if ((file_name == NULL) || (snapshot == NULL))
+	{
+		return SNAPSHOT_PARAM_ERROR;
+	}
+
+	memset(snapshot, 0, sizeof(Snapshot));
+	snapshot->file_descriptor = open(file_name, O_RDONLY);
+	if ((snapshot->file_descriptor < 0) || (fstat(snapshot->file_descriptor, &file_status) != 0))
+	{
+		close_snapshot(snapshot);
+		return SNAPSHOT_OPEN_ERROR;
+	}
+
+	snapshot->file_size = file_status.st_size;
+	if (snapshot->file_size < sizeof(SnapshotHeader))
+	{
+		close_snapshot(snapshot);
+		return SNAPSHOT_FORMAT_ERROR;
+	}
+
+	// shared read only pages, every process mapping the file uses the same page cache
+	file_data = mmap(NULL, snapshot->file_size, PROT_READ, MAP_SHARED, snapshot->file_descriptor, 0);
+	if (file_data == MAP_FAILED)
+	{
+		perror("mmap");
+		close_snapshot(snapshot);
+		return SNAPSHOT_MMAP_ERROR;
+	}
+	snapshot->file_data = (const unsigned char *)file_data;
+	snapshot->header    = (const SnapshotHeader *)file_data;
+
+	if (check_snapshot(snapshot) < 0)
+	{
+		close_snapshot(snapshot);
+		return SNAPSHOT_FORMAT_ERROR;
+	}
+
+	header                    = snapshot->header;
+	snapshot->pat_array       = (const SnapshotPat *)(snapshot->file_data + header->table[SNAPSHOT_PAT_TABLE].offset);
+	snapshot->pmt_array       = (const SnapshotPmt *)(snapshot->file_data + header->table[SNAPSHOT_PMT_TABLE].offset);
+	snapshot->es_array        = (const SnapshotEs *)(snapshot->file_data + header->table[SNAPSHOT_ES_TABLE].offset);
+	snapshot->service_array   = (const SnapshotService *)(snapshot->file_data + header->table[SNAPSHOT_SERVICE_TABLE].offset);
+	snapshot->event_array     = (const SnapshotEvent *)(snapshot->file_data + header->table[SNAPSHOT_EVENT_TABLE].offset);
+	snapshot->descriptor_data = snapshot->file_data + header->table[SNAPSHOT_DESCRIPTOR_DATA].offset;
+	snapshot->string_data     = snapshot->file_data + header->table[SNAPSHOT_STRING_DATA].offset;
+	snapshot->pat_count       = header->table[SNAPSHOT_PAT_TABLE].count;
+	snapshot->pmt_count       = header->table[SNAPSHOT_PMT_TABLE].count;
+	snapshot->es_count        = header->table[SNAPSHOT_ES_TABLE].count;
+	snapshot->service_count   = header->table[SNAPSHOT_SERVICE_TABLE].count;
+	snapshot->event_count     = header->table[SNAPSHOT_EVENT_TABLE].count;
+	snapshot->descriptor_size = header->table[SNAPSHOT_DESCRIPTOR_DATA].count;
+	snapshot->string_size     = header->table[SNAPSHOT_STRING_DATA].count;
+	return 0;
+}
+
+void close_snapshot(Snapshot *snapshot)
+{
+	if (snapshot == NULL)
+		return;
+
+	if (snapshot->file_data != NULL)
+	{
+		munmap((void *)snapshot->file_data, snapshot->file_size);
+	}
+	if (snapshot->file_descriptor >= 0)
+	{
+		close(snapshot->file_descriptor);
+	}
+	memset(snapshot, 0, sizeof(Snapshot));
+	snapshot->file_descriptor = -1;
+}
+
+int is_snapshot_of(const Snapshot *snapshot, FILE *source_fp)
+{
+	SnapshotSource source = {0};
+
+	get_snapshot_source(source_fp, 0, 0, &source);
+	if ((source.file_size == 0) || (source.file_size != snapshot->header->source.file_size) ||
+	    (source.modify_time != snapshot->header->source.modify_time))
+	{
+		return 0;
+	}
+	return 1;
+}
+
+const char *get_snapshot_string(const Snapshot *snapshot, StringHandle handle)
+{
+	unsigned int length = 0;
+
+	if ((handle == 0) || (handle >= snapshot->string_size) || (snapshot->string_size - handle < STRING_PREFIX_LENGTH + 1))
+		return "";
+
+	length = snapshot->string_data[handle] | (snapshot->string_data[handle + 1] << 8);
+	if (length >= snapshot->string_size - handle - STRING_PREFIX_LENGTH)
+		return "";
+
+	return (const char *)snapshot->string_data + handle + STRING_PREFIX_LENGTH;
+}
+
+const unsigned char *find_snapshot_descriptor(const Snapshot *snapshot, DescriptorLoop descriptor_loop, unsigned char descriptor_tag, int index, int *descriptor_length)
+{
+	if ((descriptor_loop.length == 0) || (descriptor_loop.offset > snapshot->descriptor_size) ||
+	    (descriptor_loop.length > snapshot->descriptor_size - descriptor_loop.offset))
+	{
+		return NULL;
+	}
+
+	return find_descriptor_in_buffer(snapshot->descriptor_data + descriptor_loop.offset, descriptor_loop.length, descriptor_tag, index, descriptor_length);
+}
+
+//--------------------------------------------------------------------------------------------
+// Restore, the lists come back in the order they were saved, which is the order the callbacks keep
+//--------------------------------------------------------------------------------------------
+static int restore_descriptor_loop(const Snapshot *snapshot, DescriptorLoop source_loop, DescriptorLoop *descriptor_loop)
+{
+	descriptor_loop->offset = 0;
+	descriptor_loop->length = 0;
+	if ((source_loop.length == 0) || (source_loop.offset > snapshot->descriptor_size) || (source_loop.length > snapshot->descriptor_size - source_loop.offset))
+		return 0;
+
+	return section_store_append(&get_table_context()->section_store, snapshot->descriptor_data + source_loop.offset, source_loop.length, descriptor_loop);
+}
+
+static void restore_descriptor_collection(const Snapshot *snapshot, DescriptorLoop source_loop, DescriptorCollection *collection)
+{
+	init_descriptor_collection(collection);
+	if ((source_loop.length == 0) || (source_loop.offset > snapshot->descriptor_size) || (source_loop.length > snapshot->descriptor_size - source_loop.offset))
+		return;
+
+	parse_pmt_descriptors((unsigned char *)snapshot->descriptor_data + source_loop.offset, source_loop.length, collection);
+}
+
+static int restore_pmt_list(const Snapshot *snapshot, PmtList **pmt_list)
+{
+	PmtNode    **pmt_tail = pmt_list;
+	PmtESNode  **es_tail  = NULL;
+	PmtNode     *pmt_node = NULL;
+	PmtESNode   *es_node  = NULL;
+	unsigned int i        = 0;
+	unsigned int j        = 0;
+
+	// clang-format off
+	for (i=0; i<snapshot->pmt_count; i++)
+	{ // clang-format on
+		pmt_node = (PmtNode *)calloc(1, sizeof(PmtNode));
+		if (pmt_node == NULL)
+			return SNAPSHOT_MALLOC_ERROR;
+		add_memory(MEMORY_SUBSYSTEM_PMT, sizeof(PmtNode), 0, 1);
+
+		pmt_node->program_number = snapshot->pmt_array[i].program_number;
+		pmt_node->pcr_pid        = snapshot->pmt_array[i].pcr_pid;
+		restore_descriptor_collection(snapshot, snapshot->pmt_array[i].descriptor_loop, &pmt_node->program_descriptors);
+		*pmt_tail = pmt_node;
+		pmt_tail  = &pmt_node->next;
+
+		es_tail = &pmt_node->es_info_list;
+		// clang-format off
+		for (j=snapshot->pmt_array[i].es_begin; j<snapshot->pmt_array[i].es_begin+snapshot->pmt_array[i].es_count; j++)
+		{ // clang-format on
+			es_node = (PmtESNode *)calloc(1, sizeof(PmtESNode));
+			if (es_node == NULL)
+				return SNAPSHOT_MALLOC_ERROR;
+			add_memory(MEMORY_SUBSYSTEM_PMT, sizeof(PmtESNode), 0, 1);
+
+			es_node->stream_type    = snapshot->es_array[j].stream_type;
+			es_node->elementary_pid = snapshot->es_array[j].elementary_pid;
+			restore_descriptor_collection(snapshot, snapshot->es_array[j].descriptor_loop, &es_node->descriptors);
+			*es_tail = es_node;
+			es_tail  = &es_node->next;
+		}
+	}
+	return 0;
+}
+
+static int restore_table_lists(const Snapshot *snapshot, TableContext *table_context)
+{
+	PatNode    **pat_tail   = &table_context->pat_list;
+	SdtNode    **sdt_tail   = &table_context->sdt_list;
+	EitNode    **eit_tail   = &table_context->eit_list;
+	PatNode     *pat_node   = NULL;
+	SdtNode     *sdt_node   = NULL;
+	EitNode     *eit_node   = NULL;
+	unsigned int i          = 0;
+	int          error_code = 0;
+
+	// clang-format off
+	for (i=0; i<snapshot->pat_count; i++)
+	{ // clang-format on
+		pat_node = (PatNode *)calloc(1, sizeof(PatNode));
+		if (pat_node == NULL)
+			return SNAPSHOT_MALLOC_ERROR;
+		add_memory(MEMORY_SUBSYSTEM_PAT, sizeof(PatNode), 0, 1);
+
+		pat_node->transport_stream_id = snapshot->pat_array[i].transport_stream_id;
+		pat_node->program_number      = snapshot->pat_array[i].program_number;
+		pat_node->program_map_PID     = snapshot->pat_array[i].program_map_PID;
+		*pat_tail                     = pat_node;
+		pat_tail                      = &pat_node->next;
+	}
+
+	if ((error_code = restore_pmt_list(snapshot, &table_context->pmt_list)) < 0)
+		return error_code;
+
+	// clang-format off
+	for (i=0; i<snapshot->service_count; i++)
+	{ // clang-format on
+		sdt_node = (SdtNode *)calloc(1, sizeof(SdtNode));
+		if (sdt_node == NULL)
+			return SNAPSHOT_MALLOC_ERROR;
+
+		sdt_node->table_id                   = snapshot->service_array[i].table_id;
+		sdt_node->transport_stream_id        = snapshot->service_array[i].transport_stream_id;
+		sdt_node->original_network_id        = snapshot->service_array[i].original_network_id;
+		sdt_node->service_id                 = snapshot->service_array[i].service_id;
+		sdt_node->EIT_schedule_flag          = (snapshot->service_array[i].flags & SNAPSHOT_EIT_SCHEDULE_FLAG) ? 1 : 0;
+		sdt_node->EIT_present_following_flag = (snapshot->service_array[i].flags & SNAPSHOT_EIT_PRESENT_FOLLOWING_FLAG) ? 1 : 0;
+		sdt_node->running_status             = snapshot->service_array[i].running_status;
+		sdt_node->free_CA_mode               = (snapshot->service_array[i].flags & SNAPSHOT_FREE_CA_MODE) ? 1 : 0;
+		if ((error_code = restore_descriptor_loop(snapshot, snapshot->service_array[i].descriptor_loop, &sdt_node->descriptor_loop)) < 0)
+		{
+			free(sdt_node);
+			return error_code;
+		}
+
+		// linked only once accounted, the free on failure takes out what was put in
+		add_memory(MEMORY_SUBSYSTEM_SDT, sizeof(SdtNode), sdt_node->descriptor_loop.length, 1);
+		*sdt_tail = sdt_node;
+		sdt_tail  = &sdt_node->next;
+	}
+
+	// clang-format off
+	for (i=0; i<snapshot->event_count; i++)
+	{ // clang-format on
+		eit_node = (EitNode *)calloc(1, sizeof(EitNode));
+		if (eit_node == NULL)
+			return SNAPSHOT_MALLOC_ERROR;
+
+		eit_node->service_id                  = snapshot->event_array[i].service_id;
+		eit_node->transport_stream_id         = snapshot->event_array[i].transport_stream_id;
+		eit_node->original_network_id         = snapshot->event_array[i].original_network_id;
+		eit_node->segment_last_section_number = snapshot->event_array[i].segment_last_section_number;
+		eit_node->last_table_id               = snapshot->event_array[i].last_table_id;
+		eit_node->event_id                    = snapshot->event_array[i].event_id;
+		eit_node->start_time                  = snapshot->event_array[i].start_time;
+		eit_node->duration                    = snapshot->event_array[i].duration;
+		eit_node->running_status              = snapshot->event_array[i].running_status;
+		eit_node->free_CA_mode                = snapshot->event_array[i].free_CA_mode;
+		if ((error_code = restore_descriptor_loop(snapshot, snapshot->event_array[i].descriptor_loop, &eit_node->descriptor_loop)) < 0)
+		{
+			free(eit_node);
+			return error_code;
+		}
+
+		account_eit_node(eit_node, 1);
+		*eit_tail = eit_node;
+		eit_tail  = &eit_node->next;
+	}
+	return 0;
+}
+
+int restore_snapshot(const Snapshot *snapshot)
+{
+	TableContext *table_context = get_table_context();
+	int           error_code    = 0;
+
+	if ((snapshot == NULL) || (snapshot->header == NULL))
+	{
+		return SNAPSHOT_PARAM_ERROR;
+	}
+
+	if ((error_code = restore_table_lists(snapshot, table_context)) < 0)
+	{
+		LOG("restore snapshot fail, error_code : %d\n", error_code);
+		free_pat_list(table_context->pat_list);
+		free_pmt_list(table_context->pmt_list);
+		free_sdt_list(table_context->sdt_list);
+		free_eit_list(table_context->eit_list);
+		table_context->pat_list = NULL;
+		table_context->pmt_list = NULL;
+		table_context->sdt_list = NULL;
+		table_context->eit_list = NULL;
+		return error_code;
+	}
+
+	LOG("restored %u programs, %u services, %u events from the snapshot\n", snapshot->pmt_count, snapshot->service_count, snapshot->event_count);
+	return 0;
+}
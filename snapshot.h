@@ -0,0 +1,201 @@
+/**
+ * @file snapshot.h
+ *
+ * @brief Flat binary snapshot of the acquired tables: PAT, PMT with ES and descriptors, SDT services, EIT events and strings.
+ *        Every table is an array of fixed-size records at an offset given in the header, descriptor loops and strings are
+ *        offsets into two byte blobs, so a reader maps the file and uses it in place without parsing or allocating.
+ *        The file is written to "name.tmp" and renamed, readers in other processes never see a partial snapshot.
+ *        Include ts_global.h, section_store.h and string_pool.h first.
+ *
+ * @author :Yujin Yu
+ * @date   :2025.05.19
+ */
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+//--------------------------------------------------------------------------------------------
+// macro definition
+//--------------------------------------------------------------------------------------------
+#define SNAPSHOT_MAGIC      "DMXSNAP"  // 8 bytes with the terminator
+#define SNAPSHOT_VERSION    1          // bumped whenever a record layout changes
+#define SNAPSHOT_BYTE_ORDER 0x01020304 // written in host order, a reader on the other byte order rejects the file
+#define SNAPSHOT_ALIGNMENT  8
+
+#define SNAPSHOT_EIT_SCHEDULE_FLAG          0x01
+#define SNAPSHOT_EIT_PRESENT_FOLLOWING_FLAG 0x02
+#define SNAPSHOT_FREE_CA_MODE               0x04
+
+typedef enum
+{
+	SNAPSHOT_PAT_TABLE = 0,
+	SNAPSHOT_PMT_TABLE,
+	SNAPSHOT_ES_TABLE,
+	SNAPSHOT_SERVICE_TABLE,
+	SNAPSHOT_EVENT_TABLE,
+	SNAPSHOT_DESCRIPTOR_DATA, // descriptor loops, entry_size 1
+	SNAPSHOT_STRING_DATA,     // string pool layout, see string_pool.h, entry_size 1
+	SNAPSHOT_TABLE_COUNT
+} SnapshotTableType;
+
+typedef struct
+{
+	unsigned long long offset; // from the start of the file, SNAPSHOT_ALIGNMENT aligned
+	unsigned int       count;
+	unsigned int       entry_size; // sizeof the record, checked when the file is opened
+} SnapshotTable;
+
+// Input the snapshot was taken from, used to reuse it as a cache
+typedef struct
+{
+	unsigned long long file_size; // 0: live input
+	long long          modify_time;
+	unsigned int       packet_size;
+	unsigned int       start_position;
+} SnapshotSource;
+
+typedef struct
+{
+	char               magic[8];
+	unsigned int       version;
+	unsigned int       header_size;
+	unsigned int       byte_order;
+	unsigned int       reserved;
+	unsigned long long file_size;
+	SnapshotSource     source;
+	SnapshotTable      table[SNAPSHOT_TABLE_COUNT];
+} SnapshotHeader;
+
+typedef struct
+{
+	unsigned short transport_stream_id;
+	unsigned short program_number;
+	unsigned short program_map_PID;
+	unsigned short reserved;
+} SnapshotPat;
+
+typedef struct
+{
+	unsigned short program_number;
+	unsigned short pcr_pid;
+	unsigned int   es_begin; // index into the ES table
+	unsigned int   es_count;
+	DescriptorLoop descriptor_loop; // program descriptors, offset into the descriptor data
+} SnapshotPmt;
+
+typedef struct
+{
+	unsigned char  stream_type;
+	unsigned char  reserved;
+	unsigned short elementary_pid;
+	DescriptorLoop descriptor_loop;
+} SnapshotEs;
+
+typedef struct
+{
+	unsigned char  table_id;
+	unsigned char  service_type;
+	unsigned char  running_status;
+	unsigned char  flags; // SNAPSHOT_EIT_SCHEDULE_FLAG ...
+	unsigned short transport_stream_id;
+	unsigned short original_network_id;
+	unsigned short service_id;
+	unsigned short reserved;
+	StringHandle   service_provider_name; // UTF-8, offset into the string data
+	StringHandle   service_name;
+	DescriptorLoop descriptor_loop;
+} SnapshotService;
+
+typedef struct
+{
+	unsigned long long start_time; // UTC epoch seconds
+	unsigned int       duration;   // seconds
+	unsigned short     service_id;
+	unsigned short     transport_stream_id;
+	unsigned short     original_network_id;
+	unsigned short     event_id;
+	unsigned char      running_status;
+	unsigned char      free_CA_mode;
+	unsigned char      segment_last_section_number;
+	unsigned char      last_table_id;
+	unsigned int       ISO_639_language_code; // of the short event descriptor
+	StringHandle       name;                  // UTF-8, short event descriptor
+	StringHandle       text;
+	DescriptorLoop     descriptor_loop;
+} SnapshotEvent;
+
+// A mapped snapshot, every pointer refers into the mapping
+typedef struct
+{
+	int                   file_descriptor;
+	const unsigned char  *file_data;
+	unsigned long long    file_size;
+	const SnapshotHeader *header;
+
+	const SnapshotPat     *pat_array;
+	const SnapshotPmt     *pmt_array;
+	const SnapshotEs      *es_array;
+	const SnapshotService *service_array;
+	const SnapshotEvent   *event_array;
+	const unsigned char   *descriptor_data;
+	const unsigned char   *string_data;
+	unsigned int           pat_count;
+	unsigned int           pmt_count;
+	unsigned int           es_count;
+	unsigned int           service_count;
+	unsigned int           event_count;
+	unsigned int           descriptor_size;
+	unsigned int           string_size;
+} Snapshot;
+
+//--------------------------------------------------------------------------------------------
+// Function declaration
+//--------------------------------------------------------------------------------------------
+/**
+ * @brief Write the tables of the current table context, call it before get_program_info_list consumes PAT and SDT
+ *
+ * @param file_name      Snapshot file, replaced atomically
+ * @param source_fp      Input file the tables came from, NULL for live input
+ * @param packet_size    Detected packet size of the input
+ * @param start_position Offset of the first packet
+ *
+ * @return 0: successful
+ *         <0: error code
+ */
+int save_snapshot(const char *file_name, FILE *source_fp, unsigned char packet_size, long start_position);
+
+/**
+ * @brief Map a snapshot read only and check its header and table bounds, nothing is copied
+ *
+ * @return 0: successful
+ *         <0: error code
+ */
+int  open_snapshot(const char *file_name, Snapshot *snapshot);
+void close_snapshot(Snapshot *snapshot);
+
+/**
+ * @brief Check whether the snapshot was taken from this input file, by size and modification time
+ *
+ * @return 1: the snapshot can stand in for a scan of the file
+ *         0: otherwise
+ */
+int is_snapshot_of(const Snapshot *snapshot, FILE *source_fp);
+
+/**
+ * @brief Rebuild the PAT, PMT, SDT and EIT lists of the current table context from a snapshot, as if the input had been scanned
+ *
+ * @return 0: successful
+ *         <0: error code
+ */
+int restore_snapshot(const Snapshot *snapshot);
+
+/**
+ * @brief String of a snapshot, "" for handle 0 or a handle outside the string data
+ */
+const char *get_snapshot_string(const Snapshot *snapshot, StringHandle handle);
+
+/**
+ * @brief find_descriptor for a descriptor loop of a snapshot
+ */
+const unsigned char *find_snapshot_descriptor(const Snapshot *snapshot, DescriptorLoop descriptor_loop, unsigned char descriptor_tag, int index, int *descriptor_length);
+
+#endif
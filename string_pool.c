@@ -0,0 +1,216 @@
+/**
+ * @file string_pool.c
+ *
+ * @author :Yujin Yu
+ * @date   :2025.05.13
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ts_global.h"
+#include "section_store.h"
+#include "string_pool.h"
+#include "table_context.h"
+
+#define STRING_DECODED_OFFSET 2
+
+// FNV-1a
+static unsigned int hash_string(const unsigned char *string, int length)
+{
+	unsigned int hash = 2166136261u;
+	int          i    = 0;
+
+	// clang-format off
+	for (i=0; i<length; i++)
+	{ // clang-format on
+		hash = (hash ^ string[i]) * 16777619u;
+	}
+	return hash;
+}
+
+static int get_stored_length(const StringPool *string_pool, StringHandle handle)
+{
+	return string_pool->data[handle] | (string_pool->data[handle + 1] << 8);
+}
+
+static void insert_handle(StringHandle *hash_table, unsigned int hash_capacity, unsigned int hash, StringHandle handle)
+{
+	unsigned int position = hash & (hash_capacity - 1);
+
+	while (hash_table[position] != 0)
+	{
+		position = (position + 1) & (hash_capacity - 1);
+	}
+	hash_table[position] = handle;
+}
+
+static int grow_hash_table(StringPool *string_pool)
+{
+	StringHandle *hash_table    = NULL;
+	unsigned int  hash_capacity = 0;
+	unsigned int  i             = 0;
+	StringHandle  handle        = 0;
+
+	hash_capacity = (string_pool->hash_capacity == 0) ? STRING_HASH_INITIAL_CAPACITY : string_pool->hash_capacity * 2;
+	hash_table    = (StringHandle *)calloc(hash_capacity, sizeof(StringHandle));
+	if (hash_table == NULL)
+	{
+		return STRING_POOL_MALLOC_ERROR;
+	}
+
+	// clang-format off
+	for (i=0; i<string_pool->hash_capacity; i++)
+	{ // clang-format on
+		handle = string_pool->hash_table[i];
+		if (handle != 0)
+		{
+			insert_handle(hash_table, hash_capacity, hash_string(string_pool->data + handle + STRING_PREFIX_LENGTH, get_stored_length(string_pool, handle)), handle);
+		}
+	}
+
+	free(string_pool->hash_table);
+	string_pool->hash_table    = hash_table;
+	string_pool->hash_capacity = hash_capacity;
+	return 0;
+}
+
+static int reserve_string_space(StringPool *string_pool, int length)
+{
+	unsigned char *data     = NULL;
+	unsigned int   capacity = 0;
+	unsigned int   need     = string_pool->length + STRING_PREFIX_LENGTH + length + 1;
+
+	if (need <= string_pool->capacity)
+		return 0;
+
+	capacity = (string_pool->capacity == 0) ? STRING_POOL_INITIAL_CAPACITY : string_pool->capacity;
+	while (need > capacity)
+	{
+		capacity *= 2;
+	}
+
+	data = (unsigned char *)realloc(string_pool->data, capacity);
+	if (data == NULL)
+	{
+		return STRING_POOL_MALLOC_ERROR;
+	}
+	string_pool->data     = data;
+	string_pool->capacity = capacity;
+
+	// offset 0 is the empty string, so no real string gets handle 0
+	if (string_pool->length == 0)
+	{
+		memset(string_pool->data, 0, STRING_PREFIX_LENGTH + 1);
+		string_pool->length = STRING_PREFIX_LENGTH + 1;
+	}
+	return 0;
+}
+
+int intern_string(StringPool *string_pool, const char *string, int length, StringHandle *handle)
+{
+	unsigned int hash       = 0;
+	unsigned int position   = 0;
+	StringHandle candidate  = 0;
+	int          error_code = 0;
+
+	if ((string_pool == NULL) || (handle == NULL) || (length < 0) || (length > MAX_STRING_LENGTH) || ((string == NULL) && (length > 0)))
+	{
+		return STRING_POOL_PARAM_ERROR;
+	}
+
+	*handle = 0;
+	if (length == 0)
+		return 0;
+
+	hash = hash_string((const unsigned char *)string, length);
+	if (string_pool->hash_capacity > 0)
+	{
+		position = hash & (string_pool->hash_capacity - 1);
+		while ((candidate = string_pool->hash_table[position]) != 0)
+		{
+			if ((get_stored_length(string_pool, candidate) == length) &&
+			    (memcmp(string_pool->data + candidate + STRING_PREFIX_LENGTH, string, length) == 0))
+			{
+				*handle = candidate;
+				return 0;
+			}
+			position = (position + 1) & (string_pool->hash_capacity - 1);
+		}
+	}
+
+	if ((string_pool->string_count + 1) * 2 > string_pool->hash_capacity)
+	{
+		if ((error_code = grow_hash_table(string_pool)) < 0)
+			return error_code;
+	}
+
+	if ((error_code = reserve_string_space(string_pool, length)) < 0)
+		return error_code;
+
+	candidate                           = string_pool->length;
+	string_pool->data[candidate + 0]    = length & 0xFF;
+	string_pool->data[candidate + 1]    = (length >> 8) & 0xFF;
+	memset(string_pool->data + candidate + STRING_DECODED_OFFSET, 0xFF, sizeof(StringHandle)); // STRING_NOT_DECODED
+	memcpy(string_pool->data + candidate + STRING_PREFIX_LENGTH, string, length);
+	string_pool->data[candidate + STRING_PREFIX_LENGTH + length] = 0;
+	string_pool->length += STRING_PREFIX_LENGTH + length + 1;
+
+	insert_handle(string_pool->hash_table, string_pool->hash_capacity, hash, candidate);
+	string_pool->string_count++;
+
+	*handle = candidate;
+	return 0;
+}
+
+int get_decoded_handle(const StringPool *string_pool, StringHandle handle, StringHandle *decoded_handle)
+{
+	StringHandle cached_handle = STRING_NOT_DECODED;
+
+	if ((string_pool == NULL) || (handle == 0) || (handle >= string_pool->length))
+		return 0;
+
+	memcpy(&cached_handle, string_pool->data + handle + STRING_DECODED_OFFSET, sizeof(StringHandle));
+	if (cached_handle == STRING_NOT_DECODED)
+		return 0;
+
+	*decoded_handle = cached_handle;
+	return 1;
+}
+
+void set_decoded_handle(StringPool *string_pool, StringHandle handle, StringHandle decoded_handle)
+{
+	if ((string_pool == NULL) || (handle == 0) || (handle >= string_pool->length))
+		return;
+
+	memcpy(string_pool->data + handle + STRING_DECODED_OFFSET, &decoded_handle, sizeof(StringHandle));
+}
+
+void free_string_pool(StringPool *string_pool)
+{
+	if (string_pool == NULL)
+		return;
+
+	free(string_pool->data);
+	free(string_pool->hash_table);
+	memset(string_pool, 0, sizeof(StringPool));
+}
+
+const char *get_string(StringHandle handle)
+{
+	const StringPool *string_pool = &get_table_context()->string_pool;
+
+	if ((handle == 0) || (handle >= string_pool->length))
+		return "";
+
+	return (const char *)string_pool->data + handle + STRING_PREFIX_LENGTH;
+}
+
+int get_string_length(StringHandle handle)
+{
+	const StringPool *string_pool = &get_table_context()->string_pool;
+
+	if ((handle == 0) || (handle >= string_pool->length))
+		return 0;
+
+	return get_stored_length(string_pool, handle);
+}
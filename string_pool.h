@@ -0,0 +1,66 @@
+/**
+ * @file string_pool.h
+ *
+ * @brief Length-prefixed string pool with hash interning, shared by SDT, EIT and integrate_data.
+ *        Equal strings are stored once and referred to by a 4 byte handle.
+ *
+ * @author :Yujin Yu
+ * @date   :2025.05.13
+ */
+#ifndef STRING_POOL_H
+#define STRING_POOL_H
+
+#define STRING_POOL_INITIAL_CAPACITY 16384 // bytes, doubled when full
+#define STRING_HASH_INITIAL_CAPACITY 1024  // slots, power of two, doubled at half load
+#define MAX_STRING_LENGTH            0xFFFF
+#define STRING_NOT_DECODED           0xFFFFFFFF
+#define STRING_PREFIX_LENGTH         6 // length, decoded handle
+
+typedef unsigned int StringHandle; // 0: empty string
+
+typedef struct
+{
+	unsigned char *data; // [length low][length high][decoded handle][bytes][0] per string
+	unsigned int   length;
+	unsigned int   capacity;
+
+	StringHandle *hash_table; // open addressing, 0: free slot
+	unsigned int  hash_capacity;
+	unsigned int  string_count;
+} StringPool;
+
+//--------------------------------------------------------------------------------------------
+// Function declaration
+//--------------------------------------------------------------------------------------------
+/**
+ * @brief Store a string once, an equal string that is already in the pool is reused
+ *
+ * @param string_pool Pointer to the StringPool structure
+ * @param string      Bytes of the string, they do not have to be terminated
+ * @param length      Number of bytes, at most MAX_STRING_LENGTH
+ * @param handle      Output, handle of the stored string
+ *
+ * @return 0: successful
+ *         <0: error code
+ */
+int  intern_string(StringPool *string_pool, const char *string, int length, StringHandle *handle);
+void free_string_pool(StringPool *string_pool);
+
+/**
+ * @brief Per string cache slot, holds the handle of the decoded (UTF-8) form of a raw DVB string
+ *
+ * @return 1: decoded_handle is valid
+ *         0: the string has not been decoded yet
+ */
+int  get_decoded_handle(const StringPool *string_pool, StringHandle handle, StringHandle *decoded_handle);
+void set_decoded_handle(StringPool *string_pool, StringHandle handle, StringHandle decoded_handle);
+
+/**
+ * @brief Terminated string of a handle in the pool of the current table context
+ *
+ * @return the string, "" for handle 0
+ */
+const char *get_string(StringHandle handle);
+int         get_string_length(StringHandle handle);
+
+#endif
@@ -0,0 +1,73 @@
+/**
+ * @file table_context.c
+ *
+ * @author :Yujin Yu
+ * @date   :2025.05.08
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ts_global.h"
+#include "slot_filter.h"
+#include "parse_tables_status.h"
+#include "get_pat_info.h"
+#include "get_pmt_info.h"
+#include "section_store.h"
+#include "string_pool.h"
+#include "get_sdt_info.h"
+#include "get_eit_info.h"
+#include "table_context.h"
+
+static TableContext  default_table_context = {0};
+static TableContext *current_table_context = &default_table_context;
+
+TableContext *get_table_context(void)
+{
+	return current_table_context;
+}
+
+void switch_table_context(TableContext *table_context)
+{
+	current_table_context = (table_context != NULL) ? table_context : &default_table_context;
+}
+
+TableContext *alloc_table_context(void)
+{
+	TableContext *table_context = (TableContext *)calloc(1, sizeof(TableContext));
+	if (table_context == NULL)
+	{
+		LOG("malloc error\n");
+	}
+
+	return table_context;
+}
+
+void free_table_context(TableContext *table_context)
+{
+	TableContext *previous_table_context = current_table_context;
+
+	if (table_context == NULL)
+		return;
+
+	// the lists are freed in their own context, the memory account reads their descriptor loops from its store
+	current_table_context = table_context;
+	free_pat_list(table_context->pat_list);
+	free_pmt_list(table_context->pmt_list);
+	free_sdt_list(table_context->sdt_list);
+	free_eit_list(table_context->eit_list);
+	free_table_status_list(table_context->pat_table_status_list);
+	free_table_status_list(table_context->pmt_table_status_list);
+	free_table_status_list(table_context->sdt_table_status_list);
+	free_section_store(&table_context->section_store);
+	free_string_pool(&table_context->string_pool);
+
+	current_table_context = (previous_table_context == table_context) ? &default_table_context : previous_table_context;
+
+	if (table_context == &default_table_context)
+	{
+		memset(table_context, 0, sizeof(TableContext));
+		return;
+	}
+
+	free(table_context);
+}
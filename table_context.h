@@ -0,0 +1,60 @@
+/**
+ * @file table_context.h
+ *
+ * @brief Table state of one demux context. A slot carries the context its callbacks work on,
+ *        so several transport streams can be demuxed side by side.
+ *        Include ts_global.h, section_store.h and string_pool.h first.
+ *
+ * @author :Yujin Yu
+ * @date   :2025.05.08
+ */
+#ifndef TABLE_CONTEXT_H
+#define TABLE_CONTEXT_H
+
+struct PatNode;
+struct PmtNode;
+struct SdtNode;
+struct EitNode;
+struct TableStatusNode;
+
+typedef struct TableContext
+{
+	struct PatNode         *pat_list;
+	struct TableStatusNode *pat_table_status_list;
+
+	struct PmtNode         *pmt_list;
+	struct TableStatusNode *pmt_table_status_list;
+
+	struct SdtNode         *sdt_list;
+	struct TableStatusNode *sdt_table_status_list;
+
+	struct EitNode *eit_list;
+
+	SectionStore section_store;    // descriptor loops of SDT and EIT, decoded on access
+	long long    descriptor_bytes; // loops of section_store still used by SDT and EIT nodes, what a compaction keeps
+	StringPool   string_pool;      // interned service and event text
+
+	ChannelStatus channel_status;
+} TableContext;
+
+//--------------------------------------------------------------------------------------------
+// Function declaration
+//--------------------------------------------------------------------------------------------
+/**
+ * @brief Get the context the table callbacks currently work on
+ *
+ * @return the context selected by switch_table_context, the default context if none was selected
+ */
+TableContext *get_table_context(void);
+
+/**
+ * @brief Select the context for the following table callbacks
+ *
+ * @param table_context Context to use, NULL selects the default context
+ */
+void switch_table_context(TableContext *table_context);
+
+TableContext *alloc_table_context(void);
+void          free_table_context(TableContext *table_context);
+
+#endif
@@ -0,0 +1,588 @@
+/**
+ * @file throughput.c
+ *
+ * @author :Yujin Yu
+ * @date   :2025.05.26
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include "ts_global.h"
+#include "ts_analyzer.h"
+#include "slot_filter.h"
+#include "get_pat_info.h"
+#include "get_pmt_info.h"
+#include "section_store.h"
+#include "string_pool.h"
+#include "get_sdt_info.h"
+#include "get_eit_info.h"
+#include "integrate_data.h"
+#include "ts_generator.h"
+#include "throughput.h"
+
+#define THROUGHPUT_KEY_LENGTH 32
+
+// callbacks the timing wrapper stands in for, by filter index
+static parse_callback original_callback_array[MAX_FILTER_COUNT];
+static long long      psi_callback_ns = 0;
+static long long      eit_callback_ns = 0;
+
+//--------------------------------------------------------------------------------------------
+static long long get_time_ns(void)
+{
+	struct timespec now = {0};
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (long long)now.tv_sec * 1000000000LL + now.tv_nsec;
+}
+
+static int timed_callback(Slot *slot, int filter_index, unsigned char *section_buffer, unsigned short pid);
+
+// Put the wrapper in front of every filter that does not have it yet, callbacks allocate filters of their own
+static void wrap_filter_callbacks(Slot *slot)
+{
+	Filter *filter = NULL;
+	int     i      = 0;
+
+	// clang-format off
+	for (i=0; i<MAX_FILTER_COUNT; i++)
+	{ // clang-format on
+		filter = &slot->filter_array[i];
+		if ((filter->is_used == 1) && (filter->section_callback != timed_callback))
+		{
+			original_callback_array[i] = filter->section_callback;
+			filter->section_callback   = timed_callback;
+		}
+	}
+}
+
+static int timed_callback(Slot *slot, int filter_index, unsigned char *section_buffer, unsigned short pid)
+{
+	parse_callback callback   = original_callback_array[filter_index];
+	long long      start_time = get_time_ns();
+	int            ret        = 0;
+
+	ret = callback(slot, filter_index, section_buffer, pid);
+	if (callback == eit_callback)
+		eit_callback_ns += get_time_ns() - start_time;
+	else
+		psi_callback_ns += get_time_ns() - start_time;
+
+	wrap_filter_callbacks(slot);
+	return ret;
+}
+
+/**
+ * @brief The file flow of process_ts_file without the interactive browser, run in a worker process
+ */
+static void run_worker(const char *file_name, ThroughputPhase *phase)
+{
+	FILE            *input_fp            = NULL;
+	Slot             slot                = {0};
+	ProgramInfoList *program_info_list   = NULL;
+	long             first_sync_position = 0;
+	long long        file_size           = 0;
+	long long        start_time          = 0;
+	long long        scan_ns             = 0;
+	int              packet_size         = 0;
+
+	memset(phase, 0, sizeof(ThroughputPhase));
+	if ((input_fp = fopen(file_name, "rb")) == NULL)
+	{
+		phase->error_code = THROUGHPUT_OPEN_ERROR;
+		return;
+	}
+
+	start_time    = get_time_ns();
+	packet_size   = detect_ts_packet_size(input_fp, &first_sync_position);
+	phase->detect = (get_time_ns() - start_time) / 1e9;
+	if (packet_size < 0)
+	{
+		phase->error_code = packet_size;
+		fclose(input_fp);
+		return;
+	}
+
+	fseek(input_fp, 0, SEEK_END);
+	file_size           = ftell(input_fp);
+	phase->packet_count = (file_size - first_sync_position) / packet_size;
+	fseek(input_fp, first_sync_position, SEEK_SET);
+
+	start_time = get_time_ns();
+	slot       = init_slot(input_fp, (unsigned char)packet_size, first_sync_position);
+	init_pat_resource(&slot);
+	init_sdt_resource(&slot);
+	init_eit_resource(&slot);
+	wrap_filter_callbacks(&slot);
+	section_filter(&slot);
+	free_pat_resource();
+	free_pmt_resource();
+	free_sdt_resource();
+	free_eit_resource();
+	scan_ns = get_time_ns() - start_time;
+
+	phase->psi   = psi_callback_ns / 1e9;
+	phase->eit   = eit_callback_ns / 1e9;
+	phase->demux = (scan_ns - psi_callback_ns - eit_callback_ns) / 1e9;
+
+	start_time        = get_time_ns();
+	program_info_list = get_program_info_list();
+	free_program_info_list(program_info_list);
+	phase->integrate = (get_time_ns() - start_time) / 1e9;
+
+	clear_slot(&slot);
+	fclose(input_fp);
+}
+
+/**
+ * @brief Generate the input of a point unless a file of that name is there already
+ *
+ * @return 0: successful
+ *         <0: error code
+ */
+static int prepare_input(const ThroughputConfig *config, const ThroughputPoint *point, char *file_name, int file_name_size)
+{
+	TsGeneratorConfig generator_config = {0};
+	struct stat       file_stat        = {0};
+	int               error_code       = 0;
+
+	snprintf(file_name, file_name_size, "%s/throughput_s%u_%lldmb_%lldp_%llde.ts", config->directory, config->seed, point->size_mb, point->program_count, point->event_count);
+	if ((stat(file_name, &file_stat) == 0) && (file_stat.st_size >= point->size_mb * 1048576))
+		return 0;
+
+	init_ts_generator_config(&generator_config);
+	generator_config.seed                 = config->seed;
+	generator_config.program_count        = (int)point->program_count;
+	generator_config.schedule_event_count = (int)point->event_count;
+	generator_config.target_size          = point->size_mb * 1048576;
+
+	LOG("generating %s\n", file_name);
+	fflush(stdout);
+	if ((error_code = generate_ts_file(file_name, &generator_config, NULL)) < 0)
+	{
+		LOG("generate %s fail, error code : %d\n", file_name, error_code);
+		remove(file_name);
+	}
+	return error_code;
+}
+
+/**
+ * @brief Demux the input in worker_count processes at once, each reports its phases through a pipe
+ *
+ * @return 0: successful
+ *         <0: error code
+ */
+static int run_point(const char *file_name, ThroughputPoint *point)
+{
+	ThroughputPhase phase                                         = {0};
+	struct rusage   usage                                         = {0};
+	struct stat     file_stat                                     = {0};
+	pid_t           worker_pid_array[THROUGHPUT_MAX_WORKER_COUNT] = {0};
+	int             pipe_fd[2]                                    = {-1, -1};
+	int             null_fd                                       = -1;
+	int             worker_count                                  = (int)point->worker_count;
+	int             status                                        = 0;
+	int             error_code                                    = 0;
+	long long       start_time                                    = 0;
+	long long       packet_count                                  = 0;
+	int             i                                             = 0;
+
+	if ((stat(file_name, &file_stat) != 0) || (pipe(pipe_fd) != 0))
+		return THROUGHPUT_OPEN_ERROR;
+	point->file_size = file_stat.st_size;
+
+	fflush(stdout);
+	start_time = get_time_ns();
+	// clang-format off
+	for (i=0; i<worker_count; i++)
+	{ // clang-format on
+		worker_pid_array[i] = fork();
+		if (worker_pid_array[i] == 0)
+		{
+			// the table callbacks log what they acquire, keep that out of the report
+			if ((null_fd = open("/dev/null", O_WRONLY)) >= 0)
+				dup2(null_fd, STDOUT_FILENO);
+			close(pipe_fd[0]);
+			run_worker(file_name, &phase);
+			fflush(stdout);
+			_exit((write(pipe_fd[1], &phase, sizeof(phase)) == sizeof(phase)) ? 0 : 1);
+		}
+		if (worker_pid_array[i] < 0)
+		{
+			error_code   = THROUGHPUT_FORK_ERROR;
+			worker_count = i;
+			break;
+		}
+	}
+	close(pipe_fd[1]);
+
+	// clang-format off
+	for (i=0; i<worker_count; i++)
+	{ // clang-format on
+		if (wait4(worker_pid_array[i], &status, 0, &usage) < 0)
+			continue;
+		point->peak_rss_kb = MAX(point->peak_rss_kb, usage.ru_maxrss);
+		point->minor_fault_count += usage.ru_minflt;
+		point->major_fault_count += usage.ru_majflt;
+		if (!WIFEXITED(status) || (WEXITSTATUS(status) != 0))
+			error_code = THROUGHPUT_FORK_ERROR;
+	}
+	point->wall_seconds = (get_time_ns() - start_time) / 1e9;
+
+	// clang-format off
+	for (i=0; i<worker_count; i++)
+	{ // clang-format on
+		if (read(pipe_fd[0], &phase, sizeof(phase)) != sizeof(phase))
+			break;
+		if (phase.error_code < 0)
+			error_code = phase.error_code;
+		point->phase.detect += phase.detect / worker_count;
+		point->phase.demux += phase.demux / worker_count;
+		point->phase.psi += phase.psi / worker_count;
+		point->phase.eit += phase.eit / worker_count;
+		point->phase.integrate += phase.integrate / worker_count;
+		packet_count += phase.packet_count;
+	}
+	close(pipe_fd[0]);
+
+	point->phase.packet_count = packet_count;
+	point->mb_per_second      = (double)point->file_size * worker_count / 1048576 / point->wall_seconds;
+	point->packets_per_second = packet_count / point->wall_seconds;
+	point->phase.error_code   = error_code;
+	return error_code;
+}
+
+//--------------------------------------------------------------------------------------------
+// results
+//--------------------------------------------------------------------------------------------
+static void write_point_json(FILE *output_fp, const ThroughputPoint *point)
+{
+	fprintf(output_fp, "{\"size_mb\": %lld, \"programs\": %lld, \"events\": %lld, \"workers\": %lld, \"file_size\": %lld, ", point->size_mb, point->program_count,
+	        point->event_count, point->worker_count, point->file_size);
+	fprintf(output_fp, "\"wall_s\": %.6f, \"mb_per_s\": %.3f, \"packets_per_s\": %.1f, \"peak_rss_kb\": %ld, \"minor_faults\": %lld, \"major_faults\": %lld, ",
+	        point->wall_seconds, point->mb_per_second, point->packets_per_second, point->peak_rss_kb, point->minor_fault_count, point->major_fault_count);
+	fprintf(output_fp, "\"detect_s\": %.6f, \"demux_s\": %.6f, \"psi_s\": %.6f, \"eit_s\": %.6f, \"integrate_s\": %.6f, \"error\": %d}", point->phase.detect,
+	        point->phase.demux, point->phase.psi, point->phase.eit, point->phase.integrate, point->phase.error_code);
+}
+
+static int write_throughput_json(const char *file_name, const ThroughputPoint *point_array, int point_count)
+{
+	FILE *output_fp = NULL;
+	int   i         = 0;
+
+	if ((output_fp = fopen(file_name, "w")) == NULL)
+		return THROUGHPUT_OPEN_ERROR;
+
+	// one point per line, read back by load_baseline
+	fprintf(output_fp, "{\n  \"points\": [\n");
+	// clang-format off
+	for (i=0; i<point_count; i++)
+	{ // clang-format on
+		fprintf(output_fp, "    ");
+		write_point_json(output_fp, &point_array[i]);
+		fprintf(output_fp, "%s\n", (i + 1 < point_count) ? "," : "");
+	}
+	fprintf(output_fp, "  ]\n}\n");
+
+	return (fclose(output_fp) == 0) ? 0 : THROUGHPUT_WRITE_ERROR;
+}
+
+static int write_throughput_csv(const char *file_name, const ThroughputPoint *point_array, int point_count)
+{
+	const ThroughputPoint *point     = NULL;
+	FILE                  *output_fp = NULL;
+	int                    i         = 0;
+
+	if ((output_fp = fopen(file_name, "w")) == NULL)
+		return THROUGHPUT_OPEN_ERROR;
+
+	fprintf(output_fp, "size_mb,programs,events,workers,file_size,wall_s,mb_per_s,packets_per_s,peak_rss_kb,minor_faults,major_faults,"
+	                   "detect_s,demux_s,psi_s,eit_s,integrate_s,error\n");
+	// clang-format off
+	for (i=0; i<point_count; i++)
+	{ // clang-format on
+		point = &point_array[i];
+		fprintf(output_fp, "%lld,%lld,%lld,%lld,%lld,%.6f,%.3f,%.1f,%ld,%lld,%lld,%.6f,%.6f,%.6f,%.6f,%.6f,%d\n", point->size_mb, point->program_count, point->event_count,
+		        point->worker_count, point->file_size, point->wall_seconds, point->mb_per_second, point->packets_per_second, point->peak_rss_kb, point->minor_fault_count,
+		        point->major_fault_count, point->phase.detect, point->phase.demux, point->phase.psi, point->phase.eit, point->phase.integrate, point->phase.error_code);
+	}
+
+	return (fclose(output_fp) == 0) ? 0 : THROUGHPUT_WRITE_ERROR;
+}
+
+static double get_json_number(const char *line, const char *key)
+{
+	char        pattern[THROUGHPUT_KEY_LENGTH] = {0};
+	const char *position                       = NULL;
+
+	snprintf(pattern, sizeof(pattern), "\"%s\": ", key);
+	position = strstr(line, pattern);
+	return (position == NULL) ? -1 : strtod(position + strlen(pattern), NULL);
+}
+
+/**
+ * @brief Compare each point with the baseline point of the same size, programs, events and workers
+ *
+ * @return >=0: number of regressions
+ *         <0 : error code
+ */
+static int compare_with_baseline(const ThroughputConfig *config, const ThroughputPoint *point_array, int point_count)
+{
+	const ThroughputPoint *point            = NULL;
+	FILE                  *baseline_fp      = NULL;
+	char                   line[1024]       = {0};
+	double                 baseline_speed   = 0;
+	double                 baseline_rss     = 0;
+	double                 speed_change     = 0;
+	double                 rss_change       = 0;
+	int                    regression_count = 0;
+	int                    i                = 0;
+
+	if ((baseline_fp = fopen(config->baseline_file_name, "r")) == NULL)
+	{
+		LOG("open baseline %s fail, error code : %d\n", config->baseline_file_name, THROUGHPUT_OPEN_ERROR);
+		return THROUGHPUT_OPEN_ERROR;
+	}
+
+	SINGLE_LINE
+	LOG("baseline %s, tolerance %d%%\n", config->baseline_file_name, config->tolerance_percent);
+	while (fgets(line, sizeof(line), baseline_fp) != NULL)
+	{
+		if (strstr(line, "\"size_mb\"") == NULL)
+			continue;
+
+		// clang-format off
+		for (i=0; i<point_count; i++)
+		{ // clang-format on
+			point = &point_array[i];
+			if ((get_json_number(line, "size_mb") == point->size_mb) && (get_json_number(line, "programs") == point->program_count) &&
+			    (get_json_number(line, "events") == point->event_count) && (get_json_number(line, "workers") == point->worker_count))
+				break;
+		}
+		if (i == point_count)
+			continue;
+
+		baseline_speed = get_json_number(line, "mb_per_s");
+		baseline_rss   = get_json_number(line, "peak_rss_kb");
+		speed_change   = (baseline_speed > 0) ? (point->mb_per_second - baseline_speed) * 100 / baseline_speed : 0;
+		rss_change     = (baseline_rss > 0) ? (point->peak_rss_kb - baseline_rss) * 100 / baseline_rss : 0;
+
+		if ((speed_change < -config->tolerance_percent) || (rss_change > config->tolerance_percent))
+		{
+			LOG("REGRESSION size %lld MB, programs %lld, events %lld, workers %lld: MB/s %+.1f%%, peak RSS %+.1f%%\n", point->size_mb, point->program_count,
+			    point->event_count, point->worker_count, speed_change, rss_change);
+			regression_count++;
+		}
+		else
+		{
+			LOG("ok         size %lld MB, programs %lld, events %lld, workers %lld: MB/s %+.1f%%, peak RSS %+.1f%%\n", point->size_mb, point->program_count,
+			    point->event_count, point->worker_count, speed_change, rss_change);
+		}
+	}
+
+	fclose(baseline_fp);
+	return regression_count;
+}
+
+//--------------------------------------------------------------------------------------------
+void init_throughput_config(ThroughputConfig *config)
+{
+	if (config == NULL)
+		return;
+
+	memset(config, 0, sizeof(ThroughputConfig));
+	config->size_mb.value_array[0]       = 8;
+	config->size_mb.value_array[1]       = 32;
+	config->size_mb.count                = 2;
+	config->program_count.value_array[0] = 16;
+	config->program_count.count          = 1;
+	config->event_count.value_array[0]   = 0;
+	config->event_count.value_array[1]   = 96;
+	config->event_count.count            = 2;
+	config->worker_count.value_array[0]  = 1;
+	config->worker_count.value_array[1]  = 2;
+	config->worker_count.count           = 2;
+	config->seed                         = 1;
+	config->tolerance_percent            = THROUGHPUT_DEFAULT_TOLERANCE;
+	snprintf(config->directory, sizeof(config->directory), "/tmp");
+}
+
+// "a:b:c" up to the next ','
+static int parse_sweep(ThroughputSweep *sweep, const char *value, const char **end)
+{
+	char *end_position = NULL;
+
+	sweep->count = 0;
+	while (sweep->count < THROUGHPUT_MAX_SWEEP_VALUES)
+	{
+		sweep->value_array[sweep->count] = strtoll(value, &end_position, 0);
+		if ((end_position == value) || (sweep->value_array[sweep->count] < 0))
+			return THROUGHPUT_PARAM_ERROR;
+		sweep->count++;
+
+		value = end_position;
+		if (*value != ':')
+			break;
+		value++;
+	}
+
+	*end = value;
+	return ((*value == ',') || (*value == '\0')) ? 0 : THROUGHPUT_PARAM_ERROR;
+}
+
+static int parse_path(char *path, const char *value, const char **end)
+{
+	const char *comma  = strchr(value, ',');
+	int         length = (comma == NULL) ? (int)strlen(value) : (int)(comma - value);
+
+	if (length >= THROUGHPUT_PATH_LENGTH)
+		return THROUGHPUT_PARAM_ERROR;
+
+	memcpy(path, value, length);
+	path[length] = '\0';
+	*end         = value + length;
+	return 0;
+}
+
+int parse_throughput_options(ThroughputConfig *config, const char *options)
+{
+	const char *read_position = options;
+	const char *value         = NULL;
+	const char *end           = NULL;
+	int         key_length    = 0;
+	int         error_code    = 0;
+
+	if ((config == NULL) || (options == NULL))
+		return THROUGHPUT_PARAM_ERROR;
+
+	while ((*read_position != '\0') && (error_code == 0))
+	{
+		if ((value = strchr(read_position, '=')) == NULL)
+			return THROUGHPUT_PARAM_ERROR;
+		key_length = (int)(value - read_position);
+		value++;
+
+		if ((key_length == 5) && (strncmp(read_position, "sizes", 5) == 0))
+			error_code = parse_sweep(&config->size_mb, value, &end);
+		else if ((key_length == 8) && (strncmp(read_position, "programs", 8) == 0))
+			error_code = parse_sweep(&config->program_count, value, &end);
+		else if ((key_length == 6) && (strncmp(read_position, "events", 6) == 0))
+			error_code = parse_sweep(&config->event_count, value, &end);
+		else if ((key_length == 7) && (strncmp(read_position, "workers", 7) == 0))
+			error_code = parse_sweep(&config->worker_count, value, &end);
+		else if ((key_length == 4) && (strncmp(read_position, "seed", 4) == 0))
+			config->seed = (unsigned int)strtoul(value, (char **)&end, 0);
+		else if ((key_length == 9) && (strncmp(read_position, "tolerance", 9) == 0))
+			config->tolerance_percent = (int)strtol(value, (char **)&end, 0);
+		else if ((key_length == 3) && (strncmp(read_position, "dir", 3) == 0))
+			error_code = parse_path(config->directory, value, &end);
+		else if ((key_length == 4) && (strncmp(read_position, "json", 4) == 0))
+			error_code = parse_path(config->json_file_name, value, &end);
+		else if ((key_length == 3) && (strncmp(read_position, "csv", 3) == 0))
+			error_code = parse_path(config->csv_file_name, value, &end);
+		else if ((key_length == 8) && (strncmp(read_position, "baseline", 8) == 0))
+			error_code = parse_path(config->baseline_file_name, value, &end);
+		else
+			error_code = THROUGHPUT_PARAM_ERROR;
+
+		if ((error_code == 0) && (*end != ',') && (*end != '\0'))
+			error_code = THROUGHPUT_PARAM_ERROR;
+		if (error_code < 0)
+		{
+			LOG("invalid throughput option %.*s\n", key_length, read_position);
+			return error_code;
+		}
+
+		read_position = (*end == ',') ? end + 1 : end;
+	}
+
+	return 0;
+}
+
+int run_throughput_sweep(const ThroughputConfig *config)
+{
+	ThroughputPoint *point_array                            = NULL;
+	ThroughputPoint *point                                  = NULL;
+	char             file_name[THROUGHPUT_PATH_LENGTH + 64] = {0};
+	int              point_count                            = 0;
+	int              error_code                             = 0;
+	int              s = 0, p = 0, e = 0, w = 0;
+
+	if ((config == NULL) || (config->size_mb.count * config->program_count.count * config->event_count.count * config->worker_count.count > THROUGHPUT_MAX_POINT_COUNT))
+	{
+		LOG("Invalid parameters, error code : %d\n", THROUGHPUT_PARAM_ERROR);
+		return THROUGHPUT_PARAM_ERROR;
+	}
+
+	point_array = (ThroughputPoint *)calloc(THROUGHPUT_MAX_POINT_COUNT, sizeof(ThroughputPoint));
+	if (point_array == NULL)
+		return THROUGHPUT_MALLOC_ERROR;
+
+	DOUBLE_LINE
+	LOG("%8s %8s %8s %7s %9s %9s %12s %10s %9s %8s %8s %8s %8s %8s\n", "size_MB", "programs", "events", "workers", "wall_s", "MB/s", "packets/s", "rss_kB", "faults",
+	    "detect", "demux", "psi", "eit", "integr");
+	SINGLE_LINE
+
+	// clang-format off
+	for (s=0; s<config->size_mb.count; s++)
+	{
+		for (p=0; p<config->program_count.count; p++)
+		{
+			for (e=0; e<config->event_count.count; e++)
+			{ // clang-format on
+				point                = &point_array[point_count];
+				point->size_mb       = config->size_mb.value_array[s];
+				point->program_count = config->program_count.value_array[p];
+				point->event_count   = config->event_count.value_array[e];
+				if (prepare_input(config, point, file_name, sizeof(file_name)) < 0)
+					continue;
+
+				// clang-format off
+				for (w=0; w<config->worker_count.count; w++)
+				{ // clang-format on
+					point                = &point_array[point_count++];
+					point->size_mb       = config->size_mb.value_array[s];
+					point->program_count = config->program_count.value_array[p];
+					point->event_count   = config->event_count.value_array[e];
+					point->worker_count  = MIN(MAX(config->worker_count.value_array[w], 1), THROUGHPUT_MAX_WORKER_COUNT);
+
+					if ((error_code = run_point(file_name, point)) < 0)
+					{
+						LOG("point failed, error code : %d\n", error_code);
+					}
+					LOG("%8lld %8lld %8lld %7lld %9.3f %9.1f %12.0f %10ld %9lld %8.3f %8.3f %8.3f %8.3f %8.3f\n", point->size_mb, point->program_count, point->event_count,
+					    point->worker_count, point->wall_seconds, point->mb_per_second, point->packets_per_second, point->peak_rss_kb,
+					    point->minor_fault_count + point->major_fault_count, point->phase.detect, point->phase.demux, point->phase.psi, point->phase.eit,
+					    point->phase.integrate);
+					fflush(stdout);
+				}
+			}
+		}
+	}
+	DOUBLE_LINE
+
+	error_code = 0;
+	if ((config->json_file_name[0] != '\0') && (write_throughput_json(config->json_file_name, point_array, point_count) < 0))
+	{
+		LOG("write %s fail, error code : %d\n", config->json_file_name, THROUGHPUT_WRITE_ERROR);
+	}
+	if ((config->csv_file_name[0] != '\0') && (write_throughput_csv(config->csv_file_name, point_array, point_count) < 0))
+	{
+		LOG("write %s fail, error code : %d\n", config->csv_file_name, THROUGHPUT_WRITE_ERROR);
+	}
+	if (config->baseline_file_name[0] != '\0')
+	{
+		error_code = compare_with_baseline(config, point_array, point_count);
+	}
+
+	free(point_array);
+	return error_code;
+}
@@ -0,0 +1,94 @@
+/**
+ * @file throughput.h
+ *
+ * @brief End-to-end throughput and scaling runs of the file flow: detect, scan with the PSI and EIT callbacks,
+ *        integrate. Every point of the sweep (input size x program count x EIT density x workers) demuxes a
+ *        generated stream in worker processes and records wall time, MB/s, packets/s, peak RSS, page faults
+ *        and the time of each phase. Results go to JSON/CSV and are compared against a stored baseline.
+ *
+ * @author :Yujin Yu
+ * @date   :2025.05.26
+ */
+#ifndef THROUGHPUT_H
+#define THROUGHPUT_H
+
+//--------------------------------------------------------------------------------------------
+// macro definition
+//--------------------------------------------------------------------------------------------
+#define THROUGHPUT_MAX_SWEEP_VALUES  16
+#define THROUGHPUT_MAX_POINT_COUNT   256
+#define THROUGHPUT_MAX_WORKER_COUNT  64
+#define THROUGHPUT_PATH_LENGTH       512
+#define THROUGHPUT_DEFAULT_TOLERANCE 10 // percent of MB/s lost or peak RSS gained that counts as a regression
+
+typedef struct
+{
+	long long value_array[THROUGHPUT_MAX_SWEEP_VALUES];
+	int       count;
+} ThroughputSweep;
+
+typedef struct
+{
+	ThroughputSweep size_mb;       // input size, the generator repeats its carousel until the file is this large
+	ThroughputSweep program_count;
+	ThroughputSweep event_count;   // EIT schedule events per service
+	ThroughputSweep worker_count;  // processes demuxing the same file at the same time
+	unsigned int    seed;
+	int             tolerance_percent;
+	char            directory[THROUGHPUT_PATH_LENGTH]; // generated inputs, reused while they exist
+	char            json_file_name[THROUGHPUT_PATH_LENGTH];
+	char            csv_file_name[THROUGHPUT_PATH_LENGTH];
+	char            baseline_file_name[THROUGHPUT_PATH_LENGTH];
+} ThroughputConfig;
+
+// Phase times of one worker, seconds
+typedef struct
+{
+	double    detect;
+	double    demux;     // read and dispatch, the scan without the table callbacks
+	double    psi;       // PAT, PMT and SDT callbacks
+	double    eit;       // EIT callbacks
+	double    integrate; // get_program_info_list and free_program_info_list
+	long long packet_count;
+	int       error_code;
+} ThroughputPhase;
+
+typedef struct
+{
+	long long       size_mb;
+	long long       program_count;
+	long long       event_count;
+	long long       worker_count;
+	long long       file_size;
+	double          wall_seconds;
+	double          mb_per_second;      // all workers together
+	double          packets_per_second; // all workers together
+	long            peak_rss_kb;        // largest worker
+	long long       minor_fault_count;  // all workers together
+	long long       major_fault_count;
+	ThroughputPhase phase;              // mean over the workers
+} ThroughputPoint;
+
+//--------------------------------------------------------------------------------------------
+// Function declaration
+//--------------------------------------------------------------------------------------------
+void init_throughput_config(ThroughputConfig *config);
+
+/**
+ * @brief Apply "key=value,..." options: sizes, programs, events and workers take lists separated by ':',
+ *        seed, tolerance, dir, json, csv and baseline take one value
+ *
+ * @return 0: successful
+ *         <0: error code
+ */
+int parse_throughput_options(ThroughputConfig *config, const char *options);
+
+/**
+ * @brief Run every point of the sweep, print a table, write the results and compare them with the baseline
+ *
+ * @return >=0: number of points that regressed against the baseline
+ *         <0 : error code
+ */
+int run_throughput_sweep(const ThroughputConfig *config);
+
+#endif
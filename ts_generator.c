@@ -0,0 +1,920 @@
+/**
+ * @file ts_generator.c
+ *
+ * @author :Yujin Yu
+ * @date   :2025.05.23
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+#include "ts_global.h"
+#include "ts_analyzer.h"
+#include "slot_filter.h"
+#include "section_store.h"
+#include "string_pool.h"
+#include "get_pat_info.h"
+#include "get_sdt_info.h"
+#include "get_eit_info.h"
+#include "ts_generator.h"
+
+#define GENERATOR_SECTION_HEADER_LENGTH 8
+#define GENERATOR_PAYLOAD_LENGTH        184
+#define GENERATOR_NULL_PID              0x1FFF
+#define GENERATOR_ARRIVAL_TICKS         2030 // 27 MHz ticks per packet at about 20 Mbit/s
+#define GENERATOR_SEGMENT_MINUTES       180
+#define GENERATOR_SEGMENT_SECTIONS      8
+#define GENERATOR_TRANSPORT_STREAM_ID   0x0001
+#define GENERATOR_ORIGINAL_NETWORK_ID   0x233A
+#define GENERATOR_MAX_EVENTS_PER_SECTION 16  // keeps an EIT section below 4096 bytes
+#define GENERATOR_MAX_SDT_SERVICES       20  // keeps an SDT section below 1024 bytes
+#define GENERATOR_TEXT_LENGTH            128
+
+// Where one schedule section of a service sits, identical for every service
+typedef struct
+{
+	int           first_event;
+	int           event_count;
+	unsigned char table_id;
+	unsigned char section_number;
+	unsigned char segment_last_section_number;
+	unsigned char last_section_number;
+} ScheduleSection;
+
+typedef struct
+{
+	FILE                    *output_fp;
+	const TsGeneratorConfig *config;
+	TsGeneratorStats        *stats;
+	unsigned int             random_state;
+	unsigned int             arrival_time;
+	unsigned char            continuity_counter[MAX_PID_COUNT];
+
+	ScheduleSection *schedule_array;
+	int              schedule_count;    // sections per service
+	int              schedule_position; // next section of the carousel, service major
+	int              events_per_section;
+
+	// SI packets of the current cycle, continuity counters are set when they are written
+	unsigned char *si_packet_array;
+	int            si_packet_count;
+	int            si_packet_capacity;
+
+	unsigned char section[GENERATOR_MAX_EIT_LENGTH];
+	unsigned char packet[MAX_PACKET_SIZE];
+	int           error_code;
+} TsGenerator;
+
+typedef struct
+{
+	const char *key;
+	size_t      offset;
+	int         min_value;
+	int         max_value;
+} GeneratorOption;
+
+static const GeneratorOption generator_option_array[] = {
+	{"packet", offsetof(TsGeneratorConfig, packet_size), TS_PACKET_SIZE, TS_FEC_PACKET_SIZE},
+	{"programs", offsetof(TsGeneratorConfig, program_count), 1, GENERATOR_MAX_PROGRAM_COUNT},
+	{"es", offsetof(TsGeneratorConfig, es_count), 0, GENERATOR_MAX_ES_COUNT},
+	{"sdt_per_section", offsetof(TsGeneratorConfig, sdt_services_per_section), 1, GENERATOR_MAX_SDT_SERVICES},
+	{"pf", offsetof(TsGeneratorConfig, is_present_following), 0, 1},
+	{"events", offsetof(TsGeneratorConfig, schedule_event_count), 0, 1000000},
+	{"events_per_section", offsetof(TsGeneratorConfig, events_per_section), 1, GENERATOR_MAX_EVENTS_PER_SECTION},
+	{"event_minutes", offsetof(TsGeneratorConfig, event_minutes), 1, 1440},
+	{"section_offset", offsetof(TsGeneratorConfig, section_offset), 0, GENERATOR_PAYLOAD_LENGTH - 4}, // section_length stays in the first packet
+	{"pat_period", offsetof(TsGeneratorConfig, pat_period), 1, 1000},
+	{"pmt_period", offsetof(TsGeneratorConfig, pmt_period), 1, 1000},
+	{"sdt_period", offsetof(TsGeneratorConfig, sdt_period), 1, 1000},
+	{"pf_period", offsetof(TsGeneratorConfig, present_following_period), 1, 1000},
+	{"schedule_period", offsetof(TsGeneratorConfig, schedule_period), 1, 100000},
+	{"es_packets", offsetof(TsGeneratorConfig, es_packet_count), 0, 100000},
+	{"null", offsetof(TsGeneratorConfig, null_percent), 0, 90},
+	{"cc_errors", offsetof(TsGeneratorConfig, cc_error_per_mille), 0, 1000},
+	{"sync_loss", offsetof(TsGeneratorConfig, sync_loss_per_mille), 0, 1000},
+	{"cycles", offsetof(TsGeneratorConfig, cycle_count), 0, 10000000},
+};
+
+static const char *word_array[] = {"Morning", "News", "Live", "World", "Sport", "Film", "Drama", "Kids", "Music", "Nature",
+                                   "History", "Science", "Weather", "Travel", "Cooking", "Comedy", "Late", "Night", "Classic", "Report"};
+static const char *provider_array[] = {"Alpha Media", "Beta Broadcast", "Gamma TV", "Delta Networks"};
+static const char *language_array[] = {"eng", "deu", "fra", "spa"};
+
+//--------------------------------------------------------------------------------------------
+// Content is a hash of the seed and the item, so it does not depend on how often an item is sent
+static unsigned int hash_item(unsigned int seed, unsigned int a, unsigned int b)
+{
+	unsigned int hash = seed * 0x9E3779B1u ^ a * 0x85EBCA6Bu ^ b * 0xC2B2AE35u;
+
+	hash ^= hash >> 16;
+	hash *= 0x7FEB352Du;
+	hash ^= hash >> 15;
+	hash *= 0x846CA68Bu;
+	hash ^= hash >> 16;
+	return hash;
+}
+
+// Impairments follow the packet sequence, xorshift seeded once per file
+static unsigned int next_random(TsGenerator *generator)
+{
+	generator->random_state ^= generator->random_state << 13;
+	generator->random_state ^= generator->random_state >> 17;
+	generator->random_state ^= generator->random_state << 5;
+	return generator->random_state;
+}
+
+static int put_text(unsigned char *buffer, const char *text)
+{
+	int length = (int)strlen(text);
+
+	buffer[0] = (unsigned char)length;
+	memcpy(buffer + 1, text, length);
+	return length + 1;
+}
+
+// "Word Word Word", word_count words chosen by hash
+static void make_title(char *text, unsigned int hash, int word_count)
+{
+	int length = 0;
+	int i      = 0;
+
+	text[0] = '\0';
+	// clang-format off
+	for (i=0; i<word_count; i++)
+	{ // clang-format on
+		length += snprintf(text + length, GENERATOR_TEXT_LENGTH - length, "%s%s", (i == 0) ? "" : " ", word_array[hash % ARRAY_SIZE(word_array)]);
+		if (length >= GENERATOR_TEXT_LENGTH - 1)
+			break;
+		hash = hash / ARRAY_SIZE(word_array) + hash * 7;
+	}
+}
+
+int complete_section(unsigned char *section, unsigned char table_id, unsigned short table_id_extension, unsigned char version_number,
+                     unsigned char section_number, unsigned char last_section_number, int body_length)
+{
+	int          section_length = GENERATOR_SECTION_HEADER_LENGTH - 3 + body_length + 4;
+	unsigned int crc            = 0;
+
+	section[0] = table_id;
+	section[1] = 0xB0 | ((section_length >> 8) & 0x0F);
+	section[2] = section_length & 0xFF;
+	section[3] = table_id_extension >> 8;
+	section[4] = table_id_extension & 0xFF;
+	section[5] = 0xC1 | ((version_number & 0x1F) << 1); // current_next_indicator
+	section[6] = section_number;
+	section[7] = last_section_number;
+
+	crc = calculate_crc32(section, GENERATOR_SECTION_HEADER_LENGTH + body_length);
+	section[GENERATOR_SECTION_HEADER_LENGTH + body_length + 0] = (crc >> 24) & 0xFF;
+	section[GENERATOR_SECTION_HEADER_LENGTH + body_length + 1] = (crc >> 16) & 0xFF;
+	section[GENERATOR_SECTION_HEADER_LENGTH + body_length + 2] = (crc >> 8) & 0xFF;
+	section[GENERATOR_SECTION_HEADER_LENGTH + body_length + 3] = crc & 0xFF;
+
+	return section_length + 3;
+}
+
+//--------------------------------------------------------------------------------------------
+// output
+//--------------------------------------------------------------------------------------------
+static void write_bytes(TsGenerator *generator, const unsigned char *data, int length)
+{
+	if (fwrite(data, 1, length, generator->output_fp) != (size_t)length)
+	{
+		generator->error_code = TS_GENERATOR_WRITE_ERROR;
+	}
+	generator->stats->byte_count += length;
+}
+
+// 192: arrival timestamp in front, 204: parity bytes behind
+static void write_ts_packet(TsGenerator *generator, const unsigned char *packet)
+{
+	unsigned char extra[TS_FEC_PACKET_SIZE - TS_PACKET_SIZE] = {0};
+
+	if (generator->config->packet_size == TS_DVHS_PACKET_SIZE)
+	{
+		extra[0] = (generator->arrival_time >> 24) & 0x3F;
+		extra[1] = (generator->arrival_time >> 16) & 0xFF;
+		extra[2] = (generator->arrival_time >> 8) & 0xFF;
+		extra[3] = generator->arrival_time & 0xFF;
+		write_bytes(generator, extra, TS_DVHS_PACKET_SIZE - TS_PACKET_SIZE);
+	}
+	generator->arrival_time += GENERATOR_ARRIVAL_TICKS;
+
+	write_bytes(generator, packet, TS_PACKET_SIZE);
+
+	if (generator->config->packet_size == TS_FEC_PACKET_SIZE)
+	{
+		write_bytes(generator, extra, TS_FEC_PACKET_SIZE - TS_PACKET_SIZE);
+	}
+	generator->stats->packet_count++;
+}
+
+static void write_null_packet(TsGenerator *generator)
+{
+	unsigned char *packet = generator->packet;
+
+	memset(packet, 0xFF, TS_PACKET_SIZE);
+	packet[0] = SYNC_BYTE;
+	packet[1] = GENERATOR_NULL_PID >> 8;
+	packet[2] = GENERATOR_NULL_PID & 0xFF;
+	packet[3] = 0x10;
+	write_ts_packet(generator, packet);
+	generator->stats->null_packet_count++;
+}
+
+// Junk that is never a sync byte, the demux has to find the packet grid again
+static void write_sync_loss(TsGenerator *generator)
+{
+	unsigned char junk[MAX_PACKET_SIZE] = {0};
+	int           length                = 1 + next_random(generator) % (generator->config->packet_size - 1);
+	int           i                     = 0;
+
+	// clang-format off
+	for (i=0; i<length; i++)
+	{ // clang-format on
+		junk[i] = (unsigned char)next_random(generator);
+		if (junk[i] == SYNC_BYTE)
+			junk[i] = ~SYNC_BYTE;
+	}
+	write_bytes(generator, junk, length);
+	generator->stats->sync_loss_count++;
+}
+
+/**
+ * @brief Write a packet of a payload PID: null padding in front, continuity counter, errors behind
+ */
+static void emit_packet(TsGenerator *generator, unsigned char *packet)
+{
+	const TsGeneratorConfig *config = generator->config;
+	unsigned short           pid    = ((packet[1] & 0x1F) << 8) | packet[2];
+	unsigned char            counter = generator->continuity_counter[pid];
+
+	while ((config->null_percent > 0) && ((int)(next_random(generator) % 100) < config->null_percent))
+	{
+		write_null_packet(generator);
+	}
+
+	if ((config->cc_error_per_mille > 0) && ((int)(next_random(generator) % 1000) < config->cc_error_per_mille))
+	{
+		counter = (counter + 1) & 0x0F;
+		generator->stats->cc_error_count++;
+	}
+	packet[3]                            = (packet[3] & 0xF0) | counter;
+	generator->continuity_counter[pid] = (counter + 1) & 0x0F;
+
+	write_ts_packet(generator, packet);
+
+	if ((config->sync_loss_per_mille > 0) && ((int)(next_random(generator) % 1000) < config->sync_loss_per_mille))
+	{
+		write_sync_loss(generator);
+	}
+}
+
+// Split a section into packets of the SI queue, each section starts a packet after section_offset stuffing bytes
+static void queue_section(TsGenerator *generator, unsigned short pid, const unsigned char *section, int length)
+{
+	unsigned char *new_array    = NULL;
+	unsigned char *packet       = NULL;
+	int            offset       = generator->config->section_offset;
+	int            packet_count = (offset + length + 1 + GENERATOR_PAYLOAD_LENGTH - 1) / GENERATOR_PAYLOAD_LENGTH;
+	int            new_capacity = 0;
+	int            position     = 0;
+	int            copy_length  = 0;
+	int            i            = 0;
+
+	if (generator->si_packet_count + packet_count > generator->si_packet_capacity)
+	{
+		new_capacity = MAX(generator->si_packet_capacity * 2, generator->si_packet_count + packet_count + 64);
+		new_array    = (unsigned char *)realloc(generator->si_packet_array, (size_t)new_capacity * TS_PACKET_SIZE);
+		if (new_array == NULL)
+		{
+			generator->error_code = TS_GENERATOR_MALLOC_ERROR;
+			return;
+		}
+		generator->si_packet_array    = new_array;
+		generator->si_packet_capacity = new_capacity;
+	}
+
+	// clang-format off
+	for (i=0; i<packet_count; i++)
+	{ // clang-format on
+		packet = generator->si_packet_array + (size_t)(generator->si_packet_count++) * TS_PACKET_SIZE;
+		memset(packet, 0xFF, TS_PACKET_SIZE);
+		packet[0] = SYNC_BYTE;
+		packet[1] = ((i == 0) ? 0x40 : 0x00) | (pid >> 8);
+		packet[2] = pid & 0xFF;
+		packet[3] = 0x10;
+
+		if (i == 0)
+		{
+			packet[4]   = (unsigned char)offset; // pointer_field, the stuffing in front is no section
+			copy_length = MIN(length, GENERATOR_PAYLOAD_LENGTH - 1 - offset);
+			memcpy(packet + 5 + offset, section, copy_length);
+		}
+		else
+		{
+			copy_length = MIN(length - position, GENERATOR_PAYLOAD_LENGTH);
+			memcpy(packet + 4, section + position, copy_length);
+		}
+		position += copy_length;
+	}
+}
+
+//--------------------------------------------------------------------------------------------
+// tables
+//--------------------------------------------------------------------------------------------
+static unsigned short get_pmt_pid(int program_index)
+{
+	return GENERATOR_FIRST_PMT_PID + program_index;
+}
+
+static unsigned short get_es_pid(const TsGeneratorConfig *config, int program_index, int es_index)
+{
+	return GENERATOR_FIRST_PMT_PID + config->program_count + program_index * config->es_count + es_index;
+}
+
+static void queue_pat(TsGenerator *generator)
+{
+	const TsGeneratorConfig *config        = generator->config;
+	unsigned char           *body          = generator->section + GENERATOR_SECTION_HEADER_LENGTH;
+	int                      section_count = (config->program_count + GENERATOR_PAT_PROGRAM_COUNT - 1) / GENERATOR_PAT_PROGRAM_COUNT;
+	int                      first_program = 0;
+	int                      program_count = 0;
+	int                      section_index = 0;
+	int                      i             = 0;
+
+	// clang-format off
+	for (section_index=0; section_index<section_count; section_index++)
+	{ // clang-format on
+		first_program = section_index * GENERATOR_PAT_PROGRAM_COUNT;
+		program_count = MIN(GENERATOR_PAT_PROGRAM_COUNT, config->program_count - first_program);
+		// clang-format off
+		for (i=0; i<program_count; i++)
+		{ // clang-format on
+			body[i * 4 + 0] = (first_program + i + 1) >> 8;
+			body[i * 4 + 1] = (first_program + i + 1) & 0xFF;
+			body[i * 4 + 2] = 0xE0 | (get_pmt_pid(first_program + i) >> 8);
+			body[i * 4 + 3] = get_pmt_pid(first_program + i) & 0xFF;
+		}
+		queue_section(generator, PAT_PID, generator->section,
+		              complete_section(generator->section, 0x00, GENERATOR_TRANSPORT_STREAM_ID, 1, section_index, section_count - 1, program_count * 4));
+	}
+	generator->stats->pat_section_count = section_count;
+}
+
+// Video first, then audio with a language descriptor
+static void queue_pmt(TsGenerator *generator, int program_index)
+{
+	static const unsigned char video_type_array[] = {0x02, 0x1B, 0x24};
+	static const unsigned char audio_type_array[] = {0x03, 0x04, 0x0F, 0x11};
+
+	const TsGeneratorConfig *config      = generator->config;
+	unsigned char           *body        = generator->section + GENERATOR_SECTION_HEADER_LENGTH;
+	unsigned int             hash        = hash_item(config->seed, 1, program_index);
+	unsigned short           pid         = 0;
+	int                      body_length = 4;
+	int                      i           = 0;
+
+	body[0] = 0xE0 | (GENERATOR_NULL_PID >> 8);
+	body[1] = GENERATOR_NULL_PID & 0xFF;
+	body[2] = 0xF0;
+	body[3] = 0x00;
+
+	// clang-format off
+	for (i=0; i<config->es_count; i++)
+	{ // clang-format on
+		pid = get_es_pid(config, program_index, i);
+		if (i == 0)
+		{
+			body[0] = 0xE0 | (pid >> 8); // PCR on the video PID
+			body[1] = pid & 0xFF;
+		}
+
+		body[body_length + 0] = (i == 0) ? video_type_array[hash % ARRAY_SIZE(video_type_array)] : audio_type_array[(hash >> (i * 2)) % ARRAY_SIZE(audio_type_array)];
+		body[body_length + 1] = 0xE0 | (pid >> 8);
+		body[body_length + 2] = pid & 0xFF;
+		body[body_length + 3] = 0xF0;
+		body[body_length + 4] = (i == 0) ? 0 : 6;
+		body_length += 5;
+
+		if (i > 0)
+		{
+			body[body_length + 0] = 0x0A; // ISO 639 language
+			body[body_length + 1] = 4;
+			memcpy(body + body_length + 2, language_array[(i - 1) % ARRAY_SIZE(language_array)], 3);
+			body[body_length + 5] = 0;
+			body_length += 6;
+		}
+	}
+
+	queue_section(generator, get_pmt_pid(program_index), generator->section,
+	              complete_section(generator->section, 0x02, program_index + 1, 1, 0, 0, body_length));
+}
+
+static int build_service(const TsGeneratorConfig *config, unsigned char *buffer, int program_index)
+{
+	static const unsigned char service_type_array[] = {0x01, 0x02, 0x19, 0x16};
+
+	unsigned int hash              = hash_item(config->seed, 2, program_index);
+	char         name[GENERATOR_TEXT_LENGTH] = {0};
+	int          descriptor_length = 3;
+
+	make_title(name, hash, 1);
+	snprintf(name + strlen(name), sizeof(name) - strlen(name), " %d", program_index + 1);
+
+	buffer[5] = SERVICE_DESCRIPTOR_TAG;
+	buffer[7] = service_type_array[hash % ARRAY_SIZE(service_type_array)];
+	descriptor_length += put_text(buffer + 5 + descriptor_length, provider_array[(hash >> 8) % ARRAY_SIZE(provider_array)]);
+	descriptor_length += put_text(buffer + 5 + descriptor_length, name);
+	buffer[6] = (unsigned char)(descriptor_length - 2);
+
+	buffer[0] = (program_index + 1) >> 8;
+	buffer[1] = (program_index + 1) & 0xFF;
+	buffer[2] = 0xFC | ((config->schedule_event_count > 0) ? 0x02 : 0x00) | (config->is_present_following ? 0x01 : 0x00);
+	buffer[3] = 0x80 | ((descriptor_length >> 8) & 0x0F); // running
+	buffer[4] = descriptor_length & 0xFF;
+	return 5 + descriptor_length;
+}
+
+static void queue_sdt(TsGenerator *generator)
+{
+	const TsGeneratorConfig *config        = generator->config;
+	unsigned char           *body          = generator->section + GENERATOR_SECTION_HEADER_LENGTH;
+	int                      section_count = (config->program_count + config->sdt_services_per_section - 1) / config->sdt_services_per_section;
+	int                      first_program = 0;
+	int                      body_length   = 0;
+	int                      section_index = 0;
+	int                      i             = 0;
+
+	// clang-format off
+	for (section_index=0; section_index<section_count; section_index++)
+	{ // clang-format on
+		body[0]       = GENERATOR_ORIGINAL_NETWORK_ID >> 8;
+		body[1]       = GENERATOR_ORIGINAL_NETWORK_ID & 0xFF;
+		body[2]       = 0xFF;
+		body_length   = 3;
+		first_program = section_index * config->sdt_services_per_section;
+		// clang-format off
+		for (i=first_program; i<MIN(first_program + config->sdt_services_per_section, config->program_count); i++)
+		{ // clang-format on
+			body_length += build_service(config, body + body_length, i);
+		}
+		queue_section(generator, SDT_PID, generator->section,
+		              complete_section(generator->section, 0x42, GENERATOR_TRANSPORT_STREAM_ID, 1, section_index, section_count - 1, body_length));
+	}
+	generator->stats->sdt_section_count = section_count;
+}
+
+/**
+ * @brief One event: short event descriptor, every other event an extended event descriptor
+ *
+ * @return event length
+ */
+static int build_event(const TsGeneratorConfig *config, unsigned char *buffer, int program_index, int event_index)
+{
+	unsigned int   hash                          = hash_item(config->seed, 3 + program_index, event_index);
+	unsigned char *descriptor                    = buffer + 12;
+	char           title[GENERATOR_TEXT_LENGTH]  = {0};
+	char           text[GENERATOR_TEXT_LENGTH]   = {0};
+	long long      start_minute                  = (long long)event_index * config->event_minutes;
+	int            mjd                           = GENERATOR_START_MJD + (int)(start_minute / 1440);
+	int            minute_of_day                 = (int)(start_minute % 1440);
+	int            hour                          = minute_of_day / 60;
+	int            minute                        = minute_of_day % 60;
+	int            length                        = 0;
+	int            extended_length               = 0;
+
+	make_title(title, hash, 2 + hash % 3);
+	make_title(text, hash >> 3, 4 + (hash >> 5) % 4);
+
+	descriptor[0] = SHORT_EVENT_DESCRIPTOR_TAG;
+	memcpy(descriptor + 2, "eng", 3);
+	length = 5;
+	length += put_text(descriptor + length, title);
+	length += put_text(descriptor + length, text);
+	descriptor[1] = (unsigned char)(length - 2);
+
+	if ((hash & 0x100) != 0)
+	{
+		descriptor += length;
+		make_title(text, hash >> 7, 6 + (hash >> 9) % 6);
+		descriptor[0] = EXTENDED_EVENT_DESCRIPTOR_TAG;
+		descriptor[2] = 0x00; // descriptor_number 0 of 0
+		memcpy(descriptor + 3, "eng", 3);
+		descriptor[6]   = 0; // no items
+		extended_length = 7 + put_text(descriptor + 7, text);
+		descriptor[1]   = (unsigned char)(extended_length - 2);
+		length += extended_length;
+	}
+
+	buffer[0]  = (event_index + 1) >> 8;
+	buffer[1]  = (event_index + 1) & 0xFF;
+	buffer[2]  = mjd >> 8;
+	buffer[3]  = mjd & 0xFF;
+	buffer[4]  = (unsigned char)(((hour / 10) << 4) | (hour % 10));
+	buffer[5]  = (unsigned char)(((minute / 10) << 4) | (minute % 10));
+	buffer[6]  = 0x00;
+	buffer[7]  = (unsigned char)((((config->event_minutes / 60) / 10) << 4) | ((config->event_minutes / 60) % 10));
+	buffer[8]  = (unsigned char)((((config->event_minutes % 60) / 10) << 4) | ((config->event_minutes % 60) % 10));
+	buffer[9]  = 0x00;
+	buffer[10] = ((event_index == 0) ? 0x80 : 0x20) | ((length >> 8) & 0x0F); // running or not yet running
+	buffer[11] = length & 0xFF;
+	return 12 + length;
+}
+
+static void queue_eit(TsGenerator *generator, int program_index, unsigned char table_id, unsigned char section_number, unsigned char segment_last_section_number,
+                      unsigned char last_section_number, int first_event, int event_count)
+{
+	const TsGeneratorConfig *config      = generator->config;
+	unsigned char           *body        = generator->section + GENERATOR_SECTION_HEADER_LENGTH;
+	int                      body_length = 6;
+	int                      i           = 0;
+
+	body[0] = GENERATOR_TRANSPORT_STREAM_ID >> 8;
+	body[1] = GENERATOR_TRANSPORT_STREAM_ID & 0xFF;
+	body[2] = GENERATOR_ORIGINAL_NETWORK_ID >> 8;
+	body[3] = GENERATOR_ORIGINAL_NETWORK_ID & 0xFF;
+	body[4] = segment_last_section_number;
+	body[5] = (table_id == 0x4E) ? 0x4E : generator->schedule_array[generator->schedule_count - 1].table_id; // last_table_id
+
+	// clang-format off
+	for (i=0; i<event_count; i++)
+	{ // clang-format on
+		body_length += build_event(config, body + body_length, program_index, first_event + i);
+	}
+
+	queue_section(generator, EIT_PID, generator->section,
+	              complete_section(generator->section, table_id, program_index + 1, 1, section_number, last_section_number, body_length));
+	generator->stats->eit_section_count++;
+}
+
+/**
+ * @brief Lay the schedule of one service out in 3 hour segments of up to 8 sections, 16 tables of 32 segments
+ *
+ * @return 0: successful
+ *         <0: error code
+ */
+static int build_schedule_layout(TsGenerator *generator)
+{
+	const TsGeneratorConfig *config            = generator->config;
+	int                      events_per_segment = (GENERATOR_SEGMENT_MINUTES + config->event_minutes - 1) / config->event_minutes;
+	int                      max_event_count   = 0;
+	int                      event_count       = 0;
+	int                      first_event       = 0;
+	int                      segment           = 0;
+	int                      segment_end       = 0;
+	int                      section_count     = 0;
+	int                      event_index       = 0;
+	int                      i                 = 0;
+
+	// every event of a segment has to fit in its 8 sections
+	generator->events_per_section = MAX(config->events_per_section, (events_per_segment + GENERATOR_SEGMENT_SECTIONS - 1) / GENERATOR_SEGMENT_SECTIONS);
+	generator->events_per_section = MIN(generator->events_per_section, GENERATOR_MAX_EVENTS_PER_SECTION);
+
+	max_event_count = (int)(((long long)GENERATOR_SCHEDULE_TABLE_COUNT * 32 * GENERATOR_SEGMENT_MINUTES) / config->event_minutes);
+	event_count     = MIN(config->schedule_event_count, max_event_count);
+	if (event_count == 0)
+		return 0;
+
+	generator->schedule_array = (ScheduleSection *)calloc(event_count, sizeof(ScheduleSection));
+	if (generator->schedule_array == NULL)
+		return TS_GENERATOR_MALLOC_ERROR;
+
+	while (event_index < event_count)
+	{
+		segment     = (int)(((long long)event_index * config->event_minutes) / GENERATOR_SEGMENT_MINUTES);
+		first_event = event_index;
+		while ((event_index < event_count) && ((int)(((long long)event_index * config->event_minutes) / GENERATOR_SEGMENT_MINUTES) == segment))
+		{
+			event_index++;
+		}
+
+		section_count = (event_index - first_event + generator->events_per_section - 1) / generator->events_per_section;
+		section_count = MIN(section_count, GENERATOR_SEGMENT_SECTIONS);
+		segment_end   = (segment % 32) * GENERATOR_SEGMENT_SECTIONS + section_count - 1;
+		// clang-format off
+		for (i=0; i<section_count; i++)
+		{ // clang-format on
+			generator->schedule_array[generator->schedule_count].first_event                 = first_event + i * generator->events_per_section;
+			generator->schedule_array[generator->schedule_count].event_count                 = MIN(generator->events_per_section, event_index - first_event - i * generator->events_per_section);
+			generator->schedule_array[generator->schedule_count].table_id                    = 0x50 + segment / 32;
+			generator->schedule_array[generator->schedule_count].section_number              = (segment % 32) * GENERATOR_SEGMENT_SECTIONS + i;
+			generator->schedule_array[generator->schedule_count].segment_last_section_number = segment_end;
+			generator->schedule_count++;
+		}
+	}
+
+	// last_section_number of each table is the last section written for it
+	// clang-format off
+	for (i=generator->schedule_count-1; i>=0; i--)
+	{ // clang-format on
+		if ((i == generator->schedule_count - 1) || (generator->schedule_array[i].table_id != generator->schedule_array[i + 1].table_id))
+			generator->schedule_array[i].last_section_number = generator->schedule_array[i].section_number;
+		else
+			generator->schedule_array[i].last_section_number = generator->schedule_array[i + 1].last_section_number;
+	}
+
+	generator->stats->event_count = (long long)event_count * config->program_count;
+	return 0;
+}
+
+static void queue_present_following(TsGenerator *generator)
+{
+	int i = 0;
+
+	// clang-format off
+	for (i=0; i<generator->config->program_count; i++)
+	{ // clang-format on
+		queue_eit(generator, i, 0x4E, 0, 1, 1, 0, 1);
+		queue_eit(generator, i, 0x4E, 1, 1, 1, 1, 1);
+	}
+}
+
+// The schedule carousel is spread over schedule_period cycles, service after service
+static void queue_schedule(TsGenerator *generator)
+{
+	const ScheduleSection *schedule_section = NULL;
+	long long              total_count      = (long long)generator->schedule_count * generator->config->program_count;
+	long long              chunk_count      = 0;
+	long long              i                = 0;
+	int                    program_index    = 0;
+
+	if (total_count == 0)
+		return;
+
+	chunk_count = (total_count + generator->config->schedule_period - 1) / generator->config->schedule_period;
+	// clang-format off
+	for (i=0; i<chunk_count; i++)
+	{ // clang-format on
+		program_index    = generator->schedule_position / generator->schedule_count;
+		schedule_section = &generator->schedule_array[generator->schedule_position % generator->schedule_count];
+		queue_eit(generator, program_index, schedule_section->table_id, schedule_section->section_number, schedule_section->segment_last_section_number,
+		          schedule_section->last_section_number, schedule_section->first_event, schedule_section->event_count);
+		generator->schedule_position = (int)((generator->schedule_position + 1) % total_count);
+	}
+}
+
+static void build_es_packet(TsGenerator *generator, int es_number, int frame_position)
+{
+	const TsGeneratorConfig *config        = generator->config;
+	unsigned char           *packet        = generator->packet;
+	int                      program_index = es_number / config->es_count;
+	int                      es_index      = es_number % config->es_count;
+	unsigned short           pid           = get_es_pid(config, program_index, es_index);
+
+	memset(packet + 4, (unsigned char)hash_item(config->seed, es_number, frame_position), GENERATOR_PAYLOAD_LENGTH);
+	packet[0] = SYNC_BYTE;
+	packet[1] = ((frame_position == 0) ? 0x40 : 0x00) | (pid >> 8);
+	packet[2] = pid & 0xFF;
+	packet[3] = 0x10;
+
+	if (frame_position == 0)
+	{
+		// PES header without PTS
+		packet[4]  = 0x00;
+		packet[5]  = 0x00;
+		packet[6]  = 0x01;
+		packet[7]  = (es_index == 0) ? 0xE0 : (unsigned char)(0xC0 + es_index - 1);
+		packet[8]  = 0x00;
+		packet[9]  = 0x00;
+		packet[10] = 0x80;
+		packet[11] = 0x00;
+		packet[12] = 0x00;
+	}
+}
+
+/**
+ * @brief One carousel cycle: the tables due in this cycle spread evenly between the ES packets
+ */
+static void write_cycle(TsGenerator *generator, int cycle)
+{
+	const TsGeneratorConfig *config   = generator->config;
+	long long                es_total = (long long)config->program_count * config->es_count * config->es_packet_count;
+	long long                total    = 0;
+	long long                si_done  = 0;
+	long long                es_done  = 0;
+	long long                i        = 0;
+	int                      es_stream_count = config->program_count * config->es_count;
+
+	generator->si_packet_count = 0;
+	if (cycle % config->pat_period == 0)
+		queue_pat(generator);
+	if (cycle % config->pmt_period == 0)
+	{
+		// clang-format off
+		for (i=0; i<config->program_count; i++)
+		{ // clang-format on
+			queue_pmt(generator, (int)i);
+		}
+	}
+	if (cycle % config->sdt_period == 0)
+		queue_sdt(generator);
+	if ((config->is_present_following == 1) && (cycle % config->present_following_period == 0))
+		queue_present_following(generator);
+	queue_schedule(generator);
+
+	total = es_total + generator->si_packet_count;
+	// clang-format off
+	for (i=0; (i<total) && (generator->error_code==0); i++)
+	{ // clang-format on
+		if (si_done < (i + 1) * generator->si_packet_count / total)
+		{
+			emit_packet(generator, generator->si_packet_array + (size_t)si_done * TS_PACKET_SIZE);
+			si_done++;
+		}
+		else
+		{
+			build_es_packet(generator, (int)(es_done % es_stream_count), (int)((es_done / es_stream_count) % 8));
+			emit_packet(generator, generator->packet);
+			es_done++;
+		}
+	}
+	generator->stats->si_packet_count += si_done;
+}
+
+//--------------------------------------------------------------------------------------------
+void init_ts_generator_config(TsGeneratorConfig *config)
+{
+	if (config == NULL)
+		return;
+
+	memset(config, 0, sizeof(TsGeneratorConfig));
+	config->seed                     = 1;
+	config->packet_size              = TS_PACKET_SIZE;
+	config->program_count            = 8;
+	config->es_count                 = 2;
+	config->sdt_services_per_section = 5;
+	config->is_present_following     = 1;
+	config->schedule_event_count     = 48;
+	config->events_per_section       = 4;
+	config->event_minutes            = 30;
+	config->pat_period               = 1;
+	config->pmt_period               = 1;
+	config->sdt_period               = 2;
+	config->present_following_period = 1;
+	config->schedule_period          = 8;
+	config->es_packet_count          = 20;
+	config->null_percent             = 5;
+}
+
+int parse_ts_generator_options(TsGeneratorConfig *config, const char *options)
+{
+	const char *read_position = options;
+	const char *value         = NULL;
+	char       *end_position  = NULL;
+	long long   number        = 0;
+	int         key_length    = 0;
+	int         i             = 0;
+
+	if ((config == NULL) || (options == NULL))
+		return TS_GENERATOR_PARAM_ERROR;
+
+	while (*read_position != '\0')
+	{
+		value = strchr(read_position, '=');
+		if (value == NULL)
+			return TS_GENERATOR_PARAM_ERROR;
+		key_length = (int)(value - read_position);
+
+		number = strtoll(value + 1, &end_position, 0);
+		if ((end_position == value + 1) || ((*end_position != ',') && (*end_position != '\0')))
+		{
+			LOG("invalid generator option %.*s\n", key_length, read_position);
+			return TS_GENERATOR_PARAM_ERROR;
+		}
+
+		if ((key_length == 4) && (strncmp(read_position, "seed", 4) == 0))
+		{
+			config->seed = (unsigned int)number;
+		}
+		else if ((key_length == 4) && (strncmp(read_position, "size", 4) == 0))
+		{
+			config->target_size = number * 1048576;
+		}
+		else
+		{
+			// clang-format off
+			for (i=0; i<(int)ARRAY_SIZE(generator_option_array); i++)
+			{ // clang-format on
+				if ((key_length == (int)strlen(generator_option_array[i].key)) && (strncmp(read_position, generator_option_array[i].key, key_length) == 0))
+					break;
+			}
+
+			if ((i == (int)ARRAY_SIZE(generator_option_array)) || (number < generator_option_array[i].min_value) || (number > generator_option_array[i].max_value))
+			{
+				LOG("invalid generator option %.*s\n", key_length, read_position);
+				return TS_GENERATOR_PARAM_ERROR;
+			}
+			*(int *)((char *)config + generator_option_array[i].offset) = (int)number;
+		}
+
+		read_position = (*end_position == ',') ? end_position + 1 : end_position;
+	}
+
+	return 0;
+}
+
+static int check_ts_generator_config(const TsGeneratorConfig *config)
+{
+	if ((config->packet_size != TS_PACKET_SIZE) && (config->packet_size != TS_DVHS_PACKET_SIZE) && (config->packet_size != TS_FEC_PACKET_SIZE))
+		return TS_GENERATOR_PARAM_ERROR;
+
+	if ((config->program_count < 1) || (config->program_count > GENERATOR_MAX_PROGRAM_COUNT) || (config->es_count < 0) || (config->es_count > GENERATOR_MAX_ES_COUNT))
+		return TS_GENERATOR_PARAM_ERROR;
+
+	// PMT and ES PIDs have to stay below the null PID
+	if (GENERATOR_FIRST_PMT_PID + config->program_count * (1 + config->es_count) >= GENERATOR_NULL_PID)
+		return TS_GENERATOR_PARAM_ERROR;
+
+	if ((config->sdt_services_per_section < 1) || (config->sdt_services_per_section > GENERATOR_MAX_SDT_SERVICES) || (config->events_per_section < 1) ||
+	    (config->event_minutes < 1) || (config->schedule_event_count < 0))
+		return TS_GENERATOR_PARAM_ERROR;
+
+	if ((config->pat_period < 1) || (config->pmt_period < 1) || (config->sdt_period < 1) || (config->present_following_period < 1) || (config->schedule_period < 1))
+		return TS_GENERATOR_PARAM_ERROR;
+
+	if ((config->null_percent < 0) || (config->null_percent > 90) || (config->cc_error_per_mille < 0) || (config->sync_loss_per_mille < 0))
+		return TS_GENERATOR_PARAM_ERROR;
+
+	return 0;
+}
+
+int generate_ts_file(const char *file_name, const TsGeneratorConfig *config, TsGeneratorStats *stats)
+{
+	TsGenerator     *generator     = NULL;
+	TsGeneratorStats local_stats   = {0};
+	int              cycle_count   = 0;
+	int              cycle         = 0;
+	int              error_code    = 0;
+
+	if ((file_name == NULL) || (config == NULL) || (check_ts_generator_config(config) < 0))
+	{
+		LOG("Invalid parameters, error code : %d\n", TS_GENERATOR_PARAM_ERROR);
+		return TS_GENERATOR_PARAM_ERROR;
+	}
+
+	if (stats == NULL)
+		stats = &local_stats;
+	memset(stats, 0, sizeof(TsGeneratorStats));
+
+	generator = (TsGenerator *)calloc(1, sizeof(TsGenerator));
+	if (generator == NULL)
+		return TS_GENERATOR_MALLOC_ERROR;
+	generator->config       = config;
+	generator->stats        = stats;
+	generator->random_state = (config->seed != 0) ? config->seed : 1;
+
+	if ((error_code = build_schedule_layout(generator)) < 0)
+	{
+		free(generator);
+		return error_code;
+	}
+
+	generator->output_fp = fopen(file_name, "wb");
+	if (generator->output_fp == NULL)
+	{
+		LOG("open %s fail, error code : %d\n", file_name, TS_GENERATOR_OPEN_ERROR);
+		free(generator->schedule_array);
+		free(generator);
+		return TS_GENERATOR_OPEN_ERROR;
+	}
+	setvbuf(generator->output_fp, NULL, _IOFBF, GENERATOR_BUFFER_SIZE);
+
+	if (config->is_present_following == 1)
+		stats->event_count = MAX(stats->event_count, 2LL * config->program_count);
+
+	// without an explicit length the whole schedule goes out twice
+	if (config->cycle_count > 0)
+		cycle_count = config->cycle_count;
+	else if (config->target_size == 0)
+		cycle_count = 2 * config->schedule_period;
+
+	while (((cycle < cycle_count) || (stats->byte_count < config->target_size)) && (generator->error_code == 0))
+	{
+		write_cycle(generator, cycle);
+		cycle++;
+	}
+	stats->cycle_count = cycle;
+
+	if ((fclose(generator->output_fp) != 0) && (generator->error_code == 0))
+		generator->error_code = TS_GENERATOR_WRITE_ERROR;
+
+	error_code = generator->error_code;
+	free(generator->si_packet_array);
+	free(generator->schedule_array);
+	free(generator);
+	return error_code;
+}
+
+void printf_ts_generator_stats(const TsGeneratorStats *stats)
+{
+	if (stats == NULL)
+		return;
+
+	LOG("bytes: %lld, packets: %llu (SI %llu, null %llu), cycles: %d\n", stats->byte_count, stats->packet_count, stats->si_packet_count, stats->null_packet_count,
+	    stats->cycle_count);
+	LOG("sections per cycle: PAT %d, SDT %d, EIT sections written: %lld, distinct events: %lld\n", stats->pat_section_count, stats->sdt_section_count,
+	    stats->eit_section_count, stats->event_count);
+	LOG("continuity errors: %llu, sync losses: %llu\n", stats->cc_error_count, stats->sync_loss_count);
+}
@@ -0,0 +1,107 @@
+/**
+ * @file ts_generator.h
+ *
+ * @brief Synthetic transport streams with known content: PAT, PMT, multi-section SDT, EIT present/following and
+ *        schedule, ES packets, null padding, continuity errors and sync loss. The same seed and configuration
+ *        always give the same bytes, so throughput, memory and scaling runs need no private captures.
+ *
+ * @author :Yujin Yu
+ * @date   :2025.05.23
+ */
+#ifndef TS_GENERATOR_H
+#define TS_GENERATOR_H
+
+//--------------------------------------------------------------------------------------------
+// macro definition
+//--------------------------------------------------------------------------------------------
+#define GENERATOR_MAX_ES_COUNT         8      // elementary streams per program
+#define GENERATOR_MAX_PROGRAM_COUNT    2000
+#define GENERATOR_PAT_PROGRAM_COUNT    253    // programs per PAT section, 1021 byte limit
+#define GENERATOR_MAX_PSI_LENGTH       1024   // PAT, PMT and SDT sections
+#define GENERATOR_MAX_EIT_LENGTH       4096
+#define GENERATOR_SCHEDULE_TABLE_COUNT 16     // table_id 0x50..0x5F, 32 segments of 3 hours each
+#define GENERATOR_START_MJD            60676  // 2025-01-01, start of the first event of every service
+#define GENERATOR_FIRST_PMT_PID        0x0020 // PMT PIDs, the ES PIDs follow them
+#define GENERATOR_BUFFER_SIZE          1048576
+
+typedef struct
+{
+	unsigned int seed;
+	int          packet_size;              // 188, 192 (4 byte timestamp in front) or 204 (16 byte parity behind)
+	int          program_count;
+	int          es_count;                 // per program, a video stream followed by audio streams
+	int          sdt_services_per_section; // SDT is split into sections of this many services
+	int          is_present_following;     // EIT 0x4E, two sections per service
+	int          schedule_event_count;     // EIT schedule events per service, 0: none
+	int          events_per_section;       // EIT schedule events per section
+	int          event_minutes;            // event duration, events follow each other without gaps
+	int          section_offset;           // stuffing bytes in front of every section, above 171 the filtered header bytes straddle two packets
+
+	// repetition: a table is sent every N carousel cycles
+	int pat_period;
+	int pmt_period;
+	int sdt_period;
+	int present_following_period;
+	int schedule_period;  // cycles the whole schedule is spread over
+	int es_packet_count;  // per ES and cycle, sets the share of SI in the stream
+
+	int null_percent;       // share of null packets
+	int cc_error_per_mille; // packets sent with a skipped continuity counter
+	int sync_loss_per_mille; // packets followed by a burst of junk bytes
+
+	int       cycle_count; // carousel cycles to write, 0: two full schedules or until target_size
+	long long target_size; // bytes, keep cycling until the file is this large
+} TsGeneratorConfig;
+
+typedef struct
+{
+	long long          byte_count;
+	unsigned long long packet_count;
+	unsigned long long null_packet_count;
+	unsigned long long si_packet_count;
+	unsigned long long cc_error_count;
+	unsigned long long sync_loss_count;
+	int                cycle_count;
+	int                pat_section_count;
+	int                sdt_section_count;
+	long long          eit_section_count;
+	long long          event_count; // distinct events, present/following and schedule
+} TsGeneratorStats;
+
+//--------------------------------------------------------------------------------------------
+// Function declaration
+//--------------------------------------------------------------------------------------------
+void init_ts_generator_config(TsGeneratorConfig *config);
+
+/**
+ * @brief Apply "key=value,key=value" options, keys are seed, packet, programs, es, sdt_per_section, pf, events,
+ *        events_per_section, event_minutes, pat_period, pmt_period, sdt_period, pf_period, schedule_period,
+ *        es_packets, null, cc_errors, sync_loss, cycles, size (MB)
+ *
+ * @return 0: successful
+ *         <0: unknown key or value out of range
+ */
+int parse_ts_generator_options(TsGeneratorConfig *config, const char *options);
+
+/**
+ * @brief Fill in the long section header and the CRC around a body already written at section + 8
+ *
+ * @return total section length
+ */
+int complete_section(unsigned char *section, unsigned char table_id, unsigned short table_id_extension, unsigned char version_number,
+                     unsigned char section_number, unsigned char last_section_number, int body_length);
+
+/**
+ * @brief Write a transport stream
+ *
+ * @param file_name Output file, replaced if it exists
+ * @param config    Stream layout and impairments
+ * @param stats     Output, what was written, may be NULL
+ *
+ * @return 0: successful
+ *         <0: error code
+ */
+int generate_ts_file(const char *file_name, const TsGeneratorConfig *config, TsGeneratorStats *stats);
+void printf_ts_generator_stats(const TsGeneratorStats *stats);
+
+#endif
@@ -1,22 +1,25 @@
-#include <stdio.h>
-#include "ts_global.h"
-
-static ChannelStatus channel_status = {0};
-
-void set_pmt_channel_status(void)
-{
-	channel_status.is_pmt_finish = 1;
-}
-
-void set_sdt_channel_status(void)
-{
-	channel_status.is_sdt_finish = 1;
-}
-
-int is_channel_status_finish(void)
-{
-	if (1 == (channel_status.is_pmt_finish && channel_status.is_sdt_finish))
-		return 1;
-
-	return 0;
+#include <stdio.h>
+#include "ts_global.h"
+#include "section_store.h"
+#include "string_pool.h"
+#include "table_context.h"
+
+void set_pmt_channel_status(void)
+{
+	get_table_context()->channel_status.is_pmt_finish = 1;
+}
+
+void set_sdt_channel_status(void)
+{
+	get_table_context()->channel_status.is_sdt_finish = 1;
+}
+
+int is_channel_status_finish(void)
+{
+	ChannelStatus *channel_status = &get_table_context()->channel_status;
+
+	if (1 == (channel_status->is_pmt_finish && channel_status->is_sdt_finish))
+		return 1;
+
+	return 0;
 }
\ No newline at end of file
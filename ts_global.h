@@ -1,86 +1,154 @@
-/**
- * @file ts_global.h
- *
- * @author :Yujin Yu
- * @date   :2025.03.24
- */
-
-#ifndef TS_GLOBAL_H
-#define TS_GLOBAL_H
-
-//--------------------------------------------------------------------------------------------
-// macro definition
-//--------------------------------------------------------------------------------------------
-#define SYNC_BYTE 0x47 // Sync byte
-
-#define ARRAY_SIZE(array) (sizeof(array) / sizeof(array[0]))
-
-// printf switch
-#define ENABLE_PRINTF 1 // 1 open printf，0 close
-#if ENABLE_PRINTF
-#define LOG(...) printf(__VA_ARGS__)
-#else
-#define LOG(...)
-#endif
-
-#define SINGLE_LINE LOG("---------------------------------------------------------------------------------------------------------------\n");
-#define DOUBLE_LINE LOG("===============================================================================================================\n");
-
-// #define POSITION printf("%s -> function:%s, line: %d\n", __FILE__, __func__, __LINE__);
-#define POSITION printf("%s:%d\n", __FILE__, __LINE__);
-
-#ifndef MIN
-#define MIN(a, b) ((a) < (b) ? (a) : (b))
-#endif
-
-typedef struct
-{
-	int is_pmt_finish;
-	int is_sdt_finish;
-} ChannelStatus;
-
-// , error code : %d
-enum
-{
-	OPEN_INPUT_FILE_ERROR = -1000,
-	OPEN_OUTPUT_FILE_ERROR,
-
-	FILTER_PARAM_ERROR = -900,
-	FILTER_FSEEK_ERROR,
-
-	DETECT_TS_PACKET_SIZE_PARAM_ERROR = -800,
-	DETECT_TS_PACKET_SIZE_FSEEK_ERROR,
-	DETECT_TS_PACKET_SIZE_FSEEK_BACK_ERROR,
-	DETECT_TS_PACKET_SIZE_FILE_END,
-
-	PAT_INIT_PARAM_ERROR = -700,
-	PAT_INIT_ALLOC_FILTER_ERROR,
-	PAT_CALLBACK_SECTION_LENGTH_ERROR,
-	PAT_CALLBACK_NO_STATUS_ERROR,
-	PAT_CALLBACK_PAT_LIST_NULL_ERROR,
-
-	PMT_INIT_PARAM_ERROR = -600,
-	PMT_INIT_ALLOC_FILTER_ERROR,
-	PMT_CALLBACK_SECTION_LENGTH_ERROR,
-	PMT_CALLBACK_NO_STATUS_ERROR,
-
-	SDT_INIT_PARAM_ERROR = -500,
-	SDT_MALLOC_SDT_INFO_ERROR,
-	SDT_INIT_ALLOC_FILTER_ERROR,
-	SDT_CALLBACK_SECTION_LENGTH_ERROR,
-	SDT_CALLBACK_NO_STATUS_ERROR,
-	SDT_CALLBACK_UNKNOWN_TABLE_ID_ERROR,
-
-	EIT_INIT_PARAM_ERROR = -400,
-	EIT_INIT_ALLOC_FILTER_ERROR,
-	EIT_CALLBACK_SECTION_LENGTH_ERROR,
-	EIT_CALLBACK_NO_STATUS_ERROR,
-
-};
-
-//--------------------------------------------------------------------------------------------
-void set_pmt_channel_status(void);
-void set_sdt_channel_status(void);
-int  is_channel_status_finish(void);
-
-#endif
+/**
+ * @file ts_global.h
+ *
+ * @author :Yujin Yu
+ * @date   :2025.03.24
+ */
+
+#ifndef TS_GLOBAL_H
+#define TS_GLOBAL_H
+
+//--------------------------------------------------------------------------------------------
+// macro definition
+//--------------------------------------------------------------------------------------------
+#define SYNC_BYTE 0x47 // Sync byte
+
+#define ARRAY_SIZE(array) (sizeof(array) / sizeof(array[0]))
+
+// printf switch
+#define ENABLE_PRINTF 1 // 1 open printf，0 close
+#if ENABLE_PRINTF
+#define LOG(...) printf(__VA_ARGS__)
+#else
+#define LOG(...)
+#endif
+
+#define SINGLE_LINE LOG("---------------------------------------------------------------------------------------------------------------\n");
+#define DOUBLE_LINE LOG("===============================================================================================================\n");
+
+// #define POSITION printf("%s -> function:%s, line: %d\n", __FILE__, __func__, __LINE__);
+#define POSITION printf("%s:%d\n", __FILE__, __LINE__);
+
+#ifndef MIN
+#define MIN(a, b) ((a) < (b) ? (a) : (b))
+#define MAX(a, b) ((a) > (b) ? (a) : (b))
+#endif
+
+typedef struct
+{
+	int is_pmt_finish;
+	int is_sdt_finish;
+} ChannelStatus;
+
+// , error code : %d
+enum
+{
+	OPEN_INPUT_FILE_ERROR = -1000,
+	OPEN_OUTPUT_FILE_ERROR,
+
+	FILTER_PARAM_ERROR = -900,
+	FILTER_FSEEK_ERROR,
+	FILTER_MALLOC_ERROR,
+
+	DETECT_TS_PACKET_SIZE_PARAM_ERROR = -800,
+	DETECT_TS_PACKET_SIZE_FSEEK_ERROR,
+	DETECT_TS_PACKET_SIZE_FSEEK_BACK_ERROR,
+	DETECT_TS_PACKET_SIZE_FILE_END,
+
+	PAT_INIT_PARAM_ERROR = -700,
+	PAT_INIT_ALLOC_FILTER_ERROR,
+	PAT_CALLBACK_SECTION_LENGTH_ERROR,
+	PAT_CALLBACK_NO_STATUS_ERROR,
+	PAT_CALLBACK_PAT_LIST_NULL_ERROR,
+
+	PMT_INIT_PARAM_ERROR = -600,
+	PMT_INIT_ALLOC_FILTER_ERROR,
+	PMT_CALLBACK_SECTION_LENGTH_ERROR,
+	PMT_CALLBACK_NO_STATUS_ERROR,
+
+	SDT_INIT_PARAM_ERROR = -500,
+	SDT_MALLOC_SDT_INFO_ERROR,
+	SDT_INIT_ALLOC_FILTER_ERROR,
+	SDT_CALLBACK_SECTION_LENGTH_ERROR,
+	SDT_CALLBACK_NO_STATUS_ERROR,
+	SDT_CALLBACK_UNKNOWN_TABLE_ID_ERROR,
+
+	EIT_INIT_PARAM_ERROR = -400,
+	EIT_INIT_ALLOC_FILTER_ERROR,
+	EIT_CALLBACK_SECTION_LENGTH_ERROR,
+	EIT_CALLBACK_NO_STATUS_ERROR,
+	EIT_SELECTION_PARAM_ERROR,
+
+	UDP_INPUT_PARAM_ERROR = -300,
+	UDP_INPUT_MALLOC_ERROR,
+	UDP_INPUT_SOCKET_ERROR,
+	UDP_INPUT_BIND_ERROR,
+	UDP_INPUT_MULTICAST_ERROR,
+	UDP_INPUT_RECEIVE_ERROR,
+
+	PCAP_INPUT_PARAM_ERROR = -200,
+	PCAP_INPUT_OPEN_ERROR,
+	PCAP_INPUT_MMAP_ERROR,
+	PCAP_INPUT_FORMAT_ERROR,
+	PCAP_INPUT_MALLOC_ERROR,
+
+	SECTION_STORE_PARAM_ERROR = -100,
+	SECTION_STORE_MALLOC_ERROR,
+
+	STRING_POOL_PARAM_ERROR = -50,
+	STRING_POOL_MALLOC_ERROR,
+
+	PROGRAM_CATALOG_PARAM_ERROR = -60,
+	PROGRAM_CATALOG_MALLOC_ERROR,
+
+	EPG_EXPORT_PARAM_ERROR = -70,
+	EPG_EXPORT_MALLOC_ERROR,
+	EPG_EXPORT_OPEN_ERROR,
+	EPG_EXPORT_WRITE_ERROR,
+
+	SNAPSHOT_PARAM_ERROR = -80,
+	SNAPSHOT_OPEN_ERROR,
+	SNAPSHOT_MMAP_ERROR,
+	SNAPSHOT_FORMAT_ERROR,
+	SNAPSHOT_MALLOC_ERROR,
+	SNAPSHOT_WRITE_ERROR,
+
+	SECTION_LOG_PARAM_ERROR = -90,
+	SECTION_LOG_OPEN_ERROR,
+	SECTION_LOG_FORMAT_ERROR,
+	SECTION_LOG_MALLOC_ERROR,
+	SECTION_LOG_WRITE_ERROR,
+
+	BENCHMARK_PARAM_ERROR = -110,
+	BENCHMARK_OPEN_ERROR,
+	BENCHMARK_WRITE_ERROR,
+
+	TS_GENERATOR_PARAM_ERROR = -120,
+	TS_GENERATOR_OPEN_ERROR,
+	TS_GENERATOR_MALLOC_ERROR,
+	TS_GENERATOR_WRITE_ERROR,
+
+	THROUGHPUT_PARAM_ERROR = -130,
+	THROUGHPUT_OPEN_ERROR,
+	THROUGHPUT_MALLOC_ERROR,
+	THROUGHPUT_FORK_ERROR,
+	THROUGHPUT_WRITE_ERROR,
+
+	INSTRUMENT_PARAM_ERROR = -140,
+	INSTRUMENT_OPEN_ERROR,
+	INSTRUMENT_DISABLED_ERROR,
+
+	LOGGER_PARAM_ERROR = -150,
+	LOGGER_OPEN_ERROR,
+	LOGGER_THREAD_ERROR,
+
+	MEMORY_PARAM_ERROR = -160,
+
+};
+
+//--------------------------------------------------------------------------------------------
+void set_pmt_channel_status(void);
+void set_sdt_channel_status(void);
+int  is_channel_status_finish(void);
+
+#endif
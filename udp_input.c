@@ -0,0 +1,394 @@
+/**
+ * @file udp_input.c
+ *
+ * @brief Receives MPEG-TS over UDP or RTP. One recvmmsg() call fills a preallocated ring of datagram
+ *        buffers, then the TS packets of every datagram are run through the filter bank of the slot.
+ *
+ * @author :Yujin Yu
+ * @date   :2025.05.06
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include "ts_global.h"
+#include "slot_filter.h"
+#include "udp_input.h"
+#include "instrument.h"
+#include "logger.h"
+
+#ifndef SO_RXQ_OVFL
+#define SO_RXQ_OVFL 40
+#endif
+
+static int is_multicast_address(struct in_addr address)
+{
+	return IN_MULTICAST(ntohl(address.s_addr)) ? 1 : 0;
+}
+
+static void set_receive_buffer_size(int socket_fd, int size)
+{
+	int       actual_size = 0;
+	socklen_t option_size = sizeof(actual_size);
+
+	// SO_RCVBUFFORCE ignores net.core.rmem_max but needs CAP_NET_ADMIN, fall back to the capped request
+	if (setsockopt(socket_fd, SOL_SOCKET, SO_RCVBUFFORCE, &size, sizeof(size)) != 0)
+	{
+		setsockopt(socket_fd, SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+	}
+
+	if (getsockopt(socket_fd, SOL_SOCKET, SO_RCVBUF, &actual_size, &option_size) == 0)
+	{
+		// the kernel reports the doubled value it uses for bookkeeping
+		if (actual_size / 2 < size)
+		{
+			LOG_WARN(LOGGER_CATEGORY_IO, "SO_RCVBUF is %d bytes, requested %d, raise net.core.rmem_max to avoid drops\n", actual_size / 2, size);
+		}
+	}
+}
+
+static int alloc_receive_ring(UdpInput *udp_input)
+{
+	struct msghdr *message_header = NULL;
+	int            i              = 0;
+
+	udp_input->message_array   = (struct mmsghdr *)calloc(UDP_RING_SIZE, sizeof(struct mmsghdr));
+	udp_input->iovec_array     = (struct iovec *)calloc(UDP_RING_SIZE, sizeof(struct iovec));
+	udp_input->control_buffer  = (unsigned char *)calloc(UDP_RING_SIZE, UDP_CONTROL_SIZE);
+	udp_input->datagram_buffer = (unsigned char *)malloc(UDP_RING_SIZE * UDP_DATAGRAM_SIZE);
+
+	if ((udp_input->message_array == NULL) || (udp_input->iovec_array == NULL) ||
+	    (udp_input->control_buffer == NULL) || (udp_input->datagram_buffer == NULL))
+	{
+		return UDP_INPUT_MALLOC_ERROR;
+	}
+
+	// clang-format off
+	for (i=0; i<UDP_RING_SIZE; i++)
+	{ // clang-format on
+		udp_input->iovec_array[i].iov_base = udp_input->datagram_buffer + i * UDP_DATAGRAM_SIZE;
+		udp_input->iovec_array[i].iov_len  = UDP_DATAGRAM_SIZE;
+
+		message_header              = &udp_input->message_array[i].msg_hdr;
+		message_header->msg_iov     = &udp_input->iovec_array[i];
+		message_header->msg_iovlen  = 1;
+		message_header->msg_control = udp_input->control_buffer + i * UDP_CONTROL_SIZE;
+	}
+
+	return 0;
+}
+
+int udp_input_open(UdpInput *udp_input, const char *address, unsigned short port, const char *interface_address, UdpInputMode mode)
+{
+	struct sockaddr_in bind_address  = {0};
+	struct ip_mreq     group_request = {0};
+	struct in_addr     group_address = {0};
+
+	int option = 1;
+	int ret    = 0;
+
+	if (udp_input == NULL)
+	{
+		return UDP_INPUT_PARAM_ERROR;
+	}
+
+	memset(udp_input, 0, sizeof(UdpInput));
+	udp_input->socket_fd = -1;
+	udp_input->mode      = mode;
+
+	group_address.s_addr = htonl(INADDR_ANY);
+	if ((address != NULL) && (address[0] != '\0') && (inet_pton(AF_INET, address, &group_address) != 1))
+	{
+		LOG("invalid address %s\n", address);
+		return UDP_INPUT_PARAM_ERROR;
+	}
+
+	if ((ret = alloc_receive_ring(udp_input)) < 0)
+	{
+		udp_input_close(udp_input);
+		return ret;
+	}
+
+	udp_input->socket_fd = socket(AF_INET, SOCK_DGRAM, 0);
+	if (udp_input->socket_fd < 0)
+	{
+		perror("socket");
+		udp_input_close(udp_input);
+		return UDP_INPUT_SOCKET_ERROR;
+	}
+
+	setsockopt(udp_input->socket_fd, SOL_SOCKET, SO_REUSEADDR, &option, sizeof(option));
+	setsockopt(udp_input->socket_fd, SOL_SOCKET, SO_RXQ_OVFL, &option, sizeof(option));
+	set_receive_buffer_size(udp_input->socket_fd, UDP_RECEIVE_BUFFER);
+
+	// binding to the group address keeps other groups on the same port out of this socket
+	bind_address.sin_family = AF_INET;
+	bind_address.sin_port   = htons(port);
+	bind_address.sin_addr   = group_address;
+	if (bind(udp_input->socket_fd, (struct sockaddr *)&bind_address, sizeof(bind_address)) != 0)
+	{
+		perror("bind");
+		udp_input_close(udp_input);
+		return UDP_INPUT_BIND_ERROR;
+	}
+
+	if (is_multicast_address(group_address) == 1)
+	{
+		group_request.imr_multiaddr        = group_address;
+		group_request.imr_interface.s_addr = htonl(INADDR_ANY);
+		if ((interface_address != NULL) && (inet_pton(AF_INET, interface_address, &group_request.imr_interface) != 1))
+		{
+			LOG("invalid interface address %s\n", interface_address);
+			udp_input_close(udp_input);
+			return UDP_INPUT_PARAM_ERROR;
+		}
+
+		if (setsockopt(udp_input->socket_fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &group_request, sizeof(group_request)) != 0)
+		{
+			perror("IP_ADD_MEMBERSHIP");
+			udp_input_close(udp_input);
+			return UDP_INPUT_MULTICAST_ERROR;
+		}
+	}
+
+	return 0;
+}
+
+int parse_rtp_header(const unsigned char *datagram, int length, unsigned short *sequence_number, int *payload_end)
+{
+	int header_length  = RTP_HEADER_LENGTH;
+	int padding_length = 0;
+
+	if ((length < RTP_HEADER_LENGTH) || ((datagram[0] >> 6) != RTP_VERSION))
+		return -1;
+
+	header_length += (datagram[0] & 0x0F) * 4; // CSRC list
+	if ((datagram[0] & 0x10) != 0)             // header extension
+	{
+		if (header_length + 4 > length)
+			return -1;
+		header_length += 4 + (((datagram[header_length + 2] << 8) | datagram[header_length + 3]) * 4);
+	}
+
+	if ((datagram[0] & 0x20) != 0) // padding
+		padding_length = datagram[length - 1];
+
+	if (header_length + padding_length > length)
+		return -1;
+
+	*sequence_number = (datagram[2] << 8) | datagram[3];
+	*payload_end     = length - padding_length;
+	return header_length;
+}
+
+// Check the RTP header and the sequence number of one datagram, <0 means drop it
+static int strip_rtp_header(UdpInput *udp_input, unsigned char *datagram, int length, int *payload_end)
+{
+	int            header_length   = 0;
+	unsigned short sequence_number = 0;
+	unsigned short sequence_gap    = 0;
+
+	header_length = parse_rtp_header(datagram, length, &sequence_number, payload_end);
+	if (header_length < 0)
+		return -1;
+
+	if (udp_input->is_rtp_sequence_valid == 1)
+	{
+		sequence_gap = (unsigned short)(sequence_number - udp_input->rtp_next_sequence);
+		if (sequence_gap >= 0x8000)
+		{
+			// late or duplicated datagram, its slot has already been counted as lost
+			udp_input->stats.rtp_out_of_order_count++;
+			return -1;
+		}
+		udp_input->stats.rtp_lost_count += sequence_gap;
+	}
+
+	udp_input->is_rtp_sequence_valid = 1;
+	udp_input->rtp_next_sequence     = sequence_number + 1;
+	udp_input->stats.rtp_datagram_count++;
+
+	return header_length;
+}
+
+static void process_datagram(UdpInput *udp_input, Slot *slot, unsigned char *datagram, int length)
+{
+	int read_position = 0;
+	int payload_end   = length;
+	int run_count     = 0;
+
+	if ((udp_input->mode == UDP_MODE_RTP) || ((udp_input->mode == UDP_MODE_AUTO) && (datagram[0] != SYNC_BYTE)))
+	{
+		read_position = strip_rtp_header(udp_input, datagram, length, &payload_end);
+		if (read_position < 0)
+			return;
+	}
+
+	if ((payload_end - read_position) % UDP_TS_PACKET_SIZE != 0)
+	{
+		udp_input->stats.truncated_count++;
+	}
+
+	while (read_position + UDP_TS_PACKET_SIZE <= payload_end)
+	{
+		if (datagram[read_position] != SYNC_BYTE)
+		{
+			udp_input->stats.sync_error_count++;
+			read_position += UDP_TS_PACKET_SIZE;
+			continue;
+		}
+
+		// a datagram carries up to 7 packets, the aligned ones are decoded as one batch
+		run_count = 1;
+		while ((read_position + (run_count + 1) * UDP_TS_PACKET_SIZE <= payload_end) &&
+		       (datagram[read_position + run_count * UDP_TS_PACKET_SIZE] == SYNC_BYTE))
+		{
+			run_count++;
+		}
+
+		filter_ts_packets(slot, datagram + read_position, run_count, UDP_TS_PACKET_SIZE);
+		udp_input->stats.ts_packet_count += run_count;
+		read_position += run_count * UDP_TS_PACKET_SIZE;
+	}
+}
+
+static void update_kernel_drop_count(UdpInput *udp_input, struct msghdr *message_header)
+{
+	struct cmsghdr *control_message = NULL;
+	unsigned int    drop_total      = 0;
+
+	for (control_message = CMSG_FIRSTHDR(message_header); control_message != NULL; control_message = CMSG_NXTHDR(message_header, control_message))
+	{
+		if ((control_message->cmsg_level == SOL_SOCKET) && (control_message->cmsg_type == SO_RXQ_OVFL))
+		{
+			memcpy(&drop_total, CMSG_DATA(control_message), sizeof(drop_total));
+			udp_input->stats.kernel_drop_count += (unsigned int)(drop_total - udp_input->kernel_drop_total);
+			udp_input->kernel_drop_total = drop_total;
+		}
+	}
+}
+
+int udp_input_receive(UdpInput *udp_input, Slot *slot, int timeout_ms)
+{
+	struct pollfd  poll_fd        = {0};
+	struct msghdr *message_header = NULL;
+
+	int message_count = 0;
+	int i             = 0;
+	int ret           = 0;
+
+	INSTRUMENT_DECLARE_TIMER(start_ticks);
+	if ((udp_input == NULL) || (slot == NULL) || (udp_input->socket_fd < 0))
+	{
+		return UDP_INPUT_PARAM_ERROR;
+	}
+
+	// recvmmsg's own timeout is only checked between datagrams, so wait with poll and drain without blocking
+	poll_fd.fd     = udp_input->socket_fd;
+	poll_fd.events = POLLIN;
+	ret            = poll(&poll_fd, 1, timeout_ms);
+	if (ret <= 0)
+	{
+		return ((ret < 0) && (errno != EINTR)) ? UDP_INPUT_RECEIVE_ERROR : 0;
+	}
+
+	// clang-format off
+	for (i=0; i<UDP_RING_SIZE; i++)
+	{ // clang-format on
+		udp_input->message_array[i].msg_hdr.msg_controllen = UDP_CONTROL_SIZE;
+		udp_input->message_array[i].msg_hdr.msg_flags      = 0;
+	}
+
+	INSTRUMENT_START(start_ticks);
+	message_count = recvmmsg(udp_input->socket_fd, udp_input->message_array, UDP_RING_SIZE, MSG_DONTWAIT, NULL);
+	INSTRUMENT_STOP(INSTRUMENT_TIMER_IO, start_ticks);
+	if (message_count < 0)
+	{
+		if ((errno == EAGAIN) || (errno == EWOULDBLOCK) || (errno == EINTR))
+			return 0;
+
+		LOG_ERROR(LOGGER_CATEGORY_IO, "recvmmsg: %s\n", strerror(errno));
+		return UDP_INPUT_RECEIVE_ERROR;
+	}
+
+	udp_input->stats.receive_call_count++;
+	// clang-format off
+	for (i=0; i<message_count; i++)
+	{ // clang-format on
+		message_header = &udp_input->message_array[i].msg_hdr;
+		udp_input->stats.datagram_count++;
+
+		update_kernel_drop_count(udp_input, message_header);
+		if ((message_header->msg_flags & MSG_TRUNC) != 0)
+		{
+			udp_input->stats.truncated_count++;
+		}
+
+		if (udp_input->message_array[i].msg_len == 0)
+			continue;
+
+		process_datagram(udp_input, slot, udp_input->iovec_array[i].iov_base, (int)udp_input->message_array[i].msg_len);
+	}
+
+	return message_count;
+}
+
+int udp_input_run(UdpInput *udp_input, Slot *slot, int seconds)
+{
+	struct timespec start_time   = {0};
+	struct timespec current_time = {0};
+
+	int ret = 0;
+
+	clock_gettime(CLOCK_MONOTONIC, &start_time);
+	current_time = start_time;
+
+	while (current_time.tv_sec - start_time.tv_sec < seconds)
+	{
+		if ((ret = udp_input_receive(udp_input, slot, 100)) < 0)
+		{
+			return ret;
+		}
+		clock_gettime(CLOCK_MONOTONIC, &current_time);
+	}
+
+	return 0;
+}
+
+void udp_input_close(UdpInput *udp_input)
+{
+	if (udp_input->socket_fd >= 0)
+	{
+		close(udp_input->socket_fd);
+		udp_input->socket_fd = -1;
+	}
+
+	free(udp_input->message_array);
+	free(udp_input->iovec_array);
+	free(udp_input->control_buffer);
+	free(udp_input->datagram_buffer);
+	udp_input->message_array   = NULL;
+	udp_input->iovec_array     = NULL;
+	udp_input->control_buffer  = NULL;
+	udp_input->datagram_buffer = NULL;
+}
+
+void printf_udp_input_stats(const UdpInputStats *stats)
+{
+	SINGLE_LINE
+	LOG("UDP input: recvmmsg calls: %llu | datagrams: %llu | RTP datagrams: %llu | TS packets: %llu\n",
+	    stats->receive_call_count, stats->datagram_count, stats->rtp_datagram_count, stats->ts_packet_count);
+	LOG("           RTP lost: %llu | RTP out of order: %llu | sync errors: %llu | truncated: %llu | kernel drops: %llu\n",
+	    stats->rtp_lost_count, stats->rtp_out_of_order_count, stats->sync_error_count,
+	    stats->truncated_count, stats->kernel_drop_count);
+	SINGLE_LINE
+}
@@ -0,0 +1,120 @@
+/**
+ * @file udp_input.h
+ *
+ * @brief Network input source for MPEG-TS carried over UDP or RTP
+ *
+ * @author :Yujin Yu
+ * @date   :2025.05.06
+ */
+#ifndef UDP_INPUT_H
+#define UDP_INPUT_H
+
+//--------------------------------------------------------------------------------------------
+// macro definition
+//--------------------------------------------------------------------------------------------
+#define UDP_RING_SIZE          64      // datagrams pulled by one recvmmsg call
+#define UDP_DATAGRAM_SIZE      2048    // 7 * 188 + RTP header fits easily
+#define UDP_RECEIVE_BUFFER     8388608 // requested SO_RCVBUF in bytes
+#define UDP_CONTROL_SIZE       64
+#define UDP_TS_PACKET_SIZE     188
+#define RTP_HEADER_LENGTH      12
+#define RTP_VERSION            2
+#define RTP_PAYLOAD_TYPE_MP2T  33
+
+typedef enum
+{
+	UDP_MODE_AUTO = 0, // decide per datagram: 0x47 -> raw UDP, version 2 header -> RTP
+	UDP_MODE_RAW,      // plain UDP, datagram starts with the sync byte
+	UDP_MODE_RTP       // always strip the RTP header
+} UdpInputMode;
+
+typedef struct
+{
+	unsigned long long receive_call_count; // recvmmsg calls that returned data
+	unsigned long long datagram_count;
+	unsigned long long rtp_datagram_count;
+	unsigned long long ts_packet_count;
+	unsigned long long rtp_lost_count;       // datagrams missing according to the RTP sequence number
+	unsigned long long rtp_out_of_order_count;
+	unsigned long long sync_error_count;     // 188-byte slots that did not start with 0x47
+	unsigned long long truncated_count;      // datagrams cut by the kernel or not a multiple of 188
+	unsigned long long kernel_drop_count;    // SO_RXQ_OVFL, socket buffer overruns
+} UdpInputStats;
+
+struct mmsghdr;
+struct iovec;
+
+typedef struct
+{
+	int             socket_fd;
+	UdpInputMode    mode;
+	int             is_rtp_sequence_valid;
+	unsigned short  rtp_next_sequence;
+	unsigned int    kernel_drop_total;
+	UdpInputStats   stats;
+
+	// preallocated receive ring, filled by one recvmmsg call
+	struct mmsghdr *message_array;   // UDP_RING_SIZE entries
+	struct iovec   *iovec_array;     // UDP_RING_SIZE entries
+	unsigned char  *control_buffer;  // UDP_RING_SIZE * UDP_CONTROL_SIZE, carries SO_RXQ_OVFL
+	unsigned char  *datagram_buffer; // UDP_RING_SIZE * UDP_DATAGRAM_SIZE
+} UdpInput;
+
+//--------------------------------------------------------------------------------------------
+// Function declaration
+//--------------------------------------------------------------------------------------------
+/**
+ * @brief Parse the RTP header in front of a TS payload
+ *
+ * @param datagram        UDP payload
+ * @param length          Length of the UDP payload
+ * @param sequence_number Output, RTP sequence number
+ * @param payload_end     Output, end of the payload without RTP padding
+ *
+ * @return >=0: length of the RTP header, the TS payload starts there
+ *         <0 : not an RTP version 2 header
+ */
+int parse_rtp_header(const unsigned char *datagram, int length, unsigned short *sequence_number, int *payload_end);
+
+/**
+ * @brief Open a UDP socket, join the group if address is multicast and allocate the receive ring
+ *
+ * @param udp_input         Pointer to the UdpInput structure to initialise
+ * @param address           IPv4 unicast or multicast address, NULL or "0.0.0.0" for any
+ * @param port              UDP port
+ * @param interface_address Local interface used for the multicast join, NULL for default
+ * @param mode              UDP_MODE_AUTO, UDP_MODE_RAW or UDP_MODE_RTP
+ *
+ * @return 0: successful
+ *         <0: error code
+ */
+int udp_input_open(UdpInput *udp_input, const char *address, unsigned short port, const char *interface_address, UdpInputMode mode);
+
+/**
+ * @brief Pull up to UDP_RING_SIZE datagrams with one syscall and run their TS packets through the slot
+ *
+ * @param udp_input  Opened UdpInput
+ * @param slot       Slot whose filter bank receives the packets
+ * @param timeout_ms Time to wait for the first datagram, <0 waits forever
+ *
+ * @return >0: number of datagrams processed
+ *         =0: timeout
+ *         <0: error code
+ */
+int udp_input_receive(UdpInput *udp_input, Slot *slot, int timeout_ms);
+
+/**
+ * @brief Keep receiving for the given duration, EIT keeps arriving so there is no natural end
+ *
+ * @param udp_input Opened UdpInput
+ * @param slot      Slot whose filter bank receives the packets
+ * @param seconds   Receive duration
+ *
+ * @return 0: successful
+ *         <0: error code
+ */
+int  udp_input_run(UdpInput *udp_input, Slot *slot, int seconds);
+void udp_input_close(UdpInput *udp_input);
+void printf_udp_input_stats(const UdpInputStats *stats);
+
+#endif